@@ -385,6 +385,8 @@ bool DirectGraphics::Initialize(HWND hWnd, const DirectGraphicsConfig& config) {
 	pDevice_->GetRenderTarget(0, &pBackSurf_);
 	pDevice_->GetDepthStencilSurface(&pZBuffer_);
 
+	stateCache_.SetDevice(pDevice_);
+
 	bufferManager_ = new VertexBufferManager();
 	bufferManager_->Initialize(this);
 
@@ -530,6 +532,9 @@ void DirectGraphics::_VerifyDeviceCaps() {
 }
 
 void DirectGraphics::_RestoreDxResource() {
+	//Device states return to their defaults after a reset
+	stateCache_.Invalidate();
+
 	DirectGraphicsBase::_RestoreDxResource();
 
 	ResetCamera();
@@ -607,11 +612,11 @@ void DirectGraphics::ResetCamera() {
 	}
 }
 void DirectGraphics::ResetDeviceState() {
-	pDevice_->SetRenderState(D3DRS_MULTISAMPLEANTIALIAS, false);
+	stateCache_.SetRenderState(D3DRS_MULTISAMPLEANTIALIAS, false);
 
 	SetCullingMode(D3DCULL_NONE);
-	pDevice_->SetRenderState(D3DRS_SHADEMODE, D3DSHADE_GOURAUD);
-	pDevice_->SetRenderState(D3DRS_AMBIENT, D3DCOLOR_XRGB(192, 192, 192));
+	stateCache_.SetRenderState(D3DRS_SHADEMODE, D3DSHADE_GOURAUD);
+	stateCache_.SetRenderState(D3DRS_AMBIENT, D3DCOLOR_XRGB(192, 192, 192));
 	SetLightingEnable(true);
 	SetSpecularEnable(false);
 
@@ -663,6 +668,14 @@ bool DirectGraphics::BeginScene(bool bMainRender, bool bClear) {
 
 	return SUCCEEDED(pDevice_->BeginScene());
 }
+void DirectGraphics::EndScene(bool bPresent) {
+	DirectGraphicsBase::EndScene(bPresent);
+	if (bPresent) {
+		stateCache_.EndFrame();
+		if (VertexBufferManager* vbManager = VertexBufferManager::GetBase())
+			vbManager->EndFrame();
+	}
+}
 
 void DirectGraphics::ClearRenderTarget() {
 	pDevice_->Clear(0, nullptr, D3DCLEAR_TARGET | D3DCLEAR_ZBUFFER,
@@ -697,53 +710,53 @@ void DirectGraphics::SetRenderTargetNull() {
 	pDevice_->SetDepthStencilSurface(pZBuffer_);
 }
 void DirectGraphics::SetLightingEnable(bool bEnable) {
-	pDevice_->SetRenderState(D3DRS_LIGHTING, bEnable);
+	stateCache_.SetRenderState(D3DRS_LIGHTING, bEnable);
 }
 void DirectGraphics::SetSpecularEnable(bool bEnable) {
-	pDevice_->SetRenderState(D3DRS_SPECULARENABLE, bEnable);
+	stateCache_.SetRenderState(D3DRS_SPECULARENABLE, bEnable);
 }
 void DirectGraphics::SetCullingMode(DWORD mode) {
-	pDevice_->SetRenderState(D3DRS_CULLMODE, mode);
+	stateCache_.SetRenderState(D3DRS_CULLMODE, mode);
 }
 void DirectGraphics::SetShadingMode(DWORD mode) {
-	pDevice_->SetRenderState(D3DRS_SHADEMODE, mode);
+	stateCache_.SetRenderState(D3DRS_SHADEMODE, mode);
 }
 void DirectGraphics::SetZBufferEnable(bool bEnable) {
-	pDevice_->SetRenderState(D3DRS_ZENABLE, bEnable);
+	stateCache_.SetRenderState(D3DRS_ZENABLE, bEnable);
 }
 void DirectGraphics::SetZWriteEnable(bool bEnable) {
-	pDevice_->SetRenderState(D3DRS_ZWRITEENABLE, bEnable);
+	stateCache_.SetRenderState(D3DRS_ZWRITEENABLE, bEnable);
 }
 void DirectGraphics::SetAlphaTest(bool bEnable, DWORD ref, D3DCMPFUNC func) {
-	pDevice_->SetRenderState(D3DRS_ALPHATESTENABLE, bEnable);
+	stateCache_.SetRenderState(D3DRS_ALPHATESTENABLE, bEnable);
 	if (bEnable) {
-		pDevice_->SetRenderState(D3DRS_ALPHAFUNC, func);
-		pDevice_->SetRenderState(D3DRS_ALPHAREF, ref);
+		stateCache_.SetRenderState(D3DRS_ALPHAFUNC, func);
+		stateCache_.SetRenderState(D3DRS_ALPHAREF, ref);
 	}
 }
 void DirectGraphics::SetBlendMode(BlendMode mode, int stage) {
 	if (mode == previousBlendMode_) return;
 	if (previousBlendMode_ == BlendMode::RESET) {
-		pDevice_->SetTextureStageState(stage, D3DTSS_COLOROP, D3DTOP_MODULATE);
-		pDevice_->SetTextureStageState(stage, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
-		pDevice_->SetTextureStageState(stage, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
-		pDevice_->SetTextureStageState(stage, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
-		pDevice_->SetTextureStageState(stage, D3DTSS_ALPHAARG2, D3DTA_CURRENT);
-		pDevice_->SetRenderState(D3DRS_SEPARATEALPHABLENDENABLE, TRUE);
+		stateCache_.SetTextureStageState(stage, D3DTSS_COLOROP, D3DTOP_MODULATE);
+		stateCache_.SetTextureStageState(stage, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
+		stateCache_.SetTextureStageState(stage, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
+		stateCache_.SetTextureStageState(stage, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+		stateCache_.SetTextureStageState(stage, D3DTSS_ALPHAARG2, D3DTA_CURRENT);
+		stateCache_.SetRenderState(D3DRS_SEPARATEALPHABLENDENABLE, TRUE);
 	}
 	previousBlendMode_ = mode;
 
-	pDevice_->SetTextureStageState(stage, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
-	pDevice_->SetTextureStageState(stage, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+	stateCache_.SetTextureStageState(stage, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
+	stateCache_.SetTextureStageState(stage, D3DTSS_COLORARG1, D3DTA_TEXTURE);
 
 #define SETBLENDOP(op, alp) \
-	pDevice_->SetRenderState(D3DRS_BLENDOP, op); \
-	pDevice_->SetRenderState(D3DRS_ALPHABLENDENABLE, alp);
+	stateCache_.SetRenderState(D3DRS_BLENDOP, op); \
+	stateCache_.SetRenderState(D3DRS_ALPHABLENDENABLE, alp);
 #define SETBLENDARGS(sbc, dbc, sba, dba) \
-	pDevice_->SetRenderState(D3DRS_SRCBLEND, sbc); \
-	pDevice_->SetRenderState(D3DRS_DESTBLEND, dbc); \
-	pDevice_->SetRenderState(D3DRS_SRCBLENDALPHA, sba); \
-	pDevice_->SetRenderState(D3DRS_DESTBLENDALPHA, dba);
+	stateCache_.SetRenderState(D3DRS_SRCBLEND, sbc); \
+	stateCache_.SetRenderState(D3DRS_DESTBLEND, dbc); \
+	stateCache_.SetRenderState(D3DRS_SRCBLENDALPHA, sba); \
+	stateCache_.SetRenderState(D3DRS_DESTBLENDALPHA, dba);
 
 	switch (mode) {
 	case MODE_BLEND_NONE:		//No blending
@@ -751,7 +764,7 @@ void DirectGraphics::SetBlendMode(BlendMode mode, int stage) {
 		SETBLENDARGS(D3DBLEND_ONE, D3DBLEND_ZERO, D3DBLEND_ONE, D3DBLEND_ZERO);
 		break;
 	case MODE_BLEND_ALPHA_INV:		//Alpha + Invert
-		pDevice_->SetTextureStageState(stage, D3DTSS_COLORARG1, D3DTA_TEXTURE | D3DTA_COMPLEMENT);
+		stateCache_.SetTextureStageState(stage, D3DTSS_COLORARG1, D3DTA_TEXTURE | D3DTA_COMPLEMENT);
 	case MODE_BLEND_ALPHA:			//Alpha
 		SETBLENDOP(D3DBLENDOP_ADD, TRUE);
 		SETBLENDARGS(D3DBLEND_SRCALPHA, D3DBLEND_INVSRCALPHA, D3DBLEND_ONE, D3DBLEND_INVSRCALPHA);
@@ -793,23 +806,23 @@ void DirectGraphics::SetBlendMode(BlendMode mode, int stage) {
 	//pDevice_->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE); 
 }
 void DirectGraphics::SetFillMode(DWORD mode) {
-	pDevice_->SetRenderState(D3DRS_FILLMODE, mode);
+	stateCache_.SetRenderState(D3DRS_FILLMODE, mode);
 }
 void DirectGraphics::SetFogEnable(bool bEnable) {
-	pDevice_->SetRenderState(D3DRS_FOGENABLE, bEnable ? TRUE : FALSE);
+	stateCache_.SetRenderState(D3DRS_FOGENABLE, bEnable ? TRUE : FALSE);
 }
 bool DirectGraphics::IsFogEnable() {
 	DWORD fog = FALSE;
-	pDevice_->GetRenderState(D3DRS_FOGENABLE, &fog);
+	stateCache_.GetRenderState(D3DRS_FOGENABLE, &fog);
 	return (fog == TRUE);
 }
 void DirectGraphics::SetVertexFog(bool bEnable, D3DCOLOR color, float start, float end) {
 	SetFogEnable(bEnable);
 
-	pDevice_->SetRenderState(D3DRS_FOGCOLOR, color);
-	pDevice_->SetRenderState(D3DRS_FOGVERTEXMODE, D3DFOG_LINEAR);
-	pDevice_->SetRenderState(D3DRS_FOGSTART, *(DWORD*)(&start));
-	pDevice_->SetRenderState(D3DRS_FOGEND, *(DWORD*)(&end));
+	stateCache_.SetRenderState(D3DRS_FOGCOLOR, color);
+	stateCache_.SetRenderState(D3DRS_FOGVERTEXMODE, D3DFOG_LINEAR);
+	stateCache_.SetRenderState(D3DRS_FOGSTART, *(DWORD*)(&start));
+	stateCache_.SetRenderState(D3DRS_FOGEND, *(DWORD*)(&end));
 
 	stateFog_.bEnable = bEnable;
 	stateFog_.color = ColorAccess::ToVec4Normalized(color, ColorAccess::PERMUTE_RGBA);
@@ -820,9 +833,9 @@ void DirectGraphics::SetPixelFog(bool bEnable, D3DCOLOR color, float start, floa
 void DirectGraphics::SetTextureFilter(D3DTEXTUREFILTERTYPE fMin, D3DTEXTUREFILTERTYPE fMag,
 	D3DTEXTUREFILTERTYPE fMip, int stage)
 {
-	if (fMin >= D3DTEXF_NONE) pDevice_->SetSamplerState(stage, D3DSAMP_MINFILTER, fMin);
-	if (fMag >= D3DTEXF_NONE) pDevice_->SetSamplerState(stage, D3DSAMP_MAGFILTER, fMag);
-	if (fMip >= D3DTEXF_NONE) pDevice_->SetSamplerState(stage, D3DSAMP_MIPFILTER, fMip);
+	if (fMin >= D3DTEXF_NONE) stateCache_.SetSamplerState(stage, D3DSAMP_MINFILTER, fMin);
+	if (fMag >= D3DTEXF_NONE) stateCache_.SetSamplerState(stage, D3DSAMP_MAGFILTER, fMag);
+	if (fMip >= D3DTEXF_NONE) stateCache_.SetSamplerState(stage, D3DSAMP_MIPFILTER, fMip);
 }
 DWORD DirectGraphics::GetTextureFilter(D3DTEXTUREFILTERTYPE* fMin, D3DTEXTUREFILTERTYPE* fMag,
 	D3DTEXTUREFILTERTYPE* fMip, int stage)
@@ -830,17 +843,17 @@ DWORD DirectGraphics::GetTextureFilter(D3DTEXTUREFILTERTYPE* fMin, D3DTEXTUREFIL
 	DWORD res = 0;
 	DWORD tmp;
 	if (fMin) {
-		pDevice_->GetSamplerState(stage, D3DSAMP_MINFILTER, &tmp);
+		stateCache_.GetSamplerState(stage, D3DSAMP_MINFILTER, &tmp);
 		*fMin = (D3DTEXTUREFILTERTYPE)tmp;
 		++res;
 	}
 	if (fMag) {
-		pDevice_->GetSamplerState(stage, D3DSAMP_MAGFILTER, &tmp);
+		stateCache_.GetSamplerState(stage, D3DSAMP_MAGFILTER, &tmp);
 		*fMag = (D3DTEXTUREFILTERTYPE)tmp;
 		++res;
 	}
 	if (fMip) {
-		pDevice_->GetSamplerState(stage, D3DSAMP_MIPFILTER, &tmp);
+		stateCache_.GetSamplerState(stage, D3DSAMP_MIPFILTER, &tmp);
 		*fMip = (D3DTEXTUREFILTERTYPE)tmp;
 		++res;
 	}
@@ -870,7 +883,7 @@ D3DMULTISAMPLE_TYPE DirectGraphics::GetMultiSampleType() {
 	return d3dppWin_.MultiSampleType;
 }
 HRESULT DirectGraphics::SetAntiAliasing(bool bEnable) {
-	return pDevice_->SetRenderState(D3DRS_MULTISAMPLEANTIALIAS, bEnable ? TRUE : FALSE);
+	return stateCache_.SetRenderState(D3DRS_MULTISAMPLEANTIALIAS, bEnable ? TRUE : FALSE);
 }
 bool DirectGraphics::IsSupportMultiSample(D3DMULTISAMPLE_TYPE type, bool bWindowed) {
 	if (type == D3DMULTISAMPLE_NONE)
@@ -5,6 +5,7 @@
 
 #if defined(DNH_PROJ_EXECUTOR)
 #include "VertexBuffer.hpp"
+#include "DxStateCache.hpp"
 #endif
 
 namespace directx {
@@ -109,6 +110,8 @@ namespace directx {
 		static DirectGraphics* thisBase_;
 	public:
 		static float g_dxCoordsMul_;
+
+		using StateCache = DeviceStateCache;
 	protected:
 		D3DPRESENT_PARAMETERS d3dppFull_;
 		D3DPRESENT_PARAMETERS d3dppWin_;
@@ -147,6 +150,8 @@ namespace directx {
 		VertexBufferManager* bufferManager_;
 		VertexFogState stateFog_;
 
+		StateCache stateCache_;
+
 		//-----------------------------------------------------------
 
 		virtual void _RestoreDxResource();
@@ -175,6 +180,7 @@ namespace directx {
 
 		bool BeginScene(bool bMainRender, bool bClear);
 		virtual bool BeginScene(bool bClear);
+		virtual void EndScene(bool bPresent);
 
 		//-----------------------------------------------------------
 
@@ -200,6 +206,27 @@ namespace directx {
 
 		//-----------------------------------------------------------
 
+		//Filtered device state, use these instead of calling the device directly
+		HRESULT SetRenderState(D3DRENDERSTATETYPE type, DWORD value) { return stateCache_.SetRenderState(type, value); }
+		HRESULT SetSamplerState(DWORD sampler, D3DSAMPLERSTATETYPE type, DWORD value) {
+			return stateCache_.SetSamplerState(sampler, type, value);
+		}
+		HRESULT SetTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE type, DWORD value) {
+			return stateCache_.SetTextureStageState(stage, type, value);
+		}
+		HRESULT SetTexture(DWORD stage, IDirect3DBaseTexture9* texture) { return stateCache_.SetTexture(stage, texture); }
+		HRESULT SetStreamSource(UINT stream, IDirect3DVertexBuffer9* buffer, UINT offset, UINT stride) {
+			return stateCache_.SetStreamSource(stream, buffer, offset, stride);
+		}
+		HRESULT SetFVF(DWORD fvf) { return stateCache_.SetFVF(fvf); }
+		HRESULT SetVertexDeclaration(IDirect3DVertexDeclaration9* decl) { return stateCache_.SetVertexDeclaration(decl); }
+		HRESULT SetIndices(IDirect3DIndexBuffer9* indices) { return stateCache_.SetIndices(indices); }
+		void NotifyDrawUP(bool bIndexed) { stateCache_.NotifyDrawUP(bIndexed); }
+		//ID3DXEffect sets device state directly in BeginPass and restores it in End, call after either
+		void NotifyEffectStateChange() { stateCache_.Invalidate(); }
+
+		StateCache* GetStateCache() { return &stateCache_; }
+
 		//Render states
 		void SetLightingEnable(bool bEnable);
 		void SetSpecularEnable(bool bEnable);
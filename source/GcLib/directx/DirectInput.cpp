@@ -13,12 +13,15 @@ DirectInput::DirectInput() {
 	hWnd_ = nullptr;
 
 	pDirectInput_ = nullptr;
+
+	countDropped_ = 0;
 }
 DirectInput::~DirectInput() {
 	if (this != thisBase_) return;
 
 	Logger::WriteTop("DirectInput: Finalizing:");
 
+	StopSampling();
 	UnacquireInputDevices();
 
 	ptr_release(pDirectInput_);
@@ -54,6 +57,8 @@ void DirectInput::_WrapDXErr(HRESULT hr, const std::string& routine, const std::
 }
 
 void DirectInput::UnacquireInputDevices() {
+	Lock lock(lockDevice_);
+
 	deviceKeyboard_.idh.Unacquire();
 	deviceMouse_.idh.Unacquire();
 	for (auto& iPad : listDeviceJoypad_) {
@@ -62,6 +67,8 @@ void DirectInput::UnacquireInputDevices() {
 	listDeviceJoypad_.clear();
 }
 void DirectInput::RefreshInputDevices() {
+	Lock lock(lockDevice_);
+
 	UnacquireInputDevices();
 
 	_InitializeKeyBoard();
@@ -288,68 +295,81 @@ BOOL DirectInput::_GetJoypadCallback(LPDIDEVICEINSTANCE lpddi) {
 	return DIENUM_CONTINUE;
 }
 
-DIKeyState DirectInput::_GetKeyboardKey(UINT code, DIKeyState state) {
-	return _GetStateSub((deviceKeyboard_.state[code] & 0x80) == 0x80, state);
-}
 DIKeyState DirectInput::_GetMouseButton(int16_t button, DIKeyState state) {
 	return _GetStateSub((deviceMouse_.state.rgbButtons[button] & 0x80) == 0x80, state);
 }
 
-DIKeyState DirectInput::_GetPadButton(int16_t index, int16_t buttonNo, DIKeyState state) {
-	return _GetStateSub((listDeviceJoypad_[index].state.rgbButtons[buttonNo] & 0x80) == 0x80, state);
-}
-DIKeyState DirectInput::_GetPadAnalogDirection(int16_t index, uint16_t direction, DIKeyState state) {
-	if (index < listDeviceJoypad_.size()) {
-		LONG response = listDeviceJoypad_[index].responseThreshold;
-		DIJOYSTATE* pState = &listDeviceJoypad_[index].state;
-
-		switch (direction) {
-		case DIK_UP:
-			return _GetStateSub(pState->lY < -response, state);
-		case DIK_DOWN:
-			return _GetStateSub(pState->lY > response, state);
-		case DIK_LEFT:
-			return _GetStateSub(pState->lX < -response, state);
-		case DIK_RIGHT:
-			return _GetStateSub(pState->lX > response, state);
-		}
+bool DirectInput::_IsPadAnalogDirection(const DIJOYSTATE* pState, LONG response, uint16_t direction) {
+	switch (direction) {
+	case DIK_UP:
+		return pState->lY < -response;
+	case DIK_DOWN:
+		return pState->lY > response;
+	case DIK_LEFT:
+		return pState->lX < -response;
+	case DIK_RIGHT:
+		return pState->lX > response;
 	}
-	return KEY_FREE;
+	return false;
 }
-DIKeyState DirectInput::_GetPadPovHatDirection(int16_t index, int iHat, uint16_t direction, DIKeyState state) {
+bool DirectInput::_IsPadPovHatDirection(const DIJOYSTATE* pState, int iHat, uint16_t direction) {
 	// TODO: Determine the amount of POV hats available in a pad
-	if (index < listDeviceJoypad_.size() && iHat < 4) {
-		DIJOYSTATE* pState = &listDeviceJoypad_[index].state;
-		DWORD pov = pState->rgdwPOV[iHat];
-		if (pov == UINT32_MAX)
-			return _GetStateSub(false, state);
-
-		pov /= 100;
-
-		constexpr const int MARGIN = 15;
-		switch (direction) {
-		case DIK_UP:
-			return _GetStateSub(pov < 90  - MARGIN || pov > 270 + MARGIN, state);
-		case DIK_DOWN:
-			return _GetStateSub(pov > 90  + MARGIN && pov < 270 - MARGIN, state);
-		case DIK_LEFT:
-			return _GetStateSub(pov > 180 + MARGIN && pov < 360 - MARGIN, state);
-		case DIK_RIGHT:
-			return _GetStateSub(pov > 0   + MARGIN && pov < 180 - MARGIN, state);
-		}
-	}
-	return KEY_FREE;
-}
+	if (iHat >= 4)
+		return false;
 
-DIKeyState DirectInput::_GetStateSub(bool flag, DIKeyState state) {
-	DIKeyState res = KEY_FREE;
-	if (flag) {
-		res = state == KEY_FREE ? KEY_PUSH : KEY_HOLD;
+	DWORD pov = pState->rgdwPOV[iHat];
+	if (pov == UINT32_MAX)
+		return false;
+
+	pov /= 100;
+
+	constexpr const int MARGIN = 15;
+	switch (direction) {
+	case DIK_UP:
+		return pov < 90  - MARGIN || pov > 270 + MARGIN;
+	case DIK_DOWN:
+		return pov > 90  + MARGIN && pov < 270 - MARGIN;
+	case DIK_LEFT:
+		return pov > 180 + MARGIN && pov < 360 - MARGIN;
+	case DIK_RIGHT:
+		return pov > 0   + MARGIN && pov < 180 - MARGIN;
 	}
-	else {
-		res = (state == KEY_PUSH || state == KEY_HOLD) ? KEY_PULL : KEY_FREE;
+	return false;
+}
+void DirectInput::_GetPadButtonFlags(const DIJOYSTATE* pState, LONG response, std::bitset<MAX_PAD_STATE>* pOut) {
+	auto& res = *pOut;
+
+	// 0-3 -> (Typically) Left analog stick
+	res[0] = _IsPadAnalogDirection(pState, response, DIK_LEFT);
+	res[1] = _IsPadAnalogDirection(pState, response, DIK_RIGHT);
+	res[2] = _IsPadAnalogDirection(pState, response, DIK_UP);
+	res[3] = _IsPadAnalogDirection(pState, response, DIK_DOWN);
+
+	// 4-7 -> D-Pad
+	res[4] = _IsPadPovHatDirection(pState, 0, DIK_LEFT);
+	res[5] = _IsPadPovHatDirection(pState, 0, DIK_RIGHT);
+	res[6] = _IsPadPovHatDirection(pState, 0, DIK_UP);
+	res[7] = _IsPadPovHatDirection(pState, 0, DIK_DOWN);
+
+	for (int16_t iButton = 0; iButton < MAX_PAD_BUTTON; ++iButton)
+		res[iButton + 8] = (pState->rgbButtons[iButton] & 0x80) == 0x80;
+}
+
+DIKeyState DirectInput::AdvanceKeyState(DIKeyState state, bool bDown, bool bPressed, bool bReleased) {
+	bool bWasDown = state == KEY_PUSH || state == KEY_HOLD;
+	if (bDown) {
+		if (state == KEY_FREE) return KEY_PUSH;
+		//Released and pressed again since the last update, the new press gets its PUSH frame
+		if (bWasDown) return (bReleased && bPressed) ? KEY_PUSH : KEY_HOLD;
+		//Down right after a PULL is HOLD unless the sampler saw the new press
+		return bPressed ? KEY_PUSH : KEY_HOLD;
 	}
-	return res;
+	if (bWasDown) return KEY_PULL;
+	//A press that was already released again still gets its PUSH frame
+	return bPressed ? KEY_PUSH : KEY_FREE;
+}
+DIKeyState DirectInput::_GetCodeState(size_t code, bool flag, DIKeyState state) {
+	return AdvanceKeyState(state, flag, edgePress_[code], edgeRelease_[code]);
 }
 
 bool DirectInput::_IdleKeyboard() {
@@ -391,12 +411,19 @@ bool DirectInput::_IdleJoypad() {
 }
 
 void DirectInput::Update() {
-	this->_IdleKeyboard();
-	this->_IdleMouse();
-	this->_IdleJoypad();
+	{
+		Lock lock(lockDevice_);
+		this->_IdleKeyboard();
+		this->_IdleMouse();
+		this->_IdleJoypad();
+	}
 
-	for (int16_t iKey = 0; iKey < MAX_KEY; ++iKey)
-		bufKey_[iKey] = _GetKeyboardKey(iKey, bufKey_[iKey]);
+	_ConsumeEvents();
+
+	for (int16_t iKey = 0; iKey < MAX_KEY; ++iKey) {
+		bool bDown = (deviceKeyboard_.state[iKey] & 0x80) == 0x80;
+		bufKey_[iKey] = _GetCodeState(CODE_KEY + iKey, bDown, bufKey_[iKey]);
+	}
 
 	for (int16_t iButton = 0; iButton < 3; ++iButton)
 		bufMouse_[iButton] = _GetMouseButton(iButton, bufMouse_[iButton]);
@@ -404,21 +431,124 @@ void DirectInput::Update() {
 	for (int16_t iPad = 0; iPad < listDeviceJoypad_.size(); ++iPad) {
 		auto& pad = bufPad_[iPad];
 
-		// 0-3 -> (Typically) Left analog stick
-		pad[0] = _GetPadAnalogDirection(iPad, DIK_LEFT, pad[0]);
-		pad[1] = _GetPadAnalogDirection(iPad, DIK_RIGHT, pad[1]);
-		pad[2] = _GetPadAnalogDirection(iPad, DIK_UP, pad[2]);
-		pad[3] = _GetPadAnalogDirection(iPad, DIK_DOWN, pad[3]);
+		std::bitset<MAX_PAD_STATE> flags;
+		_GetPadButtonFlags(&listDeviceJoypad_[iPad].state, listDeviceJoypad_[iPad].responseThreshold, &flags);
+
+		//Only the first MAX_JOYPAD pads are sampled, the rest are polled per update only
+		if (iPad < MAX_JOYPAD) {
+			size_t codeBase = CODE_PAD + iPad * MAX_PAD_STATE;
+			for (int16_t iState = 0; iState < 8 + MAX_PAD_BUTTON; ++iState)
+				pad[iState] = _GetCodeState(codeBase + iState, flags[iState], pad[iState]);
+		}
+		else {
+			for (int16_t iState = 0; iState < 8 + MAX_PAD_BUTTON; ++iState)
+				pad[iState] = _GetStateSub(flags[iState], pad[iState]);
+		}
+	}
+
+	edgePress_.reset();
+	edgeRelease_.reset();
+}
 
-		// 4-7 -> D-Pad
-		pad[4] = _GetPadPovHatDirection(iPad, 0, DIK_LEFT, pad[4]);
-		pad[5] = _GetPadPovHatDirection(iPad, 0, DIK_RIGHT, pad[5]);
-		pad[6] = _GetPadPovHatDirection(iPad, 0, DIK_UP, pad[6]);
-		pad[7] = _GetPadPovHatDirection(iPad, 0, DIK_DOWN, pad[7]);
+//Moves the sampled events into the edge flags of this update
+void DirectInput::_ConsumeEvents() {
+	SampleStats stats;
+	stats.countDropped = countDropped_.exchange(0);
 
-		for (int16_t iButton = 0; iButton < MAX_PAD_BUTTON; ++iButton)
-			pad[iButton + 8] = _GetPadButton(iPad, iButton, pad[iButton + 8]);
+	if (threadSampler_) {
+		uint64_t timeNow = stdch::duration_cast<stdch::nanoseconds>(
+			stdch::steady_clock::now().time_since_epoch()).count();
+
+		InputEvent ev;
+		while (queueEvent_.Pop(&ev)) {
+			if (ev.code >= MAX_INPUT_CODE) continue;
+
+			if (ev.bDown) {
+				edgePress_[ev.code] = true;
+			}
+			else {
+				if (edgePress_[ev.code])
+					++stats.countShortPress;
+				edgeRelease_[ev.code] = true;
+			}
+
+			if (timeNow > ev.time)
+				stats.latencyMax = std::max(stats.latencyMax, timeNow - ev.time);
+			++stats.countEvent;
+		}
+	}
+
+	statsLast_ = stats;
+}
+
+bool DirectInput::_SampleButtons(std::bitset<MAX_INPUT_CODE>* pOut) {
+	Lock lock(lockDevice_);
+
+	if (pDirectInput_ == nullptr)
+		return false;
+	auto& res = *pOut;
+	res.reset();
+
+	//The mouse isn't sampled, reading it here would eat the relative axis movement
+	if (LPDIRECTINPUTDEVICE8 pDevice = deviceKeyboard_.idh.pDevice) {
+		BYTE state[MAX_KEY];
+		if (FAILED(pDevice->GetDeviceState(sizeof(state), state)))
+			return false;
+		for (size_t iKey = 0; iKey < MAX_KEY; ++iKey)
+			res[CODE_KEY + iKey] = (state[iKey] & 0x80) == 0x80;
 	}
+
+	size_t countPad = std::min<size_t>(listDeviceJoypad_.size(), MAX_JOYPAD);
+	for (size_t iPad = 0; iPad < countPad; ++iPad) {
+		JoypadInputDevice* pJoypad = &listDeviceJoypad_[iPad];
+		LPDIRECTINPUTDEVICE8 pDevice = pJoypad->idh.pDevice;
+		if (pDevice == nullptr) continue;
+
+		pDevice->Poll();
+
+		DIJOYSTATE state;
+		if (FAILED(pDevice->GetDeviceState(sizeof(DIJOYSTATE), &state)))
+			return false;
+
+		std::bitset<MAX_PAD_STATE> flags;
+		_GetPadButtonFlags(&state, pJoypad->responseThreshold, &flags);
+
+		size_t codeBase = CODE_PAD + iPad * MAX_PAD_STATE;
+		for (size_t iState = 0; iState < MAX_PAD_STATE; ++iState)
+			res[codeBase + iState] = flags[iState];
+	}
+
+	return true;
+}
+
+void DirectInput::StartSampling() {
+	if (threadSampler_) return;
+
+	queueEvent_.Clear();
+	edgePress_.reset();
+	edgeRelease_.reset();
+
+	threadSampler_.reset(new SamplerThread(this));
+	threadSampler_->Start();
+
+	Logger::WriteTop("DirectInput: Input sampling started.");
+}
+void DirectInput::StopSampling() {
+	if (threadSampler_ == nullptr) return;
+
+	threadSampler_->Stop();
+	threadSampler_->Join();
+	threadSampler_ = nullptr;
+
+	queueEvent_.Clear();
+
+	Logger::WriteTop("DirectInput: Input sampling stopped.");
+}
+bool DirectInput::PushInputEvent(const InputEvent& ev) {
+	if (queueEvent_.Push(ev))
+		return true;
+	++countDropped_;
+	return false;
 }
 
 DIKeyState DirectInput::GetKeyState(int16_t key) {
@@ -451,6 +581,10 @@ void DirectInput::ResetInputState() {
 	ResetKeyState();
 	ResetMouseState();
 	ResetPadState();
+
+	queueEvent_.Clear();
+	edgePress_.reset();
+	edgeRelease_.reset();
 }
 void DirectInput::ResetKeyState() {
 	for (int16_t iKey = 0; iKey < MAX_KEY; ++iKey)
@@ -491,6 +625,42 @@ const DirectInput::JoypadInputDevice* DirectInput::GetPadDevice(int16_t padIndex
 	return &listDeviceJoypad_[padIndex];
 }
 
+//*******************************************************************
+//DirectInput::SamplerThread
+//*******************************************************************
+DirectInput::SamplerThread::SamplerThread(DirectInput* input) {
+	_SetOuter(input);
+}
+void DirectInput::SamplerThread::_Run() {
+	DirectInput* input = _GetOuter();
+
+	std::bitset<MAX_INPUT_CODE> statePrev;
+	std::bitset<MAX_INPUT_CODE> stateCurrent;
+	bool bFirst = true;
+
+	::timeBeginPeriod(1);
+	while (this->GetStatus() == RUN) {
+		if (input->_SampleButtons(&stateCurrent)) {
+			//The first sample is only a baseline, the main thread already knows what is held
+			if (!bFirst) {
+				std::bitset<MAX_INPUT_CODE> changed = stateCurrent ^ statePrev;
+				if (changed.any()) {
+					uint64_t time = stdch::duration_cast<stdch::nanoseconds>(
+						stdch::steady_clock::now().time_since_epoch()).count();
+					for (size_t iCode = 0; iCode < MAX_INPUT_CODE; ++iCode) {
+						if (!changed[iCode]) continue;
+						input->PushInputEvent(InputEvent{ time, (uint16_t)iCode, stateCurrent[iCode] });
+					}
+				}
+			}
+			statePrev = stateCurrent;
+			bFirst = false;
+		}
+		::Sleep(SAMPLE_INTERVAL_MS);
+	}
+	::timeEndPeriod(1);
+}
+
 //*******************************************************************
 //VirtualKey
 //*******************************************************************
@@ -509,7 +679,7 @@ VirtualKeyManager::VirtualKeyManager() {
 
 }
 VirtualKeyManager::~VirtualKeyManager() {
-
+	StopSampling();
 }
 
 void VirtualKeyManager::Update() {
@@ -608,7 +778,7 @@ void KeyReplayManager::Update() {
 				if (data.frame_ > frame_) break;
 
 				if (idKey == data.id_ && data.frame_ == frame_) {
-					stateKey = data.state_;
+					stateKey = _ApplyRecordedState(stateKey, data.state_);
 					++replayDataIterator_;
 				}
 			}
@@ -622,6 +792,15 @@ void KeyReplayManager::Update() {
 	}
 	++frame_;
 }
+DIKeyState KeyReplayManager::_ApplyRecordedState(DIKeyState state, DIKeyState stateRecord) {
+	//Nothing to advance from on the first frame, the key may already be held
+	if (frame_ == 0) return stateRecord;
+
+	//Through the same state machine as live input, a damaged record can't produce a transition live input never would
+	bool bDown = stateRecord == KEY_PUSH || stateRecord == KEY_HOLD;
+	bool bPressed = stateRecord == KEY_PUSH;
+	return DirectInput::AdvanceKeyState(state, bDown, bPressed, bPressed);
+}
 bool KeyReplayManager::IsTargetKeyCode(int16_t key) {
 	bool res = false;
 	for (auto itrTarget = mapKeyTarget_.begin(); itrTarget != mapKeyTarget_.end(); ++itrTarget) {
@@ -4,11 +4,54 @@
 #include "DxConstant.hpp"
 
 namespace directx {
+	//*******************************************************************
+	//InputEventQueue
+	//*******************************************************************
+	//Lock-free ring buffer for exactly one producer thread and one consumer thread.
+	//Push fails instead of blocking when the queue is full.
+	template<typename T, size_t N>
+	class InputEventQueue {
+		static_assert((N & (N - 1)) == 0, "N must be a power of 2");
+	private:
+		std::array<T, N> buffer_;
+		std::atomic<size_t> head_;	//Written by the consumer
+		std::atomic<size_t> tail_;	//Written by the producer
+	public:
+		InputEventQueue() : head_(0), tail_(0) {}
+
+		bool Push(const T& item) {
+			size_t tail = tail_.load(std::memory_order_relaxed);
+			if (tail - head_.load(std::memory_order_acquire) >= N) return false;
+			buffer_[tail & (N - 1)] = item;
+			tail_.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+		bool Pop(T* pItem) {
+			size_t head = head_.load(std::memory_order_relaxed);
+			if (head == tail_.load(std::memory_order_acquire)) return false;
+			*pItem = buffer_[head & (N - 1)];
+			head_.store(head + 1, std::memory_order_release);
+			return true;
+		}
+		//Consumer side only
+		void Clear() {
+			head_.store(tail_.load(std::memory_order_acquire), std::memory_order_release);
+		}
+	};
+
+	struct InputEvent {
+		uint64_t time;		//steady_clock, in nanoseconds
+		uint16_t code;		//DirectInput::CODE_*
+		bool bDown;
+	};
+
 	//*******************************************************************
 	//DirectInput
 	//*******************************************************************
 	class DirectInput {
 		static DirectInput* thisBase_;
+	public:
+		class SamplerThread;
 	public:
 		enum {
 			MAX_JOYPAD = 4,
@@ -45,6 +88,23 @@ namespace directx {
 			PAD_13,
 			PAD_14,
 			PAD_15,
+
+			// ------------------------------
+
+			//Button codes of the sampling thread's events
+			CODE_KEY = 0,
+			CODE_PAD = CODE_KEY + MAX_KEY,
+			MAX_INPUT_CODE = CODE_PAD + MAX_JOYPAD * MAX_PAD_STATE,
+
+			MAX_INPUT_EVENT = 1024,
+			SAMPLE_INTERVAL_MS = 1,
+		};
+
+		struct SampleStats {
+			size_t countEvent = 0;
+			size_t countShortPress = 0;		//Pressed and released between two updates
+			size_t countDropped = 0;
+			uint64_t latencyMax = 0;		//Event to update, in nanoseconds
 		};
 	public:
 		struct InputDeviceHeader {
@@ -92,6 +152,14 @@ namespace directx {
 		DIKeyState bufMouse_[MAX_MOUSE_BUTTON];			//Mouse key states
 		std::vector<std::vector<DIKeyState>> bufPad_;	//Joypad key states
 
+		unique_ptr<SamplerThread> threadSampler_;
+		gstd::CriticalSection lockDevice_;
+		InputEventQueue<InputEvent, MAX_INPUT_EVENT> queueEvent_;
+		std::atomic<size_t> countDropped_;
+		std::bitset<MAX_INPUT_CODE> edgePress_;
+		std::bitset<MAX_INPUT_CODE> edgeRelease_;
+		SampleStats statsLast_;
+
 		void _WrapDXErr(HRESULT hr, const std::string& routine, const std::string& msg, bool bThrow = false);
 
 		bool _InitializeKeyBoard();
@@ -104,14 +172,18 @@ namespace directx {
 		bool _IdleJoypad();
 		bool _IdleMouse();
 
-		DIKeyState _GetKeyboardKey(UINT code, DIKeyState state);
 		DIKeyState _GetMouseButton(int16_t button, DIKeyState state);
 
-		DIKeyState _GetPadButton(int16_t index, int16_t buttonNo, DIKeyState state);
-		DIKeyState _GetPadAnalogDirection(int16_t index, uint16_t direction, DIKeyState state);
-		DIKeyState _GetPadPovHatDirection(int16_t index, int iHat, uint16_t direction, DIKeyState state);
+		static bool _IsPadAnalogDirection(const DIJOYSTATE* pState, LONG response, uint16_t direction);
+		static bool _IsPadPovHatDirection(const DIJOYSTATE* pState, int iHat, uint16_t direction);
+		static void _GetPadButtonFlags(const DIJOYSTATE* pState, LONG response, std::bitset<MAX_PAD_STATE>* pOut);
+
+		DIKeyState _GetStateSub(bool flag, DIKeyState state) { return AdvanceKeyState(state, flag, false, false); }
+		DIKeyState _GetCodeState(size_t code, bool flag, DIKeyState state);
 
-		DIKeyState _GetStateSub(bool flag, DIKeyState state);
+		//Reads the current keyboard and pad buttons for the sampling thread, returns false if nothing could be read.
+		bool _SampleButtons(std::bitset<MAX_INPUT_CODE>* pOut);
+		void _ConsumeEvents();
 	public:
 		DirectInput();
 		virtual ~DirectInput();
@@ -124,6 +196,19 @@ namespace directx {
 		void UnacquireInputDevices();
 		void RefreshInputDevices();
 
+		//Polls the buttons on a separate thread every SAMPLE_INTERVAL_MS,
+		//	so presses shorter than an update still register on the next one
+		void StartSampling();
+		void StopSampling();
+		bool IsSampling() { return threadSampler_ != nullptr; }
+		bool PushInputEvent(const InputEvent& ev);
+		const SampleStats& GetLastSampleStats() { return statsLast_; }
+
+		//Key state machine shared by every button and by replay playback.
+		//bPressed/bReleased tell whether the button went down/up at any point since the last update.
+		//Without them (no sampler) it is the original mapping: FREE->PUSH->HOLD->PULL->FREE, down after a PULL is HOLD.
+		static DIKeyState AdvanceKeyState(DIKeyState state, bool bDown, bool bPressed, bool bReleased);
+
 		DIKeyState GetKeyState(int16_t key);
 		DIKeyState GetMouseState(int16_t button);
 		DIKeyState GetPadState(int16_t padNo, int16_t button);
@@ -145,6 +230,14 @@ namespace directx {
 		const JoypadInputDevice* GetPadDevice(int16_t padIndex);
 	};
 
+	class DirectInput::SamplerThread : public gstd::Thread, public gstd::InnerClass<DirectInput> {
+		friend DirectInput;
+	protected:
+		SamplerThread(DirectInput* input);
+
+		void _Run();
+	};
+
 	//*******************************************************************
 	//VirtualKeyManager
 	//*******************************************************************
@@ -218,6 +311,8 @@ namespace directx {
 
 		std::list<ReplayData> listReplayData_;
 		VirtualKeyManager* input_;
+
+		DIKeyState _ApplyRecordedState(DIKeyState state, DIKeyState stateRecord);
 	public:
 		KeyReplayManager(VirtualKeyManager* input);
 		virtual ~KeyReplayManager();
@@ -17,6 +17,11 @@ DirectSoundManager::DirectSoundManager() {
 	pDirectSound_ = nullptr;
 	pDirectSoundPrimaryBuffer_ = nullptr;
 
+	cachePcm_.reset(new SoundPcmCache(PCM_CACHE_BUDGET_DEFAULT));
+
+	mixer_.reset(new SoundMixer(MIXER_SAMPLE_RATE));
+	pMixerBuffer_ = nullptr;
+
 	CreateSoundDivision(SoundDivision::DIVISION_BGM);
 	CreateSoundDivision(SoundDivision::DIVISION_SE);
 	CreateSoundDivision(SoundDivision::DIVISION_VOICE);
@@ -29,6 +34,21 @@ DirectSoundManager::~DirectSoundManager() {
 	threadManage_->Join();
 	threadManage_ = nullptr;
 
+	threadDecode_->Stop();
+	threadDecode_->Notify();
+	threadDecode_->Join();
+	threadDecode_ = nullptr;
+
+	if (threadMix_) {
+		threadMix_->Stop();
+		threadMix_->Join();
+		threadMix_ = nullptr;
+	}
+	ptr_release(pMixerBuffer_);
+	mixer_ = nullptr;
+
+	cachePcm_ = nullptr;
+
 	for (auto itr = mapDivision_.begin(); itr != mapDivision_.end(); ++itr)
 		ptr_delete(itr->second);
 
@@ -87,6 +107,16 @@ bool DirectSoundManager::Initialize(HWND hWnd) {
 	threadManage_.reset(new SoundManageThread(this));
 	threadManage_->Start();
 
+	threadDecode_.reset(new SoundDecodeThread(this));
+	threadDecode_->Start();
+
+	//Sound effect mixer, played sounds fall back to their own buffers if this fails
+	_CreateMixerBuffer();
+	if (pMixerBuffer_) {
+		threadMix_.reset(new SoundMixThread(this));
+		threadMix_->Start();
+	}
+
 	Logger::WriteTop("DirectSound: Initialized.");
 
 	thisBase_ = this;
@@ -103,9 +133,113 @@ void DirectSoundManager::Clear() {
 		}
 
 		mapSoundSource_.clear();
+		setMixerRejected_.clear();
+		mixer_->StopAll();
+
+		cachePcm_->RemoveModified();
 	}
 	catch (...) {}
 }
+void DirectSoundManager::_CreateMixerBuffer() {
+	WAVEFORMATEX pcmwf;
+	ZeroMemory(&pcmwf, sizeof(WAVEFORMATEX));
+	pcmwf.wFormatTag = WAVE_FORMAT_PCM;
+	pcmwf.nChannels = 2;
+	pcmwf.nSamplesPerSec = mixer_->GetSampleRate();
+	pcmwf.nBlockAlign = 4;
+	pcmwf.nAvgBytesPerSec = pcmwf.nSamplesPerSec * pcmwf.nBlockAlign;
+	pcmwf.wBitsPerSample = 16;
+
+	DSBUFFERDESC desc;
+	ZeroMemory(&desc, sizeof(DSBUFFERDESC));
+	desc.dwSize = sizeof(DSBUFFERDESC);
+	desc.dwFlags = DSBCAPS_CTRLVOLUME | DSBCAPS_GETCURRENTPOSITION2
+		| DSBCAPS_LOCSOFTWARE | DSBCAPS_GLOBALFOCUS;
+	desc.dwBufferBytes = pcmwf.nAvgBytesPerSec * MIXER_BUFFER_MS / 1000U / pcmwf.nBlockAlign * pcmwf.nBlockAlign;
+	desc.lpwfxFormat = &pcmwf;
+
+	HRESULT hr = pDirectSound_->CreateSoundBuffer(&desc, (LPDIRECTSOUNDBUFFER*)&pMixerBuffer_, nullptr);
+	if (FAILED(hr)) {
+		Logger::WriteTop(StringUtility::Format(L"DirectSound: Mixer buffer creation failed, sound effects will use "
+			"individual buffers. [%s]", DXGetErrorString(hr)));
+		pMixerBuffer_ = nullptr;
+		return;
+	}
+
+	LPVOID pMem;
+	DWORD dwSize;
+	if (SUCCEEDED(pMixerBuffer_->Lock(0, 0, &pMem, &dwSize, nullptr, nullptr, DSBLOCK_ENTIREBUFFER))) {
+		memset(pMem, 0, dwSize);
+		pMixerBuffer_->Unlock(pMem, dwSize, nullptr, 0);
+	}
+	pMixerBuffer_->Play(0, 0, DSBPLAY_LOOPING);
+}
+shared_ptr<std::vector<byte>> DirectSoundManager::_CreateMixerPcm(SoundSourceData* source) {
+	if (source->audioSizeTotal_ == 0 || source->audioSizeTotal_ > MIXER_SOURCE_SIZE_MAX) return nullptr;
+
+	shared_ptr<SoundMixer::PcmData> res;
+	switch (source->format_) {
+	case SoundFileFormat::Wave:
+	{
+		SoundSourceDataWave* pSource = (SoundSourceDataWave*)source;
+		if (pSource->bufWaveData_.GetSize() > 0) {
+			res = SoundMixer::ConvertPcm(pSource->formatWave_, (byte*)pSource->bufWaveData_.GetPointer(),
+				pSource->bufWaveData_.GetSize(), mixer_->GetSampleRate());
+		}
+		break;
+	}
+	case SoundFileFormat::Ogg:
+	{
+		//Only sounds short enough to never be streamed, streams share the decoder with their player
+		if (source->audioSizeTotal_ > 2 * source->formatWave_.nAvgBytesPerSec) break;
+
+		SoundPcmCache::PcmData pcm;
+		if (((SoundSourceDataOgg*)source)->DecodeAll(pcm))
+			res = SoundMixer::ConvertPcm(source->formatWave_, pcm.data(), pcm.size(), mixer_->GetSampleRate());
+		break;
+	}
+	}
+	return res;
+}
+bool DirectSoundManager::PlaySoundEffect(const std::wstring& path, double rateVolume) {
+	if (pMixerBuffer_ == nullptr) return false;
+	{
+		Lock lock(lock_);
+		if (setMixerRejected_.find(path) != setMixerRejected_.end()) return false;
+	}
+
+	//Mixer PCM is cached under its own key, the source doesn't have to be reloaded once it's converted
+	std::wstring key = path + L"|mix";
+	shared_ptr<SoundMixer::PcmData> pcm = cachePcm_->Get(key);
+	if (pcm == nullptr) {
+		shared_ptr<SoundSourceData> source = GetSoundSource(path, true);
+		if (source == nullptr) return false;
+
+		auto timeStart = std::chrono::steady_clock::now();
+		pcm = _CreateMixerPcm(source.get());
+		if (pcm == nullptr) {
+			Lock lock(lock_);
+			setMixerRejected_.insert(path);
+			return false;
+		}
+
+		std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - timeStart;
+		cachePcm_->Add(key, path, pcm, time.count());
+	}
+
+	return mixer_->Play(std::hash<std::wstring>{}(path), pcm, rateVolume / 100.0);
+}
+void DirectSoundManager::StopSoundEffect(const std::wstring& path) {
+	mixer_->Stop(std::hash<std::wstring>{}(path));
+}
+void DirectSoundManager::SetSoundEffectPause(bool bPause) {
+	if (bPause) mixer_->PauseAll();
+	else mixer_->ResumeAll();
+}
+void DirectSoundManager::NotifyDecodeAhead() {
+	if (threadDecode_)
+		threadDecode_->Notify();
+}
 shared_ptr<SoundSourceData> DirectSoundManager::GetSoundSource(const std::wstring& path, bool bCreate) {
 	shared_ptr<SoundSourceData> res;
 	try {
@@ -410,6 +544,407 @@ void DirectSoundManager::SoundManageThread::_Fade() {
 	}
 }
 
+//DirectSoundManager::SoundDecodeThread
+DirectSoundManager::SoundDecodeThread::SoundDecodeThread(DirectSoundManager* manager) {
+	_SetOuter(manager);
+}
+void DirectSoundManager::SoundDecodeThread::_Run() {
+	DirectSoundManager* manager = _GetOuter();
+
+	std::vector<shared_ptr<SoundStreamingPlayerOgg>> listPlayer;
+	while (this->GetStatus() == RUN) {
+		{
+			Lock lock(manager->GetLock());
+			for (auto& iPlayer : manager->listManagedPlayer_) {
+				if (auto player = std::dynamic_pointer_cast<SoundStreamingPlayerOgg>(iPlayer)) {
+					if (player->bStreaming_ && player->IsPlaying())
+						listPlayer.push_back(player);
+				}
+			}
+		}
+
+		for (auto& player : listPlayer) {
+			if (this->GetStatus() != RUN) break;
+			player->_DecodeAhead();
+		}
+		listPlayer.clear();
+
+		//Woken up whenever a streaming thread consumes a chunk or a stream is seeked
+		signal_.Wait(50);
+	}
+}
+
+//DirectSoundManager::SoundMixThread
+DirectSoundManager::SoundMixThread::SoundMixThread(DirectSoundManager* manager) {
+	_SetOuter(manager);
+	posWrite_ = 0;
+	bWritten_ = false;
+	volume_ = DSBVOLUME_MAX + 1;
+}
+void DirectSoundManager::SoundMixThread::_Run() {
+	DirectSoundManager* manager = _GetOuter();
+	IDirectSoundBuffer8* buffer = manager->pMixerBuffer_;
+
+	while (this->GetStatus() == RUN) {
+		{
+			double rateDiv = 100.0;
+			if (SoundDivision* division = manager->GetSoundDivision(SoundDivision::DIVISION_SE))
+				rateDiv = division->GetVolumeRate();
+			LONG volume = SoundPlayer::_GetVolumeAsDirectSoundDecibel(rateDiv / 100.0);
+			if (volume != volume_) {
+				buffer->SetVolume(volume);
+				volume_ = volume;
+			}
+		}
+
+		_Fill();
+		::Sleep(5);
+	}
+}
+void DirectSoundManager::SoundMixThread::_Fill() {
+	DirectSoundManager* manager = _GetOuter();
+	IDirectSoundBuffer8* buffer = manager->pMixerBuffer_;
+
+	DSBCAPS caps;
+	caps.dwSize = sizeof(DSBCAPS);
+	if (FAILED(buffer->GetCaps(&caps))) return;
+	DWORD sizeBuffer = caps.dwBufferBytes;
+
+	DWORD posPlay = 0;
+	DWORD posSafe = 0;
+	if (FAILED(buffer->GetCurrentPosition(&posPlay, &posSafe))) return;
+
+	constexpr DWORD BLOCK_ALIGN = 4;
+	DWORD sizeLatency = Math::FloorBase<DWORD>(MIXER_SAMPLE_RATE * BLOCK_ALIGN * MIXER_LATENCY_MS / 1000U, BLOCK_ALIGN);
+
+	DWORD distWrite = (posWrite_ + sizeBuffer - posPlay) % sizeBuffer;
+	DWORD distSafe = (posSafe + sizeBuffer - posPlay) % sizeBuffer;
+	if (distWrite < distSafe || distWrite > sizeLatency * 2) {
+		//Fell behind the device (the process was stalled), restart right after the write cursor
+		if (bWritten_)
+			manager->mixer_->ReportUnderrun();
+		posWrite_ = Math::FloorBase<DWORD>(posSafe, BLOCK_ALIGN);
+		distWrite = (posWrite_ + sizeBuffer - posPlay) % sizeBuffer;
+	}
+	if (distWrite >= sizeLatency) return;
+
+	DWORD sizeFill = sizeLatency - distWrite;
+
+	LPVOID pMem1, pMem2;
+	DWORD dwSize1, dwSize2;
+	HRESULT hr = buffer->Lock(posWrite_, sizeFill, &pMem1, &dwSize1, &pMem2, &dwSize2, 0);
+	if (hr == DSERR_BUFFERLOST) {
+		buffer->Restore();
+		hr = buffer->Lock(posWrite_, sizeFill, &pMem1, &dwSize1, &pMem2, &dwSize2, 0);
+	}
+	if (FAILED(hr)) return;
+
+	manager->mixer_->Mix((int16_t*)pMem1, dwSize1 / BLOCK_ALIGN);
+	if (dwSize2 > 0)
+		manager->mixer_->Mix((int16_t*)pMem2, dwSize2 / BLOCK_ALIGN);
+
+	buffer->Unlock(pMem1, dwSize1, pMem2, dwSize2);
+	posWrite_ = (posWrite_ + dwSize1 + dwSize2) % sizeBuffer;
+	bWritten_ = true;
+}
+
+//*******************************************************************
+//SoundMixer
+//*******************************************************************
+SoundMixer::SoundMixer(DWORD sampleRate) {
+	sampleRate_ = sampleRate;
+	maxVoicePerSound_ = MAX_VOICE_PER_SOUND_DEFAULT;
+	serial_ = 0;
+}
+void SoundMixer::SetMaxVoicePerSound(size_t count) {
+	Lock lock(lock_);
+	maxVoicePerSound_ = std::max<size_t>(count, 1);
+}
+bool SoundMixer::Play(size_t key, shared_ptr<PcmData> pcm, float volume) {
+	if (pcm == nullptr || pcm->size() < sizeof(int16_t) * 2) return false;
+
+	Lock lock(lock_);
+	++stats_.countPlay;
+
+	Voice* pFree = nullptr;
+	Voice* pOldest = nullptr;
+	Voice* pOldestSame = nullptr;
+	size_t countSame = 0;
+	for (Voice& voice : voice_) {
+		if (!voice.bActive) {
+			if (pFree == nullptr) pFree = &voice;
+			continue;
+		}
+		if (voice.key == key) {
+			if (voice.bFresh) {
+				//Starting the same sound twice on the same sample would only make it louder
+				voice.volume = std::max(voice.volume, volume);
+				++stats_.countMerge;
+				return true;
+			}
+			++countSame;
+			if (pOldestSame == nullptr || voice.serial < pOldestSame->serial)
+				pOldestSame = &voice;
+		}
+		if (pOldest == nullptr || voice.serial < pOldest->serial)
+			pOldest = &voice;
+	}
+
+	//Restart the oldest instance of the sound when it's at its limit, otherwise the oldest voice when all are taken
+	Voice* pVoice = pFree;
+	if (countSame >= maxVoicePerSound_) pVoice = pOldestSame;
+	else if (pVoice == nullptr) pVoice = pOldest;
+
+	if (pVoice->bActive)
+		++stats_.countSteal;
+
+	pVoice->bActive = true;
+	pVoice->bFresh = true;
+	pVoice->bPaused = false;
+	pVoice->key = key;
+	pVoice->serial = serial_++;
+	pVoice->volume = volume;
+	pVoice->pos = 0;
+	pVoice->pcm = pcm;
+	return true;
+}
+void SoundMixer::Stop(size_t key) {
+	Lock lock(lock_);
+	for (Voice& voice : voice_) {
+		if (voice.bActive && voice.key == key) {
+			voice.bActive = false;
+			voice.pcm = nullptr;
+		}
+	}
+}
+void SoundMixer::StopAll() {
+	Lock lock(lock_);
+	for (Voice& voice : voice_) {
+		voice.bActive = false;
+		voice.pcm = nullptr;
+	}
+}
+void SoundMixer::PauseAll() {
+	Lock lock(lock_);
+	for (Voice& voice : voice_) {
+		if (voice.bActive)
+			voice.bPaused = true;
+	}
+}
+void SoundMixer::ResumeAll() {
+	Lock lock(lock_);
+	for (Voice& voice : voice_)
+		voice.bPaused = false;
+}
+void SoundMixer::Mix(int16_t* dst, size_t countFrame) {
+	size_t countSample = countFrame * 2;
+
+	Lock lock(lock_);
+
+	bufMix_.resize(countSample);
+	std::fill(bufMix_.begin(), bufMix_.end(), 0.0f);
+
+	for (Voice& voice : voice_) {
+		if (!voice.bActive || voice.bPaused) continue;
+
+		const int16_t* src = (const int16_t*)voice.pcm->data();
+		size_t sizeVoice = voice.pcm->size() / sizeof(int16_t);
+		size_t count = std::min(countSample, sizeVoice - voice.pos);
+
+		_MixVoice(bufMix_.data(), src + voice.pos, count, voice.volume);
+
+		voice.bFresh = false;
+		voice.pos += count;
+		if (voice.pos >= sizeVoice) {
+			voice.bActive = false;
+			voice.pcm = nullptr;
+		}
+	}
+
+	_Saturate(dst, bufMix_.data(), countSample);
+}
+void SoundMixer::_MixVoice(float* dst, const int16_t* src, size_t countSample, float volume) {
+	size_t i = 0;
+#ifdef __L_MATH_VECTORIZE
+	__m128 vVolume = _mm_set1_ps(volume);
+	for (; i + 8 <= countSample; i += 8) {
+		__m128i vSrc = _mm_loadu_si128((const __m128i*)(src + i));
+		//Sign-extend to int32 by unpacking into the upper halves
+		__m128i vLo = _mm_srai_epi32(_mm_unpacklo_epi16(vSrc, vSrc), 16);
+		__m128i vHi = _mm_srai_epi32(_mm_unpackhi_epi16(vSrc, vSrc), 16);
+
+		_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), 
+			_mm_mul_ps(_mm_cvtepi32_ps(vLo), vVolume)));
+		_mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_loadu_ps(dst + i + 4), 
+			_mm_mul_ps(_mm_cvtepi32_ps(vHi), vVolume)));
+	}
+#endif
+	for (; i < countSample; ++i)
+		dst[i] += src[i] * volume;
+}
+void SoundMixer::_Saturate(int16_t* dst, const float* src, size_t countSample) {
+	size_t i = 0;
+#ifdef __L_MATH_VECTORIZE
+	__m128 vMin = _mm_set1_ps(-32768.0f);
+	__m128 vMax = _mm_set1_ps(32767.0f);
+	for (; i + 8 <= countSample; i += 8) {
+		__m128 vLo = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), vMin), vMax);
+		__m128 vHi = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), vMin), vMax);
+		_mm_storeu_si128((__m128i*)(dst + i), 
+			_mm_packs_epi32(_mm_cvtps_epi32(vLo), _mm_cvtps_epi32(vHi)));
+	}
+#endif
+	//Round to nearest like _mm_cvtps_epi32, so both paths give the same samples
+	for (; i < countSample; ++i)
+		dst[i] = (int16_t)std::lrint(std::clamp(src[i], -32768.0f, 32767.0f));
+}
+void SoundMixer::ReportUnderrun() {
+	Lock lock(lock_);
+	++stats_.countUnderrun;
+}
+SoundMixer::Stats SoundMixer::GetStats() {
+	Lock lock(lock_);
+	Stats res = stats_;
+	res.countActive = 0;
+	for (Voice& voice : voice_) {
+		if (voice.bActive) ++res.countActive;
+	}
+	return res;
+}
+shared_ptr<SoundMixer::PcmData> SoundMixer::ConvertPcm(const WAVEFORMATEX& format, const byte* src, size_t size, DWORD sampleRate) {
+	if (format.wFormatTag != WAVE_FORMAT_PCM) return nullptr;
+	if (format.nChannels != 1 && format.nChannels != 2) return nullptr;
+	if (format.wBitsPerSample != 8 && format.wBitsPerSample != 16) return nullptr;
+	if (format.nSamplesPerSec == 0 || sampleRate == 0) return nullptr;
+
+	size_t bytePerSample = format.wBitsPerSample / 8U;
+	size_t blockAlign = bytePerSample * format.nChannels;
+	size_t countFrameIn = size / blockAlign;
+	if (countFrameIn == 0) return nullptr;
+
+	auto _Read = [&](size_t frame, size_t channel) -> float {
+		const byte* p = src + frame * blockAlign + (format.nChannels == 2 ? channel : 0) * bytePerSample;
+		if (bytePerSample == 1)
+			return ((int)*p - 128) * 256.0f;
+		return (float)*(const int16_t*)p;
+	};
+
+	size_t countFrameOut = std::max<size_t>((uint64_t)countFrameIn * sampleRate / format.nSamplesPerSec, 1);
+
+	shared_ptr<PcmData> res(new PcmData());
+	res->resize(countFrameOut * 2 * sizeof(int16_t));
+	int16_t* dst = (int16_t*)res->data();
+
+	//Linear resampling, only done once per sound
+	double step = format.nSamplesPerSec / (double)sampleRate;
+	for (size_t i = 0; i < countFrameOut; ++i) {
+		double pos = i * step;
+		size_t i0 = std::min((size_t)pos, countFrameIn - 1);
+		size_t i1 = std::min(i0 + 1, countFrameIn - 1);
+		float t = (float)(pos - i0);
+		for (size_t ch = 0; ch < 2; ++ch) {
+			float a = _Read(i0, ch);
+			float b = _Read(i1, ch);
+			dst[i * 2 + ch] = (int16_t)std::clamp(a + (b - a) * t, -32768.0f, 32767.0f);
+		}
+	}
+
+	return res;
+}
+
+//*******************************************************************
+//SoundPcmCache
+//*******************************************************************
+SoundPcmCache::SoundPcmCache(size_t sizeBudget) {
+	sizeBudget_ = sizeBudget;
+}
+void SoundPcmCache::_Evict() {
+	while (stats_.sizeResident > sizeBudget_ && listEntry_.size() > 0) {
+		Entry& entry = listEntry_.back();
+		stats_.sizeResident -= entry.data->size();
+		mapEntry_.erase(entry.path);
+		listEntry_.pop_back();
+	}
+	stats_.countEntry = listEntry_.size();
+}
+void SoundPcmCache::SetBudget(size_t size) {
+	Lock lock(lock_);
+	sizeBudget_ = size;
+	_Evict();
+}
+shared_ptr<SoundPcmCache::PcmData> SoundPcmCache::Get(const std::wstring& path) {
+	Lock lock(lock_);
+
+	auto itrFind = mapEntry_.find(path);
+	if (itrFind == mapEntry_.end()) {
+		++stats_.countMiss;
+		return nullptr;
+	}
+
+	++stats_.countHit;
+	listEntry_.splice(listEntry_.begin(), listEntry_, itrFind->second);
+	return itrFind->second->data;
+}
+void SoundPcmCache::Add(const std::wstring& path, const std::wstring& pathFile, shared_ptr<PcmData> data, double timeDecode) {
+	if (data == nullptr) return;
+
+	int64_t timeWrite = File::GetLastWriteTime(pathFile);
+
+	Lock lock(lock_);
+	stats_.timeDecode += timeDecode;
+
+	//Larger than the whole budget, would only flush everything else out
+	if (data->size() > sizeBudget_) return;
+
+	auto itrFind = mapEntry_.find(path);
+	if (itrFind != mapEntry_.end()) {
+		stats_.sizeResident -= itrFind->second->data->size();
+		listEntry_.erase(itrFind->second);
+		mapEntry_.erase(itrFind);
+	}
+
+	listEntry_.push_front(Entry{ path, pathFile, timeWrite, data });
+	mapEntry_[path] = listEntry_.begin();
+	stats_.sizeResident += data->size();
+
+	_Evict();
+}
+size_t SoundPcmCache::GetResidentSize(const std::wstring& path) {
+	Lock lock(lock_);
+	auto itrFind = mapEntry_.find(path);
+	return itrFind != mapEntry_.end() ? itrFind->second->data->size() : 0;
+}
+void SoundPcmCache::Clear() {
+	Lock lock(lock_);
+	listEntry_.clear();
+	mapEntry_.clear();
+	stats_.sizeResident = 0;
+	stats_.countEntry = 0;
+}
+void SoundPcmCache::RemoveModified() {
+	Lock lock(lock_);
+	for (auto itr = listEntry_.begin(); itr != listEntry_.end();) {
+		if (File::GetLastWriteTime(itr->pathFile) != itr->timeWrite) {
+			stats_.sizeResident -= itr->data->size();
+			mapEntry_.erase(itr->path);
+			itr = listEntry_.erase(itr);
+		}
+		else ++itr;
+	}
+	stats_.countEntry = listEntry_.size();
+}
+void SoundPcmCache::AddStreamDecode(double timeDecode, bool bAhead) {
+	Lock lock(lock_);
+	if (bAhead) ++stats_.countChunkAhead;
+	else ++stats_.countChunkSync;
+	stats_.timeDecodeStream += timeDecode;
+}
+SoundPcmCache::Stats SoundPcmCache::GetStats() {
+	Lock lock(lock_);
+	Stats res = stats_;
+	res.sizeBudget = sizeBudget_;
+	return res;
+}
 
 //*******************************************************************
 //SoundInfoPanel
@@ -432,6 +967,7 @@ bool SoundInfoPanel::_AddedLogger(HWND hTab) {
 	wndListView_.AddColumn(96, ROW_FILENAME, L"Name");
 	wndListView_.AddColumn(128, ROW_FULLPATH, L"Path");
 	wndListView_.AddColumn(48, ROW_COUNT_REFFRENCE, L"Uses");
+	wndListView_.AddColumn(64, ROW_SIZE_PCM, L"PCM");
 
 	SetWindowVisible(false);
 
@@ -458,6 +994,7 @@ void SoundInfoPanel::Update(DirectSoundManager* soundManager) {
 		uint32_t address;
 		std::wstring path;
 		int countRef;
+		size_t sizePcm;
 	};
 
 	std::vector<_Info> listInfo;
@@ -474,6 +1011,7 @@ void SoundInfoPanel::Update(DirectSoundManager* soundManager) {
 				info.address = (uint32_t)source.get();
 				info.path = path;
 				info.countRef = source.use_count();
+				info.sizePcm = soundManager->GetPcmCache()->GetResidentSize(path);
 				listInfo.push_back(info);
 			}
 		}
@@ -488,6 +1026,8 @@ void SoundInfoPanel::Update(DirectSoundManager* soundManager) {
 			wndListView_.SetText(i, ROW_FILENAME, PathProperty::GetFileName(pInfo->path));
 			wndListView_.SetText(i, ROW_FULLPATH, pInfo->path);
 			wndListView_.SetText(i, ROW_COUNT_REFFRENCE, StringUtility::Format(L"%d", pInfo->countRef));
+			wndListView_.SetText(i, ROW_SIZE_PCM, pInfo->sizePcm > 0 ?
+				StringUtility::Format(L"%u KB", (UINT)(pInfo->sizePcm / 1024U)) : L"-");
 		}
 		for (; i < wndListView_.GetRowCount(); ++i) {
 			wndListView_.DeleteRow(i);
@@ -501,10 +1041,22 @@ void SoundInfoPanel::Update(DirectSoundManager* soundManager) {
 		UINT sndMemRemain = _sndCaps.dwFreeHwMemBytes / (1024U * 1024U);
 		UINT sndMemTotal = _sndCaps.dwTotalHwMemBytes / (1024U * 1024U);
 
+		SoundPcmCache::Stats stats = soundManager->GetPcmCache()->GetStats();
+		SoundMixer::Stats statsMixer = soundManager->GetMixer()->GetStats();
+		uint64_t countLookup = stats.countHit + stats.countMiss;
+		uint64_t countChunk = stats.countChunkAhead + stats.countChunkSync;
+
 		if (WindowLogger* logger = WindowLogger::GetParent()) {
 			shared_ptr<WStatusBar> statusBar = logger->GetStatusBar();
 			statusBar->SetText(0, L"Sound Memory");
-			statusBar->SetText(1, StringUtility::Format(L"%u/%u MB", sndMemRemain, sndMemTotal));
+			statusBar->SetText(1, StringUtility::Format(
+				L"%u/%u MB | PCM: %.2f/%.2f MB (%u), hit %.1f%%, decode %.1f ms | Stream: ahead %.1f%%, decode %.1f ms"
+				" | Mixer: %u/%u voices, %llu merged, %llu cut, %llu underrun", 
+				sndMemRemain, sndMemTotal,
+				stats.sizeResident / (1024.0 * 1024.0), stats.sizeBudget / (1024.0 * 1024.0), (UINT)stats.countEntry,
+				countLookup > 0 ? stats.countHit * 100.0 / countLookup : 0.0, stats.timeDecode,
+				countChunk > 0 ? stats.countChunkAhead * 100.0 / countChunk : 0.0, stats.timeDecodeStream,
+				(UINT)statsMixer.countActive, (UINT)SoundMixer::MAX_VOICE, statsMixer.countMerge, statsMixer.countSteal, statsMixer.countUnderrun));
 		}
 	}
 }
@@ -684,6 +1236,24 @@ bool SoundSourceDataOgg::Load(shared_ptr<gstd::FileReader> reader) {
 
 	return true;
 }
+bool SoundSourceDataOgg::DecodeAll(SoundPcmCache::PcmData& dest) {
+	if (fileOgg_ == nullptr) return false;
+
+	dest.resize(audioSizeTotal_);
+	if (ov_pcm_seek(fileOgg_, 0) != 0) return false;
+
+	size_t written = 0;
+	while (written < dest.size()) {
+		long read = ov_read(fileOgg_, (char*)dest.data() + written, dest.size() - written, 0, 2, 1, nullptr);
+		if (read == OV_HOLE) continue;
+		if (read <= 0) break;
+		written += read;
+	}
+	if (written < dest.size())
+		memset(dest.data() + written, 0, dest.size() - written);
+
+	return true;
+}
 size_t SoundSourceDataOgg::_ReadOgg(void* ptr, size_t size, size_t nmemb, void* source) {
 	SoundSourceDataOgg* parent = (SoundSourceDataOgg*)source;
 
@@ -1127,7 +1697,8 @@ lab_unlock_buf:
 }
 bool SoundStreamingPlayer::Play() {
 	if (pDirectSoundBuffer_ == nullptr) return false;
-	if (IsPlaying()) return true;
+	//A playing buffer that isn't streamed is restarted, the same as SoundPlayerWave
+	if (bStreaming_ && IsPlaying()) return true;
 
 	{
 		Lock lock(lock_);
@@ -1141,7 +1712,8 @@ bool SoundStreamingPlayer::Play() {
 		bStreamOver_ = false;
 		if (!bPause_ || !playStyle_.bResume_ || playStyle_.sampleStart_ >= 0) {
 			this->Seek(playStyle_.sampleStart_ >= 0 ? playStyle_.sampleStart_ : 0UL);
-			pDirectSoundBuffer_->SetCurrentPosition(0);
+			if (bStreaming_)
+				pDirectSoundBuffer_->SetCurrentPosition(0);
 		}
 		playStyle_.sampleStart_ = -1;
 
@@ -1178,7 +1750,8 @@ bool SoundStreamingPlayer::Stop() {
 	return true;
 }
 void SoundStreamingPlayer::ResetStreamForSeek() {
-	if (pDirectSoundBuffer_) {
+	//Non-streamed buffers hold the entire audio, Seek already moved the play cursor
+	if (pDirectSoundBuffer_ && bStreaming_) {
 		_CopyStream(1);
 		_CopyStream(0);
 
@@ -1186,6 +1759,12 @@ void SoundStreamingPlayer::ResetStreamForSeek() {
 	}
 }
 bool SoundStreamingPlayer::IsPlaying() {
+	if (!bStreaming_) {
+		if (pDirectSoundBuffer_ == nullptr) return false;
+		DWORD status = 0;
+		pDirectSoundBuffer_->GetStatus(&status);
+		return (status & DSBSTATUS_PLAYING) > 0;
+	}
 	return thread_->GetStatus() == Thread::RUN;
 }
 DWORD SoundStreamingPlayer::GetCurrentPosition() {
@@ -1549,7 +2128,9 @@ bool SoundStreamingPlayerWave::Seek(DWORD sample) {
 //*******************************************************************
 //SoundStreamingPlayerOgg
 //*******************************************************************
-SoundStreamingPlayerOgg::SoundStreamingPlayerOgg() {}
+SoundStreamingPlayerOgg::SoundStreamingPlayerOgg() {
+	bDecodeOver_ = false;
+}
 SoundStreamingPlayerOgg::~SoundStreamingPlayerOgg() {
 	this->Stop();
 	thread_->Join();
@@ -1587,8 +2168,35 @@ bool SoundStreamingPlayerOgg::_CreateBuffer(shared_ptr<SoundSourceData> source)
 
 				bStreaming_ = sizeBuffer != pSource->audioSizeTotal_;
 				if (!bStreaming_) {
+					//Short enough to fit the buffer entirely, fill it once from the shared decoded PCM
 					sizeCopy_ = pSource->audioSizeTotal_;
-					_CopyStream(0);
+
+					SoundPcmCache* cache = soundManager->GetPcmCache();
+					shared_ptr<SoundPcmCache::PcmData> pcm = cache->Get(pSource->path_);
+					if (pcm == nullptr) {
+						auto timeStart = std::chrono::steady_clock::now();
+
+						pcm.reset(new SoundPcmCache::PcmData());
+						if (!pSource->DecodeAll(*pcm))
+							throw gstd::wexception("Ogg decode failure");
+
+						std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - timeStart;
+						cache->Add(pSource->path_, pSource->path_, pcm, time.count());
+					}
+
+					LPVOID pMem;
+					DWORD dwSize;
+					HRESULT hrLock = pDirectSoundBuffer_->Lock(0, sizeBuffer, &pMem, &dwSize, nullptr, nullptr, 0);
+					if (hrLock == DSERR_BUFFERLOST) {
+						hrLock = pDirectSoundBuffer_->Restore();
+						hrLock = pDirectSoundBuffer_->Lock(0, sizeBuffer, &pMem, &dwSize, nullptr, nullptr, 0);
+					}
+					if (FAILED(hrLock))
+						throw gstd::wexception("IDirectSoundBuffer8::Lock failure");
+
+					memcpy(pMem, pcm->data(), std::min<size_t>(dwSize, pcm->size()));
+
+					pDirectSoundBuffer_->Unlock(pMem, dwSize, nullptr, 0);
 				}
 				else {
 					_CreateSoundEvent(pSource->formatWave_);
@@ -1607,13 +2215,58 @@ bool SoundStreamingPlayerOgg::_CreateBuffer(shared_ptr<SoundSourceData> source)
 	return true;
 }
 DWORD SoundStreamingPlayerOgg::_CopyBuffer(LPVOID pMem, DWORD dwSize) {
+	DirectSoundManager* soundManager = DirectSoundManager::GetBase();
+	DWORD bytePerSample = soundSource_->formatWave_.nBlockAlign;
+
+	DWORD resStreamPos = 0;
+	if (_PopDecodedChunk(pMem, dwSize, &resStreamPos)) {
+		soundManager->NotifyDecodeAhead();
+		return resStreamPos;
+	}
+
+	Lock lock(lock_);
+
+	//The decode thread may have finished a chunk while we were waiting for the lock
+	if (_PopDecodedChunk(pMem, dwSize, &resStreamPos)) {
+		soundManager->NotifyDecodeAhead();
+		return resStreamPos;
+	}
+
+	{
+		//Nothing usable was decoded ahead, rewind to the first pending chunk and decode in place
+		Lock lockQueue(lockQueue_);
+		if (listChunk_.size() > 0) {
+			_SeekDecoder(listChunk_.front().sampleStart);
+			listChunk_.clear();
+		}
+	}
+
+	resStreamPos = lastReadPointer_ * bytePerSample;
+
+	auto timeStart = std::chrono::steady_clock::now();
+	bool bStreamOver = _Decode(pMem, dwSize);
+	std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - timeStart;
+	soundManager->GetPcmCache()->AddStreamDecode(time.count(), false);
+
+	{
+		Lock lockQueue(lockQueue_);
+		bDecodeOver_ = bStreamOver;
+	}
+	if (bStreamOver)
+		_SetStreamOver();
+	else
+		soundManager->NotifyDecodeAhead();
+
+	return resStreamPos;
+}
+bool SoundStreamingPlayerOgg::_Decode(LPVOID pMem, DWORD dwSize) {
 	SoundSourceDataOgg* source = (SoundSourceDataOgg*)soundSource_.get();
 	
 	DWORD samplePerSec = source->formatWave_.nSamplesPerSec;
 	DWORD bytePerSample = source->formatWave_.nBlockAlign;
 	DWORD bytePerSec = source->formatWave_.nAvgBytesPerSec;
 
-	DWORD resStreamPos = lastReadPointer_ * bytePerSample;
+	bool bStreamOver = false;
 
 	memset((char*)pMem, 0, dwSize);
 	if (OggVorbis_File* pFileOgg = source->fileOgg_) {
@@ -1666,10 +2319,10 @@ DWORD SoundStreamingPlayerOgg::_CopyBuffer(LPVOID pMem, DWORD dwSize) {
 			//Reset to loop start
 			{
 				if (playStyle_.bLoop_) {
-					Seek(jumpDestSample);
+					_SeekDecoder(jumpDestSample);
 				}
 				else {
-					_SetStreamOver();
+					bStreamOver = true;
 					break;
 				}
 			}
@@ -1678,7 +2331,61 @@ DWORD SoundStreamingPlayerOgg::_CopyBuffer(LPVOID pMem, DWORD dwSize) {
 		lastReadPointer_ = ov_pcm_tell(pFileOgg);
 	}
 	
-	return resStreamPos;
+	return bStreamOver;
+}
+void SoundStreamingPlayerOgg::_SeekDecoder(DWORD sample) {
+	SoundSourceDataOgg* source = (SoundSourceDataOgg*)soundSource_.get();
+	ov_pcm_seek(source->fileOgg_, sample);
+	lastReadPointer_ = sample;
+}
+void SoundStreamingPlayerOgg::_ClearDecodeAhead() {
+	Lock lockQueue(lockQueue_);
+	listChunk_.clear();
+	bDecodeOver_ = false;
+}
+bool SoundStreamingPlayerOgg::_PopDecodedChunk(LPVOID pMem, DWORD dwSize, DWORD* pStreamPos) {
+	Lock lockQueue(lockQueue_);
+	if (listChunk_.size() == 0) return false;
+
+	DecodedChunk& chunk = listChunk_.front();
+	if (chunk.data.size() != dwSize) return false;
+
+	memcpy(pMem, chunk.data.data(), dwSize);
+	*pStreamPos = chunk.sampleStart * soundSource_->formatWave_.nBlockAlign;
+	if (chunk.bStreamOver)
+		_SetStreamOver();
+
+	listChunk_.pop_front();
+	return true;
+}
+void SoundStreamingPlayerOgg::_DecodeAhead() {
+	DirectSoundManager* soundManager = DirectSoundManager::GetBase();
+
+	//Holding lock_ keeps Seek from moving the decoder in the middle of a chunk
+	Lock lock(lock_);
+	if (!bStreaming_ || soundSource_ == nullptr) return;
+
+	while (true) {
+		{
+			Lock lockQueue(lockQueue_);
+			if (bDecodeOver_ || listChunk_.size() >= DECODE_AHEAD_COUNT) break;
+		}
+
+		DecodedChunk chunk;
+		chunk.sampleStart = lastReadPointer_;
+		chunk.data.resize(sizeCopy_);
+
+		auto timeStart = std::chrono::steady_clock::now();
+		chunk.bStreamOver = _Decode(chunk.data.data(), sizeCopy_);
+		std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - timeStart;
+		soundManager->GetPcmCache()->AddStreamDecode(time.count(), true);
+
+		{
+			Lock lockQueue(lockQueue_);
+			bDecodeOver_ = chunk.bStreamOver;
+			listChunk_.push_back(std::move(chunk));
+		}
+	}
 }
 bool SoundStreamingPlayerOgg::Seek(double time) {
 	if (soundSource_ == nullptr) return false;
@@ -1686,11 +2393,17 @@ bool SoundStreamingPlayerOgg::Seek(double time) {
 }
 bool SoundStreamingPlayerOgg::Seek(DWORD sample) {
 	if (soundSource_ == nullptr) return false;
-	SoundSourceDataOgg* source = (SoundSourceDataOgg*)soundSource_.get();
 	{
 		Lock lock(lock_);
-		ov_pcm_seek(source->fileOgg_, sample);
-		lastReadPointer_ = sample;
+
+		_ClearDecodeAhead();
+		_SeekDecoder(sample);
+
+		//Non-streamed buffers hold the entire audio, only the play cursor has to move
+		if (!bStreaming_ && pDirectSoundBuffer_)
+			pDirectSoundBuffer_->SetCurrentPosition(sample * soundSource_->formatWave_.nBlockAlign);
 	}
+	if (manager_)
+		manager_->NotifyDecodeAhead();
 	return true;
 }
@@ -9,6 +9,8 @@ namespace directx {
 
 	class SoundInfoPanel;
 
+	class SoundPcmCache;
+	class SoundMixer;
 	class SoundSourceData;
 
 	class SoundPlayer;
@@ -29,13 +31,25 @@ namespace directx {
 	class DirectSoundManager {
 	public:
 		class SoundManageThread;
+		class SoundDecodeThread;
+		class SoundMixThread;
 		friend SoundManageThread;
+		friend SoundDecodeThread;
+		friend SoundMixThread;
 		friend SoundInfoPanel;
 	public:
 		enum {
 			SD_VOLUME_MIN = DSBVOLUME_MIN,
 			SD_VOLUME_MAX = DSBVOLUME_MAX,
 		};
+		enum : size_t {
+			PCM_CACHE_BUDGET_DEFAULT = 32U * 1024U * 1024U,
+
+			MIXER_SAMPLE_RATE = 44100U,
+			MIXER_BUFFER_MS = 200U,		//Length of the mixer's looping output buffer
+			MIXER_LATENCY_MS = 40U,		//How far ahead of the play cursor the mixer writes
+			MIXER_SOURCE_SIZE_MAX = 1024U * 1024U,	//Larger sounds get their own buffer
+		};
 	private:
 		static DirectSoundManager* thisBase_;
 	protected:
@@ -46,6 +60,14 @@ namespace directx {
 
 		gstd::CriticalSection lock_;
 		std::unique_ptr<SoundManageThread> threadManage_;
+		std::unique_ptr<SoundDecodeThread> threadDecode_;
+
+		unique_ptr<SoundPcmCache> cachePcm_;
+
+		unique_ptr<SoundMixer> mixer_;
+		IDirectSoundBuffer8* pMixerBuffer_;
+		std::unique_ptr<SoundMixThread> threadMix_;
+		std::set<std::wstring> setMixerRejected_;	//Sounds that need their own buffer
 
 		std::list<shared_ptr<SoundPlayer>> listManagedPlayer_;
 		std::map<std::wstring, shared_ptr<SoundSourceData>> mapSoundSource_;
@@ -55,6 +77,9 @@ namespace directx {
 
 		shared_ptr<SoundSourceData> _GetSoundSource(const std::wstring& path);
 		shared_ptr<SoundSourceData> _CreateSoundSource(std::wstring path);
+
+		void _CreateMixerBuffer();
+		shared_ptr<std::vector<byte>> _CreateMixerPcm(SoundSourceData* source);
 	public:
 		DirectSoundManager();
 		virtual ~DirectSoundManager();
@@ -69,6 +94,16 @@ namespace directx {
 		IDirectSound8* GetDirectSound() { return pDirectSound_; }
 		gstd::CriticalSection& GetLock() { return lock_; }
 
+		SoundPcmCache* GetPcmCache() { return cachePcm_.get(); }
+		void NotifyDecodeAhead();
+
+		SoundMixer* GetMixer() { return mixer_.get(); }
+		//Plays a short sound through the shared SE mixer, returns false if it has to be played with its own buffer
+		bool PlaySoundEffect(const std::wstring& path, double rateVolume = 100);
+		void StopSoundEffect(const std::wstring& path);
+		//Holds the mixer voices that are playing, sounds played while paused are not held
+		void SetSoundEffectPause(bool bPause);
+
 		shared_ptr<SoundSourceData> GetSoundSource(const std::wstring& path, bool bCreate = false);
 		shared_ptr<SoundPlayer> CreatePlayer(shared_ptr<SoundSourceData> source);
 		shared_ptr<SoundPlayer> GetPlayer(const std::wstring& path);
@@ -96,6 +131,31 @@ namespace directx {
 		void _Arrange();
 		void _Fade();
 	};
+	//Keeps the decode-ahead queues of playing streams filled, so that the streaming threads only copy
+	class DirectSoundManager::SoundDecodeThread : public gstd::Thread, public gstd::InnerClass<DirectSoundManager> {
+		friend DirectSoundManager;
+	protected:
+		gstd::ThreadSignal signal_;
+	protected:
+		SoundDecodeThread(DirectSoundManager* manager);
+
+		void _Run();
+	public:
+		void Notify() { signal_.SetSignal(true); }
+	};
+	//Keeps the mixer's output buffer filled MIXER_LATENCY_MS ahead of the play cursor
+	class DirectSoundManager::SoundMixThread : public gstd::Thread, public gstd::InnerClass<DirectSoundManager> {
+		friend DirectSoundManager;
+	protected:
+		DWORD posWrite_;
+		bool bWritten_;		//posWrite_ is meaningful, the first fill isn't an underrun
+		LONG volume_;
+	protected:
+		SoundMixThread(DirectSoundManager* manager);
+
+		void _Run();
+		void _Fill();
+	};
 
 	//*******************************************************************
 	//SoundInfoPanel
@@ -107,6 +167,7 @@ namespace directx {
 			ROW_FILENAME,
 			ROW_FULLPATH,
 			ROW_COUNT_REFFRENCE,
+			ROW_SIZE_PCM,
 		};
 	protected:
 		gstd::WListView wndListView_;
@@ -143,6 +204,128 @@ namespace directx {
 		double GetVolumeRate() { return rateVolume_; }
 	};
 
+	//*******************************************************************
+	//SoundPcmCache
+	//*******************************************************************
+	//Decoded PCM of short sounds, shared by every player created from the same file and kept across
+	//	DirectSoundManager::Clear, which drops the entries whose file was modified since it was decoded.
+	//Least recently used entries are evicted once the budget is exceeded.
+	class SoundPcmCache {
+	public:
+		using PcmData = std::vector<byte>;
+
+		struct Stats {
+			size_t countEntry = 0;
+			size_t sizeResident = 0;	//In bytes
+			size_t sizeBudget = 0;		//In bytes
+			uint64_t countHit = 0;
+			uint64_t countMiss = 0;
+			double timeDecode = 0;		//Total time spent decoding cache misses, in ms
+
+			uint64_t countChunkAhead = 0;	//Stream chunks served from the decode-ahead queue
+			uint64_t countChunkSync = 0;	//Stream chunks that had to be decoded by the streaming thread
+			double timeDecodeStream = 0;	//In ms
+		};
+	protected:
+		struct Entry {
+			std::wstring path;
+			std::wstring pathFile;
+			int64_t timeWrite;
+			shared_ptr<PcmData> data;
+		};
+	protected:
+		gstd::CriticalSection lock_;
+
+		std::list<Entry> listEntry_;		//Most recently used first
+		std::unordered_map<std::wstring, std::list<Entry>::iterator> mapEntry_;
+
+		size_t sizeBudget_;
+		Stats stats_;
+
+		void _Evict();
+	public:
+		SoundPcmCache(size_t sizeBudget);
+
+		void SetBudget(size_t size);
+
+		shared_ptr<PcmData> Get(const std::wstring& path);
+		void Add(const std::wstring& path, const std::wstring& pathFile, shared_ptr<PcmData> data, double timeDecode);
+		size_t GetResidentSize(const std::wstring& path);
+		void Clear();
+		void RemoveModified();
+
+		void AddStreamDecode(double timeDecode, bool bAhead);
+		Stats GetStats();
+	};
+
+	//*******************************************************************
+	//SoundMixer
+	//*******************************************************************
+	//Mixes fire-and-forget sound effects from a fixed pool of voices into one 16-bit stereo stream.
+	//Doesn't touch DirectSound, the output is pulled through Mix by whoever owns the device buffer.
+	class SoundMixer {
+	public:
+		using PcmData = std::vector<byte>;	//16-bit stereo at the mixer's sample rate
+
+		enum : size_t {
+			MAX_VOICE = 32,
+			MAX_VOICE_PER_SOUND_DEFAULT = 4,
+		};
+
+		struct Stats {
+			size_t countActive = 0;
+			uint64_t countPlay = 0;
+			uint64_t countMerge = 0;	//Requests merged into a voice started in the same mix period
+			uint64_t countSteal = 0;	//Requests that cut off a playing voice
+			uint64_t countUnderrun = 0;	//Times the output fell behind the device and skipped ahead
+		};
+	protected:
+		struct Voice {
+			bool bActive = false;
+			bool bFresh = false;		//Started after the last Mix
+			bool bPaused = false;
+			size_t key = 0;
+			uint64_t serial = 0;
+			float volume = 0;
+			size_t pos = 0;				//In int16 samples
+			shared_ptr<PcmData> pcm;
+		};
+	protected:
+		gstd::CriticalSection lock_;
+
+		DWORD sampleRate_;
+		size_t maxVoicePerSound_;
+
+		std::array<Voice, MAX_VOICE> voice_;
+		uint64_t serial_;
+
+		std::vector<float> bufMix_;
+		Stats stats_;
+
+		static void _MixVoice(float* dst, const int16_t* src, size_t countSample, float volume);
+		static void _Saturate(int16_t* dst, const float* src, size_t countSample);
+	public:
+		SoundMixer(DWORD sampleRate);
+
+		DWORD GetSampleRate() { return sampleRate_; }
+		void SetMaxVoicePerSound(size_t count);
+
+		bool Play(size_t key, shared_ptr<PcmData> pcm, float volume);
+		void Stop(size_t key);
+		void StopAll();
+		void PauseAll();
+		void ResumeAll();
+
+		//dst receives countFrame interleaved stereo frames
+		void Mix(int16_t* dst, size_t countFrame);
+		void ReportUnderrun();
+
+		Stats GetStats();
+
+		//Converts 8/16-bit mono/stereo PCM to the mixer's format, returns nullptr for anything else
+		static shared_ptr<PcmData> ConvertPcm(const WAVEFORMATEX& format, const byte* src, size_t size, DWORD sampleRate);
+	};
+
 	//*******************************************************************
 	//SoundSourceData
 	//*******************************************************************
@@ -190,6 +373,8 @@ namespace directx {
 
 		virtual void Release();
 		virtual bool Load(shared_ptr<gstd::FileReader> reader);
+
+		bool DecodeAll(SoundPcmCache::PcmData& dest);
 	};
 
 	//*******************************************************************
@@ -198,6 +383,7 @@ namespace directx {
 	class SoundPlayer {
 		friend DirectSoundManager;
 		friend DirectSoundManager::SoundManageThread;
+		friend DirectSoundManager::SoundMixThread;
 	public:
 		struct PlayStyle {
 			bool bLoop_;				//Loop enable
@@ -382,9 +568,31 @@ namespace directx {
 	//SoundStreamingPlayerOgg
 	//*******************************************************************
 	class SoundStreamingPlayerOgg : public SoundStreamingPlayer {
+		friend DirectSoundManager;
+		friend DirectSoundManager::SoundDecodeThread;
+	public:
+		enum : size_t {
+			DECODE_AHEAD_COUNT = 2,		//In chunks of sizeCopy_ bytes
+		};
 	protected:
+		struct DecodedChunk {
+			DWORD sampleStart;
+			bool bStreamOver;
+			std::vector<byte> data;
+		};
+
+		gstd::CriticalSection lockQueue_;
+		std::list<DecodedChunk> listChunk_;
+		bool bDecodeOver_;
+
 		virtual bool _CreateBuffer(shared_ptr<SoundSourceData> source);
 		virtual DWORD _CopyBuffer(LPVOID pMem, DWORD dwSize);
+
+		bool _Decode(LPVOID pMem, DWORD dwSize);
+		void _SeekDecoder(DWORD sample);
+		void _ClearDecodeAhead();
+		bool _PopDecodedChunk(LPVOID pMem, DWORD dwSize, DWORD* pStreamPos);
+		void _DecodeAhead();
 	public:
 		SoundStreamingPlayerOgg();
 		~SoundStreamingPlayerOgg();
@@ -10,6 +10,63 @@
 using namespace gstd;
 using namespace directx;
 
+//****************************************************************************
+//DxScriptObjectNamedValueTable
+//****************************************************************************
+gstd::value* DxScriptObjectNamedValueTable::Find(uint32_t atom) {
+	gstd::value* res = mapAtom_.Find(atom);
+	//The literal may have been interned after the value was set with a runtime string
+	if (res == nullptr && mapString_.GetSize() > 0)
+		res = mapString_.Find(script_atom_table::get_string(atom));
+	return res;
+}
+gstd::value* DxScriptObjectNamedValueTable::Find(const std::wstring& key) {
+	uint32_t atom = script_atom_table::find(key);
+	if (atom != script_atom_table::INVALID_ATOM) {
+		if (gstd::value* res = mapAtom_.Find(atom))
+			return res;
+	}
+	return mapString_.Find(key);
+}
+gstd::value* DxScriptObjectNamedValueTable::Find(const gstd::value& key) {
+	if (script_atom_table::is_atom(key))
+		return Find((uint32_t)key.as_int());
+	return Find(key.as_string());
+}
+void DxScriptObjectNamedValueTable::Set(uint32_t atom, const gstd::value& val) {
+	if (mapString_.GetSize() > 0)
+		mapString_.Erase(script_atom_table::get_string(atom));
+	mapAtom_.Set(atom, val);
+}
+void DxScriptObjectNamedValueTable::Set(const std::wstring& key, const gstd::value& val) {
+	uint32_t atom = script_atom_table::find(key);
+	if (atom != script_atom_table::INVALID_ATOM) {
+		mapString_.Erase(key);
+		mapAtom_.Set(atom, val);
+	}
+	else mapString_.Set(key, val);
+}
+void DxScriptObjectNamedValueTable::Set(const gstd::value& key, const gstd::value& val) {
+	if (script_atom_table::is_atom(key))
+		Set((uint32_t)key.as_int(), val);
+	else Set(key.as_string(), val);
+}
+void DxScriptObjectNamedValueTable::Erase(const gstd::value& key) {
+	if (script_atom_table::is_atom(key)) {
+		uint32_t atom = (uint32_t)key.as_int();
+		mapAtom_.Erase(atom);
+		if (mapString_.GetSize() > 0)
+			mapString_.Erase(script_atom_table::get_string(atom));
+	}
+	else {
+		std::wstring str = key.as_string();
+		uint32_t atom = script_atom_table::find(str);
+		if (atom != script_atom_table::INVALID_ATOM)
+			mapAtom_.Erase(atom);
+		mapString_.Erase(str);
+	}
+}
+
 //****************************************************************************
 //DxScriptObjectBase
 //****************************************************************************
@@ -175,7 +232,7 @@ void DxScriptPrimitiveObject2D::Render() {
 	if (RenderObjectTLX* obj = GetRenderObject()) {
 		DirectGraphics* graphics = DirectGraphics::GetBase();
 		DWORD bEnableFog = FALSE;
-		graphics->GetDevice()->GetRenderState(D3DRS_FOGENABLE, &bEnableFog);
+		bEnableFog = graphics->IsFogEnable();
 		if (bEnableFog)
 			graphics->SetFogEnable(false);
 
@@ -186,6 +243,21 @@ void DxScriptPrimitiveObject2D::Render() {
 			graphics->SetFogEnable(true);
 	}
 }
+bool DxScriptPrimitiveObject2D::SubmitBatch(RenderQueue2D* queue) {
+	//Derived objects (player, spells, etc.) keep their own rendering
+	if (typeObject_ != TypeObject::Primitive2D && typeObject_ != TypeObject::Sprite2D) return false;
+	if (bVertexShaderMode_) return false;
+
+	RenderObjectTLX* obj = GetRenderObject();
+	if (obj == nullptr) return false;
+	obj->SetPosition(position_);
+	obj->SetAngle(angle_);
+	obj->SetScale(scale_);
+	obj->SetDisableMatrixTransformation(!bEnableMatrix_);
+
+	return obj->SubmitBatch(queue, typeBlend_, modeCulling_,
+		filterMin_, filterMag_, filterMip_, angX_, angY_, angZ_);
+}
 void DxScriptPrimitiveObject2D::SetRenderState() {
 	DirectGraphics* graphics = DirectGraphics::GetBase();
 	RenderObjectTLX* obj = GetRenderObject();
@@ -498,13 +570,16 @@ DxScriptParticleListObject2D::DxScriptParticleListObject2D() {
 	objRender_->SetDxObjectReference(this);
 }
 
+void DxScriptParticleListObject2D::Work() {
+	GetParticlePointer()->UpdateEmitter();
+}
 void DxScriptParticleListObject2D::Render() {
 	ParticleRenderer2D* obj = GetParticlePointer();
 
 	//Save fog state
 	DirectGraphics* graphics = DirectGraphics::GetBase();
 	DWORD bEnableFog = FALSE;
-	graphics->GetDevice()->GetRenderState(D3DRS_FOGENABLE, &bEnableFog);
+	bEnableFog = graphics->IsFogEnable();
 	if (bEnableFog)
 		graphics->SetFogEnable(false);
 
@@ -540,6 +615,9 @@ DxScriptParticleListObject3D::DxScriptParticleListObject3D() {
 	objRender_->SetDxObjectReference(this);
 }
 
+void DxScriptParticleListObject3D::Work() {
+	GetParticlePointer()->UpdateEmitter();
+}
 void DxScriptParticleListObject3D::Render() {
 	ParticleRenderer3D* obj = GetParticlePointer();
 	DirectGraphics* graphics = DirectGraphics::GetBase();
@@ -720,7 +798,7 @@ void DxScriptTextObject::Render() {
 	//Save fog state, text objects don't fucking get fogged
 	DirectGraphics* graphics = DirectGraphics::GetBase();
 	DWORD bEnableFog = FALSE;
-	graphics->GetDevice()->GetRenderState(D3DRS_FOGENABLE, &bEnableFog);
+	bEnableFog = graphics->IsFogEnable();
 	if (bEnableFog)
 		graphics->SetFogEnable(false);
 
@@ -1425,6 +1503,7 @@ DWORD DxBinaryFileObject::Write(LPVOID data, size_t size) {
 //DxScriptObjectManager
 //****************************************************************************
 DxScriptObjectManager::FogData DxScriptObjectManager::fogData_ = { false, 0xffffffff, 0, 0 };
+RenderQueue2D DxScriptObjectManager::renderQueue_;
 DxScriptObjectManager::DxScriptObjectManager() {
 	SetMaxObject(DEFAULT_CONTAINER_CAPACITY);
 	SetRenderBucketCapacity(101);
@@ -1457,6 +1536,22 @@ void DxScriptObjectManager::SetRenderBucketCapacity(size_t capacity) {
 	listShader_.resize(capacity);
 }
 
+//Makes sure the next [count] AddObject calls don't need to expand the pool, growing it at most once
+bool DxScriptObjectManager::ReserveObject(size_t count) {
+	if (listUnusedIndex_.size() >= count) return true;
+
+	size_t oldSize = obj_.size();
+	size_t newSize = std::max<size_t>(oldSize, 1U);
+	while (newSize - oldSize + listUnusedIndex_.size() < count)
+		newSize *= 2U;
+
+	if (SetMaxObject(newSize)) {
+		Logger::WriteTop(StringUtility::Format("DxScriptObjectManager: Object pool expansion. [%d->%d]",
+			oldSize, obj_.size()));
+	}
+	return listUnusedIndex_.size() >= count;
+}
+
 int DxScriptObjectManager::AddObject(ref_unsync_ptr<DxScriptObjectBase> obj, bool bActivate) {
 	int res = DxScript::ID_INVALID;
 
@@ -1641,15 +1736,25 @@ void DxScriptObjectManager::RenderObject() {
 		RenderList& renderList = listObjRender_[iPri];
 
 		for (UINT iPass = 0; iPass < cPass; ++iPass) {
-			if (effect) effect->BeginPass(iPass);
+			if (effect) {
+				effect->BeginPass(iPass);
+				//The objects drawn in this pass go through the state cache
+				graphics->NotifyEffectStateChange();
+			}
 			for (auto itr = renderList.begin(); itr != renderList.end(); ++itr) {
+				if ((*itr)->SubmitBatch(&renderQueue_)) continue;
+				renderQueue_.Flush();
 				(*itr)->Render();
 			}
+			renderQueue_.Flush();
 			if (effect) effect->EndPass();
 		}
 		renderList.Clear();
 
-		if (effect) effect->End();
+		if (effect) {
+			effect->End();
+			graphics->NotifyEffectStateChange();
+		}
 	}
 }
 void DxScriptObjectManager::CleanupObject() {
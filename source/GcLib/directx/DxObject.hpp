@@ -15,6 +15,145 @@ namespace directx {
 	class DxScriptObjectManager;
 	class DxScriptObjectBase;
 
+	//****************************************************************************
+	//DxScriptObjectValueTable
+	//****************************************************************************
+	//Storage behind Obj_SetValue and friends.
+	//Nothing is allocated until the first value is set, small tables are a flat vector and only larger ones are hashed.
+	template<typename K>
+	class DxScriptObjectValueTable {
+	public:
+		enum : size_t {
+			HASH_THRESHOLD = 16,
+		};
+	private:
+		struct Storage {
+			std::vector<std::pair<K, gstd::value>> listValue;
+			std::unordered_map<K, gstd::value> mapValue;
+			bool bHashed = false;
+		};
+		std::unique_ptr<Storage> data_;
+
+		Storage* _GetStorage() {
+			if (data_ == nullptr)
+				data_.reset(new Storage());
+			return data_.get();
+		}
+	public:
+		DxScriptObjectValueTable() = default;
+		DxScriptObjectValueTable(const DxScriptObjectValueTable& other) { *this = other; }
+
+		DxScriptObjectValueTable& operator=(const DxScriptObjectValueTable& other) {
+			if (this != &other) {
+				if (other.data_ && other.GetSize() > 0)
+					data_.reset(new Storage(*other.data_));
+				else data_ = nullptr;
+			}
+			return *this;
+		}
+
+		size_t GetSize() const {
+			if (data_ == nullptr) return 0;
+			return data_->bHashed ? data_->mapValue.size() : data_->listValue.size();
+		}
+
+		gstd::value* Find(const K& key) {
+			if (data_ == nullptr) return nullptr;
+			if (data_->bHashed) {
+				auto itr = data_->mapValue.find(key);
+				return itr != data_->mapValue.end() ? &itr->second : nullptr;
+			}
+			for (auto& iPair : data_->listValue) {
+				if (iPair.first == key) return &iPair.second;
+			}
+			return nullptr;
+		}
+		void Set(const K& key, const gstd::value& val) {
+			if (gstd::value* pValue = Find(key)) {
+				*pValue = val;
+				return;
+			}
+
+			Storage* data = _GetStorage();
+			if (data->bHashed) {
+				data->mapValue.insert(std::make_pair(key, val));
+			}
+			else if (data->listValue.size() < HASH_THRESHOLD) {
+				data->listValue.push_back(std::make_pair(key, val));
+			}
+			else {
+				data->mapValue.reserve(HASH_THRESHOLD * 2);
+				for (auto& iPair : data->listValue)
+					data->mapValue.insert(std::move(iPair));
+				data->mapValue.insert(std::make_pair(key, val));
+				data->listValue = std::vector<std::pair<K, gstd::value>>();
+				data->bHashed = true;
+			}
+		}
+		void Erase(const K& key) {
+			if (data_ == nullptr) return;
+			if (data_->bHashed) {
+				data_->mapValue.erase(key);
+				return;
+			}
+			auto& list = data_->listValue;
+			for (auto itr = list.begin(); itr != list.end(); ++itr) {
+				if (itr->first == key) {
+					//Order doesn't matter, swap with the last element
+					if (itr != list.end() - 1)
+						*itr = std::move(list.back());
+					list.pop_back();
+					break;
+				}
+			}
+		}
+		void Clear() { data_ = nullptr; }
+
+		template<class F>
+		void ForEach(F&& func) const {
+			if (data_ == nullptr) return;
+			if (data_->bHashed) {
+				for (auto& iPair : data_->mapValue)
+					func(iPair.first, iPair.second);
+			}
+			else {
+				for (auto& iPair : data_->listValue)
+					func(iPair.first, iPair.second);
+			}
+		}
+	};
+
+	//****************************************************************************
+	//DxScriptObjectNamedValueTable
+	//****************************************************************************
+	//String keyed values. String literal keys arrive as atoms interned by the parser,
+	//	keys built at runtime are looked up in gstd::script_atom_table and stored by string if no literal uses them.
+	class DxScriptObjectNamedValueTable {
+		DxScriptObjectValueTable<uint32_t> mapAtom_;
+		DxScriptObjectValueTable<std::wstring> mapString_;
+	public:
+		size_t GetSize() const { return mapAtom_.GetSize() + mapString_.GetSize(); }
+
+		gstd::value* Find(uint32_t atom);
+		gstd::value* Find(const std::wstring& key);
+		gstd::value* Find(const gstd::value& key);
+		void Set(uint32_t atom, const gstd::value& val);
+		void Set(const std::wstring& key, const gstd::value& val);
+		void Set(const gstd::value& key, const gstd::value& val);
+		void Erase(const gstd::value& key);
+		void Clear() {
+			mapAtom_.Clear();
+			mapString_.Clear();
+		}
+
+		//func is called with either a uint32_t atom or a std::wstring key
+		template<class F>
+		void ForEach(F&& func) const {
+			mapAtom_.ForEach(func);
+			mapString_.ForEach(func);
+		}
+	};
+
 	//****************************************************************************
 	//DxScriptObjectBase
 	//****************************************************************************
@@ -35,8 +174,8 @@ namespace directx {
 
 		uint32_t frameExist_;
 
-		std::unordered_map<std::wstring, gstd::value> mapObjectValue_;
-		std::unordered_map<int64_t, gstd::value> mapObjectValueI_;
+		DxScriptObjectNamedValueTable mapObjectValue_;
+		DxScriptObjectValueTable<int64_t> mapObjectValueI_;
 	public:
 		DxScriptObjectBase();
 		virtual ~DxScriptObjectBase();
@@ -51,6 +190,9 @@ namespace directx {
 		virtual void SetRenderState() {}
 		virtual void CleanUp() {}
 
+		//Queues the object into a merged draw call instead of rendering it, returns false if Render must be called
+		virtual bool SubmitBatch(RenderQueue2D* queue) { return false; }
+
 		virtual bool HasNormalRendering() { return false; }
 
 		int GetObjectID() { return idObject_; }
@@ -69,8 +211,8 @@ namespace directx {
 
 		uint32_t GetExistFrame() { return frameExist_; }
 
-		std::unordered_map<std::wstring, gstd::value>& GetValueMap() { return mapObjectValue_; }
-		std::unordered_map<int64_t, gstd::value>& GetValueMapI() { return mapObjectValueI_; }
+		DxScriptObjectNamedValueTable& GetValueMap() { return mapObjectValue_; }
+		DxScriptObjectValueTable<int64_t>& GetValueMapI() { return mapObjectValueI_; }
 	};
 
 	//****************************************************************************
@@ -226,6 +368,7 @@ namespace directx {
 
 		virtual void Render();
 		virtual void SetRenderState();
+		virtual bool SubmitBatch(RenderQueue2D* queue);
 
 		RenderObjectTLX* GetRenderObject() { return dynamic_cast<RenderObjectTLX*>(objRender_.get()); }
 
@@ -337,6 +480,7 @@ namespace directx {
 	public:
 		DxScriptParticleListObject2D();
 
+		virtual void Work();
 		virtual void Render();
 		virtual void SetRenderState();
 
@@ -355,6 +499,7 @@ namespace directx {
 	public:
 		DxScriptParticleListObject3D();
 
+		virtual void Work();
 		virtual void Render();
 		virtual void SetRenderState();
 
@@ -683,6 +828,7 @@ namespace directx {
 		};
 	protected:
 		static FogData fogData_;
+		static RenderQueue2D renderQueue_;
 	protected:
 		size_t totalObjectCreateCount_;
 		std::list<int> listUnusedIndex_;
@@ -710,6 +856,7 @@ namespace directx {
 		void SetRenderBucketCapacity(size_t capacity);
 
 		virtual int AddObject(ref_unsync_ptr<DxScriptObjectBase> obj, bool bActivate = true);
+		bool ReserveObject(size_t count);
 		//void AddObject(int id, shared_ptr<DxScriptObjectBase> obj, bool bActivate = true);
 		void ActivateObject(int id, bool bActivate);
 		void ActivateObject(ref_unsync_ptr<DxScriptObjectBase> obj, bool bActivate);
@@ -738,6 +885,7 @@ namespace directx {
 		virtual void PrepareRenderObject();
 		void ClearRenderObject();
 		std::vector<DxScriptObjectManager::RenderList>* GetRenderObjectListPointer() { return &listObjRender_; }
+		static RenderQueue2D* GetRenderQueue() { return &renderQueue_; }
 
 		void SetShader(shared_ptr<Shader> shader, int min, int max);
 		void ResetShader();
@@ -254,12 +254,12 @@ static const std::vector<function> dxFunction = {
 	{ "Obj_SetParentScriptID", DxScript::Func_Obj_SetParentScriptID, 2 }, //Overloaded
 	{ "Obj_Clone", DxScript::Func_Obj_Clone, 1 },
 
-	{ "Obj_GetValue", DxScript::Func_Obj_GetValue<false>, 2 },
-	{ "Obj_GetValue", DxScript::Func_Obj_GetValue<false>, 3 },
-	{ "Obj_GetValueD", DxScript::Func_Obj_GetValue<false>, 3 },
-	{ "Obj_SetValue", DxScript::Func_Obj_SetValue<false>, 3 },
-	{ "Obj_DeleteValue", DxScript::Func_Obj_DeleteValue<false>, 2 },
-	{ "Obj_IsValueExists", DxScript::Func_Obj_IsValueExists<false>, 2 },
+	{ "Obj_GetValue", DxScript::Func_Obj_GetValue<false>, 2, "", 1 },
+	{ "Obj_GetValue", DxScript::Func_Obj_GetValue<false>, 3, "", 1 },
+	{ "Obj_GetValueD", DxScript::Func_Obj_GetValue<false>, 3, "", 1 },
+	{ "Obj_SetValue", DxScript::Func_Obj_SetValue<false>, 3, "", 1 },
+	{ "Obj_DeleteValue", DxScript::Func_Obj_DeleteValue<false>, 2, "", 1 },
+	{ "Obj_IsValueExists", DxScript::Func_Obj_IsValueExists<false>, 2, "", 1 },
 	{ "Obj_CopyValueTable", DxScript::Func_Obj_CopyValueTable<false>, 3 },
 
 	{ "Obj_GetValueI", DxScript::Func_Obj_GetValue<true>, 2 },
@@ -421,6 +421,22 @@ static const std::vector<function> dxFunction = {
 	{ "ObjParticleList_SetExtraData", DxScript::Func_ObjParticleList_SetExtraData, 4 },
 	{ "ObjParticleList_AddInstance", DxScript::Func_ObjParticleList_AddInstance, 1 },
 	{ "ObjParticleList_ClearInstance", DxScript::Func_ObjParticleList_ClearInstance, 1 },
+	{ "ObjParticleList_AddInstanceArray", DxScript::Func_ObjParticleList_AddInstanceArray, 2 },
+	{ "ObjParticleList_AddInstanceArray", DxScript::Func_ObjParticleList_AddInstanceArray, 4 },	//Overloaded
+	{ "ObjParticleList_SetEmitterSpawnRate", DxScript::Func_ObjParticleList_SetEmitterSpawnRate, 2 },
+	{ "ObjParticleList_SetEmitterLife", DxScript::Func_ObjParticleList_SetEmitterLife, 3 },
+	{ "ObjParticleList_SetEmitterPosition", DxScript::Func_ObjParticleList_SetEmitterVector<0>, 4 },
+	{ "ObjParticleList_SetEmitterSpread", DxScript::Func_ObjParticleList_SetEmitterVector<1>, 4 },
+	{ "ObjParticleList_SetEmitterVelocity", DxScript::Func_ObjParticleList_SetEmitterVector<2>, 4 },
+	{ "ObjParticleList_SetEmitterGravity", DxScript::Func_ObjParticleList_SetEmitterVector<3>, 4 },
+	{ "ObjParticleList_SetEmitterSpeed", DxScript::Func_ObjParticleList_SetEmitterSpeed, 3 },
+	{ "ObjParticleList_SetEmitterAngle", DxScript::Func_ObjParticleList_SetEmitterAngle, 3 },
+	{ "ObjParticleList_AddEmitterColorKey", DxScript::Func_ObjParticleList_AddEmitterColorKey, 4 },
+	{ "ObjParticleList_AddEmitterScaleKey", DxScript::Func_ObjParticleList_AddEmitterScaleKey, 3 },
+	{ "ObjParticleList_ClearEmitterCurve", DxScript::Func_ObjParticleList_ClearEmitterCurve, 1 },
+	{ "ObjParticleList_EmitterBurst", DxScript::Func_ObjParticleList_EmitterBurst, 2 },
+	{ "ObjParticleList_ClearEmitter", DxScript::Func_ObjParticleList_ClearEmitter, 1 },
+	{ "ObjParticleList_GetEmitterParticleCount", DxScript::Func_ObjParticleList_GetEmitterParticleCount, 1 },
 
 	//Mesh object functions
 	{ "ObjMesh_Create", DxScript::Func_ObjMesh_Create, 0 },
@@ -1112,6 +1128,10 @@ gstd::value DxScript::Func_PlaySE(gstd::script_machine* machine, int argc, const
 	std::wstring path = argv[0].as_string();
 	path = PathProperty::GetUnique(path);
 
+	//Short sounds go through the shared mixer, anything else gets its own buffer
+	if (manager->PlaySoundEffect(path))
+		return value();
+
 	shared_ptr<SoundSourceData> soundSource = manager->GetSoundSource(path, true);
 	if (soundSource) {
 		shared_ptr<SoundPlayer> player = manager->CreatePlayer(soundSource);
@@ -1133,6 +1153,8 @@ value DxScript::Func_StopSound(script_machine* machine, int argc, const value* a
 	std::wstring path = argv[0].as_string();
 	path = PathProperty::GetUnique(path);
 
+	manager->StopSoundEffect(path);
+
 	shared_ptr<SoundPlayer> player = manager->GetPlayer(path);
 	if (player) {
 		player->Stop();
@@ -2547,57 +2569,43 @@ gstd::value DxScript::Func_Obj_GetRenderPriorityI(gstd::script_machine* machine,
 	return script->CreateFloatValue(res);
 }
 
+//String keys are resolved by DxScriptObjectNamedValueTable, literal keys were already interned by the parser
+template<bool INTEGER>
+static auto _GetValueTableKey(const gstd::value& key) {
+	if constexpr (!INTEGER)
+		return key;
+	else
+		return key.as_int();
+}
+template<bool INTEGER>
+static auto& _GetValueTable(DxScriptObjectBase* obj) {
+	if constexpr (!INTEGER)
+		return obj->GetValueMap();
+	else
+		return obj->GetValueMapI();
+}
+
 template<bool INTEGER>
 gstd::value DxScript::Func_Obj_GetValue(gstd::script_machine* machine, int argc, const gstd::value* argv) {
 	DxScript* script = (DxScript*)machine->data;
 	int id = argv[0].as_int();
 
-	gstd::value defaultValue = argc >= 3 ? argv[2] : value();
-
 	DxScriptObjectBase* obj = script->GetObjectPointer(id);
 	if (obj) {
-		if constexpr (!INTEGER) {
-			std::wstring key = argv[1].as_string();
-
-			auto& pValueMap = obj->GetValueMap();
-			auto itr = pValueMap.find(key);
-			if (itr != pValueMap.end())
-				return itr->second;
-		}
-		else {
-			int64_t key = argv[1].as_int();
-
-			auto& pValueMap = obj->GetValueMapI();
-			auto itr = pValueMap.find(key);
-			if (itr != pValueMap.end())
-				return itr->second;
-		}
+		if (gstd::value* pValue = _GetValueTable<INTEGER>(obj).Find(_GetValueTableKey<INTEGER>(argv[1])))
+			return *pValue;
 	}
 
-	return defaultValue;
+	return argc >= 3 ? argv[2] : value();
 }
 template<bool INTEGER>
 gstd::value DxScript::Func_Obj_SetValue(gstd::script_machine* machine, int argc, const gstd::value* argv) {
 	DxScript* script = (DxScript*)machine->data;
 	int id = argv[0].as_int();
-	
-	gstd::value val = argv[2];
 
 	DxScriptObjectBase* obj = script->GetObjectPointer(id);
-	if (obj) {
-		if constexpr (!INTEGER) {
-			std::wstring key = argv[1].as_string();
-
-			auto& pValueMap = obj->GetValueMap();
-			pValueMap[key] = val;
-		}
-		else {
-			int64_t key = argv[1].as_int();
-
-			auto& pValueMap = obj->GetValueMapI();
-			pValueMap[key] = val;
-		}
-	}
+	if (obj)
+		_GetValueTable<INTEGER>(obj).Set(_GetValueTableKey<INTEGER>(argv[1]), argv[2]);
 
 	return value();
 }
@@ -2607,20 +2615,8 @@ gstd::value DxScript::Func_Obj_DeleteValue(gstd::script_machine* machine, int ar
 	int id = argv[0].as_int();
 
 	DxScriptObjectBase* obj = script->GetObjectPointer(id);
-	if (obj) {
-		if constexpr (!INTEGER) {
-			std::wstring key = argv[1].as_string();
-
-			auto& pValueMap = obj->GetValueMap();
-			pValueMap.erase(key);
-		}
-		else {
-			int64_t key = argv[1].as_int();
-
-			auto& pValueMap = obj->GetValueMapI();
-			pValueMap.erase(key);
-		}
-	}
+	if (obj)
+		_GetValueTable<INTEGER>(obj).Erase(_GetValueTableKey<INTEGER>(argv[1]));
 
 	return value();
 }
@@ -2632,20 +2628,8 @@ gstd::value DxScript::Func_Obj_IsValueExists(gstd::script_machine* machine, int
 	bool res = false;
 
 	DxScriptObjectBase* obj = script->GetObjectPointer(id);
-	if (obj) {
-		if constexpr (!INTEGER) {
-			std::wstring key = argv[1].as_string();
-
-			auto& pValueMap = obj->GetValueMap();
-			res = pValueMap.find(key) != pValueMap.end();
-		}
-		else {
-			int64_t key = argv[1].as_int();
-
-			auto& pValueMap = obj->GetValueMapI();
-			res = pValueMap.find(key) != pValueMap.end();
-		}
-	}
+	if (obj)
+		res = _GetValueTable<INTEGER>(obj).Find(_GetValueTableKey<INTEGER>(argv[1])) != nullptr;
 
 	return script->CreateBooleanValue(res);
 }
@@ -2655,42 +2639,31 @@ gstd::value DxScript::Func_Obj_GetValueCount(gstd::script_machine* machine, int
 	int id = argv[0].as_int();
 	int64_t res = 0;
 	DxScriptObjectBase* obj = script->GetObjectPointer(id);
-	if (obj) {
-		if constexpr (!INTEGER) {
-			res = obj->GetValueMap().size();
-		}
-		else {
-			res = obj->GetValueMapI().size();
-		}
-	}
+	if (obj)
+		res = _GetValueTable<INTEGER>(obj).GetSize();
 	return script->CreateIntValue(res);
 }
 
-template<typename T>
-static void _CopyValueTable(std::unordered_map<T, gstd::value>& srcMap, std::unordered_map<T, gstd::value>& dstMap, int mode) {
+template<class TTable>
+static void _CopyValueTable(TTable& srcMap, TTable& dstMap, int mode) {
+	if (&srcMap == &dstMap) return;
+
 	//Mode 0 - Clear dest and copy
 	if (mode == 0) {
-		dstMap.clear();
-		for (auto itr = srcMap.begin(); itr != srcMap.end(); ++itr)
-			dstMap.insert(*itr);
+		dstMap = srcMap;
 	}
 	//Mode 1 - Source takes priority (Always overwrite)
 	else if (mode == 1) {
-		for (auto itr = srcMap.begin(); itr != srcMap.end(); ++itr) {
-			auto itrDst = srcMap.find(itr->first);
-			if (itrDst != srcMap.end())
-				itrDst->second = itr->second;
-			else
-				dstMap.insert(*itr);
-		}
+		srcMap.ForEach([&](const auto& key, const gstd::value& val) {
+			dstMap.Set(key, val);
+		});
 	}
 	//Mode 2 - Dest takes priority (No overwrite)
 	else if (mode == 2) {
-		for (auto itr = srcMap.begin(); itr != srcMap.end(); ++itr) {
-			auto itrDst = srcMap.find(itr->first);
-			if (itrDst == srcMap.end())
-				dstMap.insert(*itr);
-		}
+		srcMap.ForEach([&](const auto& key, const gstd::value& val) {
+			if (dstMap.Find(key) == nullptr)
+				dstMap.Set(key, val);
+		});
 	}
 }
 
@@ -2708,18 +2681,10 @@ gstd::value DxScript::Func_Obj_CopyValueTable(gstd::script_machine* machine, int
 		if (objSrc) {
 			int copyMode = argv[2].as_int();
 
-			if constexpr (!INTEGER) {
-				auto& srcMap = objSrc->GetValueMap();
-				auto& dstMap = objDst->GetValueMap();
-				countValue = srcMap.size();
-				_CopyValueTable(srcMap, dstMap, copyMode);
-			}
-			else {
-				auto& srcMap = objSrc->GetValueMapI();
-				auto& dstMap = objDst->GetValueMapI();
-				countValue = srcMap.size();
-				_CopyValueTable(srcMap, dstMap, copyMode);
-			}
+			auto& srcMap = _GetValueTable<INTEGER>(objSrc);
+			auto& dstMap = _GetValueTable<INTEGER>(objDst);
+			countValue = srcMap.GetSize();
+			_CopyValueTable(srcMap, dstMap, copyMode);
 		}
 	}
 
@@ -4420,6 +4385,172 @@ value DxScript::Func_ObjParticleList_ClearInstance(script_machine* machine, int
 	return value();
 }
 
+static ParticleRendererBase* _script_get_particle(DxScript* script, int id) {
+	DxScriptPrimitiveObject* obj = script->GetObjectPointerAs<DxScriptPrimitiveObject>(id);
+	return obj ? dynamic_cast<ParticleRendererBase*>(obj->GetRenderObject()) : nullptr;
+}
+value DxScript::Func_ObjParticleList_AddInstanceArray(script_machine* machine, int argc, const value* argv) {
+	DxScript* script = (DxScript*)machine->data;
+	ParticleRendererBase* objParticle = _script_get_particle(script, argv[0].as_int());
+	if (objParticle == nullptr) return value();
+
+	const value& valPos = argv[1];
+	size_t count = valPos.length_as_array();
+	if (count == 0) return value();
+
+	//Positions without a z use the current instance z
+	std::vector<float> posX(count);
+	std::vector<float> posY(count);
+	std::vector<float> posZ;
+	for (size_t i = 0; i < count; ++i) {
+		const value& subArray = valPos[i];
+		size_t countElem = subArray.length_as_array();
+		if (countElem < 2U) {
+			machine->raise_error("Invalid value for particle position. (Expected array of [x, y] or [x, y, z])");
+			return value();
+		}
+		posX[i] = subArray[0].as_float();
+		posY[i] = subArray[1].as_float();
+		if (countElem >= 3U) {
+			if (posZ.empty())
+				posZ.resize(count, objParticle->GetInstancePosition().z / DirectGraphics::g_dxCoordsMul_);
+			posZ[i] = subArray[2].as_float();
+		}
+	}
+
+	//Scales and colors may be empty (current instance value), a single value, or one per position
+	std::vector<float> scale;
+	std::vector<D3DCOLOR> color;
+	if (argc == 4) {
+		const value& valScale = argv[2];
+		const value& valColor = argv[3];
+		size_t countScale = valScale.length_as_array();
+		size_t countColor = valColor.length_as_array();
+		if ((countScale > 1U && countScale != count) || (countColor > 1U && countColor != count)) {
+			machine->raise_error("Particle scale and color arrays must be empty, of size 1, or the same size as the position array.");
+			return value();
+		}
+
+		if (countScale > 0U) {
+			scale.resize(count);
+			for (size_t i = 0; i < count; ++i)
+				scale[i] = valScale[countScale == 1U ? 0 : i].as_float();
+		}
+		if (countColor > 0U) {
+			D3DCOLOR alpha = objParticle->GetInstanceColor() & 0xff000000;
+			color.resize(count);
+			for (size_t i = 0; i < count; ++i)
+				color[i] = ((D3DCOLOR)valColor[countColor == 1U ? 0 : i].as_int() & 0x00ffffff) | alpha;
+		}
+	}
+
+	objParticle->AddInstanceArray(posX.data(), posY.data(), posZ.size() > 0 ? posZ.data() : nullptr,
+		scale.size() > 0 ? scale.data() : nullptr, color.size() > 0 ? color.data() : nullptr, count);
+	return value();
+}
+value DxScript::Func_ObjParticleList_SetEmitterSpawnRate(script_machine* machine, int argc, const value* argv) {
+	DxScript* script = (DxScript*)machine->data;
+	ParticleRendererBase* objParticle = _script_get_particle(script, argv[0].as_int());
+	if (objParticle)
+		objParticle->GetEmitter()->SetSpawnRate(argv[1].as_float());
+	return value();
+}
+value DxScript::Func_ObjParticleList_SetEmitterLife(script_machine* machine, int argc, const value* argv) {
+	DxScript* script = (DxScript*)machine->data;
+	ParticleRendererBase* objParticle = _script_get_particle(script, argv[0].as_int());
+	if (objParticle) {
+		int min = std::max(argv[1].as_int(), 1);
+		int max = std::max(argv[2].as_int(), 1);
+		objParticle->GetEmitter()->SetLife(min, max);
+	}
+	return value();
+}
+template<size_t ID>
+value DxScript::Func_ObjParticleList_SetEmitterVector(script_machine* machine, int argc, const value* argv) {
+	DxScript* script = (DxScript*)machine->data;
+	ParticleRendererBase* objParticle = _script_get_particle(script, argv[0].as_int());
+	if (objParticle) {
+		ParticleEmitter* emitter = objParticle->GetEmitter();
+		D3DXVECTOR3 vec(argv[1].as_float(), argv[2].as_float(), argv[3].as_float());
+		switch (ID) {
+		case 0:
+			emitter->SetPosition(vec);
+			break;
+		case 1:
+			emitter->SetSpread(vec);
+			break;
+		case 2:
+			emitter->SetVelocity(vec);
+			break;
+		case 3:
+			emitter->SetGravity(vec);
+			break;
+		}
+	}
+	return value();
+}
+value DxScript::Func_ObjParticleList_SetEmitterSpeed(script_machine* machine, int argc, const value* argv) {
+	DxScript* script = (DxScript*)machine->data;
+	ParticleRendererBase* objParticle = _script_get_particle(script, argv[0].as_int());
+	if (objParticle)
+		objParticle->GetEmitter()->SetSpeed(argv[1].as_float(), argv[2].as_float());
+	return value();
+}
+value DxScript::Func_ObjParticleList_SetEmitterAngle(script_machine* machine, int argc, const value* argv) {
+	DxScript* script = (DxScript*)machine->data;
+	ParticleRendererBase* objParticle = _script_get_particle(script, argv[0].as_int());
+	if (objParticle)
+		objParticle->GetEmitter()->SetAngle(argv[1].as_float(), argv[2].as_float());
+	return value();
+}
+value DxScript::Func_ObjParticleList_AddEmitterColorKey(script_machine* machine, int argc, const value* argv) {
+	DxScript* script = (DxScript*)machine->data;
+	ParticleRendererBase* objParticle = _script_get_particle(script, argv[0].as_int());
+	if (objParticle) {
+		D3DCOLOR color = argv[2].as_int();
+		D3DXVECTOR4 key(argv[3].as_float(),
+			(float)((color >> 16) & 0xff), (float)((color >> 8) & 0xff), (float)(color & 0xff));
+		objParticle->GetEmitter()->AddColorKey(argv[1].as_float(), key);
+	}
+	return value();
+}
+value DxScript::Func_ObjParticleList_AddEmitterScaleKey(script_machine* machine, int argc, const value* argv) {
+	DxScript* script = (DxScript*)machine->data;
+	ParticleRendererBase* objParticle = _script_get_particle(script, argv[0].as_int());
+	if (objParticle)
+		objParticle->GetEmitter()->AddScaleKey(argv[1].as_float(), argv[2].as_float());
+	return value();
+}
+value DxScript::Func_ObjParticleList_ClearEmitterCurve(script_machine* machine, int argc, const value* argv) {
+	DxScript* script = (DxScript*)machine->data;
+	ParticleRendererBase* objParticle = _script_get_particle(script, argv[0].as_int());
+	if (objParticle && objParticle->IsEmitterExists())
+		objParticle->GetEmitter()->ClearCurve();
+	return value();
+}
+value DxScript::Func_ObjParticleList_EmitterBurst(script_machine* machine, int argc, const value* argv) {
+	DxScript* script = (DxScript*)machine->data;
+	ParticleRendererBase* objParticle = _script_get_particle(script, argv[0].as_int());
+	if (objParticle)
+		objParticle->GetEmitter()->Burst(std::max(argv[1].as_int(), 0));
+	return value();
+}
+value DxScript::Func_ObjParticleList_ClearEmitter(script_machine* machine, int argc, const value* argv) {
+	DxScript* script = (DxScript*)machine->data;
+	ParticleRendererBase* objParticle = _script_get_particle(script, argv[0].as_int());
+	if (objParticle && objParticle->IsEmitterExists())
+		objParticle->GetEmitter()->Clear();
+	return value();
+}
+value DxScript::Func_ObjParticleList_GetEmitterParticleCount(script_machine* machine, int argc, const value* argv) {
+	DxScript* script = (DxScript*)machine->data;
+	ParticleRendererBase* objParticle = _script_get_particle(script, argv[0].as_int());
+	size_t res = 0;
+	if (objParticle && objParticle->IsEmitterExists())
+		res = objParticle->GetEmitter()->GetParticleCount();
+	return script->CreateIntValue(res);
+}
+
 //Dx関数：オブジェクト操作(DxMesh)
 value DxScript::Func_ObjMesh_Create(script_machine* machine, int argc, const value* argv) {
 	DxScript* script = (DxScript*)machine->data;
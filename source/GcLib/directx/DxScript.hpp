@@ -405,6 +405,18 @@ namespace directx {
 		DNH_FUNCAPI_DECL_(Func_ObjParticleList_SetExtraData);
 		DNH_FUNCAPI_DECL_(Func_ObjParticleList_AddInstance);
 		DNH_FUNCAPI_DECL_(Func_ObjParticleList_ClearInstance);
+		DNH_FUNCAPI_DECL_(Func_ObjParticleList_AddInstanceArray);
+		DNH_FUNCAPI_DECL_(Func_ObjParticleList_SetEmitterSpawnRate);
+		DNH_FUNCAPI_DECL_(Func_ObjParticleList_SetEmitterLife);
+		template<size_t ID> DNH_FUNCAPI_DECL_(Func_ObjParticleList_SetEmitterVector);
+		DNH_FUNCAPI_DECL_(Func_ObjParticleList_SetEmitterSpeed);
+		DNH_FUNCAPI_DECL_(Func_ObjParticleList_SetEmitterAngle);
+		DNH_FUNCAPI_DECL_(Func_ObjParticleList_AddEmitterColorKey);
+		DNH_FUNCAPI_DECL_(Func_ObjParticleList_AddEmitterScaleKey);
+		DNH_FUNCAPI_DECL_(Func_ObjParticleList_ClearEmitterCurve);
+		DNH_FUNCAPI_DECL_(Func_ObjParticleList_EmitterBurst);
+		DNH_FUNCAPI_DECL_(Func_ObjParticleList_ClearEmitter);
+		DNH_FUNCAPI_DECL_(Func_ObjParticleList_GetEmitterParticleCount);
 
 		//Dx関数：オブジェクト操作(DxMesh)
 		static gstd::value Func_ObjMesh_Create(gstd::script_machine* machine, int argc, const gstd::value* argv);
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "../pch.h"
+
+namespace directx {
+	//*******************************************************************
+	//DeviceStateCache
+	//*******************************************************************
+	//Keeps a shadow copy of the device's render, sampler, texture stage, texture and stream states,
+	//	and drops Set* calls that would not change anything.
+	class DeviceStateCache {
+	public:
+		enum : size_t {
+			MAX_RENDER_STATE = 256,		//D3DRS_BLENDOPALPHA is 209
+			MAX_SAMPLER = 16,
+			MAX_SAMPLER_STATE = 14,		//D3DSAMP_DMAPOFFSET is 13
+			MAX_TEXTURE_STAGE = 8,
+			MAX_TEXTURE_STAGE_STATE = 33,	//D3DTSS_CONSTANT is 32
+			MAX_STREAM = 4,
+		};
+
+		struct Stats {
+			size_t countIssued = 0;
+			size_t countFiltered = 0;
+		};
+	private:
+		template<typename T, size_t N>
+		struct ShadowArray {
+			std::array<T, N> value;
+			std::bitset<N> valid;
+
+			//Returns true if the value was changed (the call must be issued)
+			inline bool Update(size_t index, const T& v) {
+				if (valid[index] && value[index] == v) return false;
+				value[index] = v;
+				valid[index] = true;
+				return true;
+			}
+		};
+
+		struct StreamSource {
+			void* buffer;
+			UINT offset;
+			UINT stride;
+
+			bool operator==(const StreamSource& other) const {
+				return buffer == other.buffer && offset == other.offset && stride == other.stride;
+			}
+		};
+	private:
+		IDirect3DDevice9* pDevice_;
+
+		ShadowArray<DWORD, MAX_RENDER_STATE> renderState_;
+		ShadowArray<DWORD, MAX_SAMPLER * MAX_SAMPLER_STATE> samplerState_;
+		ShadowArray<DWORD, MAX_TEXTURE_STAGE * MAX_TEXTURE_STAGE_STATE> textureStageState_;
+		ShadowArray<void*, MAX_SAMPLER> texture_;
+		ShadowArray<StreamSource, MAX_STREAM> streamSource_;
+
+		//SetFVF and SetVertexDeclaration overwrite each other
+		enum class InputMode {
+			UNKNOWN,
+			FVF,
+			DECLARATION,
+		};
+		InputMode modeInput_;
+		DWORD fvf_;
+		IDirect3DVertexDeclaration9* vertexDecl_;
+		ShadowArray<IDirect3DIndexBuffer9*, 1> indices_;
+
+		Stats statsFrame_;
+		Stats statsLastFrame_;
+	private:
+		inline bool _Count(bool bIssue) {
+			if (bIssue) ++statsFrame_.countIssued;
+			else ++statsFrame_.countFiltered;
+			return bIssue;
+		}
+	public:
+		DeviceStateCache() {
+			pDevice_ = nullptr;
+			fvf_ = 0;
+			vertexDecl_ = nullptr;
+			Invalidate();
+		}
+
+		void SetDevice(IDirect3DDevice9* device) {
+			pDevice_ = device;
+			Invalidate();
+		}
+		IDirect3DDevice9* GetDevice() { return pDevice_; }
+
+		//Forgets all shadowed state, the next call to every setter will be issued.
+		//Must be called whenever the device state is changed outside of this cache (device reset, etc.)
+		void Invalidate() {
+			renderState_.valid.reset();
+			samplerState_.valid.reset();
+			textureStageState_.valid.reset();
+			texture_.valid.reset();
+			streamSource_.valid.reset();
+			indices_.valid.reset();
+			modeInput_ = InputMode::UNKNOWN;
+		}
+
+		HRESULT SetRenderState(D3DRENDERSTATETYPE type, DWORD value) {
+			if ((size_t)type < MAX_RENDER_STATE && !_Count(renderState_.Update(type, value)))
+				return D3D_OK;
+			return pDevice_->SetRenderState(type, value);
+		}
+		HRESULT SetSamplerState(DWORD sampler, D3DSAMPLERSTATETYPE type, DWORD value) {
+			//Displacement map and vertex samplers are passed straight through
+			if (sampler < MAX_SAMPLER && (size_t)type < MAX_SAMPLER_STATE) {
+				if (!_Count(samplerState_.Update(sampler * MAX_SAMPLER_STATE + type, value)))
+					return D3D_OK;
+			}
+			return pDevice_->SetSamplerState(sampler, type, value);
+		}
+		HRESULT SetTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE type, DWORD value) {
+			if (stage < MAX_TEXTURE_STAGE && (size_t)type < MAX_TEXTURE_STAGE_STATE) {
+				if (!_Count(textureStageState_.Update(stage * MAX_TEXTURE_STAGE_STATE + type, value)))
+					return D3D_OK;
+			}
+			return pDevice_->SetTextureStageState(stage, type, value);
+		}
+		HRESULT SetTexture(DWORD stage, IDirect3DBaseTexture9* texture) {
+			if (stage < MAX_SAMPLER && !_Count(texture_.Update(stage, texture)))
+				return D3D_OK;
+			return pDevice_->SetTexture(stage, texture);
+		}
+		HRESULT SetStreamSource(UINT stream, IDirect3DVertexBuffer9* buffer, UINT offset, UINT stride) {
+			if (stream < MAX_STREAM && !_Count(streamSource_.Update(stream, StreamSource{ buffer, offset, stride })))
+				return D3D_OK;
+			return pDevice_->SetStreamSource(stream, buffer, offset, stride);
+		}
+		HRESULT SetFVF(DWORD fvf) {
+			if (!_Count(modeInput_ != InputMode::FVF || fvf_ != fvf))
+				return D3D_OK;
+			modeInput_ = InputMode::FVF;
+			fvf_ = fvf;
+			return pDevice_->SetFVF(fvf);
+		}
+		HRESULT SetVertexDeclaration(IDirect3DVertexDeclaration9* decl) {
+			if (!_Count(modeInput_ != InputMode::DECLARATION || vertexDecl_ != decl))
+				return D3D_OK;
+			modeInput_ = InputMode::DECLARATION;
+			vertexDecl_ = decl;
+			return pDevice_->SetVertexDeclaration(decl);
+		}
+		HRESULT SetIndices(IDirect3DIndexBuffer9* indices) {
+			if (!_Count(indices_.Update(0, indices)))
+				return D3D_OK;
+			return pDevice_->SetIndices(indices);
+		}
+
+		//DrawPrimitiveUP and DrawIndexedPrimitiveUP reset stream 0 (and the index buffer) to null
+		void NotifyDrawUP(bool bIndexed) {
+			streamSource_.Update(0, StreamSource{ nullptr, 0, 0 });
+			if (bIndexed)
+				indices_.Update(0, nullptr);
+		}
+
+		bool GetRenderState(D3DRENDERSTATETYPE type, DWORD* value) {
+			if ((size_t)type < MAX_RENDER_STATE && renderState_.valid[type]) {
+				*value = renderState_.value[type];
+				return true;
+			}
+			return SUCCEEDED(pDevice_->GetRenderState(type, value));
+		}
+		bool GetSamplerState(DWORD sampler, D3DSAMPLERSTATETYPE type, DWORD* value) {
+			if (sampler < MAX_SAMPLER && (size_t)type < MAX_SAMPLER_STATE) {
+				size_t index = sampler * MAX_SAMPLER_STATE + type;
+				if (samplerState_.valid[index]) {
+					*value = samplerState_.value[index];
+					return true;
+				}
+			}
+			return SUCCEEDED(pDevice_->GetSamplerState(sampler, type, value));
+		}
+
+		//Moves the current frame's counters to the last frame's
+		void EndFrame() {
+			statsLastFrame_ = statsFrame_;
+			statsFrame_ = Stats();
+		}
+		const Stats& GetFrameStats() { return statsFrame_; }
+		const Stats& GetLastFrameStats() { return statsLastFrame_; }
+	};
+}
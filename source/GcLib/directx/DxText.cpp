@@ -309,6 +309,112 @@ void DxCharCache::AddChar(DxCharCacheKey& key, shared_ptr<DxCharGlyph> value) {
 	}
 }
 
+//*******************************************************************
+//DxGlyphMetricsCache
+//*******************************************************************
+shared_ptr<DxGlyphMetricsCache::Table> DxGlyphMetricsCache::GetTable(const LOGFONT& font) {
+	FontKey key;
+	key.info = font;
+	{
+		//Whatever follows the terminator in the face name must not affect the key
+		size_t lenFace = wcsnlen(key.info.lfFaceName, LF_FACESIZE);
+		std::fill(key.info.lfFaceName + lenFace, key.info.lfFaceName + LF_FACESIZE, L'\0');
+	}
+
+	auto itr = mapTable_.find(key);
+	if (itr != mapTable_.end())
+		return itr->second;
+
+	if (mapTable_.size() >= MAX_FONT)
+		mapTable_.clear();
+
+	shared_ptr<Table> table = std::make_shared<Table>();
+	mapTable_[key] = table;
+	return table;
+}
+bool DxGlyphMetricsCache::Find(Table* table, UINT code, SIZE* res) {
+	if (code < SIZE_DIRECT) {
+		if (table->validDirect[code]) {
+			*res = table->sizeDirect[code];
+			++stats_.countHit;
+			return true;
+		}
+	}
+	else {
+		auto itr = table->mapSize.find(code);
+		if (itr != table->mapSize.end()) {
+			*res = itr->second;
+			++stats_.countHit;
+			return true;
+		}
+	}
+	++stats_.countMiss;
+	return false;
+}
+void DxGlyphMetricsCache::Add(Table* table, UINT code, const SIZE& size) {
+	if (code < SIZE_DIRECT) {
+		table->sizeDirect[code] = size;
+		table->validDirect[code] = true;
+	}
+	else table->mapSize[code] = size;
+}
+
+//*******************************************************************
+//DxTextLayoutCache
+//*******************************************************************
+DxTextLayoutKey::DxTextLayoutKey(DxText* dxText) {
+	text_ = dxText->GetText();
+	font_ = dxText->GetFont();
+	sidePitch_ = dxText->GetSidePitch();
+	linePitch_ = dxText->GetLinePitch();
+	widthMax_ = dxText->GetMaxWidth();
+	heightMax_ = dxText->GetMaxHeight();
+	margin_ = dxText->GetMargin();
+	bSyntacticAnalysis_ = dxText->IsSyntacticAnalysis();
+
+	{
+		LOGFONT& info = font_.GetLogFont();
+		size_t lenFace = wcsnlen(info.lfFaceName, LF_FACESIZE);
+		std::fill(info.lfFaceName + lenFace, info.lfFaceName + LF_FACESIZE, L'\0');
+	}
+
+	hash_ = std::hash<std::wstring>{}(text_);
+	hash_ ^= std::hash<LONG>{}(font_.GetLogFont().lfHeight) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
+	hash_ ^= std::hash<LONG>{}(widthMax_) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
+}
+bool DxTextLayoutKey::operator==(const DxTextLayoutKey& key) const {
+	if (hash_ != key.hash_) return false;
+	if (sidePitch_ != key.sidePitch_ || linePitch_ != key.linePitch_) return false;
+	if (widthMax_ != key.widthMax_ || heightMax_ != key.heightMax_) return false;
+	if (margin_.left != key.margin_.left || margin_.top != key.margin_.top
+		|| margin_.right != key.margin_.right || margin_.bottom != key.margin_.bottom) return false;
+	if (bSyntacticAnalysis_ != key.bSyntacticAnalysis_) return false;
+
+	//Font tags copy the colors into the layout
+	if (font_.GetTopColor() != key.font_.GetTopColor()) return false;
+	if (font_.GetBottomColor() != key.font_.GetBottomColor()) return false;
+	if (font_.GetBorderType() != key.font_.GetBorderType()) return false;
+	if (font_.GetBorderWidth() != key.font_.GetBorderWidth()) return false;
+	if (font_.GetBorderColor() != key.font_.GetBorderColor()) return false;
+	if (memcmp(&font_.GetLogFont(), &key.font_.GetLogFont(), sizeof(LOGFONT)) != 0) return false;
+
+	return text_ == key.text_;
+}
+
+shared_ptr<DxTextInfo> DxTextLayoutCache::Get(const DxTextLayoutKey& key) {
+	auto itr = mapCache_.find(key);
+	if (itr != mapCache_.end()) {
+		++stats_.countHit;
+		return itr->second;
+	}
+	++stats_.countMiss;
+	return nullptr;
+}
+void DxTextLayoutCache::Add(const DxTextLayoutKey& key, shared_ptr<DxTextInfo> value) {
+	if (mapCache_.size() >= MAX)
+		mapCache_.clear();
+	mapCache_[key] = value;
+}
 
 //*******************************************************************
 //DxTextScanner
@@ -727,19 +833,64 @@ bool DxTextRenderer::Initialize() {
 	thisBase_ = this;
 	return true;
 }
-SIZE DxTextRenderer::_GetTextSize(HDC hDC, wchar_t* pText) {
-	//文字コード
-	int charCount = 1;
-	int code = 0;
-
-	//文字サイズ計算
+DxTextRenderer::TextMeasure::TextMeasure(DxGlyphMetricsCache* cache, const LOGFONT& font) {
+	cache_ = cache;
+	hDC_ = nullptr;
+	hFontOld_ = nullptr;
+	hFont_ = nullptr;
+	SetFont(font);
+}
+DxTextRenderer::TextMeasure::~TextMeasure() {
+	if (hDC_) {
+		::SelectObject(hDC_, hFontOld_);
+		::ReleaseDC(nullptr, hDC_);
+	}
+	if (hFont_)
+		::DeleteObject(hFont_);
+}
+void DxTextRenderer::TextMeasure::SetFont(const LOGFONT& font) {
+	info_ = font;
+	table_ = cache_->GetTable(font);
+
+	if (hFont_) {
+		if (hDC_)
+			::SelectObject(hDC_, hFontOld_);
+		::DeleteObject(hFont_);
+		hFont_ = nullptr;
+	}
+}
+SIZE DxTextRenderer::TextMeasure::GetCharSize(UINT code) {
 	SIZE size;
-	::GetTextExtentPoint32(hDC, pText, charCount, &size);
+	if (cache_->Find(table_.get(), code, &size))
+		return size;
+
+	if (hDC_ == nullptr) {
+		hDC_ = ::GetDC(nullptr);
+		hFontOld_ = (HFONT)::GetCurrentObject(hDC_, OBJ_FONT);
+	}
+	if (hFont_ == nullptr) {
+		hFont_ = ::CreateFontIndirect(&info_);
+		::SelectObject(hDC_, hFont_);
+	}
+
+	wchar_t ch = (wchar_t)code;
+	::GetTextExtentPoint32(hDC_, &ch, 1, &size);
+
+	cache_->Add(table_.get(), code, size);
 	return size;
 }
+SIZE DxTextRenderer::TextMeasure::GetTextSize(const std::wstring& text) {
+	SIZE res = { 0, 0 };
+	for (wchar_t ch : text) {
+		SIZE size = GetCharSize(ch);
+		res.cx += size.cx;
+		res.cy = std::max(res.cy, size.cy);
+	}
+	return res;
+}
 
 shared_ptr<DxTextLine> DxTextRenderer::_GetTextInfoSub(const std::wstring& text, DxText* dxText, DxTextInfo* textInfo,
-	shared_ptr<DxTextLine> textLine, HDC& hDC, LONG& totalWidth, LONG& totalHeight)
+	shared_ptr<DxTextLine> textLine, TextMeasure& measure, LONG& totalWidth, LONG& totalHeight)
 {
 	DxFont& dxFont = dxText->GetFont();
 	float sidePitch = dxText->GetSidePitch();
@@ -775,11 +926,11 @@ shared_ptr<DxTextLine> DxTextRenderer::_GetTextInfoSub(const std::wstring& text,
 
 			bool bFirstForbid = strFirstForbid.find(strNext) != std::wstring::npos;
 			if (bFirstForbid)
-				sizeNext = _GetTextSize(hDC, pNextChar);
+				sizeNext = measure.GetCharSize(*pNextChar);
 		}
 
 		//文字サイズ計算
-		SIZE size = _GetTextSize(hDC, pText);
+		SIZE size = measure.GetCharSize(code);
 		LONG lw = size.cx + widthBorder + sidePitch;
 		LONG lh = size.cy;
 		if (heightMax > 0 && totalHeight + size.cy > heightMax) {
@@ -841,8 +992,18 @@ std::vector<std::wstring> GetScannerStringArgumentList(DxTextScanner& scan, std:
 	return list;
 }
 shared_ptr<DxTextInfo> DxTextRenderer::GetTextInfo(DxText* dxText) {
-	SetFont(dxText->dxFont_.GetLogFont());
-
+	DxTextLayoutKey key(dxText);
+
+	shared_ptr<DxTextInfo> res = cacheLayout_.Get(key);
+	if (res == nullptr) {
+		auto timeStart = stdch::steady_clock::now();
+		res = _CreateTextInfo(dxText);
+		cacheLayout_.AddLayoutTime(stdch::duration<double, std::milli>(stdch::steady_clock::now() - timeStart).count());
+		cacheLayout_.Add(key, res);
+	}
+	return res;
+}
+shared_ptr<DxTextInfo> DxTextRenderer::_CreateTextInfo(DxText* dxText) {
 	DxTextInfo* res = new DxTextInfo();
 	const std::wstring& text = dxText->GetText();
 	DxFont& dxFont = dxText->GetFont();
@@ -851,10 +1012,7 @@ shared_ptr<DxTextInfo> DxTextRenderer::GetTextInfo(DxText* dxText) {
 	LONG heightMax = dxText->GetMaxHeight();
 	DxRect<LONG>& margin = dxText->GetMargin();
 
-	shared_ptr<Font> fontTemp;
-
-	HDC hDC = ::GetDC(nullptr);
-	HFONT oldFont = (HFONT)::SelectObject(hDC, winFont_.GetHandle());
+	TextMeasure measure(&cacheMetrics_, dxFont.GetLogFont());
 
 	bool bEnd = false;
 	LONG totalWidth = 0;
@@ -903,7 +1061,7 @@ shared_ptr<DxTextInfo> DxTextRenderer::GetTextInfo(DxText* dxText) {
 				text = _ReplaceRenderText(text);
 				if (text.size() == 0 || text == L"") continue;
 
-				textLine = _GetTextInfoSub(text, dxText, res, textLine, hDC, totalWidth, totalHeight);
+				textLine = _GetTextInfoSub(text, dxText, res, textLine, measure, totalWidth, totalHeight);
 				if (textLine == nullptr) bEnd = true;
 			}
 			else if (typeToken == TOKEN_TAG_START) {
@@ -913,7 +1071,7 @@ shared_ptr<DxTextInfo> DxTextRenderer::GetTextInfo(DxText* dxText) {
 				if (element == TAG_NEW_LINE) {
 					if (textLine->height_ == 0) {
 						//Insert a dummy space if there is no text
-						textLine = _GetTextInfoSub(L" ", dxText, res, textLine, hDC, totalWidth, totalHeight);
+						textLine = _GetTextInfoSub(L" ", dxText, res, textLine, measure, totalWidth, totalHeight);
 					}
 
 					totalWidth = std::max(totalWidth, textLine->width_);
@@ -989,10 +1147,9 @@ shared_ptr<DxTextInfo> DxTextRenderer::GetTextInfo(DxText* dxText) {
 					size_t codeCount = textLine->GetTextCodes().size();
 					const std::wstring& text = data.tag->GetText();
 					shared_ptr<DxTextLine> textLineRuby = textLine;
-					textLine = _GetTextInfoSub(text, dxText, res, textLine, hDC, totalWidth, totalHeight);
+					textLine = _GetTextInfoSub(text, dxText, res, textLine, measure, totalWidth, totalHeight);
 
-					SIZE sizeTextBase;
-					::GetTextExtentPoint32(hDC, &text[0], text.size(), &sizeTextBase);
+					SIZE sizeTextBase = measure.GetTextSize(text);
 
 					LONG rubyFontWidth = dxText->GetFontSize() / 2L + data.sizeOff;
 					size_t rubyCount = StringUtility::CountAsciiSizeCharacter(data.tag->GetRuby());
@@ -1196,15 +1353,12 @@ shared_ptr<DxTextInfo> DxTextRenderer::GetTextInfo(DxText* dxText) {
 
 					if (data.bClear) {
 						widthBorder = dxFont.GetBorderType() != TextBorderType::None ? dxFont.GetBorderWidth() : 0L;
-						fontTemp = nullptr;
-						::SelectObject(hDC, oldFont);
+						measure.SetFont(dxFont.GetLogFont());
 						curFontData = orgFontData;
 					}
 					else {
 						widthBorder = font.GetBorderType() != TextBorderType::None ? font.GetBorderWidth() : 0L;
-						fontTemp = std::make_shared<Font>();
-						fontTemp->CreateFontIndirect(logFont);
-						::SelectObject(hDC, fontTemp->GetHandle());
+						measure.SetFont(logFont);
 					}
 
 					font.SetBottomColor(curFontData.colorBottom);
@@ -1229,7 +1383,7 @@ shared_ptr<DxTextInfo> DxTextRenderer::GetTextInfo(DxText* dxText) {
 					text = _ReplaceRenderText(text);
 					if (text.size() == 0 || text == L"") continue;
 
-					textLine = _GetTextInfoSub(text, dxText, res, textLine, hDC, totalWidth, totalHeight);
+					textLine = _GetTextInfoSub(text, dxText, res, textLine, measure, totalWidth, totalHeight);
 					if (textLine == nullptr) bEnd = true;
 				}
 			}
@@ -1239,15 +1393,13 @@ shared_ptr<DxTextInfo> DxTextRenderer::GetTextInfo(DxText* dxText) {
 		std::wstring text = dxText->GetText();
 		text = _ReplaceRenderText(text);
 		if (text.size() > 0) {
-			textLine = _GetTextInfoSub(text, dxText, res, textLine, hDC, totalWidth, totalHeight);
+			textLine = _GetTextInfoSub(text, dxText, res, textLine, measure, totalWidth, totalHeight);
 			res->AddTextLine(textLine);
 		}
 	}
 
 	res->totalWidth_ = totalWidth + widthBorder;
 	res->totalHeight_ = totalHeight + widthBorder;
-	::SelectObject(hDC, oldFont);
-	::ReleaseDC(nullptr, hDC);
 
 	return shared_ptr<DxTextInfo>(res);
 }
@@ -1462,6 +1614,12 @@ bool DxTextRenderer::AddFontFromFile(const std::wstring& path) {
 	DWORD count = 0;
 	HANDLE hFont = ::AddFontMemResourceEx((LPVOID)source.c_str(), source.size(), nullptr, &count);
 
+	//Faces that fell back to another font before may measure differently now
+	if (hFont != 0) {
+		cacheMetrics_.Clear();
+		cacheLayout_.Clear();
+	}
+
 	Logger::WriteTop(StringUtility::Format(L"AddFontFromFile: Font loaded. [%s]", pathReduce.c_str()));
 	return hFont != 0;
 }
@@ -10,6 +10,8 @@ namespace directx {
 	class DxCharGlyph;
 	class DxCharCache;
 	class DxCharCacheKey;
+	class DxTextLayoutCache;
+	class DxTextInfo;
 	class DxTextRenderer;
 	class DxText;
 
@@ -131,6 +133,103 @@ namespace directx {
 		void AddChar(DxCharCacheKey& key, shared_ptr<DxCharGlyph> value);
 	};
 
+	//*******************************************************************
+	//DxGlyphMetricsCache
+	//Per-font character size tables, filled lazily as characters are measured
+	//*******************************************************************
+	class DxGlyphMetricsCache {
+	public:
+		enum : size_t {
+			MAX_FONT = 64U,
+			SIZE_DIRECT = 256U,
+		};
+
+		struct Table {
+			std::array<SIZE, SIZE_DIRECT> sizeDirect;
+			std::bitset<SIZE_DIRECT> validDirect;
+			std::unordered_map<UINT, SIZE> mapSize;
+		};
+		struct Stats {
+			size_t countHit = 0;
+			size_t countMiss = 0;
+		};
+	private:
+		struct FontKey {
+			LOGFONT info;
+
+			bool operator<(const FontKey& key) const {
+				return memcmp(&info, &key.info, sizeof(LOGFONT)) < 0;
+			}
+		};
+
+		std::map<FontKey, shared_ptr<Table>> mapTable_;
+		Stats stats_;
+	public:
+		DxGlyphMetricsCache() {}
+
+		void Clear() { mapTable_.clear(); }
+		size_t GetFontCount() { return mapTable_.size(); }
+
+		shared_ptr<Table> GetTable(const LOGFONT& font);
+		//Returns false if the character has not been measured with this font yet
+		bool Find(Table* table, UINT code, SIZE* res);
+		void Add(Table* table, UINT code, const SIZE& size);
+
+		const Stats& GetStats() { return stats_; }
+	};
+
+	//*******************************************************************
+	//DxTextLayoutCache
+	//Finished text layouts, keyed by everything GetTextInfo reads from the DxText
+	//*******************************************************************
+	class DxTextLayoutKey {
+		friend DxTextLayoutCache;
+	private:
+		std::wstring text_;
+		DxFont font_;
+		float sidePitch_;
+		float linePitch_;
+		LONG widthMax_;
+		LONG heightMax_;
+		DxRect<LONG> margin_;
+		bool bSyntacticAnalysis_;
+		size_t hash_;
+	public:
+		DxTextLayoutKey(DxText* dxText);
+
+		bool operator==(const DxTextLayoutKey& key) const;
+	};
+	class DxTextLayoutCache {
+	public:
+		enum : size_t {
+			MAX = 2048U,
+		};
+
+		struct Stats {
+			size_t countHit = 0;
+			size_t countMiss = 0;
+			double timeLayout = 0;		//In milliseconds, spent laying out the missed texts
+		};
+	private:
+		struct KeyHash {
+			size_t operator()(const DxTextLayoutKey& key) const { return key.hash_; }
+		};
+
+		std::unordered_map<DxTextLayoutKey, shared_ptr<DxTextInfo>, KeyHash> mapCache_;
+		Stats stats_;
+	public:
+		DxTextLayoutCache() {}
+
+		void Clear() { mapCache_.clear(); }
+		size_t GetCacheCount() { return mapCache_.size(); }
+
+		shared_ptr<DxTextInfo> Get(const DxTextLayoutKey& key);
+		void Add(const DxTextLayoutKey& key, shared_ptr<DxTextInfo> value);
+		void AddLayoutTime(double time) { stats_.timeLayout += time; }
+
+		const Stats& GetStats() { return stats_; }
+	};
+
 	//*******************************************************************
 	//DxTextScanner
 	//*******************************************************************
@@ -357,15 +456,35 @@ namespace directx {
 
 	class DxTextRenderer {
 		static DxTextRenderer* thisBase_;
+	protected:
+		//Measures characters through the metrics cache, the DC and the GDI font are only set up on a miss
+		class TextMeasure {
+			DxGlyphMetricsCache* cache_;
+			LOGFONT info_;
+			shared_ptr<DxGlyphMetricsCache::Table> table_;
+
+			HDC hDC_;
+			HFONT hFontOld_;
+			HFONT hFont_;
+		public:
+			TextMeasure(DxGlyphMetricsCache* cache, const LOGFONT& font);
+			~TextMeasure();
+
+			void SetFont(const LOGFONT& font);
+			SIZE GetCharSize(UINT code);
+			SIZE GetTextSize(const std::wstring& text);
+		};
 	protected:
 		DxCharCache cache_;
+		DxGlyphMetricsCache cacheMetrics_;
+		DxTextLayoutCache cacheLayout_;
 		gstd::Font winFont_;
 		D3DCOLOR colorVertex_;
 		gstd::CriticalSection lock_;
 
-		SIZE _GetTextSize(HDC hDC, wchar_t* pText);
 		shared_ptr<DxTextLine> _GetTextInfoSub(const std::wstring& text, DxText* dxText, DxTextInfo* textInfo,
-			shared_ptr<DxTextLine> textLine, HDC& hDC, LONG& totalWidth, LONG& totalHeight);
+			shared_ptr<DxTextLine> textLine, TextMeasure& measure, LONG& totalWidth, LONG& totalHeight);
+		shared_ptr<DxTextInfo> _CreateTextInfo(DxText* dxText);
 		void _CreateRenderObject(shared_ptr<DxTextRenderObject> objRender, DxText* pDxText, 
 			const POINT& pos, DxFont dxFont, shared_ptr<DxTextLine> textLine);
 		std::wstring _ReplaceRenderText(std::wstring text);
@@ -377,9 +496,14 @@ namespace directx {
 		bool Initialize();
 		gstd::CriticalSection& GetLock() { return lock_; }
 
-		void ClearCache() { cache_.Clear(); }
+		void ClearCache() {
+			cache_.Clear();
+			cacheMetrics_.Clear();
+			cacheLayout_.Clear();
+		}
 		void SetFont(LOGFONT& logFont) { winFont_.CreateFontIndirect(logFont); }
 		void SetVertexColor(D3DCOLOR color) { colorVertex_ = color; }
+		//The returned layout may be shared with other texts and must not be modified
 		shared_ptr<DxTextInfo> GetTextInfo(DxText* dxText);
 
 		shared_ptr<DxTextRenderObject> CreateRenderObject(DxText* dxText, shared_ptr<DxTextInfo> textInfo);
@@ -388,6 +512,8 @@ namespace directx {
 		void Render(DxText* dxText, shared_ptr<DxTextInfo> textInfo);
 
 		size_t GetCacheCount() { return cache_.GetCacheCount(); }
+		const DxGlyphMetricsCache::Stats& GetGlyphMetricsStats() { return cacheMetrics_.GetStats(); }
+		const DxTextLayoutCache::Stats& GetLayoutCacheStats() { return cacheLayout_.GetStats(); }
 
 		bool AddFontFromFile(const std::wstring& path);
 	};
@@ -86,6 +86,20 @@ namespace directx {
 		MatrixArray,	//4x4 matrix array
 		Texture,		//IDirect3DTexture9* object
 	};
+	enum class ShaderSemantic : uint8_t {
+		World,				//WORLD
+		View,				//VIEW
+		Projection,			//PROJECTION
+		ViewProjection,		//VIEWPROJECTION
+		WorldViewProj,		//WORLDVIEWPROJ
+		IColor,				//ICOLOR
+		FogEnable,			//FOGENABLE
+		FogColor,			//FOGCOLOR
+		FogDist,			//FOGDIST
+		Texture,			//TEXTURE
+
+		Count,
+	};
 
 	//*******************************************************************
 	//DxObject
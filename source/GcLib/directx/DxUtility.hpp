@@ -136,17 +136,43 @@ namespace directx {
 	};
 
 	class DxIntersect {
+	public:
+		enum : size_t {
+			//Regular polygons with more sides than this build their vertices on the heap
+			MAX_STACK_POLYGON_VERTEX = 64,
+		};
+
+		//Structure-of-arrays input of the batched tests, a stride of 0 repeats element 0 for every pair
+		struct CircleArray {
+			const float* x;
+			const float* y;
+			const float* r;
+			size_t stride;
+		};
+		struct WidthLineArray {
+			const float* x1;
+			const float* y1;
+			const float* x2;
+			const float* y2;
+			const float* w;
+			size_t stride;
+		};
 	public:
 		static inline DxWidthLine _LineW_From_Line(const DxLine* line) {
 			return DxWidthLine(line->GetX1(), line->GetY1(), line->GetX2(), line->GetY2(), 1.0f);
 		}
-		static std::vector<DxPoint> _Polygon_From_LineW(const DxWidthLine* line);
+		//Writes the outline of the line into dest, returns the vertex count (2 for thin lines, 4 otherwise)
+		static size_t _Polygon_From_LineW(const DxWidthLine* line, DxPoint(&dest)[4]);
+		static void _Polygon_From_RegularPolygon(const DxRegularPolygon* polygon, DxPoint* dest);
 
 		static size_t SplitWidthLine(DxLine* dest, const DxWidthLine* src, float mulWidth = 1.0f, bool bForceDouble = false);
 
 		//----------------------------------------------------------------
 
-		static bool Point_Polygon(const DxPoint* pos, const std::vector<DxPoint>* verts);
+		static bool Point_Polygon(const DxPoint* pos, const DxPoint* verts, size_t countVert);
+		static bool Point_Polygon(const DxPoint* pos, const std::vector<DxPoint>* verts) {
+			return Point_Polygon(pos, verts->data(), verts->size());
+		}
 		static bool Point_Circle(const DxPoint* pos, const DxCircle* circle);
 		static bool Point_Ellipse(const DxPoint* pos, const DxEllipse* ellipse);
 		static bool Point_Line(const DxPoint* pos, const DxLine* line);
@@ -174,12 +200,35 @@ namespace directx {
 		static bool LineW_LineW(const DxWidthLine* line1, const DxWidthLine* line2);
 		static bool LineW_RegularPolygon(const DxWidthLine* line, const DxRegularPolygon* polygon);
 
-		static bool Polygon_Polygon(const std::vector<DxPoint>* verts1, const std::vector<DxPoint>* verts2);
-		static bool Polygon_Circle(const std::vector<DxPoint>* verts, const DxCircle* circle);
-		static bool Polygon_Ellipse(const std::vector<DxPoint>* verts, const DxEllipse* ellipse);
-		static bool Polygon_Line(const std::vector<DxPoint>* verts, const DxLine* line);
+		static bool Polygon_Polygon(const DxPoint* verts1, size_t countVert1, const DxPoint* verts2, size_t countVert2);
+		static bool Polygon_Polygon(const std::vector<DxPoint>* verts1, const std::vector<DxPoint>* verts2) {
+			return Polygon_Polygon(verts1->data(), verts1->size(), verts2->data(), verts2->size());
+		}
+		static bool Polygon_Circle(const DxPoint* verts, size_t countVert, const DxCircle* circle);
+		static bool Polygon_Circle(const std::vector<DxPoint>* verts, const DxCircle* circle) {
+			return Polygon_Circle(verts->data(), verts->size(), circle);
+		}
+		static bool Polygon_Ellipse(const DxPoint* verts, size_t countVert, const DxEllipse* ellipse);
+		static bool Polygon_Ellipse(const std::vector<DxPoint>* verts, const DxEllipse* ellipse) {
+			return Polygon_Ellipse(verts->data(), verts->size(), ellipse);
+		}
+		static bool Polygon_Line(const DxPoint* verts, size_t countVert, const DxLine* line);
+		static bool Polygon_Line(const std::vector<DxPoint>* verts, const DxLine* line) {
+			return Polygon_Line(verts->data(), verts->size(), line);
+		}
 		static bool Polygon_LineW(const std::vector<DxPoint>* verts, const DxWidthLine* line);
-		static bool Polygon_RegularPolygon(const std::vector<DxPoint>* verts, const DxRegularPolygon* polygon);
+		static bool Polygon_RegularPolygon(const DxPoint* verts, size_t countVert, const DxRegularPolygon* polygon);
+		static bool Polygon_RegularPolygon(const std::vector<DxPoint>* verts, const DxRegularPolygon* polygon) {
+			return Polygon_RegularPolygon(verts->data(), verts->size(), polygon);
+		}
+
+		//----------------------------------------------------------------
+
+		//Batched tests, res[i] is set to the result of Circle_Circle/Circle_LineW on pair i
+		static void Circle_Circle_Batch(size_t count, const CircleArray& circle1, const CircleArray& circle2, bool* res);
+		static void Circle_Circle_Batch(const DxCircle* circle1, size_t count, const CircleArray& circle2, bool* res);
+		static void Circle_LineW_Batch(size_t count, const CircleArray& circle, const WidthLineArray& line, bool* res);
+		static void Circle_LineW_Batch(const DxCircle* circle, size_t count, const WidthLineArray& line, bool* res);
 	};
 #endif
 }
\ No newline at end of file
@@ -12,24 +12,38 @@ using namespace directx;
 //*******************************************************************
 //DxIntersect
 //*******************************************************************
-std::vector<DxPoint> DxIntersect::_Polygon_From_LineW(const DxWidthLine* line) {
-	std::vector<DxPoint> verts;
+size_t DxIntersect::_Polygon_From_LineW(const DxWidthLine* line, DxPoint(&dest)[4]) {
 	if (abs(line->GetWidth()) < 1.0f) {
-		verts.resize(2);
-		verts[0] = DxPoint(line->GetX1(), line->GetY1());
-		verts[1] = DxPoint(line->GetX2(), line->GetY2());
+		dest[0] = DxPoint(line->GetX1(), line->GetY1());
+		dest[1] = DxPoint(line->GetX2(), line->GetY2());
+		return 2U;
 	}
-	else {
-		DxLine splitLine[2];
-		SplitWidthLine(splitLine, line);
 
-		verts.resize(4);
-		verts[0] = DxPoint(splitLine[0].GetX1(), splitLine[0].GetY1());
-		verts[1] = DxPoint(splitLine[0].GetX2(), splitLine[0].GetY2());
-		verts[2] = DxPoint(splitLine[1].GetX2(), splitLine[1].GetY2());
-		verts[3] = DxPoint(splitLine[1].GetX1(), splitLine[1].GetY1());
+	DxLine splitLine[2];
+	if (SplitWidthLine(splitLine, line) < 2U) {
+		//Zero-length line, SplitWidthLine leaves splitLine untouched
+		dest[0] = DxPoint(line->GetX1(), line->GetY1());
+		dest[1] = DxPoint(line->GetX2(), line->GetY2());
+		return 2U;
+	}
+
+	dest[0] = DxPoint(splitLine[0].GetX1(), splitLine[0].GetY1());
+	dest[1] = DxPoint(splitLine[0].GetX2(), splitLine[0].GetY2());
+	dest[2] = DxPoint(splitLine[1].GetX2(), splitLine[1].GetY2());
+	dest[3] = DxPoint(splitLine[1].GetX1(), splitLine[1].GetY1());
+	return 4U;
+}
+void DxIntersect::_Polygon_From_RegularPolygon(const DxRegularPolygon* polygon, DxPoint* dest) {
+	float pr = polygon->GetR();
+	size_t ps = polygon->GetSide();
+	float pa = polygon->GetAngle();
+
+	float f = GM_PI_X2 / ps;
+	for (size_t i = 0; i < ps; i++, pa += f) {
+		float p_sx = polygon->GetX() + pr * cosf(pa);
+		float p_sy = polygon->GetY() + pr * sinf(pa);
+		dest[i] = DxPoint(p_sx, p_sy);
 	}
-	return verts;
 }
 size_t DxIntersect::SplitWidthLine(DxLine* dest, const DxWidthLine* pSrcLine, float mulWidth, bool bForceDouble) {
 	float dx = pSrcLine->GetX2() - pSrcLine->GetX1();
@@ -42,7 +56,7 @@ size_t DxIntersect::SplitWidthLine(DxLine* dest, const DxWidthLine* pSrcLine, fl
 
 	if (abs(width) <= 1.0f) {
 		if (!bForceDouble) {
-			dest[0] = *(dynamic_cast<const DxLine*>(pSrcLine));
+			dest[0] = *static_cast<const DxLine*>(pSrcLine);
 			return 1U;
 		}
 		else width = 1.0f;
@@ -64,14 +78,13 @@ size_t DxIntersect::SplitWidthLine(DxLine* dest, const DxWidthLine* pSrcLine, fl
 
 //---------------------------------------------------------------------------------------------------------
 
-bool DxIntersect::Point_Polygon(const DxPoint* pos, const std::vector<DxPoint>* verts) {
-	if (verts->size() < 2) return false;
+bool DxIntersect::Point_Polygon(const DxPoint* pos, const DxPoint* verts, size_t nVert) {
+	if (nVert < 2) return false;
 
 	//https://wrf.ecse.rpi.edu/Research/Short_Notes/pnpoly.html
 
 	float px = pos->GetX();
 	float py = pos->GetY();
-	size_t nVert = verts->size();
 
 	{
 		float minX = FLT_MAX;
@@ -79,10 +92,10 @@ bool DxIntersect::Point_Polygon(const DxPoint* pos, const std::vector<DxPoint>*
 		float minY = FLT_MAX;
 		float maxY = FLT_MIN;
 		for (size_t i = 0; i < nVert; ++i) {
-			minX = std::min(minX, (*verts)[i].GetX());
-			maxX = std::max(maxX, (*verts)[i].GetX());
-			minY = std::min(minY, (*verts)[i].GetY());
-			maxY = std::max(maxY, (*verts)[i].GetY());
+			minX = std::min(minX, verts[i].GetX());
+			maxX = std::max(maxX, verts[i].GetX());
+			minY = std::min(minY, verts[i].GetY());
+			maxY = std::max(maxY, verts[i].GetY());
 		}
 
 		//First, check against the bounding box
@@ -95,10 +108,10 @@ bool DxIntersect::Point_Polygon(const DxPoint* pos, const std::vector<DxPoint>*
 	for (size_t i = 0; i < nVert; ++i) {
 		size_t j = (i + 1) % nVert;
 
-		float p1x = (*verts)[i].GetX();
-		float p1y = (*verts)[i].GetY();
-		float p2x = (*verts)[j].GetX();
-		float p2y = (*verts)[j].GetY();
+		float p1x = verts[i].GetX();
+		float p1y = verts[i].GetY();
+		float p2x = verts[j].GetX();
+		float p2y = verts[j].GetY();
 
 		if ((p1y > py) != (p2y > py)) {
 			if (px < ((p2x - p1x) * (py - p1y) / (p2y - p1y) + p1x))
@@ -164,10 +177,11 @@ bool DxIntersect::Point_Line(const DxPoint* pos, const DxLine* line) {
 }
 bool DxIntersect::Point_LineW(const DxPoint* pos, const DxWidthLine* line) {
 	if (abs(line->GetWidth()) <= 1.0f) {
-		return Point_Line(pos, dynamic_cast<const DxLine*>(line));
+		return Point_Line(pos, line);
 	}
-	std::vector<DxPoint> verts = _Polygon_From_LineW(line);
-	return Point_Polygon(pos, &verts);
+	DxPoint verts[4];
+	size_t countVert = _Polygon_From_LineW(line, verts);
+	return Point_Polygon(pos, verts, countVert);
 }
 bool DxIntersect::Point_RegularPolygon(const DxPoint* pos, const DxRegularPolygon* polygon) {
 	Math::DVec2 cpos{ pos->GetX(), pos->GetY() };
@@ -474,7 +488,7 @@ bool DxIntersect::Circle_RegularPolygon(const DxCircle* circle, const DxRegularP
 		return false;
 	}
 	else {
-		return Point_RegularPolygon(dynamic_cast<const DxPoint*>(circle), polygon);
+		return Point_RegularPolygon(circle, polygon);
 	}
 }
 
@@ -543,42 +557,42 @@ bool DxIntersect::Line_Line(const DxLine* line1, const DxLine* line2) {
 	}
 }
 bool DxIntersect::Line_LineW(const DxLine* line1, const DxWidthLine* line2) {
-	std::vector<DxPoint> verts2 = _Polygon_From_LineW(line2);
-	return Polygon_Line(&verts2, line1);
+	DxPoint verts2[4];
+	size_t countVert2 = _Polygon_From_LineW(line2, verts2);
+	return Polygon_Line(verts2, countVert2, line1);
 }
 bool DxIntersect::Line_RegularPolygon(const DxLine* line, const DxRegularPolygon* polygon) {
-	float pr = polygon->GetR();
 	size_t ps = polygon->GetSide();
-	float pa = polygon->GetAngle();
-
-	std::vector<DxPoint> tmpVerts;
-	tmpVerts.resize(ps);
-
-	float f = GM_PI_X2 / ps;
-	for (size_t i = 0; i < ps; i++, pa += f) {
-		float p_sx = polygon->GetX() + pr * cosf(pa);
-		float p_sy = polygon->GetY() + pr * sinf(pa);
-		tmpVerts[i] = DxPoint(p_sx, p_sy);
+	if (ps > MAX_STACK_POLYGON_VERTEX) {
+		std::vector<DxPoint> tmpVerts(ps);
+		_Polygon_From_RegularPolygon(polygon, tmpVerts.data());
+		return Polygon_Line(tmpVerts.data(), ps, line);
 	}
 
-	return Line_Polygon(line, &tmpVerts);
+	DxPoint tmpVerts[MAX_STACK_POLYGON_VERTEX];
+	_Polygon_From_RegularPolygon(polygon, tmpVerts);
+	return Polygon_Line(tmpVerts, ps, line);
 }
 
 bool DxIntersect::LineW_Polygon(const DxWidthLine* line, const std::vector<DxPoint>* verts) {
-	std::vector<DxPoint> verts2 = _Polygon_From_LineW(line);
-	return Polygon_Polygon(&verts2, verts);
+	DxPoint verts2[4];
+	size_t countVert2 = _Polygon_From_LineW(line, verts2);
+	return Polygon_Polygon(verts2, countVert2, verts->data(), verts->size());
 }
 bool DxIntersect::LineW_Circle(const DxWidthLine* line, const DxCircle* circle) {
-	std::vector<DxPoint> verts = _Polygon_From_LineW(line);
-	return Polygon_Circle(&verts, circle);
+	DxPoint verts[4];
+	size_t countVert = _Polygon_From_LineW(line, verts);
+	return Polygon_Circle(verts, countVert, circle);
 }
 bool DxIntersect::LineW_Ellipse(const DxWidthLine* line, const DxEllipse* ellipse) {
-	std::vector<DxPoint> verts = _Polygon_From_LineW(line);
-	return Polygon_Ellipse(&verts, ellipse);
+	DxPoint verts[4];
+	size_t countVert = _Polygon_From_LineW(line, verts);
+	return Polygon_Ellipse(verts, countVert, ellipse);
 }
 bool DxIntersect::LineW_Line(const DxWidthLine* line1, const DxLine* line2) {
-	std::vector<DxPoint> verts = _Polygon_From_LineW(line1);
-	return Polygon_Line(&verts, line2);
+	DxPoint verts[4];
+	size_t countVert = _Polygon_From_LineW(line1, verts);
+	return Polygon_Line(verts, countVert, line2);
 }
 bool DxIntersect::LineW_LineW(const DxWidthLine* line1, const DxWidthLine* line2) {
 	float wd1 = line1->GetWidth();
@@ -586,41 +600,42 @@ bool DxIntersect::LineW_LineW(const DxWidthLine* line1, const DxWidthLine* line2
 	bool bValid1 = abs(wd1) > 1.0f;
 	bool bValid2 = abs(wd2) > 1.0f;
 	if (bValid1 && bValid2) {
-		std::vector<DxPoint> verts1 = _Polygon_From_LineW(line1);
-		std::vector<DxPoint> verts2 = _Polygon_From_LineW(line2);
-		return Polygon_Polygon(&verts1, &verts2);
+		DxPoint verts1[4];
+		DxPoint verts2[4];
+		size_t countVert1 = _Polygon_From_LineW(line1, verts1);
+		size_t countVert2 = _Polygon_From_LineW(line2, verts2);
+		return Polygon_Polygon(verts1, countVert1, verts2, countVert2);
 	}
 	else if (bValid1) {		//line2 is a simple DxLine
-		return LineW_Line(line1, dynamic_cast<const DxLine*>(line2));
+		return LineW_Line(line1, line2);
 	}
 	else if (bValid2) {		//line1 is a simple DxLine
-		return LineW_Line(line2, dynamic_cast<const DxLine*>(line1));
+		return LineW_Line(line2, line1);
 	}
 	else {	//Both are simple DxLines
-		return Line_Line(dynamic_cast<const DxLine*>(line1), 
-			dynamic_cast<const DxLine*>(line2));
+		return Line_Line(line1, line2);
 	}
 	return false;
 }
 bool DxIntersect::LineW_RegularPolygon(const DxWidthLine* line, const DxRegularPolygon* polygon) {
-	std::vector<DxPoint> verts = _Polygon_From_LineW(line);
-	return Polygon_RegularPolygon(&verts, polygon);
+	DxPoint verts[4];
+	size_t countVert = _Polygon_From_LineW(line, verts);
+	return Polygon_RegularPolygon(verts, countVert, polygon);
 }
 
-bool DxIntersect::Polygon_Polygon(const std::vector<DxPoint>* verts1, const std::vector<DxPoint>* verts2) {
-	size_t vertCount1 = verts1->size();
-	size_t vertCount2 = verts2->size();
+bool DxIntersect::Polygon_Polygon(const DxPoint* verts1, size_t vertCount1, const DxPoint* verts2, size_t vertCount2) {
 	if (vertCount1 < 2 || vertCount2 < 2)
 		return false;
 
-	const std::vector<DxPoint>* listPolygon[2] = { verts1, verts2 };
+	const DxPoint* listPolygon[2] = { verts1, verts2 };
+	const size_t listVertCount[2] = { vertCount1, vertCount2 };
 	for (size_t iPoly = 0U; iPoly < 2; ++iPoly) {
-		const std::vector<DxPoint>* pPolygon = listPolygon[iPoly];
-		size_t countVert = pPolygon->size();
+		const DxPoint* pPolygon = listPolygon[iPoly];
+		size_t countVert = listVertCount[iPoly];
 
 		for (size_t iPoint = 0U; iPoint < countVert; ++iPoint) {
-			const DxPoint* p1 = &pPolygon->at(iPoint);
-			const DxPoint* p2 = &pPolygon->at((iPoint + 1) % countVert);
+			const DxPoint* p1 = &pPolygon[iPoint];
+			const DxPoint* p2 = &pPolygon[(iPoint + 1) % countVert];
 
 			float dx = p1->GetX() - p2->GetX();
 			float dy = p2->GetY() - p1->GetY();
@@ -628,12 +643,12 @@ bool DxIntersect::Polygon_Polygon(const std::vector<DxPoint>* verts1, const std:
 			float minA = FLT_MAX, maxA = FLT_MIN;
 			float minB = FLT_MAX, maxB = FLT_MIN;
 			for (size_t iPA = 0U; iPA < vertCount1; ++iPA) {
-				float proj = dy * verts1->at(iPA).GetX() + dx * verts1->at(iPA).GetY();
+				float proj = dy * verts1[iPA].GetX() + dx * verts1[iPA].GetY();
 				minA = std::min(minA, proj);
 				maxA = std::max(maxA, proj);
 			}
 			for (size_t iPB = 0U; iPB < vertCount2; ++iPB) {
-				float proj = dy * verts2->at(iPB).GetX() + dx * verts2->at(iPB).GetY();
+				float proj = dy * verts2[iPB].GetX() + dx * verts2[iPB].GetY();
 				minB = std::min(minB, proj);
 				maxB = std::max(maxB, proj);
 			}
@@ -643,78 +658,195 @@ bool DxIntersect::Polygon_Polygon(const std::vector<DxPoint>* verts1, const std:
 	}
 	return true;
 }
-bool DxIntersect::Polygon_Circle(const std::vector<DxPoint>* verts, const DxCircle* circle) {
-	if (verts->size() < 2) return false;
+bool DxIntersect::Polygon_Circle(const DxPoint* verts, size_t countVert, const DxCircle* circle) {
+	if (countVert < 2) return false;
 
 	//Check if circle center is inside the polygon
-	if (Point_Polygon(dynamic_cast<const DxPoint*>(circle), verts))
+	if (Point_Polygon(circle, verts, countVert))
 		return true;
 
-	for (size_t i = 0; i < verts->size(); ++i) {
-		size_t j = (i + 1) % verts->size();
+	for (size_t i = 0; i < countVert; ++i) {
+		size_t j = (i + 1) % countVert;
 
-		DxLine tmpLine((*verts)[i].GetX(), (*verts)[i].GetY(), (*verts)[j].GetX(), (*verts)[j].GetY());
+		DxLine tmpLine(verts[i].GetX(), verts[i].GetY(), verts[j].GetX(), verts[j].GetY());
 		if (Line_Circle(&tmpLine, circle))
 			return true;
 	}
 	return false;
 }
-bool DxIntersect::Polygon_Ellipse(const std::vector<DxPoint>* verts, const DxEllipse* ellipse) {
-	if (verts->size() < 2) return false;
+bool DxIntersect::Polygon_Ellipse(const DxPoint* verts, size_t countVert, const DxEllipse* ellipse) {
+	if (countVert < 2) return false;
 
 	//Check if ellipse center is inside the polygon
-	if (Point_Polygon(dynamic_cast<const DxPoint*>(ellipse), verts))
+	if (Point_Polygon(ellipse, verts, countVert))
 		return true;
 
-	for (size_t i = 0; i < verts->size(); ++i) {
-		size_t j = (i + 1) % verts->size();
+	for (size_t i = 0; i < countVert; ++i) {
+		size_t j = (i + 1) % countVert;
 
-		DxLine tmpLine((*verts)[i].GetX(), (*verts)[i].GetY(), (*verts)[j].GetX(), (*verts)[j].GetY());
+		DxLine tmpLine(verts[i].GetX(), verts[i].GetY(), verts[j].GetX(), verts[j].GetY());
 		if (Line_Ellipse(&tmpLine, ellipse))
 			return true;
 	}
 	return false;
 }
-bool DxIntersect::Polygon_Line(const std::vector<DxPoint>* verts, const DxLine* line) {
-	if (verts->size() < 2) return false;
+bool DxIntersect::Polygon_Line(const DxPoint* verts, size_t countVert, const DxLine* line) {
+	if (countVert < 2) return false;
 
 	//Check if either of the line terminals are inside the polygon
 	DxPoint tmpPoint = DxPoint(line->GetX1(), line->GetY1());
-	if (Point_Polygon(&tmpPoint, verts))
+	if (Point_Polygon(&tmpPoint, verts, countVert))
 		return true;
 	tmpPoint = DxPoint(line->GetX2(), line->GetY2());
-	if (Point_Polygon(&tmpPoint, verts))
+	if (Point_Polygon(&tmpPoint, verts, countVert))
 		return true;
 
-	for (size_t i = 0; i < verts->size(); ++i) {
-		size_t j = (i + 1) % verts->size();
+	for (size_t i = 0; i < countVert; ++i) {
+		size_t j = (i + 1) % countVert;
 
-		DxLine tmpLine((*verts)[i].GetX(), (*verts)[i].GetY(), (*verts)[j].GetX(), (*verts)[j].GetY());
+		DxLine tmpLine(verts[i].GetX(), verts[i].GetY(), verts[j].GetX(), verts[j].GetY());
 		if (Line_Line(line, &tmpLine))
 			return true;
 	}
 	return false;
 }
 bool DxIntersect::Polygon_LineW(const std::vector<DxPoint>* verts, const DxWidthLine* line) {
-	std::vector<DxPoint> verts2 = _Polygon_From_LineW(line);
-	return Polygon_Polygon(&verts2, verts);
+	DxPoint verts2[4];
+	size_t countVert2 = _Polygon_From_LineW(line, verts2);
+	return Polygon_Polygon(verts2, countVert2, verts->data(), verts->size());
 }
-bool DxIntersect::Polygon_RegularPolygon(const std::vector<DxPoint>* verts, const DxRegularPolygon* polygon) {
-	float pr = polygon->GetR();
+bool DxIntersect::Polygon_RegularPolygon(const DxPoint* verts, size_t countVert, const DxRegularPolygon* polygon) {
 	size_t ps = polygon->GetSide();
-	float pa = polygon->GetAngle();
+	if (ps > MAX_STACK_POLYGON_VERTEX) {
+		std::vector<DxPoint> tmpVerts(ps);
+		_Polygon_From_RegularPolygon(polygon, tmpVerts.data());
+		return Polygon_Polygon(verts, countVert, tmpVerts.data(), ps);
+	}
 
-	std::vector<DxPoint> tmpVerts;
-	tmpVerts.resize(ps);
+	DxPoint tmpVerts[MAX_STACK_POLYGON_VERTEX];
+	_Polygon_From_RegularPolygon(polygon, tmpVerts);
+	return Polygon_Polygon(verts, countVert, tmpVerts, ps);
+}
 
-	float f = GM_PI_X2 / ps;
-	for (size_t i = 0; i < ps; i++, pa += f) {
-		float p_sx = polygon->GetX() + pr * cosf(pa);
-		float p_sy = polygon->GetY() + pr * sinf(pa);
-		tmpVerts[i] = DxPoint(p_sx, p_sy);
-	}
+//---------------------------------------------------------------------------------------------------------
 
-	return Polygon_Polygon(verts, &tmpVerts);
+void DxIntersect::Circle_Circle_Batch(size_t count, const CircleArray& circle1, const CircleArray& circle2, bool* res) {
+	size_t i = 0;
+#ifdef __L_MATH_VECTORIZE
+	auto _Load = [](const float* ptr, size_t index, size_t stride) {
+		return stride ? _mm_loadu_ps(ptr + index) : _mm_set1_ps(*ptr);
+	};
+	for (; i + 4 <= count; i += 4) {
+		__m128 dx = _mm_sub_ps(_Load(circle1.x, i, circle1.stride), _Load(circle2.x, i, circle2.stride));
+		__m128 dy = _mm_sub_ps(_Load(circle1.y, i, circle1.stride), _Load(circle2.y, i, circle2.stride));
+		__m128 rr = _mm_add_ps(_Load(circle1.r, i, circle1.stride), _Load(circle2.r, i, circle2.stride));
+
+		__m128 dd = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		int mask = _mm_movemask_ps(_mm_cmple_ps(dd, _mm_mul_ps(rr, rr)));
+
+		for (size_t j = 0; j < 4; ++j)
+			res[i + j] = (mask >> j) & 1;
+	}
+#endif
+	for (; i < count; ++i) {
+		size_t i1 = i * circle1.stride;
+		size_t i2 = i * circle2.stride;
+		DxCircle c1(circle1.x[i1], circle1.y[i1], circle1.r[i1]);
+		DxCircle c2(circle2.x[i2], circle2.y[i2], circle2.r[i2]);
+		res[i] = Circle_Circle(&c1, &c2);
+	}
+}
+void DxIntersect::Circle_Circle_Batch(const DxCircle* circle1, size_t count, const CircleArray& circle2, bool* res) {
+	float x = circle1->GetX();
+	float y = circle1->GetY();
+	float r = circle1->GetR();
+	Circle_Circle_Batch(count, CircleArray{ &x, &y, &r, 0 }, circle2, res);
+}
+void DxIntersect::Circle_LineW_Batch(size_t count, const CircleArray& circle, const WidthLineArray& line, bool* res) {
+	size_t i = 0;
+#ifdef __L_MATH_VECTORIZE
+	//Lane-wise version of Circle_LineW, each region's test is computed for all lanes and masked together
+	auto _Load = [](const float* ptr, size_t index, size_t stride) {
+		return stride ? _mm_loadu_ps(ptr + index) : _mm_set1_ps(*ptr);
+	};
+	const __m128 vHalf = _mm_set1_ps(0.5f);
+	const __m128 vTwo = _mm_set1_ps(2.0f);
+	const __m128 vAbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	for (; i + 4 <= count; i += 4) {
+		__m128 cx = _Load(circle.x, i, circle.stride);
+		__m128 cy = _Load(circle.y, i, circle.stride);
+		__m128 cr = _Load(circle.r, i, circle.stride);
+		__m128 x1 = _Load(line.x1, i, line.stride);
+		__m128 y1 = _Load(line.y1, i, line.stride);
+		__m128 x2 = _Load(line.x2, i, line.stride);
+		__m128 y2 = _Load(line.y2, i, line.stride);
+		__m128 lw = _Load(line.w, i, line.stride);
+
+		__m128 rr = _mm_mul_ps(cr, cr);
+		__m128 cen_x = _mm_mul_ps(_mm_add_ps(x1, x2), vHalf);
+		__m128 cen_y = _mm_mul_ps(_mm_add_ps(y1, y2), vHalf);
+		__m128 dx = _mm_sub_ps(x2, x1);
+		__m128 dy = _mm_sub_ps(y2, y1);
+		__m128 line_h = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+
+		__m128 rcos = _mm_div_ps(dx, line_h);
+		__m128 rsin = _mm_div_ps(dy, line_h);
+
+		__m128 ucx = _mm_sub_ps(cen_x, cx);
+		__m128 ucy = _mm_sub_ps(cen_y, cy);
+		__m128 cross_x = _mm_mul_ps(_mm_and_ps(
+			_mm_sub_ps(_mm_mul_ps(rcos, ucy), _mm_mul_ps(rsin, ucx)), vAbsMask), vTwo);
+		__m128 cross_y = _mm_mul_ps(_mm_and_ps(
+			_mm_add_ps(_mm_mul_ps(rsin, ucy), _mm_mul_ps(rcos, ucx)), vAbsMask), vTwo);
+
+		__m128 intersect_w = _mm_cmple_ps(cross_x, lw);
+		__m128 intersect_h = _mm_cmple_ps(cross_y, line_h);
+
+		//Center inside the rectangle, or inside the side regions
+		__m128 r2 = _mm_mul_ps(cr, vTwo);
+		__m128 hitSide = _mm_or_ps(
+			_mm_and_ps(intersect_w, _mm_cmple_ps(cross_y, _mm_add_ps(line_h, r2))),
+			_mm_and_ps(intersect_h, _mm_cmple_ps(cross_x, _mm_add_ps(lw, r2))));
+
+		//Center inside the diagonal regions
+		__m128 l_uw = _mm_mul_ps(_mm_div_ps(lw, line_h), vHalf);
+		__m128 nx = _mm_mul_ps(dx, l_uw);
+		__m128 ny = _mm_mul_ps(dy, l_uw);
+		auto _CheckDist = [&](const __m128& tx, const __m128& ty) {
+			__m128 ddx = _mm_sub_ps(tx, cx);
+			__m128 ddy = _mm_sub_ps(ty, cy);
+			return _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(ddx, ddx), _mm_mul_ps(ddy, ddy)), rr);
+		};
+		__m128 hitCorner = _mm_or_ps(
+			_mm_or_ps(
+				_CheckDist(_mm_sub_ps(x1, ny), _mm_add_ps(y1, nx)),
+				_CheckDist(_mm_add_ps(x1, ny), _mm_sub_ps(y1, nx))),
+			_mm_or_ps(
+				_CheckDist(_mm_add_ps(x2, ny), _mm_sub_ps(y2, nx)),
+				_CheckDist(_mm_sub_ps(x2, ny), _mm_add_ps(y2, nx))));
+
+		__m128 inRegion = _mm_or_ps(intersect_w, intersect_h);
+		int mask = _mm_movemask_ps(_mm_or_ps(
+			_mm_and_ps(inRegion, hitSide),
+			_mm_andnot_ps(inRegion, hitCorner)));
+
+		for (size_t j = 0; j < 4; ++j)
+			res[i + j] = (mask >> j) & 1;
+	}
+#endif
+	for (; i < count; ++i) {
+		size_t ic = i * circle.stride;
+		size_t il = i * line.stride;
+		DxCircle c(circle.x[ic], circle.y[ic], circle.r[ic]);
+		DxWidthLine l(line.x1[il], line.y1[il], line.x2[il], line.y2[il], line.w[il]);
+		res[i] = Circle_LineW(&c, &l);
+	}
+}
+void DxIntersect::Circle_LineW_Batch(const DxCircle* circle, size_t count, const WidthLineArray& line, bool* res) {
+	float x = circle->GetX();
+	float y = circle->GetY();
+	float r = circle->GetR();
+	Circle_LineW_Batch(count, CircleArray{ &x, &y, &r, 0 }, line, res);
 }
 
 #endif
\ No newline at end of file
@@ -414,6 +414,80 @@ namespace directx {
 			"}"
 		"}";
 
+	//*******************************************************************
+	//ShaderSemanticBinding
+	//*******************************************************************
+	const char* const ShaderSemanticBinding::SEMANTIC_NAMES[(size_t)ShaderSemantic::Count] = {
+		"WORLD", "VIEW", "PROJECTION", "VIEWPROJECTION", "WORLDVIEWPROJ",
+		"ICOLOR", "FOGENABLE", "FOGCOLOR", "FOGDIST", "TEXTURE",
+	};
+
+	ShaderSemanticBinding::ShaderSemanticBinding() {
+		Bind(nullptr);
+	}
+
+	void ShaderSemanticBinding::Bind(ID3DXEffect* effect) {
+		effect_ = effect;
+		for (size_t i = 0; i < listBlock_.size(); ++i) {
+			ConstantBlock& block = listBlock_[i];
+			block.handle = effect ? effect->GetParameterBySemantic(nullptr, SEMANTIC_NAMES[i]) : nullptr;
+			block.bValid = false;
+			block.size = 0;
+		}
+	}
+	void ShaderSemanticBinding::Invalidate() {
+		for (auto& block : listBlock_)
+			block.bValid = false;
+	}
+	void ShaderSemanticBinding::Invalidate(D3DXHANDLE handle) {
+		for (auto& block : listBlock_) {
+			if (block.handle == handle)
+				block.bValid = false;
+		}
+	}
+
+	bool ShaderSemanticBinding::IsBound(D3DXHANDLE handle) {
+		for (auto& block : listBlock_) {
+			if (block.handle == handle)
+				return true;
+		}
+		return false;
+	}
+
+	D3DXHANDLE ShaderSemanticBinding::_Update(ShaderSemantic semantic, const void* data, size_t size) {
+		ConstantBlock& block = listBlock_[(size_t)semantic];
+		if (block.handle == nullptr) return nullptr;
+
+		if (block.bValid && block.size == size && memcmp(block.value, data, size) == 0)
+			return nullptr;
+
+		memcpy(block.value, data, size);
+		block.size = size;
+		block.bValid = true;
+		return block.handle;
+	}
+	void ShaderSemanticBinding::SetMatrix(ShaderSemantic semantic, const D3DXMATRIX& value) {
+		if (D3DXHANDLE handle = _Update(semantic, &value, sizeof(D3DXMATRIX)))
+			effect_->SetMatrix(handle, &value);
+	}
+	void ShaderSemanticBinding::SetVector(ShaderSemantic semantic, const D3DXVECTOR4& value) {
+		if (D3DXHANDLE handle = _Update(semantic, &value, sizeof(D3DXVECTOR4)))
+			effect_->SetVector(handle, &value);
+	}
+	void ShaderSemanticBinding::SetBool(ShaderSemantic semantic, BOOL value) {
+		if (D3DXHANDLE handle = _Update(semantic, &value, sizeof(BOOL)))
+			effect_->SetBool(handle, value);
+	}
+	void ShaderSemanticBinding::SetFloatArray(ShaderSemantic semantic, const FLOAT* value, UINT count) {
+		count = std::min<UINT>(count, sizeof(D3DXMATRIX) / sizeof(FLOAT));
+		if (D3DXHANDLE handle = _Update(semantic, value, count * sizeof(FLOAT)))
+			effect_->SetFloatArray(handle, value, count);
+	}
+	void ShaderSemanticBinding::SetTexture(ShaderSemantic semantic, IDirect3DBaseTexture9* value) {
+		if (D3DXHANDLE handle = _Update(semantic, &value, sizeof(IDirect3DBaseTexture9*)))
+			effect_->SetTexture(handle, value);
+	}
+
 	//*******************************************************************
 	//RenderShaderLibrary
 	//*******************************************************************
@@ -459,6 +533,10 @@ namespace directx {
 				}
 			}
 		}
+		listBinding_.resize(listEffect_.size());
+		for (size_t iEff = 0U; iEff < listEffect_.size(); ++iEff)
+			listBinding_[iEff].Bind(listEffect_[iEff]);
+
 		if (listEffect_[0])
 			listEffect_[0]->SetTechnique("Render");
 
@@ -488,6 +566,8 @@ namespace directx {
 	void RenderShaderLibrary::Release() {
 		for (auto& iEffect : listEffect_)
 			ptr_release(iEffect);
+		for (auto& iBinding : listBinding_)
+			iBinding.Bind(nullptr);
 		for (auto& iDecl : listDeclaration_)
 			ptr_release(iDecl);
 	}
@@ -503,5 +583,7 @@ namespace directx {
 			if (iEffect)
 				iEffect->OnResetDevice();
 		}
+		for (auto& iBinding : listBinding_)
+			iBinding.Invalidate();
 	}
 }
\ No newline at end of file
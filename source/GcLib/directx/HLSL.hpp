@@ -26,6 +26,47 @@ namespace directx {
 		static const std::string sourceIntersectVisual2_;
 	};
 	
+	//*******************************************************************
+	//ShaderSemanticBinding
+	//*******************************************************************
+	//Engine-supplied effect parameters, resolved once by semantic when the effect is loaded.
+	//Values are kept in dirty-tracked constant blocks so unchanged values are never uploaded again.
+	class ShaderSemanticBinding {
+	public:
+		static const char* const SEMANTIC_NAMES[(size_t)ShaderSemantic::Count];
+	private:
+		struct ConstantBlock {
+			D3DXHANDLE handle;
+			bool bValid;
+			size_t size;
+			alignas(16) byte value[sizeof(D3DXMATRIX)];
+		};
+
+		ID3DXEffect* effect_;
+		std::array<ConstantBlock, (size_t)ShaderSemantic::Count> listBlock_;
+
+		D3DXHANDLE _Update(ShaderSemantic semantic, const void* data, size_t size);
+	public:
+		ShaderSemanticBinding();
+
+		void Bind(ID3DXEffect* effect);
+		void Invalidate();
+		void Invalidate(D3DXHANDLE handle);
+
+		ID3DXEffect* GetEffect() { return effect_; }
+		bool IsBound(ShaderSemantic semantic) { return listBlock_[(size_t)semantic].handle != nullptr; }
+		bool IsBound(D3DXHANDLE handle);
+
+		void SetMatrix(ShaderSemantic semantic, const D3DXMATRIX& value);
+		void SetVector(ShaderSemantic semantic, const D3DXVECTOR4& value);
+		void SetBool(ShaderSemantic semantic, BOOL value);
+		void SetFloatArray(ShaderSemantic semantic, const FLOAT* value, UINT count);
+		void SetTexture(ShaderSemantic semantic, IDirect3DBaseTexture9* value);
+	};
+
+	//*******************************************************************
+	//RenderShaderLibrary
+	//*******************************************************************
 	class RenderShaderLibrary {
 	public:
 		enum {
@@ -47,6 +88,10 @@ namespace directx {
 		ID3DXEffect* GetIntersectVisualShader1() { return listEffect_[3]; }
 		ID3DXEffect* GetIntersectVisualShader2() { return listEffect_[4]; }
 
+		ShaderSemanticBinding* GetRender2DBinding() { return &listBinding_[0]; }
+		ShaderSemanticBinding* GetInstancing2DBinding() { return &listBinding_[1]; }
+		ShaderSemanticBinding* GetInstancing3DBinding() { return &listBinding_[2]; }
+
 		IDirect3DVertexDeclaration9* GetVertexDeclarationTLX() { return listDeclaration_[0]; }
 		IDirect3DVertexDeclaration9* GetVertexDeclarationLX() { return listDeclaration_[1]; }
 		IDirect3DVertexDeclaration9* GetVertexDeclarationNX() { return listDeclaration_[2]; }
@@ -63,6 +108,7 @@ namespace directx {
 		 * 4 -> Intersection visualizer (line)
 		 */
 		std::vector<ID3DXEffect*> listEffect_;
+		std::vector<ShaderSemanticBinding> listBinding_;
 
 		/*
 		 * 0 -> TLX
@@ -12,19 +12,64 @@ using namespace directx;
 //*******************************************************************
 
 //MetasequoiaMeshData
+bool MetasequoiaMeshData::bCacheEnable_ = false;
+#ifdef _DEBUG
+bool MetasequoiaMeshData::bCacheValidate_ = true;
+#else
+bool MetasequoiaMeshData::bCacheValidate_ = false;
+#endif
 MetasequoiaMeshData::MetasequoiaMeshData() {}
 MetasequoiaMeshData::~MetasequoiaMeshData() {
+	_Clear();
+}
+void MetasequoiaMeshData::_Clear() {
 	for (auto& obj : renderList_) ptr_delete(obj);
 	for (auto& obj : materialList_) ptr_delete(obj);
+	renderList_.clear();
+	materialList_.clear();
 }
 bool MetasequoiaMeshData::CreateFromFileReader(shared_ptr<gstd::FileReader> reader) {
-	bool res = false;
 	path_ = reader->GetOriginalPath();
 	std::string text;
 	size_t size = reader->GetFileSize();
 	text.resize(size);
 	reader->Read(&text[0], size);
 
+	std::wstring pathCache;
+	if (bCacheEnable_) {
+		uint64_t hash = Hash::Fnv1a(text.data(), text.size());
+		pathCache = PathProperty::GetModuleDirectory() + StringUtility::Format(L"cache/mesh/%016llx.dat", hash);
+
+		if (_ReadCache(pathCache)) {
+			//The text is only parsed for comparison, it doesn't need textures or vertex buffers
+			bool bValid = true;
+			if (bCacheValidate_) {
+				MetasequoiaMeshData dataText;
+				dataText.path_ = path_;
+				bValid = dataText._ReadText(text) && _IsEqual(&dataText);
+			}
+			if (bValid) {
+				_CreateResource();
+				return true;
+			}
+
+			Logger::WriteTop(StringUtility::Format(L"MetasequoiaMeshData: Cached mesh doesn't match the source, "
+				"reparsing. [%s]", PathProperty::ReduceModuleDirectory(path_).c_str()));
+		}
+		_Clear();
+	}
+
+	bool res = _ReadText(text);
+	if (res) {
+		if (pathCache.size() > 0)
+			_WriteCache(pathCache);
+		_CreateResource();
+	}
+	return res;
+}
+bool MetasequoiaMeshData::_ReadText(const std::string& text) {
+	bool res = false;
+
 	gstd::Scanner scanner(text);
 	try {
 		while (scanner.HasNext()) {
@@ -111,10 +156,7 @@ void MetasequoiaMeshData::_ReadMaterial(gstd::Scanner& scanner) {
 			scanner.CheckType(scanner.Next(), Token::Type::TK_OPENP);
 			tok = scanner.Next();
 
-			std::wstring wPathTexture = tok.GetString();
-			std::wstring path = PathProperty::GetFileDirectory(path_) + wPathTexture;
-			mat->texture_ = std::make_shared<Texture>();
-			mat->texture_->CreateFromFile(PathProperty::GetUnique(path), false, false);
+			mat->pathTexture_ = tok.GetString();
 			scanner.CheckType(scanner.Next(), Token::Type::TK_CLOSEP);
 		}
 	}
@@ -419,24 +461,188 @@ void MetasequoiaMeshData::_ReadObject(gstd::Scanner& scanner) {
 				}
 			}
 		}
+	}
+}
+void MetasequoiaMeshData::_CreateResource() {
+	for (Material* mat : materialList_) {
+		if (mat->pathTexture_.size() > 0)
+			_LoadMaterialTexture(mat);
+	}
+	for (RenderObject* render : renderList_)
+		_CreateVertexBuffer(render);
+}
+void MetasequoiaMeshData::_LoadMaterialTexture(Material* mat) {
+	std::wstring path = PathProperty::GetFileDirectory(path_) + mat->pathTexture_;
+	mat->texture_ = std::make_shared<Texture>();
+	mat->texture_->CreateFromFile(PathProperty::GetUnique(path), false, false);
+}
+void MetasequoiaMeshData::_CreateVertexBuffer(RenderObject* render) {
+	size_t countVert = render->GetVertexCount();
+	if (countVert == 0) return;
+
+	IDirect3DDevice9* device = DirectGraphics::GetBase()->GetDevice();
+	IDirect3DVertexBuffer9*& vertexBuf = render->pVertexBuffer_;
+
+	size_t vertexBufSize = std::min(countVert, 65536U) * sizeof(VERTEX_NX);
+	render->vertexBufferSize_ = vertexBufSize;
+
+	void* pVoid;
+	VERTEX_NX* pVertData = render->GetVertex(0);
+
+	device->CreateVertexBuffer(vertexBufSize, 0, VERTEX_NX::fvf, D3DPOOL_MANAGED, &vertexBuf, nullptr);
+
+	vertexBuf->Lock(0, vertexBufSize, &pVoid, D3DLOCK_DISCARD);
+	memcpy(pVoid, pVertData, vertexBufSize);
+	vertexBuf->Unlock();
+}
 
-		if (countVert > 0) {
-			IDirect3DDevice9* device = DirectGraphics::GetBase()->GetDevice();
-			IDirect3DVertexBuffer9*& vertexBuf = render->pVertexBuffer_;
+//Binary cache layout:
+//	uint32 version
+//	uint32 material count
+//		uint32 name length, wchar_t[] name, D3DMATERIAL9, uint32 texture path length, wchar_t[] texture path
+//	uint32 render object count
+//		int32 material index, D3DXVECTOR3 object color, uint32 vertex count, VERTEX_NX[] vertices
+bool MetasequoiaMeshData::_ReadCache(const std::wstring& pathCache) {
+	HANDLE hFile = ::CreateFileW(pathCache.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER sizeFile;
+	HANDLE hMapping = nullptr;
+	const byte* pView = nullptr;
+	if (::GetFileSizeEx(hFile, &sizeFile) && sizeFile.QuadPart > 0) {
+		hMapping = ::CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (hMapping)
+			pView = (const byte*)::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	}
 
-			size_t vertexBufSize = std::min(countVert, 65536U) * sizeof(VERTEX_NX);
-			render->vertexBufferSize_ = vertexBufSize;
+	bool res = false;
+	if (pView) {
+		const byte* pos = pView;
+		const byte* end = pView + sizeFile.QuadPart;
+		auto _Read = [&](void* dst, size_t size) -> bool {
+			if (size > (size_t)(end - pos)) return false;
+			memcpy(dst, pos, size);
+			pos += size;
+			return true;
+		};
+		auto _ReadString = [&](std::wstring& dst) -> bool {
+			uint32_t length = 0;
+			if (!_Read(&length, sizeof(uint32_t))) return false;
+			dst.resize(length);
+			return _Read(dst.data(), length * sizeof(wchar_t));
+		};
+
+		res = [&]() -> bool {
+			uint32_t version = 0;
+			if (!_Read(&version, sizeof(uint32_t)) || version != CACHE_VERSION) return false;
+
+			uint32_t countMaterial = 0;
+			if (!_Read(&countMaterial, sizeof(uint32_t))) return false;
+			for (uint32_t iMat = 0; iMat < countMaterial; ++iMat) {
+				Material* mat = new Material();
+				materialList_.push_back(mat);
+				if (!_ReadString(mat->name_)) return false;
+				if (!_Read(&mat->mat_, sizeof(D3DMATERIAL9))) return false;
+				if (!_ReadString(mat->pathTexture_)) return false;
+			}
 
-			void* pVoid;
-			VERTEX_NX* pVertData = render->GetVertex(0);
+			uint32_t countRender = 0;
+			if (!_Read(&countRender, sizeof(uint32_t))) return false;
+			for (uint32_t iRender = 0; iRender < countRender; ++iRender) {
+				RenderObject* render = new RenderObject();
+				renderList_.push_back(render);
+
+				int32_t indexMaterial = -1;
+				uint32_t countVert = 0;
+				if (!_Read(&indexMaterial, sizeof(int32_t))) return false;
+				if (!_Read(&render->objectColor_, sizeof(D3DXVECTOR3))) return false;
+				if (!_Read(&countVert, sizeof(uint32_t))) return false;
+				if (indexMaterial >= 0 && indexMaterial < materialList_.size())
+					render->material_ = materialList_[indexMaterial];
+
+				if ((size_t)(end - pos) < countVert * sizeof(VERTEX_NX)) return false;
+				render->SetVertexCount(countVert);
+				if (countVert > 0 && !_Read(render->GetVertex(0), countVert * sizeof(VERTEX_NX))) return false;
+			}
+			return pos == end;
+		}();
 
-			device->CreateVertexBuffer(vertexBufSize, 0, VERTEX_NX::fvf, D3DPOOL_MANAGED, &vertexBuf, nullptr);
+		::UnmapViewOfFile(pView);
+	}
+	if (hMapping) ::CloseHandle(hMapping);
+	::CloseHandle(hFile);
+
+	if (!res) {
+		_Clear();
+		return false;
+	}
+	return true;
+}
+void MetasequoiaMeshData::_WriteCache(const std::wstring& pathCache) {
+	//The same mesh may be loaded on several threads
+	File::WriteAtomic(pathCache, [&](File& file) {
+		auto _WriteString = [&](std::wstring& str) {
+			file.WriteValue<uint32_t>(str.size());
+			if (str.size() > 0)
+				file.Write(str.data(), str.size() * sizeof(wchar_t));
+		};
+
+		file.WriteValue<uint32_t>(CACHE_VERSION);
+
+		file.WriteValue<uint32_t>(materialList_.size());
+		for (Material* mat : materialList_) {
+			_WriteString(mat->name_);
+			file.Write(mat->mat_);
+			_WriteString(mat->pathTexture_);
+		}
+
+		file.WriteValue<uint32_t>(renderList_.size());
+		for (RenderObject* render : renderList_) {
+			auto itrMat = std::find(materialList_.begin(), materialList_.end(), render->material_);
+			int32_t indexMaterial = itrMat != materialList_.end() ? std::distance(materialList_.begin(), itrMat) : -1;
+
+			size_t countVert = render->GetVertexCount();
+			file.WriteValue<int32_t>(indexMaterial);
+			file.Write(render->objectColor_);
+			file.WriteValue<uint32_t>(countVert);
+			if (countVert > 0)
+				file.Write(render->GetVertex(0), countVert * sizeof(VERTEX_NX));
+		}
+		return true;
+	});
+}
+bool MetasequoiaMeshData::_IsEqual(MetasequoiaMeshData* other) {
+	if (materialList_.size() != other->materialList_.size()) return false;
+	for (size_t iMat = 0; iMat < materialList_.size(); ++iMat) {
+		Material* mat = materialList_[iMat];
+		Material* matOther = other->materialList_[iMat];
+		if (mat->name_ != matOther->name_ || mat->pathTexture_ != matOther->pathTexture_) return false;
+		if (memcmp(&mat->mat_, &matOther->mat_, sizeof(D3DMATERIAL9)) != 0) return false;
+	}
 
-			vertexBuf->Lock(0, vertexBufSize, &pVoid, D3DLOCK_DISCARD);
-			memcpy(pVoid, pVertData, vertexBufSize);
-			vertexBuf->Unlock();
+	if (renderList_.size() != other->renderList_.size()) return false;
+	for (size_t iRender = 0; iRender < renderList_.size(); ++iRender) {
+		RenderObject* render = renderList_[iRender];
+		RenderObject* renderOther = other->renderList_[iRender];
+
+		auto _GetMaterialIndex = [](MetasequoiaMeshData* data, Material* mat) -> ptrdiff_t {
+			auto itr = std::find(data->materialList_.begin(), data->materialList_.end(), mat);
+			return itr != data->materialList_.end() ? std::distance(data->materialList_.begin(), itr) : -1;
+		};
+		if (_GetMaterialIndex(this, render->material_) != _GetMaterialIndex(other, renderOther->material_)) return false;
+		if (render->objectColor_ != renderOther->objectColor_) return false;
+
+		size_t countVert = render->GetVertexCount();
+		if (countVert != renderOther->GetVertexCount()) return false;
+		for (size_t iVert = 0; iVert < countVert; ++iVert) {
+			VERTEX_NX* vert = render->GetVertex(iVert);
+			VERTEX_NX* vertOther = renderOther->GetVertex(iVert);
+			if (vert->position != vertOther->position || vert->normal != vertOther->normal
+				|| vert->texcoord != vertOther->texcoord) return false;
 		}
 	}
+	return true;
 }
 
 //This causes a memory leak but who cares, it's only once and will get deleted once the game closes anyway
@@ -515,8 +721,8 @@ void MetasequoiaMesh::Render(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, c
 		DWORD bFogEnable = FALSE;
 		if (bCoordinate2D_) {
 			device->SetTransform(D3DTS_VIEW, &camera->GetIdentity());
-			device->GetRenderState(D3DRS_FOGENABLE, &bFogEnable);
-			device->SetRenderState(D3DRS_FOGENABLE, FALSE);
+			bFogEnable = graphics->IsFogEnable();
+			graphics->SetRenderState(D3DRS_FOGENABLE, FALSE);
 			RenderObject::SetCoordinate2dDeviceMatrix();
 		}
 
@@ -537,7 +743,7 @@ void MetasequoiaMesh::Render(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, c
 
 		if (bCoordinate2D_) {
 			device->SetTransform(D3DTS_VIEW, &camera->GetViewProjectionMatrix());
-			device->SetRenderState(D3DRS_FOGENABLE, bFogEnable);
+			graphics->SetRenderState(D3DRS_FOGENABLE, bFogEnable);
 		}
 	}
 }
@@ -20,17 +20,38 @@ namespace directx {
 			D3DXVECTOR3 normal_;
 			virtual ~NormalData() {}
 		};
+		enum : uint32_t {
+			CACHE_VERSION = 1,
+		};
 	protected:
+		//Parsed meshes are kept in a binary cache keyed by the hash of the .mqo text
+		static bool bCacheEnable_;
+		//Checks every cache load against the text parser
+		static bool bCacheValidate_;
+
 		std::wstring path_;
 		std::vector<RenderObject*> renderList_;
 		std::vector<Material*> materialList_;
 
+		void _Clear();
+		bool _ReadText(const std::string& text);
 		void _ReadMaterial(gstd::Scanner& scanner);
 		void _ReadObject(gstd::Scanner& scanner);
+		//Textures and vertex buffers are only created once the mesh data is final
+		void _CreateResource();
+		void _LoadMaterialTexture(Material* mat);
+		void _CreateVertexBuffer(RenderObject* render);
+
+		bool _ReadCache(const std::wstring& pathCache);
+		void _WriteCache(const std::wstring& pathCache);
+		bool _IsEqual(MetasequoiaMeshData* other);
 	public:
 		MetasequoiaMeshData();
 		~MetasequoiaMeshData();
 
+		static void SetCacheEnable(bool bEnable) { bCacheEnable_ = bEnable; }
+		static void SetCacheValidation(bool bValidate) { bCacheValidate_ = bValidate; }
+
 		bool CreateFromFileReader(shared_ptr<gstd::FileReader> reader);
 	};
 
@@ -41,6 +62,7 @@ namespace directx {
 	protected:
 		std::wstring name_;
 		D3DMATERIAL9 mat_;
+		std::wstring pathTexture_;
 		shared_ptr<Texture> texture_;
 		std::string pathTextureAlpha_;
 		std::string pathTextureBump_;
@@ -30,9 +30,10 @@ DirectionalLightingState::DirectionalLightingState() {
 	light_.Direction = D3DXVECTOR3(-1, -1, -1);
 }
 void DirectionalLightingState::Apply() {
-	IDirect3DDevice9* device = DirectGraphics::GetBase()->GetDevice();
-	device->SetRenderState(D3DRS_LIGHTING, bLightEnable_);
-	device->SetRenderState(D3DRS_SPECULARENABLE, bLightEnable_ ? bSpecularEnable_ : false);
+	DirectGraphics* graphics = DirectGraphics::GetBase();
+	IDirect3DDevice9* device = graphics->GetDevice();
+	graphics->SetRenderState(D3DRS_LIGHTING, bLightEnable_);
+	graphics->SetRenderState(D3DRS_SPECULARENABLE, bLightEnable_ ? bSpecularEnable_ : false);
 	device->LightEnable(0, bLightEnable_);
 	if (bLightEnable_) device->SetLight(0, &light_);
 }
@@ -433,8 +434,8 @@ void RenderObjectTLX::Render(const D3DXMATRIX& matTransform) {
 		else graphics->SetRenderTarget(nullptr);
 	}
 
-	device->SetTexture(0, texture_ ? texture_->GetD3DTexture() : nullptr);
-	device->SetFVF(VERTEX_TLX::fvf);
+	graphics->SetTexture(0, texture_ ? texture_->GetD3DTexture() : nullptr);
+	graphics->SetFVF(VERTEX_TLX::fvf);
 
 	{
 		bool bUseIndex = vertexIndices_.size() > 0;
@@ -455,23 +456,19 @@ void RenderObjectTLX::Render(const D3DXMATRIX& matTransform) {
 		RenderShaderLibrary* shaderLib = ShaderManager::GetBase()->GetRenderLib();
 
 		VertexBufferManager* vbManager = VertexBufferManager::GetBase();
-		FixedVertexBuffer* vertexBuffer = vbManager->GetVertexBufferTLX();
-		FixedIndexBuffer* indexBuffer = vbManager->GetIndexBuffer();
+		TransientVertexRing* vertexRing = vbManager->GetVertexRingTLX();
+		TransientIndexRing* indexRing = vbManager->GetIndexRing();
 
+		TransientVertexRing::Slice sliceVertex;
+		TransientIndexRing::Slice sliceIndex;
 		if (flgUseVertexBufferMode_ || bVertexShaderMode_) {
-			BufferLockParameter lockParam = BufferLockParameter(D3DLOCK_DISCARD);
-
-			lockParam.SetSource(bVertexShaderMode_ ? vertex_ : vertCopy_, countVertex, sizeof(VERTEX_TLX));
-			vertexBuffer->UpdateBuffer(&lockParam);
-			
-			if (bUseIndex) {
-				lockParam.SetSource(vertexIndices_, countIndex, sizeof(uint16_t));
-				indexBuffer->UpdateBuffer(&lockParam);
-			}
+			vertexRing->Write(bVertexShaderMode_ ? vertex_ : vertCopy_, countVertex, sizeof(VERTEX_TLX), &sliceVertex);
+			if (bUseIndex)
+				indexRing->Write(vertexIndices_, countIndex, sizeof(uint16_t), &sliceIndex);
 		}
 
-		device->SetStreamSource(0, vertexBuffer->GetBuffer(), 0, sizeof(VERTEX_TLX));
-		device->SetIndices(indexBuffer->GetBuffer());
+		graphics->SetStreamSource(0, vertexRing->GetBuffer(), 0, sizeof(VERTEX_TLX));
+		graphics->SetIndices(indexRing->GetBuffer());
 
 		{
 			UINT countPass = 1;
@@ -483,14 +480,11 @@ void RenderObjectTLX::Render(const D3DXMATRIX& matTransform) {
 					shader_->LoadParameter();
 
 					if (bVertexShaderMode_) {
-						device->SetVertexDeclaration(shaderLib->GetVertexDeclarationTLX());
-
-						D3DXHANDLE handle = nullptr;
-						if (handle = effect->GetParameterBySemantic(nullptr, "WORLD"))
-							effect->SetMatrix(handle, &matTransform);
-						if (handle = effect->GetParameterBySemantic(nullptr, "VIEWPROJECTION")) {
-							effect->SetMatrix(handle, &graphics->GetViewPortMatrix());
-						}
+						graphics->SetVertexDeclaration(shaderLib->GetVertexDeclarationTLX());
+
+						ShaderSemanticBinding* binding = shader_->GetBinding();
+						binding->SetMatrix(ShaderSemantic::World, matTransform);
+						binding->SetMatrix(ShaderSemantic::ViewProjection, graphics->GetViewPortMatrix());
 					}
 				}
 				
@@ -500,8 +494,9 @@ void RenderObjectTLX::Render(const D3DXMATRIX& matTransform) {
 				if (effect) effect->BeginPass(iPass);
 
 				if (flgUseVertexBufferMode_ || bVertexShaderMode_) {
-					if (bUseIndex) device->DrawIndexedPrimitive(typePrimitive_, 0, 0, countVertex, 0, countPrim);
-					else device->DrawPrimitive(typePrimitive_, 0, countPrim);
+					if (bUseIndex)
+						device->DrawIndexedPrimitive(typePrimitive_, sliceVertex.start, 0, countVertex, sliceIndex.start, countPrim);
+					else device->DrawPrimitive(typePrimitive_, sliceVertex.start, countPrim);
 				}
 				else {
 					if (bUseIndex)
@@ -509,16 +504,54 @@ void RenderObjectTLX::Render(const D3DXMATRIX& matTransform) {
 							vertexIndices_.data(), D3DFMT_INDEX16, vertCopy_.data(), strideVertexStreamZero_);
 					else
 						device->DrawPrimitiveUP(typePrimitive_, countPrim, vertCopy_.data(), strideVertexStreamZero_);
+					graphics->NotifyDrawUP(bUseIndex);
 				}
 
 				if (effect) effect->EndPass();
 			}
-			if (effect) effect->End();
+			if (effect) {
+				effect->End();
+				graphics->NotifyEffectStateChange();
+			}
 		}
 
-		device->SetIndices(nullptr);
-		device->SetVertexDeclaration(nullptr);
+		graphics->SetIndices(nullptr);
+		graphics->SetVertexDeclaration(nullptr);
+	}
+}
+
+bool RenderObjectTLX::SubmitBatch(RenderQueue2D* queue, BlendMode blend, D3DCULL culling,
+	D3DTEXTUREFILTERTYPE filterMin, D3DTEXTUREFILTERTYPE filterMag, D3DTEXTUREFILTERTYPE filterMip,
+	const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, const D3DXVECTOR2& angZ)
+{
+	if (shader_ || bVertexShaderMode_) return false;
+
+	DirectGraphics* graphics = DirectGraphics::GetBase();
+	ref_count_ptr<DxCamera2D> camera = graphics->GetCamera2D();
+	bool bCamera = camera->IsEnable() && bPermitCamera_;
+
+	D3DXMATRIX matWorld;
+	if (!disableMatrixTransform_) {
+		matWorld = RenderObject::CreateWorldMatrix2D(position_, scale_,
+			angX, angY, angZ, bCamera ? &camera->GetMatrix() : nullptr);
+	}
+	else {
+		matWorld = camera->GetMatrix();
 	}
+
+	RenderQueue2D::State state;
+	state.texture = texture_ ? texture_->GetD3DTexture() : nullptr;
+	if (graphics->IsAllowRenderTargetChange())
+		state.renderTarget = renderTarget_.lock();
+	state.blend = blend;
+	state.culling = culling;
+	state.filterMin = filterMin;
+	state.filterMag = filterMag;
+	state.filterMip = filterMip;
+
+	size_t countVertex = std::min(GetVertexCount(), 65536U);
+	return queue->Append(state, (VERTEX_TLX*)vertex_.data(), countVertex,
+		vertexIndices_.data(), std::min(vertexIndices_.size(), 65536U), typePrimitive_, matWorld);
 }
 
 void RenderObjectTLX::Copy(RenderObject* _src) {
@@ -644,8 +677,8 @@ void RenderObjectLX::Render(const D3DXMATRIX& matTransform) {
 		else graphics->SetRenderTarget(nullptr);
 	}
 
-	device->SetTexture(0, texture_ ? texture_->GetD3DTexture() : nullptr);
-	device->SetFVF(VERTEX_LX::fvf);
+	graphics->SetTexture(0, texture_ ? texture_->GetD3DTexture() : nullptr);
+	graphics->SetFVF(VERTEX_LX::fvf);
 
 	device->SetTransform(D3DTS_WORLD, &matTransform);
 
@@ -658,23 +691,19 @@ void RenderObjectLX::Render(const D3DXMATRIX& matTransform) {
 		RenderShaderLibrary* shaderLib = ShaderManager::GetBase()->GetRenderLib();
 
 		VertexBufferManager* vbManager = VertexBufferManager::GetBase();
-		FixedVertexBuffer* vertexBuffer = vbManager->GetVertexBufferLX();
-		FixedIndexBuffer* indexBuffer = vbManager->GetIndexBuffer();
+		TransientVertexRing* vertexRing = vbManager->GetVertexRingLX();
+		TransientIndexRing* indexRing = vbManager->GetIndexRing();
 
+		TransientVertexRing::Slice sliceVertex;
+		TransientIndexRing::Slice sliceIndex;
 		if (flgUseVertexBufferMode_ || bVertexShaderMode_) {
-			BufferLockParameter lockParam = BufferLockParameter(D3DLOCK_DISCARD);
-
-			lockParam.SetSource(vertex_, countVertex, sizeof(VERTEX_LX));
-			vertexBuffer->UpdateBuffer(&lockParam);
-
-			if (bUseIndex) {
-				lockParam.SetSource(vertexIndices_, countIndex, sizeof(uint16_t));
-				indexBuffer->UpdateBuffer(&lockParam);
-			}
+			vertexRing->Write(vertex_, countVertex, sizeof(VERTEX_LX), &sliceVertex);
+			if (bUseIndex)
+				indexRing->Write(vertexIndices_, countIndex, sizeof(uint16_t), &sliceIndex);
 		}
 
-		device->SetStreamSource(0, vertexBuffer->GetBuffer(), 0, sizeof(VERTEX_LX));
-		device->SetIndices(indexBuffer->GetBuffer());
+		graphics->SetStreamSource(0, vertexRing->GetBuffer(), 0, sizeof(VERTEX_LX));
+		graphics->SetIndices(indexRing->GetBuffer());
 
 		UINT countPass = 1;
 		ID3DXEffect* effect = nullptr;
@@ -691,24 +720,17 @@ void RenderObjectLX::Render(const D3DXMATRIX& matTransform) {
 
 					bool bFog = graphics->IsFogEnable();
 					graphics->SetFogEnable(false);
-					device->SetVertexDeclaration(shaderLib->GetVertexDeclarationLX());
-
-					D3DXHANDLE handle = nullptr;
-					if (handle = effect->GetParameterBySemantic(nullptr, "WORLD"))
-						effect->SetMatrix(handle, &matTransform);
-					if (handle = effect->GetParameterBySemantic(nullptr, "VIEW"))
-						effect->SetMatrix(handle, &camera->GetViewMatrix());
-					if (handle = effect->GetParameterBySemantic(nullptr, "PROJECTION"))
-						effect->SetMatrix(handle, &camera->GetProjectionMatrix());
-					if (handle = effect->GetParameterBySemantic(nullptr, "VIEWPROJECTION"))
-						effect->SetMatrix(handle, &camera->GetViewProjectionMatrix());
-					if (handle = effect->GetParameterBySemantic(nullptr, "FOGENABLE"))
-						effect->SetBool(handle, bFog);
+					graphics->SetVertexDeclaration(shaderLib->GetVertexDeclarationLX());
+
+					ShaderSemanticBinding* binding = shader_->GetBinding();
+					binding->SetMatrix(ShaderSemantic::World, matTransform);
+					binding->SetMatrix(ShaderSemantic::View, camera->GetViewMatrix());
+					binding->SetMatrix(ShaderSemantic::Projection, camera->GetProjectionMatrix());
+					binding->SetMatrix(ShaderSemantic::ViewProjection, camera->GetViewProjectionMatrix());
+					binding->SetBool(ShaderSemantic::FogEnable, bFog);
 					if (bFog) {
-						if (handle = effect->GetParameterBySemantic(nullptr, "FOGCOLOR"))
-							effect->SetFloatArray(handle, (FLOAT*)(&(fogParam->color)), 3);
-						if (handle = effect->GetParameterBySemantic(nullptr, "FOGDIST"))
-							effect->SetFloatArray(handle, (FLOAT*)(&(fogParam->fogDist)), 2);
+						binding->SetFloatArray(ShaderSemantic::FogColor, (FLOAT*)(&(fogParam->color)), 3);
+						binding->SetFloatArray(ShaderSemantic::FogDist, (FLOAT*)(&(fogParam->fogDist)), 2);
 					}
 				}
 			}
@@ -719,8 +741,9 @@ void RenderObjectLX::Render(const D3DXMATRIX& matTransform) {
 			if (effect) effect->BeginPass(iPass);
 
 			if (flgUseVertexBufferMode_ || bVertexShaderMode_) {
-				if (bUseIndex) device->DrawIndexedPrimitive(typePrimitive_, 0, 0, countVertex, 0, countPrim);
-				else device->DrawPrimitive(typePrimitive_, 0, countPrim);
+				if (bUseIndex)
+					device->DrawIndexedPrimitive(typePrimitive_, sliceVertex.start, 0, countVertex, sliceIndex.start, countPrim);
+				else device->DrawPrimitive(typePrimitive_, sliceVertex.start, countPrim);
 			}
 			else {
 				if (bUseIndex)
@@ -728,14 +751,18 @@ void RenderObjectLX::Render(const D3DXMATRIX& matTransform) {
 						vertexIndices_.data(), D3DFMT_INDEX16, vertex_.data(), strideVertexStreamZero_);
 				else
 					device->DrawPrimitiveUP(typePrimitive_, countPrim, vertex_.data(), strideVertexStreamZero_);
+				graphics->NotifyDrawUP(bUseIndex);
 			}
 
 			if (effect) effect->EndPass();
 		}
-		if (effect) effect->End();
+		if (effect) {
+			effect->End();
+			graphics->NotifyEffectStateChange();
+		}
 
-		device->SetIndices(nullptr);
-		device->SetVertexDeclaration(nullptr);
+		graphics->SetIndices(nullptr);
+		graphics->SetVertexDeclaration(nullptr);
 	}
 }
 
@@ -846,8 +873,8 @@ void RenderObjectNX::Render(D3DXMATRIX* matTransform) {
 		else graphics->SetRenderTarget(nullptr);
 	}
 
-	device->SetTexture(0, texture_ ? texture_->GetD3DTexture() : nullptr);
-	device->SetFVF(VERTEX_NX::fvf);
+	graphics->SetTexture(0, texture_ ? texture_->GetD3DTexture() : nullptr);
+	graphics->SetFVF(VERTEX_NX::fvf);
 
 	{
 		bool bUseIndex = vertexIndices_.size() > 0;
@@ -858,19 +885,14 @@ void RenderObjectNX::Render(D3DXMATRIX* matTransform) {
 		RenderShaderLibrary* shaderLib = ShaderManager::GetBase()->GetRenderLib();
 
 		VertexBufferManager* vbManager = VertexBufferManager::GetBase();
-		FixedIndexBuffer* indexBuffer = vbManager->GetIndexBuffer();
+		TransientIndexRing* indexRing = vbManager->GetIndexRing();
 
-		{
-			if (bUseIndex) {
-				BufferLockParameter lockParam = BufferLockParameter(D3DLOCK_DISCARD);
+		TransientIndexRing::Slice sliceIndex;
+		if (bUseIndex)
+			indexRing->Write(vertexIndices_, countIndex, sizeof(uint16_t), &sliceIndex);
 
-				lockParam.SetSource(vertexIndices_, countIndex, sizeof(uint16_t));
-				indexBuffer->UpdateBuffer(&lockParam);
-			}
-		}
-
-		device->SetStreamSource(0, pVertexBuffer_, 0, sizeof(VERTEX_NX));
-		device->SetIndices(indexBuffer->GetBuffer());
+		graphics->SetStreamSource(0, pVertexBuffer_, 0, sizeof(VERTEX_NX));
+		graphics->SetIndices(indexRing->GetBuffer());
 
 		UINT countPass = 1;
 		ID3DXEffect* effect = nullptr;
@@ -887,24 +909,17 @@ void RenderObjectNX::Render(D3DXMATRIX* matTransform) {
 
 					bool bFog = graphics->IsFogEnable();
 					graphics->SetFogEnable(false);
-					device->SetVertexDeclaration(shaderLib->GetVertexDeclarationNX());
-
-					D3DXHANDLE handle = nullptr;
-					if (handle = effect->GetParameterBySemantic(nullptr, "WORLD"))
-						effect->SetMatrix(handle, matTransform ? matTransform : &graphics->GetCamera()->GetIdentity());
-					if (handle = effect->GetParameterBySemantic(nullptr, "VIEW"))
-						effect->SetMatrix(handle, &camera->GetViewMatrix());
-					if (handle = effect->GetParameterBySemantic(nullptr, "PROJECTION"))
-						effect->SetMatrix(handle, &camera->GetProjectionMatrix());
-					if (handle = effect->GetParameterBySemantic(nullptr, "VIEWPROJECTION"))
-						effect->SetMatrix(handle, &camera->GetViewProjectionMatrix());
-					if (handle = effect->GetParameterBySemantic(nullptr, "FOGENABLE"))
-						effect->SetBool(handle, bFog);
+					graphics->SetVertexDeclaration(shaderLib->GetVertexDeclarationNX());
+
+					ShaderSemanticBinding* binding = shader_->GetBinding();
+					binding->SetMatrix(ShaderSemantic::World, matTransform ? *matTransform : graphics->GetCamera()->GetIdentity());
+					binding->SetMatrix(ShaderSemantic::View, camera->GetViewMatrix());
+					binding->SetMatrix(ShaderSemantic::Projection, camera->GetProjectionMatrix());
+					binding->SetMatrix(ShaderSemantic::ViewProjection, camera->GetViewProjectionMatrix());
+					binding->SetBool(ShaderSemantic::FogEnable, bFog);
 					if (bFog) {
-						if (handle = effect->GetParameterBySemantic(nullptr, "FOGCOLOR"))
-							effect->SetFloatArray(handle, (FLOAT*)(&(fogParam->color)), 3);
-						if (handle = effect->GetParameterBySemantic(nullptr, "FOGDIST"))
-							effect->SetFloatArray(handle, (FLOAT*)(&(fogParam->fogDist)), 2);
+						binding->SetFloatArray(ShaderSemantic::FogColor, (FLOAT*)(&(fogParam->color)), 3);
+						binding->SetFloatArray(ShaderSemantic::FogDist, (FLOAT*)(&(fogParam->fogDist)), 2);
 					}
 				}
 			}
@@ -914,17 +929,20 @@ void RenderObjectNX::Render(D3DXMATRIX* matTransform) {
 		for (UINT iPass = 0; iPass < countPass; ++iPass) {
 			if (effect) effect->BeginPass(iPass);
 			if (bUseIndex) {
-				device->DrawIndexedPrimitive(typePrimitive_, 0, 0, countVertex, 0, countPrim);
+				device->DrawIndexedPrimitive(typePrimitive_, 0, 0, countVertex, sliceIndex.start, countPrim);
 			}
 			else {
 				device->DrawPrimitive(typePrimitive_, 0, countPrim);
 			}
 			if (effect) effect->EndPass();
 		}
-		if (effect) effect->End();
+		if (effect) {
+			effect->End();
+			graphics->NotifyEffectStateChange();
+		}
 
-		device->SetIndices(nullptr);
-		device->SetVertexDeclaration(nullptr);
+		graphics->SetIndices(nullptr);
+		graphics->SetVertexDeclaration(nullptr);
 	}
 }
 
@@ -1093,8 +1111,8 @@ void SpriteList2D::Render(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, cons
 		else graphics->SetRenderTarget(nullptr);
 	}
 	
-	device->SetTexture(0, texture_ ? texture_->GetD3DTexture() : nullptr);
-	device->SetFVF(VERTEX_TLX::fvf);
+	graphics->SetTexture(0, texture_ ? texture_->GetD3DTexture() : nullptr);
+	graphics->SetFVF(VERTEX_TLX::fvf);
 
 	bool bCamera = camera->IsEnable() && bPermitCamera_;
 	{
@@ -1139,21 +1157,16 @@ void SpriteList2D::Render(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, cons
 			RenderShaderLibrary* shaderLib = ShaderManager::GetBase()->GetRenderLib();
 
 			VertexBufferManager* vbManager = VertexBufferManager::GetBase();
-			FixedVertexBuffer* vertexBuffer = vbManager->GetVertexBufferTLX();
-			FixedIndexBuffer* indexBuffer = vbManager->GetIndexBuffer();
-
-			{
-				BufferLockParameter lockParam = BufferLockParameter(D3DLOCK_DISCARD);
+			TransientVertexRing* vertexRing = vbManager->GetVertexRingTLX();
+			TransientIndexRing* indexRing = vbManager->GetIndexRing();
 
-				lockParam.SetSource(vertCopy_, countVertex, sizeof(VERTEX_TLX));
-				vertexBuffer->UpdateBuffer(&lockParam);
-				
-				lockParam.SetSource(vertexIndices_, countIndex, sizeof(uint16_t));
-				indexBuffer->UpdateBuffer(&lockParam);
-			}
+			TransientVertexRing::Slice sliceVertex;
+			TransientIndexRing::Slice sliceIndex;
+			vertexRing->Write(vertCopy_, countVertex, sizeof(VERTEX_TLX), &sliceVertex);
+			indexRing->Write(vertexIndices_, countIndex, sizeof(uint16_t), &sliceIndex);
 
-			device->SetStreamSource(0, vertexBuffer->GetBuffer(), 0, sizeof(VERTEX_TLX));
-			device->SetIndices(indexBuffer->GetBuffer());
+			graphics->SetStreamSource(0, vertexRing->GetBuffer(), 0, sizeof(VERTEX_TLX));
+			graphics->SetIndices(indexRing->GetBuffer());
 
 			UINT countPass = 1;
 			ID3DXEffect* effect = nullptr;
@@ -1164,20 +1177,16 @@ void SpriteList2D::Render(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, cons
 					shader_->LoadParameter();
 
 					if (bVertexShaderMode_) {
-						device->SetVertexDeclaration(shaderLib->GetVertexDeclarationTLX());
-
-						D3DXHANDLE handle = nullptr;
-						if (handle = effect->GetParameterBySemantic(nullptr, "WORLD")) {
-							if (bCloseVertexList_)
-								effect->SetMatrix(handle, &matWorld);
-							else if (bCamera)
-								effect->SetMatrix(handle, &camera->GetMatrix());
-							else
-								effect->SetMatrix(handle, &camera3D->GetIdentity());
-						}
-						if (handle = effect->GetParameterBySemantic(nullptr, "VIEWPROJECTION")) {
-							effect->SetMatrix(handle, &graphics->GetViewPortMatrix());
-						}
+						graphics->SetVertexDeclaration(shaderLib->GetVertexDeclarationTLX());
+
+						ShaderSemanticBinding* binding = shader_->GetBinding();
+						if (bCloseVertexList_)
+							binding->SetMatrix(ShaderSemantic::World, matWorld);
+						else if (bCamera)
+							binding->SetMatrix(ShaderSemantic::World, camera->GetMatrix());
+						else
+							binding->SetMatrix(ShaderSemantic::World, camera3D->GetIdentity());
+						binding->SetMatrix(ShaderSemantic::ViewProjection, graphics->GetViewPortMatrix());
 					}
 				}
 
@@ -1185,13 +1194,16 @@ void SpriteList2D::Render(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, cons
 			}
 			for (UINT iPass = 0; iPass < countPass; ++iPass) {
 				if (effect) effect->BeginPass(iPass);
-				device->DrawIndexedPrimitive(typePrimitive_, 0, 0, countVertex, 0, countPrim);
+				device->DrawIndexedPrimitive(typePrimitive_, sliceVertex.start, 0, countVertex, sliceIndex.start, countPrim);
 				if (effect) effect->EndPass();
 			}
-			if (effect) effect->End();
+			if (effect) {
+				effect->End();
+				graphics->NotifyEffectStateChange();
+			}
 
-			device->SetIndices(nullptr);
-			device->SetVertexDeclaration(nullptr);
+			graphics->SetIndices(nullptr);
+			graphics->SetVertexDeclaration(nullptr);
 		}
 	}
 }
@@ -1301,6 +1313,147 @@ void SpriteList2D::SetColor(D3DCOLOR color) {
 	color_ = color;
 }
 
+//****************************************************************************
+//RenderQueue2D
+//****************************************************************************
+RenderQueue2D::RenderQueue2D() {
+	bEnable_ = true;
+	vertex_.reserve(MAX_BATCH_VERTEX);
+	index_.reserve(MAX_BATCH_INDEX);
+}
+
+bool RenderQueue2D::Append(const State& state, const VERTEX_TLX* vertices, size_t countVertex,
+	const uint16_t* indices, size_t countIndex, D3DPRIMITIVETYPE type, const D3DXMATRIX& matTransform)
+{
+	if (!bEnable_) return false;
+
+	bool bUseIndex = countIndex > 0;
+	size_t countSource = bUseIndex ? countIndex : countVertex;
+
+	//Everything is converted to an indexed triangle list
+	size_t countOutIndex = 0;
+	switch (type) {
+	case D3DPT_TRIANGLELIST:
+		countOutIndex = countSource / 3U * 3U;
+		break;
+	case D3DPT_TRIANGLESTRIP:
+	case D3DPT_TRIANGLEFAN:
+		countOutIndex = countSource >= 3U ? (countSource - 2U) * 3U : 0U;
+		break;
+	default:
+		return false;
+	}
+	if (countVertex > MAX_BATCH_VERTEX || countOutIndex > MAX_BATCH_INDEX) return false;
+
+	if (bUseIndex) {
+		for (size_t i = 0; i < countIndex; ++i) {
+			if (indices[i] >= countVertex) return false;
+		}
+	}
+
+	if (state != state_ || vertex_.size() + countVertex > MAX_BATCH_VERTEX
+		|| index_.size() + countOutIndex > MAX_BATCH_INDEX)
+	{
+		Flush();
+		state_ = state;
+	}
+	++statsFrame_.countObject;
+	if (countOutIndex == 0) return true;
+
+	uint16_t base = (uint16_t)vertex_.size();
+	for (size_t iVert = 0; iVert < countVertex; ++iVert) {
+		vertex_.push_back(vertices[iVert]);
+		D3DXVECTOR3* vPos = (D3DXVECTOR3*)&vertex_.back().position;
+		D3DXVec3TransformCoord(vPos, vPos, &matTransform);
+	}
+
+	auto _Source = [&](size_t i) -> uint16_t {
+		return base + (bUseIndex ? indices[i] : (uint16_t)i);
+	};
+	switch (type) {
+	case D3DPT_TRIANGLELIST:
+		for (size_t i = 0; i < countOutIndex; ++i)
+			index_.push_back(_Source(i));
+		break;
+	case D3DPT_TRIANGLESTRIP:
+		//Every other triangle of a strip has its winding flipped
+		for (size_t i = 0; i + 2U < countSource; ++i) {
+			bool bOdd = i & 1;
+			index_.push_back(_Source(bOdd ? i + 1U : i));
+			index_.push_back(_Source(bOdd ? i : i + 1U));
+			index_.push_back(_Source(i + 2U));
+		}
+		break;
+	case D3DPT_TRIANGLEFAN:
+		for (size_t i = 1; i + 1U < countSource; ++i) {
+			index_.push_back(_Source(0));
+			index_.push_back(_Source(i));
+			index_.push_back(_Source(i + 1U));
+		}
+		break;
+	}
+
+	return true;
+}
+void RenderQueue2D::Flush() {
+	if (index_.empty()) {
+		vertex_.clear();
+		return;
+	}
+
+	DirectGraphics* graphics = DirectGraphics::GetBase();
+	IDirect3DDevice9* device = graphics->GetDevice();
+
+	bool bEnableFog = graphics->IsFogEnable();
+	if (bEnableFog)
+		graphics->SetFogEnable(false);
+
+	if (graphics->IsAllowRenderTargetChange())
+		graphics->SetRenderTarget(state_.renderTarget);
+
+	graphics->SetLightingEnable(false);
+	graphics->SetZWriteEnable(false);
+	graphics->SetZBufferEnable(false);
+	graphics->SetBlendMode(state_.blend);
+	graphics->SetCullingMode(state_.culling);
+	graphics->SetTextureFilter(state_.filterMin, state_.filterMag, state_.filterMip);
+
+	graphics->SetTexture(0, state_.texture);
+	graphics->SetFVF(VERTEX_TLX::fvf);
+
+	{
+		VertexBufferManager* vbManager = VertexBufferManager::GetBase();
+		TransientVertexRing* vertexRing = vbManager->GetVertexRingTLX();
+		TransientIndexRing* indexRing = vbManager->GetIndexRing();
+
+		TransientVertexRing::Slice sliceVertex;
+		TransientIndexRing::Slice sliceIndex;
+		vertexRing->Write(vertex_, vertex_.size(), sizeof(VERTEX_TLX), &sliceVertex);
+		indexRing->Write(index_, index_.size(), sizeof(uint16_t), &sliceIndex);
+
+		graphics->SetStreamSource(0, vertexRing->GetBuffer(), 0, sizeof(VERTEX_TLX));
+		graphics->SetIndices(indexRing->GetBuffer());
+
+		device->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, sliceVertex.start, 0, sliceVertex.count,
+			sliceIndex.start, sliceIndex.count / 3U);
+
+		graphics->SetIndices(nullptr);
+	}
+
+	if (bEnableFog)
+		graphics->SetFogEnable(true);
+
+	++statsFrame_.countDraw;
+
+	vertex_.clear();
+	index_.clear();
+}
+
+void RenderQueue2D::EndFrame() {
+	statsLastFrame_ = statsFrame_;
+	statsFrame_ = Stats();
+}
+
 //****************************************************************************
 //Sprite3D
 //****************************************************************************
@@ -1495,6 +1648,193 @@ void TrajectoryObject3D::Copy(RenderObject* _src) {
 	listData_ = src->listData_;
 }
 
+//****************************************************************************
+//ParticleEmitter
+//****************************************************************************
+ParticleEmitter::Stats ParticleEmitter::statsFrame_;
+ParticleEmitter::Stats ParticleEmitter::statsLastFrame_;
+ParticleEmitter::ParticleEmitter() : rand_((uint32_t)SystemUtility::GetCpuTime2()) {
+	rateSpawn_ = 0;
+	accumSpawn_ = 0;
+	lifeMin_ = 60;
+	lifeMax_ = 60;
+
+	position_ = D3DXVECTOR3(0, 0, 0);
+	spread_ = D3DXVECTOR3(0, 0, 0);
+	speedMin_ = 0;
+	speedMax_ = 0;
+	angleMin_ = 0;
+	angleMax_ = (float)GM_PI_X2;
+	velocity_ = D3DXVECTOR3(0, 0, 0);
+	gravity_ = D3DXVECTOR3(0, 0, 0);
+
+	bCurveChanged_ = true;
+
+	count_ = 0;
+}
+void ParticleEmitter::SetLife(uint32_t min, uint32_t max) {
+	lifeMin_ = std::max(min, 1U);
+	lifeMax_ = std::max(max, lifeMin_);
+}
+void ParticleEmitter::SetAngle(float min, float max) {
+	angleMin_ = D3DXToRadian(min);
+	angleMax_ = D3DXToRadian(max);
+}
+void ParticleEmitter::AddColorKey(float time, const D3DXVECTOR4& color) {
+	ColorKey key = { std::clamp(time, 0.0f, 1.0f), color };
+	auto itr = std::upper_bound(listColorKey_.begin(), listColorKey_.end(), key.time,
+		[](float t, const ColorKey& k) { return t < k.time; });
+	listColorKey_.insert(itr, key);
+	bCurveChanged_ = true;
+}
+void ParticleEmitter::AddScaleKey(float time, float scale) {
+	ScaleKey key = { std::clamp(time, 0.0f, 1.0f), scale };
+	auto itr = std::upper_bound(listScaleKey_.begin(), listScaleKey_.end(), key.time,
+		[](float t, const ScaleKey& k) { return t < k.time; });
+	listScaleKey_.insert(itr, key);
+	bCurveChanged_ = true;
+}
+void ParticleEmitter::ClearCurve() {
+	listColorKey_.clear();
+	listScaleKey_.clear();
+	bCurveChanged_ = true;
+}
+
+template<typename TKey, typename TValue>
+static TValue _SampleParticleCurve(const std::vector<TKey>& keys, float time, TValue TKey::* member) {
+	if (time <= keys.front().time) return keys.front().*member;
+	if (time >= keys.back().time) return keys.back().*member;
+
+	auto itr = std::upper_bound(keys.begin(), keys.end(), time,
+		[](float t, const TKey& k) { return t < k.time; });
+	const TKey& k1 = *itr;
+	const TKey& k0 = *(itr - 1);
+
+	float span = k1.time - k0.time;
+	float rate = span > 0 ? (time - k0.time) / span : 1.0f;
+	return k0.*member + (k1.*member - k0.*member) * rate;
+}
+void ParticleEmitter::_BakeCurve() {
+	for (size_t i = 0; i < CURVE_RESOLUTION; ++i) {
+		float time = i / (float)(CURVE_RESOLUTION - 1);
+
+		if (listColorKey_.size() > 0) {
+			D3DXVECTOR4 color = _SampleParticleCurve(listColorKey_, time, &ColorKey::color);
+			curveColor_[i] = D3DCOLOR_ARGB(
+				ColorAccess::ClampColorRet((int)color.x), ColorAccess::ClampColorRet((int)color.y),
+				ColorAccess::ClampColorRet((int)color.z), ColorAccess::ClampColorRet((int)color.w));
+		}
+		if (listScaleKey_.size() > 0)
+			curveScale_[i] = _SampleParticleCurve(listScaleKey_, time, &ScaleKey::scale);
+	}
+	bCurveChanged_ = false;
+}
+void ParticleEmitter::_Spawn(size_t count) {
+	count = std::min(count, (size_t)MAX_PARTICLE - count_);
+	if (count == 0) return;
+
+	size_t countNew = count_ + count;
+	if (posX_.size() < countNew) {
+		size_t newSize = std::min(std::max(posX_.size() * 2U, countNew), (size_t)MAX_PARTICLE);
+		for (auto pVec : { &posX_, &posY_, &posZ_, &velX_, &velY_, &velZ_, &age_, &ageStep_ })
+			pVec->resize(newSize);
+	}
+
+	for (size_t i = count_; i < countNew; ++i) {
+		posX_[i] = position_.x + spread_.x * (float)rand_.GetReal(-1, 1);
+		posY_[i] = position_.y + spread_.y * (float)rand_.GetReal(-1, 1);
+		posZ_[i] = position_.z + spread_.z * (float)rand_.GetReal(-1, 1);
+
+		float speed = (float)rand_.GetReal(speedMin_, speedMax_);
+		float angle = (float)rand_.GetReal(angleMin_, angleMax_);
+		velX_[i] = velocity_.x + speed * cosf(angle);
+		velY_[i] = velocity_.y + speed * sinf(angle);
+		velZ_[i] = velocity_.z;
+
+		uint32_t life = std::min((uint32_t)rand_.GetReal(lifeMin_, lifeMax_ + 1.0), lifeMax_);
+		age_[i] = 0;
+		ageStep_[i] = 1.0f / life;
+	}
+	count_ = countNew;
+}
+void ParticleEmitter::Update() {
+	auto timeStart = stdch::steady_clock::now();
+	{
+		float* pPosX = posX_.data();
+		float* pPosY = posY_.data();
+		float* pPosZ = posZ_.data();
+		float* pVelX = velX_.data();
+		float* pVelY = velY_.data();
+		float* pVelZ = velZ_.data();
+		float* pAge = age_.data();
+		const float* pAgeStep = ageStep_.data();
+		for (size_t i = 0; i < count_; ++i) {
+			pVelX[i] += gravity_.x;
+			pVelY[i] += gravity_.y;
+			pVelZ[i] += gravity_.z;
+			pPosX[i] += pVelX[i];
+			pPosY[i] += pVelY[i];
+			pPosZ[i] += pVelZ[i];
+			pAge[i] += pAgeStep[i];
+		}
+	}
+
+	//Retire expired particles by moving the last live particle into their slot
+	for (size_t i = 0; i < count_;) {
+		if (age_[i] < 1.0f) {
+			++i;
+			continue;
+		}
+		size_t iLast = --count_;
+		posX_[i] = posX_[iLast];
+		posY_[i] = posY_[iLast];
+		posZ_[i] = posZ_[iLast];
+		velX_[i] = velX_[iLast];
+		velY_[i] = velY_[iLast];
+		velZ_[i] = velZ_[iLast];
+		age_[i] = age_[iLast];
+		ageStep_[i] = ageStep_[iLast];
+	}
+
+	accumSpawn_ += rateSpawn_;
+	if (accumSpawn_ >= 1.0f) {
+		size_t countSpawn = (size_t)accumSpawn_;
+		accumSpawn_ -= countSpawn;
+		_Spawn(countSpawn);
+	}
+
+	++statsFrame_.countEmitter;
+	statsFrame_.countParticle += count_;
+	statsFrame_.timeUpdate += stdch::duration<double, std::milli>(stdch::steady_clock::now() - timeStart).count();
+}
+void ParticleEmitter::Emit(ParticleRendererBase* renderer) {
+	if (count_ == 0) return;
+	auto timeStart = stdch::steady_clock::now();
+	if (bCurveChanged_) _BakeCurve();
+
+	bool bColor = listColorKey_.size() > 0;
+	bool bScale = listScaleKey_.size() > 0;
+	if (bColor && outColor_.size() < count_)
+		outColor_.resize(posX_.size());
+	if (bScale && outScale_.size() < count_)
+		outScale_.resize(posX_.size());
+
+	for (size_t i = 0; i < count_; ++i) {
+		size_t index = std::min((size_t)(age_[i] * (CURVE_RESOLUTION - 1) + 0.5f), (size_t)CURVE_RESOLUTION - 1);
+		if (bColor) outColor_[i] = curveColor_[index];
+		if (bScale) outScale_[i] = curveScale_[index];
+	}
+
+	renderer->AddInstanceArray(posX_.data(), posY_.data(), posZ_.data(),
+		bScale ? outScale_.data() : nullptr, bColor ? outColor_.data() : nullptr, count_);
+
+	statsFrame_.timeUpdate += stdch::duration<double, std::milli>(stdch::steady_clock::now() - timeStart).count();
+}
+void ParticleEmitter::EndFrame() {
+	statsLastFrame_ = statsFrame_;
+	statsFrame_ = Stats();
+}
+
 //****************************************************************************
 //ParticleRendererBase
 //****************************************************************************
@@ -1521,12 +1861,16 @@ void ParticleRendererBase::CopyParticle(ParticleRendererBase* src) {
 	instScale_ = src->instScale_;
 	instAngle_ = src->instAngle_;
 	instUserData_ = src->instUserData_;
+
+	if (src->emitter_)
+		emitter_.reset(new ParticleEmitter(*src->emitter_));
+	else emitter_ = nullptr;
 }
 
 void ParticleRendererBase::AddInstance() {
-	if (countInstance_ == 32768U) return;
+	if (countInstance_ == MAX_INSTANCE) return;
 	if (instanceData_.size() == countInstance_) {
-		size_t newSize = std::min(countInstance_ * 2U, 32768U);
+		size_t newSize = std::min(countInstance_ * 2U, (size_t)MAX_INSTANCE);
 		instanceData_.resize(newSize);
 	}
 	VERTEX_INSTANCE instance;
@@ -1536,11 +1880,52 @@ void ParticleRendererBase::AddInstance() {
 	instance.z_ang_extra = D3DXVECTOR4(-instAngle_.z, instUserData_.x, instUserData_.y, instUserData_.z);
 	instanceData_[countInstance_++] = instance;
 }
+size_t ParticleRendererBase::AddInstanceArray(const float* posX, const float* posY, const float* posZ,
+	const float* scale, const D3DCOLOR* color, size_t count)
+{
+	count = std::min(count, (size_t)MAX_INSTANCE - countInstance_);
+	if (count == 0U) return 0U;
+
+	size_t countNew = countInstance_ + count;
+	if (instanceData_.size() < countNew) {
+		size_t newSize = std::max<size_t>(instanceData_.size(), 8U);
+		while (newSize < countNew)
+			newSize *= 2U;
+		instanceData_.resize(std::min(newSize, (size_t)MAX_INSTANCE));
+	}
+
+	const float mul = DirectGraphics::g_dxCoordsMul_;
+	const D3DXVECTOR4 angleExtra(-instAngle_.z, instUserData_.x, instUserData_.y, instUserData_.z);
+
+	VERTEX_INSTANCE* pInstance = &instanceData_[countInstance_];
+	for (size_t i = 0; i < count; ++i, ++pInstance) {
+		float z = posZ ? posZ[i] * mul : instPosition_.z;
+		D3DXVECTOR3 sc = scale ? D3DXVECTOR3(scale[i], scale[i], scale[i]) * mul : instScale_;
+
+		pInstance->diffuse_color = color ? color[i] : instColor_;
+		pInstance->xyz_pos_x_scale = D3DXVECTOR4(posX[i] * mul, posY[i] * mul, z, sc.x);
+		pInstance->yz_scale_xy_ang = D3DXVECTOR4(sc.y, sc.z, -instAngle_.x, -instAngle_.y);
+		pInstance->z_ang_extra = angleExtra;
+	}
+
+	countInstance_ = countNew;
+	return count;
+}
 void ParticleRendererBase::ClearInstance() {
 	countInstancePrev_ = countInstance_;
 	countInstance_ = 0U;
 	//countInstancePrev_ = 0U;
 }
+ParticleEmitter* ParticleRendererBase::GetEmitter() {
+	if (emitter_ == nullptr)
+		emitter_.reset(new ParticleEmitter());
+	return emitter_.get();
+}
+void ParticleRendererBase::UpdateEmitter() {
+	if (emitter_ == nullptr) return;
+	emitter_->Update();
+	emitter_->Emit(this);
+}
 void ParticleRendererBase::SetInstanceColorRGB(int r, int g, int b) {
 	__m128i c = Vectorize::Set(instColor_ >> 24, r, g, b);
 	D3DCOLOR color = ColorAccess::ToD3DCOLOR(ColorAccess::ClampColorPacked(c));
@@ -1596,7 +1981,7 @@ void ParticleRenderer2D::Render() {
 
 	bool bCamera = camera->IsEnable() && bPermitCamera_;
 
-	device->SetTexture(0, texture_ ? texture_->GetD3DTexture() : nullptr);
+	graphics->SetTexture(0, texture_ ? texture_->GetD3DTexture() : nullptr);
 
 	{
 		size_t countVertex = std::min(GetVertexCount(), 65536U);
@@ -1605,45 +1990,48 @@ void ParticleRenderer2D::Render() {
 		VertexBufferManager* bufferManager = VertexBufferManager::GetBase();
 		RenderShaderLibrary* shaderManager = ShaderManager::GetBase()->GetRenderLib();
 
-		FixedVertexBuffer* vertexBuffer = bufferManager->GetVertexBufferTLX();
+		TransientVertexRing* vertexRing = bufferManager->GetVertexRingTLX();
 		GrowableVertexBuffer* instanceBuffer = bufferManager->GetInstancingVertexBuffer();
-		FixedIndexBuffer* indexBuffer = bufferManager->GetIndexBuffer();
+		TransientIndexRing* indexRing = bufferManager->GetIndexRing();
 
 		instanceBuffer->Expand(countRenderInstance);
 
+		TransientVertexRing::Slice sliceVertex;
+		TransientIndexRing::Slice sliceIndex;
 		{
 			BufferLockParameter lockParam = BufferLockParameter(D3DLOCK_DISCARD);
 
-			lockParam.SetSource(vertex_, countVertex, sizeof(VERTEX_TLX));
-			vertexBuffer->UpdateBuffer(&lockParam);
-
 			lockParam.SetSource(instanceData_, countRenderInstance, sizeof(VERTEX_INSTANCE));
 			instanceBuffer->UpdateBuffer(&lockParam);
 
-			lockParam.SetSource(vertexIndices_, countIndex, sizeof(uint16_t));
-			indexBuffer->UpdateBuffer(&lockParam);
+			vertexRing->Write(vertex_, countVertex, sizeof(VERTEX_TLX), &sliceVertex);
+			indexRing->Write(vertexIndices_, countIndex, sizeof(uint16_t), &sliceIndex);
 		}
 
-		device->SetVertexDeclaration(shaderManager->GetVertexDeclarationInstancedTLX());
+		graphics->SetVertexDeclaration(shaderManager->GetVertexDeclarationInstancedTLX());
 
-		device->SetStreamSource(0, vertexBuffer->GetBuffer(), 0, sizeof(VERTEX_TLX));
+		graphics->SetStreamSource(0, vertexRing->GetBuffer(), 0, sizeof(VERTEX_TLX));
 #ifdef __L_USE_HWINSTANCING
 		device->SetStreamSourceFreq(0, D3DSTREAMSOURCE_INDEXEDDATA | countRenderInstance);
-		device->SetStreamSource(1, instanceBuffer->GetBuffer(), 0, sizeof(VERTEX_INSTANCE));
+		graphics->SetStreamSource(1, instanceBuffer->GetBuffer(), 0, sizeof(VERTEX_INSTANCE));
 		device->SetStreamSourceFreq(1, D3DSTREAMSOURCE_INSTANCEDATA | 1U);
 #endif
 
-		device->SetIndices(indexBuffer->GetBuffer());
+		graphics->SetIndices(indexRing->GetBuffer());
 
 		{
 			UINT countPass = 1;
 			ID3DXEffect* effect = nullptr;
 
+			ShaderSemanticBinding* binding = nullptr;
+
 			if (shader_) {
 				effect = shader_->GetEffect();
+				binding = shader_->GetBinding();
 			}
 			else {
 				effect = shaderManager->GetInstancing2DShader();
+				binding = shaderManager->GetInstancing2DBinding();
 				effect->SetTechnique(texture_ ? (dxObjParent_->GetBlendType() == MODE_BLEND_ALPHA_INV ?
 					"RenderInv" : "Render") : "RenderNoTexture");
 			}
@@ -1651,11 +2039,10 @@ void ParticleRenderer2D::Render() {
 			if (effect == nullptr) return;
 
 			auto _SetParam = [&]() {
-				D3DXHANDLE handle = nullptr;
-				if (handle = effect->GetParameterBySemantic(nullptr, "WORLDVIEWPROJ")) {
+				if (binding->IsBound(ShaderSemantic::WorldViewProj)) {
 					D3DXMATRIX mat;
 					D3DXMatrixMultiply(&mat, &camera->GetMatrix(), &graphics->GetViewPortMatrix());
-					effect->SetMatrix(handle, &mat);
+					binding->SetMatrix(ShaderSemantic::WorldViewProj, mat);
 				}
 			};
 			
@@ -1674,18 +2061,19 @@ void ParticleRenderer2D::Render() {
 				effect->BeginPass(iPass);
 
 #ifdef __L_USE_HWINSTANCING
-				device->DrawIndexedPrimitive(typePrimitive_, 0, 0, countVertex, 0, countPrim);
+				device->DrawIndexedPrimitive(typePrimitive_, sliceVertex.start, 0, countVertex, sliceIndex.start, countPrim);
 #else
 				for (UINT nInst = 0; nInst < countRenderInstance; ++nInst) {
-					device->SetStreamSource(1, instanceBuffer->GetBuffer(), 
+					graphics->SetStreamSource(1, instanceBuffer->GetBuffer(), 
 						nInst * sizeof(VERTEX_INSTANCE), 0);
-					device->DrawIndexedPrimitive(typePrimitive_, 0, 0, countVertex, 0, countPrim);
+					device->DrawIndexedPrimitive(typePrimitive_, sliceVertex.start, 0, countVertex, sliceIndex.start, countPrim);
 				}
 #endif
 
 				effect->EndPass();
 			}
 			effect->End();
+			graphics->NotifyEffectStateChange();
 		}
 
 #ifdef __L_USE_HWINSTANCING
@@ -1722,7 +2110,7 @@ void ParticleRenderer3D::Render() {
 		else graphics->SetRenderTarget(nullptr);
 	}
 
-	device->SetTexture(0, texture_ ? texture_->GetD3DTexture() : nullptr);
+	graphics->SetTexture(0, texture_ ? texture_->GetD3DTexture() : nullptr);
 
 	{
 		size_t countVertex = std::min(GetVertexCount(), 65536U);
@@ -1731,45 +2119,48 @@ void ParticleRenderer3D::Render() {
 		VertexBufferManager* bufferManager = VertexBufferManager::GetBase();
 		RenderShaderLibrary* shaderManager = ShaderManager::GetBase()->GetRenderLib();
 
-		FixedVertexBuffer* vertexBuffer = bufferManager->GetVertexBufferLX();
+		TransientVertexRing* vertexRing = bufferManager->GetVertexRingLX();
 		GrowableVertexBuffer* instanceBuffer = bufferManager->GetInstancingVertexBuffer();
-		FixedIndexBuffer* indexBuffer = bufferManager->GetIndexBuffer();
+		TransientIndexRing* indexRing = bufferManager->GetIndexRing();
 
 		instanceBuffer->Expand(countRenderInstance);
 
+		TransientVertexRing::Slice sliceVertex;
+		TransientIndexRing::Slice sliceIndex;
 		{
 			BufferLockParameter lockParam = BufferLockParameter(D3DLOCK_DISCARD);
 
-			lockParam.SetSource(vertex_, countVertex, sizeof(VERTEX_LX));
-			vertexBuffer->UpdateBuffer(&lockParam);
-
 			lockParam.SetSource(instanceData_, countRenderInstance, sizeof(VERTEX_INSTANCE));
 			instanceBuffer->UpdateBuffer(&lockParam);
 
-			lockParam.SetSource(vertexIndices_, countIndex, sizeof(uint16_t));
-			indexBuffer->UpdateBuffer(&lockParam);
+			vertexRing->Write(vertex_, countVertex, sizeof(VERTEX_LX), &sliceVertex);
+			indexRing->Write(vertexIndices_, countIndex, sizeof(uint16_t), &sliceIndex);
 		}
 
-		device->SetVertexDeclaration(shaderManager->GetVertexDeclarationInstancedLX());
+		graphics->SetVertexDeclaration(shaderManager->GetVertexDeclarationInstancedLX());
 
-		device->SetStreamSource(0, vertexBuffer->GetBuffer(), 0, sizeof(VERTEX_LX));
+		graphics->SetStreamSource(0, vertexRing->GetBuffer(), 0, sizeof(VERTEX_LX));
 #ifdef __L_USE_HWINSTANCING
 		device->SetStreamSourceFreq(0, D3DSTREAMSOURCE_INDEXEDDATA | countRenderInstance);
-		device->SetStreamSource(1, instanceBuffer->GetBuffer(), 0, sizeof(VERTEX_INSTANCE));
+		graphics->SetStreamSource(1, instanceBuffer->GetBuffer(), 0, sizeof(VERTEX_INSTANCE));
 		device->SetStreamSourceFreq(1, D3DSTREAMSOURCE_INSTANCEDATA | 1U);
 #endif
 
-		device->SetIndices(indexBuffer->GetBuffer());
+		graphics->SetIndices(indexRing->GetBuffer());
 
 		{
 			UINT countPass = 1;
 			ID3DXEffect* effect = nullptr;
 
+			ShaderSemanticBinding* binding = nullptr;
+
 			if (shader_) {
 				effect = shader_->GetEffect();
+				binding = shader_->GetBinding();
 			}
 			else {
 				effect = shaderManager->GetInstancing3DShader();
+				binding = shaderManager->GetInstancing3DBinding();
 				effect->SetTechnique(texture_ ? (dxObjParent_->GetBlendType() == MODE_BLEND_ALPHA_INV ?
 					"RenderInv" : "Render") : "RenderNoTexture");
 			}
@@ -1782,25 +2173,16 @@ void ParticleRenderer3D::Render() {
 				bool bFog = graphics->IsFogEnable();
 				graphics->SetFogEnable(false);
 
-				D3DXHANDLE handle = nullptr;
-				if (handle = effect->GetParameterBySemantic(nullptr, "WORLD")) {
-					if (bBillboard_)
-						effect->SetMatrix(handle, &camera->GetViewTransposedMatrix());
-					else effect->SetMatrix(handle, &camera->GetIdentity());
-				}
-				if (handle = effect->GetParameterBySemantic(nullptr, "VIEW"))
-					effect->SetMatrix(handle, &camera->GetViewMatrix());
-				if (handle = effect->GetParameterBySemantic(nullptr, "PROJECTION"))
-					effect->SetMatrix(handle, &camera->GetProjectionMatrix());
-				if (handle = effect->GetParameterBySemantic(nullptr, "VIEWPROJECTION"))
-					effect->SetMatrix(handle, &camera->GetViewProjectionMatrix());
-				if (handle = effect->GetParameterBySemantic(nullptr, "FOGENABLE"))
-					effect->SetBool(handle, bFog);
+				if (bBillboard_)
+					binding->SetMatrix(ShaderSemantic::World, camera->GetViewTransposedMatrix());
+				else binding->SetMatrix(ShaderSemantic::World, camera->GetIdentity());
+				binding->SetMatrix(ShaderSemantic::View, camera->GetViewMatrix());
+				binding->SetMatrix(ShaderSemantic::Projection, camera->GetProjectionMatrix());
+				binding->SetMatrix(ShaderSemantic::ViewProjection, camera->GetViewProjectionMatrix());
+				binding->SetBool(ShaderSemantic::FogEnable, bFog);
 				if (bFog) {
-					if (handle = effect->GetParameterBySemantic(nullptr, "FOGCOLOR"))
-						effect->SetFloatArray(handle, (FLOAT*)(&(fogParam->color)), 3);
-					if (handle = effect->GetParameterBySemantic(nullptr, "FOGDIST"))
-						effect->SetFloatArray(handle, (FLOAT*)(&(fogParam->fogDist)), 2);
+					binding->SetFloatArray(ShaderSemantic::FogColor, (FLOAT*)(&(fogParam->color)), 3);
+					binding->SetFloatArray(ShaderSemantic::FogDist, (FLOAT*)(&(fogParam->fogDist)), 2);
 				}
 			};
 
@@ -1819,18 +2201,19 @@ void ParticleRenderer3D::Render() {
 				effect->BeginPass(iPass);
 
 #ifdef __L_USE_HWINSTANCING
-				device->DrawIndexedPrimitive(typePrimitive_, 0, 0, countVertex, 0, countPrim);
+				device->DrawIndexedPrimitive(typePrimitive_, sliceVertex.start, 0, countVertex, sliceIndex.start, countPrim);
 #else
 				for (UINT nInst = 0; nInst < countRenderInstance; ++nInst) {
-					device->SetStreamSource(1, instanceBuffer->GetBuffer(),
+					graphics->SetStreamSource(1, instanceBuffer->GetBuffer(),
 						nInst * sizeof(VERTEX_INSTANCE), 0);
-					device->DrawIndexedPrimitive(typePrimitive_, 0, 0, countVertex, 0, countPrim);
+					device->DrawIndexedPrimitive(typePrimitive_, sliceVertex.start, 0, countVertex, sliceIndex.start, countPrim);
 				}
 #endif
 
 				effect->EndPass();
 			}
 			effect->End();
+			graphics->NotifyEffectStateChange();
 		}
 
 #ifdef __L_USE_HWINSTANCING
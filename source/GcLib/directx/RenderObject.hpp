@@ -150,6 +150,8 @@ namespace directx {
 		void SetVertexIndices(const std::vector<uint16_t>& indices) { vertexIndices_ = indices; }
 	};
 
+	class RenderQueue2D;
+
 	//****************************************************************************
 	//RenderObjectTLX
 	//	2D render object
@@ -168,6 +170,11 @@ namespace directx {
 		virtual void Render(const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, const D3DXVECTOR2& angZ);
 		virtual void Render(const D3DXMATRIX& matTransform);
 
+		//Appends the transformed vertices to the queue instead of drawing, returns false if the object can't be batched
+		bool SubmitBatch(RenderQueue2D* queue, BlendMode blend, D3DCULL culling,
+			D3DTEXTUREFILTERTYPE filterMin, D3DTEXTUREFILTERTYPE filterMag, D3DTEXTUREFILTERTYPE filterMip,
+			const D3DXVECTOR2& angX, const D3DXVECTOR2& angY, const D3DXVECTOR2& angZ);
+
 		virtual void SetVertexCount(size_t count);
 
 		VERTEX_TLX* GetVertex(size_t index);
@@ -314,6 +321,66 @@ namespace directx {
 		void SetAutoClearVertex(bool clear) { autoClearVertexList_ = clear; }
 	};
 
+	//****************************************************************************
+	//RenderQueue2D
+	//	Merges consecutive 2D objects that share the same device state into one draw call
+	//****************************************************************************
+	class RenderQueue2D {
+	public:
+		enum : size_t {
+			MAX_BATCH_VERTEX = 16384U,
+			MAX_BATCH_INDEX = 49152U,
+		};
+
+		//Everything that has to match for two objects to be drawn together
+		struct State {
+			IDirect3DTexture9* texture = nullptr;
+			shared_ptr<Texture> renderTarget;
+			BlendMode blend = MODE_BLEND_ALPHA;
+			D3DCULL culling = D3DCULL_NONE;
+			D3DTEXTUREFILTERTYPE filterMin = D3DTEXF_LINEAR;
+			D3DTEXTUREFILTERTYPE filterMag = D3DTEXF_LINEAR;
+			D3DTEXTUREFILTERTYPE filterMip = D3DTEXF_NONE;
+
+			bool operator==(const State& other) const {
+				return texture == other.texture && renderTarget == other.renderTarget
+					&& blend == other.blend && culling == other.culling
+					&& filterMin == other.filterMin && filterMag == other.filterMag && filterMip == other.filterMip;
+			}
+			bool operator!=(const State& other) const { return !(*this == other); }
+		};
+		struct Stats {
+			size_t countObject = 0;
+			size_t countDraw = 0;
+		};
+	private:
+		bool bEnable_;
+
+		State state_;
+		std::vector<VERTEX_TLX> vertex_;
+		std::vector<uint16_t> index_;
+
+		Stats statsFrame_;
+		Stats statsLastFrame_;
+	public:
+		RenderQueue2D();
+
+		//When disabled, Append always returns false and every object is drawn by itself
+		void SetEnable(bool b) { bEnable_ = b; }
+		bool IsEnable() { return bEnable_; }
+
+		//Objects are never reordered, so the output is the same as drawing them one by one.
+		//Returns false if the primitive type or size can't be batched, the caller must then Flush and draw the object itself.
+		bool Append(const State& state, const VERTEX_TLX* vertices, size_t countVertex,
+			const uint16_t* indices, size_t countIndex, D3DPRIMITIVETYPE type, const D3DXMATRIX& matTransform);
+		void Flush();
+		bool IsEmpty() { return index_.empty(); }
+
+		//Moves the current frame's counters to the last frame's
+		void EndFrame();
+		const Stats& GetLastFrameStats() { return statsLastFrame_; }
+	};
+
 	//****************************************************************************
 	//Sprite3D
 	//	RenderObjectLX with pre-defined 4-vertex layout
@@ -379,11 +446,115 @@ namespace directx {
 		void SetColor(D3DCOLOR color) { color_ = color; }
 	};
 
+	//****************************************************************************
+	//ParticleEmitter
+	//	Spawns and moves particles in native code, so that a particle costs no script calls
+	//****************************************************************************
+	class ParticleRendererBase;
+	class ParticleEmitter {
+	public:
+		enum : size_t {
+			MAX_PARTICLE = 32768U,
+			CURVE_RESOLUTION = 64U,
+		};
+
+		//Keys of the curves over a particle's life, time is in [0, 1]
+		struct ColorKey {
+			float time;
+			D3DXVECTOR4 color;	//a, r, g, b
+		};
+		struct ScaleKey {
+			float time;
+			float scale;
+		};
+		//Totals over every emitter
+		struct Stats {
+			size_t countEmitter = 0;
+			size_t countParticle = 0;
+			double timeUpdate = 0;		//In milliseconds, Update and Emit
+		};
+	protected:
+		static Stats statsFrame_;
+		static Stats statsLastFrame_;
+
+		float rateSpawn_;
+		float accumSpawn_;
+		uint32_t lifeMin_;
+		uint32_t lifeMax_;
+
+		D3DXVECTOR3 position_;
+		D3DXVECTOR3 spread_;
+		float speedMin_;
+		float speedMax_;
+		float angleMin_;
+		float angleMax_;
+		D3DXVECTOR3 velocity_;
+		D3DXVECTOR3 gravity_;
+
+		std::vector<ColorKey> listColorKey_;
+		std::vector<ScaleKey> listScaleKey_;
+		std::array<D3DCOLOR, CURVE_RESOLUTION> curveColor_;
+		std::array<float, CURVE_RESOLUTION> curveScale_;
+		bool bCurveChanged_;
+
+		//Live particles, in structure-of-arrays form
+		size_t count_;
+		std::vector<float> posX_;
+		std::vector<float> posY_;
+		std::vector<float> posZ_;
+		std::vector<float> velX_;
+		std::vector<float> velY_;
+		std::vector<float> velZ_;
+		std::vector<float> age_;		//0 to 1 over the particle's life
+		std::vector<float> ageStep_;
+
+		std::vector<float> outScale_;
+		std::vector<D3DCOLOR> outColor_;
+
+		gstd::RandProvider rand_;
+
+		void _BakeCurve();
+		void _Spawn(size_t count);
+	public:
+		ParticleEmitter();
+
+		void SetSpawnRate(float rate) { rateSpawn_ = std::max(rate, 0.0f); }
+		void SetLife(uint32_t min, uint32_t max);
+		void SetPosition(const D3DXVECTOR3& pos) { position_ = pos; }
+		void SetSpread(const D3DXVECTOR3& spread) { spread_ = spread; }
+		void SetSpeed(float min, float max) { speedMin_ = min; speedMax_ = max; }
+		//In degrees, on the XY plane
+		void SetAngle(float min, float max);
+		void SetVelocity(const D3DXVECTOR3& vel) { velocity_ = vel; }
+		void SetGravity(const D3DXVECTOR3& gravity) { gravity_ = gravity; }
+
+		void AddColorKey(float time, const D3DXVECTOR4& color);
+		void AddScaleKey(float time, float scale);
+		void ClearCurve();
+
+		void Burst(size_t count) { _Spawn(count); }
+		void Clear() { count_ = 0; }
+		size_t GetParticleCount() { return count_; }
+
+		//Spawns, moves and retires particles, once per frame
+		void Update();
+		//Appends the live particles to the renderer's instances
+		void Emit(ParticleRendererBase* renderer);
+
+		//Moves the current frame's counters to the last frame's
+		static void EndFrame();
+		static const Stats& GetLastFrameStats() { return statsLastFrame_; }
+	};
+
 	//****************************************************************************
 	//ParticleRendererBase
 	//	Base class for instanced render objects
 	//****************************************************************************
 	class ParticleRendererBase {
+	public:
+		enum : size_t {
+			MAX_INSTANCE = 32768U,
+		};
 	protected:
 		size_t countInstance_;
 		size_t countInstancePrev_;
@@ -394,6 +565,8 @@ namespace directx {
 		D3DXVECTOR3 instScale_;
 		D3DXVECTOR3 instAngle_;
 		D3DXVECTOR3 instUserData_;
+
+		unique_ptr<ParticleEmitter> emitter_;
 	public:
 		ParticleRendererBase();
 		virtual ~ParticleRendererBase();
@@ -401,15 +574,28 @@ namespace directx {
 		void CopyParticle(ParticleRendererBase* src);
 
 		void AddInstance();
+		//Adds count instances in one go, taking the angle and user data from the current instance values.
+		//	posZ, scale and color may be null to use the current instance values for all of them.
+		//	Returns the number of instances actually added.
+		size_t AddInstanceArray(const float* posX, const float* posY, const float* posZ,
+			const float* scale, const D3DCOLOR* color, size_t count);
 		void ClearInstance();
 
+		//The emitter is created on first use
+		ParticleEmitter* GetEmitter();
+		bool IsEmitterExists() { return emitter_ != nullptr; }
+		void UpdateEmitter();
+
 		void SetInstanceColor(D3DCOLOR color) { instColor_ = color; }
+		D3DCOLOR GetInstanceColor() { return instColor_; }
 		void SetInstanceColorRGB(int r, int g, int b);
 		void SetInstanceColorRGB(D3DCOLOR color);
 		void SetInstanceAlpha(int alpha);
 
 		void SetInstancePosition(float x, float y, float z) { SetInstancePosition(D3DXVECTOR3(x, y, z)); }
 		void SetInstancePosition(const D3DXVECTOR3& pos);
+		//Already scaled by the coordinate multiplier
+		const D3DXVECTOR3& GetInstancePosition() { return instPosition_; }
 
 		void SetInstanceScaleSingle(size_t index, float sc);
 		void SetInstanceScale(float x, float y, float z) { SetInstanceScale(D3DXVECTOR3(x, y, z)); }
@@ -55,6 +55,9 @@ void ScriptManager::Work(int targetType) {
 			itr = listScriptRun_.erase(itr);
 		}
 		else {
+			//Coalesced events queued since the last frame are delivered ahead of MainLoop
+			script->DispatchEventBatch();
+
 			std::map<std::string, script_block*>::iterator itrEvent;
 			if (script->IsEventExists("MainLoop", itrEvent))
 				script->Run(itrEvent);
@@ -300,6 +303,39 @@ void ScriptManager::CallFromLoadThread(shared_ptr<gstd::FileManager::LoadThreadE
 		SetError(e.what());
 	}
 }
+void ScriptManager::CompileScriptInParallel(const std::vector<std::pair<std::wstring, int>>& listScript) {
+	std::vector<ScriptCompileService::Job> listJob;
+	{
+		std::set<std::wstring> setPath;
+		for (auto& iScript : listScript) {
+			std::wstring path = PathProperty::GetUnique(iScript.first);
+			if (!setPath.insert(path).second) continue;
+
+			shared_ptr<ManagedScript> script = CreateClient(iScript.second);
+			if (script == nullptr) continue;
+
+			//Only cached engines outlive the compiling script
+			auto cache = script->GetScriptEngineCache();
+			if (cache == nullptr || cache->IsExists(path)) continue;
+
+			ScriptCompileService::Job job;
+			job.path = path;
+			job.client = script;
+			listJob.push_back(job);
+		}
+	}
+	if (listJob.empty()) return;
+
+	double timeTotal = ScriptCompileService::Compile(listJob);
+
+	for (auto& job : listJob) {
+		Logger::WriteTop(StringUtility::Format(L"Compiled script%s in %.2fms: [%s]",
+			job.bSuccess ? L"" : L" (failed)", job.timeCompile,
+			PathProperty::ReduceModuleDirectory(job.path).c_str()));
+	}
+	Logger::WriteTop(StringUtility::Format(L"Compiled %u scripts in %.2fms",
+		(uint32_t)listJob.size(), timeTotal));
+}
 void ScriptManager::UnloadScript(int64_t id) {
 	Lock lock(lock_);
 	mapScriptLoad_.erase(id);
@@ -383,6 +419,7 @@ static const std::vector<function> managedScriptFunction = {
 	{ "NotifyEvent", ManagedScript::Func_NotifyEvent, -3 },          //2 fixed (+ ...) -> 2 minimum
 	{ "NotifyEventOwn", ManagedScript::Func_NotifyEventOwn, -2 },    //1 fixed (+ ...) -> 1 minimum
 	{ "NotifyEventAll", ManagedScript::Func_NotifyEventAll, -2 },    //1 fixed (+ ...) -> 1 minimum
+	{ "SetEventCoalescing", ManagedScript::Func_SetEventCoalescing, 2 },
 	{ "PauseScript", ManagedScript::Func_PauseScript, 2 },
 
 	{ "GetScriptStatus", ManagedScript::Func_GetScriptStatus, 1 },
@@ -415,6 +452,9 @@ ManagedScript::ManagedScript() {
 	typeEvent_ = -1;
 	listValueEvent_ = nullptr;
 	listValueEventSize_ = 0;
+
+	bEventBlockCached_ = false;
+	bEventBlockExists_ = false;
 }
 ManagedScript::~ManagedScript() {
 	//listValueEvent_ shouldn't be delete'd, that's the job of whatever was calling RequestEvent,
@@ -436,6 +476,11 @@ void ManagedScript::Reset() {
 	bEndScript_ = false;
 	bRunning_ = false;
 	bPaused_ = false;
+
+	for (auto& [type, batch] : mapEventBatch_) {
+		batch.countEvent = 0;
+		batch.listValue.clear();
+	}
 }
 
 void ManagedScript::SetScriptManager(ScriptManager* manager) {
@@ -447,11 +492,48 @@ gstd::value ManagedScript::RequestEvent(int type) {
 	return RequestEvent(type, nullptr, 0);
 }
 gstd::value ManagedScript::RequestEvent(int type, const gstd::value* listValue, size_t countArgument) {
-	gstd::value res;
 	std::map<std::string, script_block*>::iterator itrEvent;
-	if (!IsEventExists("Event", itrEvent)) {
-		return res;
+	if (!_GetEventBlock(itrEvent))
+		return gstd::value();
+
+	auto itrBatch = mapEventBatch_.find(type);
+	if (itrBatch != mapEventBatch_.end() && itrBatch->second.bEnable) {
+		EventBatch& batch = itrBatch->second;
+		if (batch.countEvent == 0) {
+			batch.countArgument = countArgument;
+			batch.listType.resize(countArgument);
+			for (size_t iArg = 0; iArg < countArgument; ++iArg)
+				batch.listType[iArg] = listValue[iArg].get_type();
+		}
+
+		//Each argument column becomes a typed array, so events whose argument count or types
+		//	differ from the rest of the batch can't be stacked, deliver them as-is
+		bool bStack = batch.countArgument == countArgument;
+		for (size_t iArg = 0; bStack && iArg < countArgument; ++iArg)
+			bStack = batch.listType[iArg] == listValue[iArg].get_type();
+
+		if (bStack) {
+			batch.listValue.insert(batch.listValue.end(), listValue, listValue + countArgument);
+			++batch.countEvent;
+			return gstd::value();
+		}
+	}
+
+	return _RunEvent(itrEvent, type, listValue, countArgument);
+}
+bool ManagedScript::_GetEventBlock(std::map<std::string, script_block*>::iterator& res) {
+	//Go through IsEventExists when the script has errored so that the error gets raised
+	if (bError_ || !bEventBlockCached_) {
+		bEventBlockExists_ = IsEventExists("Event", itrEventBlock_);
+		bEventBlockCached_ = !bError_;
 	}
+	res = itrEventBlock_;
+	return bEventBlockExists_;
+}
+gstd::value ManagedScript::_RunEvent(std::map<std::string, script_block*>::iterator itrEvent,
+	int type, const gstd::value* listValue, size_t countArgument)
+{
+	gstd::value res;
 
 	//Run() may overwrite these if it invokes another RequestEvent
 	int prevEventType = typeEvent_;
@@ -476,6 +558,42 @@ gstd::value ManagedScript::RequestEvent(int type, const gstd::value* listValue,
 	return res;
 }
 
+void ManagedScript::SetEventCoalescing(int type, bool bEnable) {
+	//Entries are never erased, DispatchEventBatch may be iterating the map when this is called
+	EventBatch& batch = mapEventBatch_[type];
+	batch.bEnable = bEnable;
+}
+void ManagedScript::DispatchEventBatch() {
+	if (mapEventBatch_.empty()) return;
+
+	std::map<std::string, script_block*>::iterator itrEvent;
+	if (!_GetEventBlock(itrEvent)) return;
+
+	for (auto& [type, batch] : mapEventBatch_) {
+		size_t countEvent = batch.countEvent;
+		if (countEvent == 0) continue;
+
+		size_t countArgument = batch.countArgument;
+		std::vector<gstd::value> listArgument(countArgument);
+		{
+			listValueBatchColumn_.resize(countEvent);
+			for (size_t iArg = 0; iArg < countArgument; ++iArg) {
+				for (size_t iEvent = 0; iEvent < countEvent; ++iEvent)
+					listValueBatchColumn_[iEvent] = std::move(batch.listValue[iEvent * countArgument + iArg]);
+				listArgument[iArg] = CreateValueArrayValue(listValueBatchColumn_);
+			}
+			listValueBatchColumn_.clear();
+		}
+
+		//Clear the batch before running, the event may queue more events of the same type
+		batch.countEvent = 0;
+		batch.listValue.clear();
+
+		_RunEvent(itrEvent, type, listArgument.data(), countArgument);
+		if (bError_) break;
+	}
+}
+
 
 
 //STG制御共通関数：スクリプト操作
@@ -650,6 +768,16 @@ gstd::value ManagedScript::Func_NotifyEventAll(script_machine* machine, int argc
 
 	return value();
 }
+gstd::value ManagedScript::Func_SetEventCoalescing(script_machine* machine, int argc, const value* argv) {
+	ManagedScript* script = (ManagedScript*)machine->data;
+	script->CheckRunInMainThread();
+
+	int type = argv[0].as_int();
+	bool bEnable = argv[1].as_boolean();
+	script->SetEventCoalescing(type, bEnable);
+
+	return value();
+}
 gstd::value ManagedScript::Func_PauseScript(script_machine* machine, int argc, const value* argv) {
 	ManagedScript* script = (ManagedScript*)machine->data;
 	script->CheckRunInMainThread();
@@ -77,10 +77,17 @@ namespace directx {
 		shared_ptr<ManagedScript> LoadScriptInThread(const std::wstring& path, int type);
 		virtual void CallFromLoadThread(shared_ptr<gstd::FileManager::LoadThreadEvent> event);
 
+		//Compiles the scripts into the engine cache on worker threads, so that later LoadScript calls skip compilation.
+		//	Failed scripts are left out of the cache and report their errors when loaded normally.
+		void CompileScriptInParallel(const std::vector<std::pair<std::wstring, int>>& listScript);
+
 		void UnloadScript(int64_t id);
 		void UnloadScript(shared_ptr<ManagedScript> script);
 
 		virtual shared_ptr<ManagedScript> Create(int type) = 0;
+		//A client with the builtin functions and constants of the type, not registered to the manager and without a script ID.
+		//	Only meant for compiling, managers that don't support it return nullptr.
+		virtual shared_ptr<ManagedScript> CreateClient(int type) { return nullptr; }
 
 		virtual void RequestEventAll(int type, const gstd::value* listValue = nullptr, size_t countArgument = 0);
 
@@ -132,6 +139,27 @@ namespace directx {
 		int typeEvent_;
 		gstd::value* listValueEvent_;
 		size_t listValueEventSize_;
+
+		//The "Event" block is looked up once and reused by every RequestEvent
+		bool bEventBlockCached_;
+		bool bEventBlockExists_;
+		std::map<std::string, script_block*>::iterator itrEventBlock_;
+
+		//Events of a coalesced type are queued and delivered once per frame,
+		//	each argument becomes an array holding that argument of every queued event
+		struct EventBatch {
+			bool bEnable;
+			size_t countArgument;
+			size_t countEvent;
+			std::vector<gstd::type_data*> listType;		//Argument types of the first queued event
+			std::vector<gstd::value> listValue;
+		};
+		std::map<int, EventBatch> mapEventBatch_;
+		std::vector<gstd::value> listValueBatchColumn_;
+	protected:
+		bool _GetEventBlock(std::map<std::string, script_block*>::iterator& res);
+		gstd::value _RunEvent(std::map<std::string, script_block*>::iterator itrEvent,
+			int type, const gstd::value* listValue, size_t countArgument);
 	public:
 		ManagedScript();
 		virtual ~ManagedScript();
@@ -160,6 +188,9 @@ namespace directx {
 		gstd::value RequestEvent(int type);
 		gstd::value RequestEvent(int type, const gstd::value* listValue, size_t countArgument);
 
+		void SetEventCoalescing(int type, bool bEnable);
+		void DispatchEventBatch();
+
 		//制御共通関数：共通データ
 		static gstd::value Func_SaveCommonDataAreaA1(gstd::script_machine* machine, int argc, const gstd::value* argv);
 		static gstd::value Func_LoadCommonDataAreaA1(gstd::script_machine* machine, int argc, const gstd::value* argv);
@@ -184,6 +215,7 @@ namespace directx {
 		static gstd::value Func_NotifyEvent(gstd::script_machine* machine, int argc, const gstd::value* argv);
 		DNH_FUNCAPI_DECL_(Func_NotifyEventOwn);
 		static gstd::value Func_NotifyEventAll(gstd::script_machine* machine, int argc, const gstd::value* argv);
+		DNH_FUNCAPI_DECL_(Func_SetEventCoalescing);
 		DNH_FUNCAPI_DECL_(Func_PauseScript);
 
 		DNH_FUNCAPI_DECL_(Func_GetScriptStatus);
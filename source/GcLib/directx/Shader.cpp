@@ -15,6 +15,7 @@ ShaderData::ShaderData() {
 	pIncludeCallback_ = nullptr;
 	bLoad_ = false;
 	bText_ = false;
+	pLastParamOwner_ = nullptr;
 }
 ShaderData::~ShaderData() {
 	ptr_release(effect_);
@@ -27,6 +28,9 @@ void ShaderData::ReleaseDxResource() {
 void ShaderData::RestoreDxResource() {
 	if (effect_ == nullptr) return;
 	effect_->OnResetDevice();
+
+	binding_.Invalidate();
+	pLastParamOwner_ = nullptr;
 }
 
 //*******************************************************************
@@ -36,12 +40,14 @@ ShaderParameter::ShaderParameter(D3DXHANDLE handle) {
 	handle_ = handle;
 	type_ = ShaderParameterType::Unknown;
 	texture_ = nullptr;
+	bDirty_ = false;
 }
 ShaderParameter::~ShaderParameter() {
 }
 
 void ShaderParameter::SubmitData(ID3DXEffect* effect) {
 	if (effect == nullptr) return;
+	bDirty_ = false;
 	switch (type_) {
 	case ShaderParameterType::Texture:
 		if (texture_)
@@ -63,48 +69,56 @@ void ShaderParameter::SubmitData(ID3DXEffect* effect) {
 
 void ShaderParameter::SetInt(const int32_t value) {
 	type_ = ShaderParameterType::Int;
+	bDirty_ = true;
 
 	value_.resize(sizeof(int32_t));
 	memcpy(value_.data(), &value, sizeof(int32_t));
 }
 void ShaderParameter::SetIntArray(const std::vector<int32_t>& values) {
 	type_ = ShaderParameterType::IntArray;
+	bDirty_ = true;
 
 	value_.resize(values.size() * sizeof(int32_t));
 	memcpy(value_.data(), values.data(), values.size() * sizeof(int32_t));
 }
 void ShaderParameter::SetFloat(const float value) {
 	type_ = ShaderParameterType::Float;
+	bDirty_ = true;
 
 	value_.resize(sizeof(float));
 	memcpy(value_.data(), &value, sizeof(float));
 }
 void ShaderParameter::SetFloatArray(const std::vector<float>& values) {
 	type_ = ShaderParameterType::FloatArray;
+	bDirty_ = true;
 
 	value_.resize(values.size() * sizeof(float));
 	memcpy(value_.data(), values.data(), values.size() * sizeof(float));
 }
 void ShaderParameter::SetVector(const D3DXVECTOR4& vector) {
 	type_ = ShaderParameterType::Vector;
+	bDirty_ = true;
 
 	value_.resize(sizeof(D3DXVECTOR4));
 	memcpy(value_.data(), &vector, sizeof(D3DXVECTOR4));
 }
 void ShaderParameter::SetMatrix(const D3DXMATRIX& matrix) {
 	type_ = ShaderParameterType::Matrix;
+	bDirty_ = true;
 
 	value_.resize(sizeof(D3DXMATRIX));
 	memcpy(value_.data(), &matrix, sizeof(D3DXMATRIX));
 }
 void ShaderParameter::SetMatrixArray(const std::vector<D3DXMATRIX>& listMatrix) {
 	type_ = ShaderParameterType::MatrixArray;
+	bDirty_ = true;
 
 	value_.resize(listMatrix.size() * sizeof(D3DXMATRIX));
 	memcpy(value_.data(), listMatrix.data(), listMatrix.size() * sizeof(D3DXMATRIX));
 }
 void ShaderParameter::SetTexture(shared_ptr<Texture> texture) {
 	type_ = ShaderParameterType::Texture;
+	bDirty_ = true;
 
 	texture_ = texture;
 }
@@ -162,6 +176,9 @@ void Shader::Release() {
 	{
 		Lock lock(ShaderManager::GetBase()->GetLock());
 		if (data_) {
+			if (data_->pLastParamOwner_ == this)
+				data_->pLastParamOwner_ = nullptr;
+
 			ShaderManager* manager = data_->manager_;
 			if (manager) {
 				auto itrData = manager->IsDataExistsItr(data_->name_);
@@ -250,13 +267,20 @@ bool Shader::LoadParameter() {
 	ID3DXEffect* effect = GetEffect();
 	if (effect == nullptr) return false;
 
-	HRESULT hr = S_OK;
+	ShaderSemanticBinding* binding = &data_->binding_;
 
-	for (auto itrParam = mapParam_.begin(); itrParam != mapParam_.end(); ++itrParam) {
-		D3DXHANDLE name = itrParam->first;
-		ShaderParameter* param = &itrParam->second;
+	//If the effect still holds this shader's values, only the changed ones need to be submitted.
+	//Textures are always submitted, as the underlying D3D texture can be recreated,
+	//	and so are parameters shared with an engine semantic, as the renderer may have overwritten them.
+	bool bOwner = data_->pLastParamOwner_ == this;
+	data_->pLastParamOwner_ = this;
 
-		param->SubmitData(effect);
+	for (ShaderParameter& param : listParam_) {
+		if (bOwner && !param.IsDirty() && param.GetType() != ShaderParameterType::Texture
+			&& !binding->IsBound(param.GetHandle()))
+			continue;
+		param.SubmitData(effect);
+		binding->Invalidate(param.GetHandle());
 	}
 
 	return true;
@@ -265,17 +289,15 @@ ShaderParameter* Shader::_GetParameter(const std::string& name, bool bCreate) {
 	if (data_ == nullptr || data_->effect_ == nullptr) return nullptr;
 	D3DXHANDLE handle = data_->effect_->GetParameterByName(nullptr, name.c_str());
 	if (handle) {
-		auto itr = mapParam_.find(handle);
-		bool bFind = itr != mapParam_.end();
-		if (!bFind && !bCreate) return nullptr;
-
-		if (!bFind) {
-			auto itrInsert = mapParam_.insert({ handle, ShaderParameter(handle) });
-			return &itrInsert.first->second;
-		}
-		else {
-			return &itr->second;
+		//Shaders rarely have more than a handful of parameters, a linear search beats a tree here
+		for (ShaderParameter& param : listParam_) {
+			if (param.GetHandle() == handle)
+				return &param;
 		}
+		if (!bCreate) return nullptr;
+
+		listParam_.push_back(ShaderParameter(handle));
+		return &listParam_.back();
 	}
 	return nullptr;
 }
@@ -497,6 +519,7 @@ bool ShaderManager::_CreateFromFile(const std::wstring& path, shared_ptr<ShaderD
 			dest->manager_ = this;
 			dest->name_ = path;
 			dest->bLoad_ = true;
+			dest->binding_.Bind(dest->effect_);
 
 			mapShaderData_[path] = dest;
 
@@ -548,6 +571,7 @@ bool ShaderManager::_CreateFromText(const std::wstring& name, const std::string&
 			dest->manager_ = this;
 			dest->name_ = name;
 			dest->bLoad_ = true;
+			dest->binding_.Bind(dest->effect_);
 			dest->bText_ = true;
 
 			mapShaderData_[name] = dest;
@@ -589,6 +613,7 @@ bool ShaderManager::_CreateCloneFromEffect(ID3DXEffect* effect, shared_ptr<Shade
 			dest->manager_ = this;
 			dest->name_ = shaderID;
 			dest->bLoad_ = true;
+			dest->binding_.Bind(dest->effect_);
 			dest->bText_ = true;
 
 			mapShaderData_[shaderID] = dest;
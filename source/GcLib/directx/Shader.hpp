@@ -5,6 +5,7 @@
 #include "DxConstant.hpp"
 #include "DirectGraphics.hpp"
 #include "Texture.hpp"
+#include "HLSL.hpp"
 
 namespace directx {
 	class ShaderManager;
@@ -27,11 +28,15 @@ namespace directx {
 		std::wstring name_;
 		bool bLoad_;
 		bool bText_;
+
+		ShaderSemanticBinding binding_;
+		Shader* pLastParamOwner_;		//The Shader whose parameters were last submitted to effect_
 	public:
 		ShaderData();
 		virtual ~ShaderData();
 
 		std::wstring& GetName() { return name_; }
+		ShaderSemanticBinding* GetBinding() { return &binding_; }
 
 		void ReleaseDxResource();
 		void RestoreDxResource();
@@ -126,6 +131,7 @@ namespace directx {
 		ShaderParameterType type_;
 		std::vector<byte> value_;
 		shared_ptr<Texture> texture_;
+		bool bDirty_;
 	public:
 		ShaderParameter(D3DXHANDLE handle);
 		virtual ~ShaderParameter();
@@ -134,6 +140,7 @@ namespace directx {
 
 		D3DXHANDLE GetHandle() { return handle_; }
 		ShaderParameterType GetType() { return type_; }
+		bool IsDirty() { return bDirty_; }
 
 		void SetInt(const int32_t value);
 		void SetIntArray(const std::vector<int32_t>& values);
@@ -165,7 +172,7 @@ namespace directx {
 		shared_ptr<ShaderData> data_;
 
 		std::string technique_;
-		std::map<D3DXHANDLE, ShaderParameter> mapParam_;
+		std::vector<ShaderParameter> listParam_;
 
 		ShaderData* _GetShaderData() { return data_.get(); }
 		ShaderParameter* _GetParameter(const std::string& name, bool bCreate);
@@ -181,6 +188,7 @@ namespace directx {
 
 		shared_ptr<ShaderData> GetData() { return data_; }
 		ID3DXEffect* GetEffect();
+		ShaderSemanticBinding* GetBinding() { return data_ ? &data_->binding_ : nullptr; }
 
 		bool CreateFromFile(const std::wstring& path);
 		bool CreateFromText(const std::wstring& name, const std::string& source);
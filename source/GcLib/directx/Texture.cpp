@@ -246,6 +246,269 @@ size_t Texture::GetFormatBPP(D3DFORMAT format) {
 	}
 }
 
+//****************************************************************************
+//TextureImage
+//****************************************************************************
+UINT TextureImage::GetRowCount(D3DFORMAT format, UINT height) {
+	switch (format) {
+	case D3DFMT_DXT1:
+	case D3DFMT_DXT2:
+	case D3DFMT_DXT3:
+	case D3DFMT_DXT4:
+	case D3DFMT_DXT5:
+		return std::max((height + 3U) / 4U, 1U);
+	}
+	return height;
+}
+
+//****************************************************************************
+//TextureDecoder
+//****************************************************************************
+TextureDecoder::TextureDecoder() {
+	bStop_ = false;
+	bCache_ = false;
+	dirCache_ = PathProperty::GetModuleDirectory() + L"cache/texture/";
+}
+TextureDecoder::~TextureDecoder() {
+	Stop();
+}
+void TextureDecoder::Start(size_t countThread) {
+	Stop();
+
+	bStop_ = false;
+	for (size_t i = 0; i < countThread; ++i) {
+		WorkerThread* thread = new WorkerThread(this);
+		listWorker_.push_back(unique_ptr<WorkerThread>(thread));
+		thread->Start();
+	}
+}
+void TextureDecoder::Stop() {
+	bStop_ = true;
+	for (auto& thread : listWorker_) {
+		signalTask_.SetSignal(true);
+		thread->Join();
+	}
+	listWorker_.clear();
+
+	//Unfinished decodes report a broken promise to whoever waits on them
+	Lock lock(lock_);
+	listTask_.clear();
+}
+void TextureDecoder::WorkerThread::_Run() {
+	while (!decoder_->bStop_) {
+		std::packaged_task<shared_ptr<TextureImage>()> task;
+		{
+			Lock lock(decoder_->lock_);
+			if (decoder_->listTask_.size() > 0) {
+				task = std::move(decoder_->listTask_.front());
+				decoder_->listTask_.pop_front();
+			}
+		}
+
+		if (task.valid()) task();
+		else decoder_->signalTask_.Wait(100);
+	}
+}
+
+uint64_t TextureDecoder::_GetSourceHash(const std::string& source, bool genMipmap, bool flgNonPowerOfTwo) {
+	byte suffix[2] = { (byte)CACHE_VERSION, (byte)((genMipmap ? 0x1 : 0x0) | (flgNonPowerOfTwo ? 0x2 : 0x0)) };
+	uint64_t hash = Hash::Fnv1a(source.data(), source.size());
+	return Hash::Fnv1a(suffix, sizeof(suffix), hash);
+}
+shared_ptr<TextureImage> TextureDecoder::_ReadCache(const std::wstring& pathCache) {
+	File file(pathCache);
+	if (!file.IsExists() || !file.Open()) return nullptr;
+
+	shared_ptr<TextureImage> image(new TextureImage());
+	try {
+		if (file.ReadValue<uint32_t>() != CACHE_VERSION) return nullptr;
+
+		file.Read(image->infoImage_);
+		file.Read(image->format_);
+
+		uint32_t countLevel = file.ReadValue<uint32_t>();
+		if (countLevel == 0 || countLevel > 16) return nullptr;
+
+		image->listLevel_.resize(countLevel);
+		for (TextureImage::Level& level : image->listLevel_) {
+			file.Read(level.width);
+			file.Read(level.height);
+			file.Read(level.pitch);
+
+			size_t size = level.pitch * TextureImage::GetRowCount(image->format_, level.height);
+			level.data.resize(size);
+			if (file.Read(level.data.data(), size) != size) return nullptr;
+		}
+	}
+	catch (...) {
+		return nullptr;
+	}
+
+	//The cache may have been written on a device that supports other formats
+	{
+		TextureImage::Level& level = image->listLevel_[0];
+		UINT width = level.width;
+		UINT height = level.height;
+		UINT countLevel = image->listLevel_.size();
+		D3DFORMAT format = image->format_;
+		HRESULT hr = D3DXCheckTextureRequirements(DirectGraphics::GetBase()->GetDevice(),
+			&width, &height, &countLevel, 0, &format, D3DPOOL_MANAGED);
+		if (FAILED(hr) || format != image->format_ || width != level.width || height != level.height)
+			return nullptr;
+	}
+
+	return image;
+}
+void TextureDecoder::_WriteCache(const std::wstring& pathCache, TextureImage* image) {
+	//Other threads may be decoding the same image
+	File::WriteAtomic(pathCache, [&](File& file) {
+		file.WriteValue<uint32_t>(CACHE_VERSION);
+		file.Write(image->infoImage_);
+		file.Write(image->format_);
+		file.WriteValue<uint32_t>(image->listLevel_.size());
+		for (TextureImage::Level& level : image->listLevel_) {
+			file.Write(level.width);
+			file.Write(level.height);
+			file.Write(level.pitch);
+			file.Write(level.data.data(), level.data.size());
+		}
+		return true;
+	});
+}
+shared_ptr<TextureImage> TextureDecoder::_Decode(const std::string& source, bool genMipmap, bool flgNonPowerOfTwo) {
+	IDirect3DDevice9* device = DirectGraphics::GetBase()->GetDevice();
+
+	shared_ptr<TextureImage> image(new TextureImage());
+
+	//Scratch textures live in system memory and aren't affected by device resets.
+	//	The source image's information is returned by the same call, the header doesn't need to be parsed again.
+	IDirect3DTexture9* pTexture = nullptr;
+	HRESULT hr = D3DXCreateTextureFromFileInMemoryEx(device,
+		source.c_str(), source.size(),
+		flgNonPowerOfTwo ? D3DX_DEFAULT_NONPOW2 : D3DX_DEFAULT,
+		flgNonPowerOfTwo ? D3DX_DEFAULT_NONPOW2 : D3DX_DEFAULT,
+		genMipmap ? D3DX_DEFAULT : 1, 0,
+		D3DFMT_UNKNOWN, D3DPOOL_SCRATCH, D3DX_FILTER_BOX, D3DX_DEFAULT, 0x00000000,
+		&image->infoImage_, nullptr, &pTexture);
+	if (FAILED(hr))
+		throw wexception("D3DXCreateTextureFromFileInMemoryEx failure.");
+
+	//Scratch textures accept any format and size, convert to what the device takes for managed textures
+	{
+		D3DSURFACE_DESC desc;
+		pTexture->GetLevelDesc(0, &desc);
+
+		UINT width = desc.Width;
+		UINT height = desc.Height;
+		UINT countLevel = pTexture->GetLevelCount();
+		D3DFORMAT format = desc.Format;
+		D3DXCheckTextureRequirements(device, &width, &height, &countLevel, 0, &format, D3DPOOL_MANAGED);
+
+		if (format != desc.Format || width != desc.Width || height != desc.Height 
+			|| countLevel != pTexture->GetLevelCount())
+		{
+			IDirect3DTexture9* pConverted = nullptr;
+			hr = D3DXCreateTexture(device, width, height, countLevel, 0, format, D3DPOOL_SCRATCH, &pConverted);
+			if (SUCCEEDED(hr)) {
+				IDirect3DSurface9* pSurfaceSrc = nullptr;
+				IDirect3DSurface9* pSurfaceDst = nullptr;
+				pTexture->GetSurfaceLevel(0, &pSurfaceSrc);
+				pConverted->GetSurfaceLevel(0, &pSurfaceDst);
+				hr = D3DXLoadSurfaceFromSurface(pSurfaceDst, nullptr, nullptr, pSurfaceSrc, nullptr, nullptr,
+					D3DX_FILTER_BOX, 0x00000000);
+				ptr_release(pSurfaceSrc);
+				ptr_release(pSurfaceDst);
+
+				if (SUCCEEDED(hr) && countLevel > 1)
+					hr = D3DXFilterTexture(pConverted, nullptr, 0, D3DX_FILTER_BOX);
+			}
+
+			ptr_release(pTexture);
+			pTexture = pConverted;
+			if (FAILED(hr)) {
+				ptr_release(pTexture);
+				throw wexception("Texture format conversion failure.");
+			}
+		}
+	}
+
+	image->format_ = D3DFMT_UNKNOWN;
+	image->listLevel_.resize(pTexture->GetLevelCount());
+	for (DWORD iLevel = 0; iLevel < image->listLevel_.size(); ++iLevel) {
+		TextureImage::Level& level = image->listLevel_[iLevel];
+
+		D3DSURFACE_DESC desc;
+		pTexture->GetLevelDesc(iLevel, &desc);
+		image->format_ = desc.Format;
+
+		D3DLOCKED_RECT rect;
+		hr = pTexture->LockRect(iLevel, &rect, nullptr, D3DLOCK_READONLY);
+		if (FAILED(hr)) {
+			ptr_release(pTexture);
+			throw wexception("LockRect failure.");
+		}
+
+		level.width = desc.Width;
+		level.height = desc.Height;
+		level.pitch = rect.Pitch;
+		level.data.resize(rect.Pitch * TextureImage::GetRowCount(desc.Format, desc.Height));
+		memcpy(level.data.data(), rect.pBits, level.data.size());
+
+		pTexture->UnlockRect(iLevel);
+	}
+	ptr_release(pTexture);
+
+	return image;
+}
+shared_ptr<TextureImage> TextureDecoder::Decode(const std::wstring& path, bool genMipmap, bool flgNonPowerOfTwo) {
+	auto timeStart = stdch::steady_clock::now();
+	auto _GetElapsed = [&]() -> double {
+		return stdch::duration<double, std::milli>(stdch::steady_clock::now() - timeStart).count();
+	};
+
+	shared_ptr<FileReader> reader = FileManager::GetBase()->GetFileReader(path);
+	if (reader == nullptr || !reader->Open())
+		throw wexception(ErrorUtility::GetFileNotFoundErrorMessage(PathProperty::ReduceModuleDirectory(path), true));
+
+	std::string source = reader->ReadAllString();
+
+	std::wstring pathCache;
+	if (bCache_) {
+		uint64_t hash = _GetSourceHash(source, genMipmap, flgNonPowerOfTwo);
+		pathCache = dirCache_ + StringUtility::Format(L"%016llx.dat", hash);
+
+		if (shared_ptr<TextureImage> image = _ReadCache(pathCache)) {
+			image->bFromCache_ = true;
+			image->timeDecode_ = _GetElapsed();
+			return image;
+		}
+	}
+
+	shared_ptr<TextureImage> image = _Decode(source, genMipmap, flgNonPowerOfTwo);
+	image->timeDecode_ = _GetElapsed();
+	if (pathCache.size() > 0)
+		_WriteCache(pathCache, image.get());
+
+	return image;
+}
+TextureDecoder::ImageFuture TextureDecoder::DecodeAsync(const std::wstring& path, bool genMipmap, bool flgNonPowerOfTwo) {
+	std::packaged_task<shared_ptr<TextureImage>()> task([=]() {
+		return Decode(path, genMipmap, flgNonPowerOfTwo);
+	});
+	ImageFuture res = task.get_future().share();
+
+	if (listWorker_.size() > 0) {
+		{
+			Lock lock(lock_);
+			listTask_.push_back(std::move(task));
+		}
+		signalTask_.SetSignal(true);
+	}
+	else task();
+
+	return res;
+}
+
 //****************************************************************************
 //TextureManager
 //****************************************************************************
@@ -260,6 +523,7 @@ TextureManager::~TextureManager() {
 	this->Clear();
 
 	FileManager::GetBase()->RemoveLoadThreadListener(this);
+	decoder_.Stop();
 
 	panelInfo_ = nullptr;
 	thisBase_ = nullptr;
@@ -277,6 +541,9 @@ bool TextureManager::Initialize() {
 
 	FileManager::GetBase()->AddLoadThreadListener(this);
 
+	//Leave a core for the main thread
+	decoder_.Start(std::clamp(std::thread::hardware_concurrency(), 2U, 5U) - 1U);
+
 	return res;
 }
 void TextureManager::Clear() {
@@ -425,36 +692,70 @@ void TextureManager::RestoreDxResource() {
 	}
 }
 
-void TextureManager::__CreateFromFile(shared_ptr<TextureData>& dst, const std::wstring& path, bool genMipmap, bool flgNonPowerOfTwo) {
-	DirectGraphics* graphics = DirectGraphics::GetBase();
-
-	shared_ptr<FileReader> reader = FileManager::GetBase()->GetFileReader(path);
-	if (reader == nullptr || !reader->Open())
-		throw wexception(ErrorUtility::GetFileNotFoundErrorMessage(PathProperty::ReduceModuleDirectory(path), true));
-
-	std::string source = reader->ReadAllString();
+std::wstring TextureManager::__CreateFromFile(shared_ptr<TextureData>& dst, const std::wstring& path, bool genMipmap, bool flgNonPowerOfTwo) {
+	shared_ptr<TextureImage> image;
+	if (dst->futureImage_.valid()) {
+		try {
+			image = dst->futureImage_.get();
+		}
+		catch (const std::future_error&) {
+			throw wexception("Texture decoding was cancelled.");
+		}
+		dst->futureImage_ = TextureDecoder::ImageFuture();
+	}
+	else {
+		image = decoder_.Decode(path, genMipmap, flgNonPowerOfTwo);
+	}
 
 	dst->useMipMap_ = genMipmap;
 	dst->useNonPowerOfTwo_ = flgNonPowerOfTwo;
 
-	HRESULT hr = D3DXCreateTextureFromFileInMemoryEx(DirectGraphics::GetBase()->GetDevice(),
-		source.c_str(), source.size(),
-		dst->useNonPowerOfTwo_ ? D3DX_DEFAULT_NONPOW2 : D3DX_DEFAULT,
-		dst->useNonPowerOfTwo_ ? D3DX_DEFAULT_NONPOW2 : D3DX_DEFAULT,
-		dst->useMipMap_ ? D3DX_DEFAULT : 1, 0,
-		D3DFMT_UNKNOWN, D3DPOOL_MANAGED, D3DX_FILTER_BOX, D3DX_DEFAULT, 0x00000000,
-		nullptr, nullptr, &(dst->pTexture_));
-	if (FAILED(hr))
-		throw wexception("D3DXCreateTextureFromFileInMemoryEx failure.");
-
-	hr = D3DXGetImageInfoFromFileInMemory(source.c_str(), source.size(), &dst->infoImage_);
-	if (FAILED(hr))
-		throw wexception("D3DXGetImageInfoFromFileInMemory failure.");
-	dst->CalculateResourceSize();
+	auto timeUpload = stdch::steady_clock::now();
+	_CreateFromImage(dst, image.get());
 
 	dst->manager_ = this;
 	dst->name_ = path;
 	dst->type_ = TextureData::Type::TYPE_TEXTURE;
+
+	return StringUtility::Format(L"decode%s=%.2fms, upload=%.2fms",
+		image->bFromCache_ ? L"(cache)" : L"", image->timeDecode_,
+		stdch::duration<double, std::milli>(stdch::steady_clock::now() - timeUpload).count());
+}
+void TextureManager::_CreateFromImage(shared_ptr<TextureData>& dst, TextureImage* image) {
+	IDirect3DDevice9* device = DirectGraphics::GetBase()->GetDevice();
+
+	TextureImage::Level& levelTop = image->listLevel_[0];
+	HRESULT hr = device->CreateTexture(levelTop.width, levelTop.height, image->listLevel_.size(), 0, 
+		image->format_, D3DPOOL_MANAGED, &dst->pTexture_, nullptr);
+	if (FAILED(hr))
+		throw wexception("CreateTexture failure.");
+
+	for (DWORD iLevel = 0; iLevel < image->listLevel_.size(); ++iLevel) {
+		TextureImage::Level& level = image->listLevel_[iLevel];
+
+		D3DLOCKED_RECT rect;
+		hr = dst->pTexture_->LockRect(iLevel, &rect, nullptr, 0);
+		if (FAILED(hr)) {
+			ptr_release(dst->pTexture_);
+			throw wexception("LockRect failure.");
+		}
+
+		UINT countRow = TextureImage::GetRowCount(image->format_, level.height);
+		if (rect.Pitch == level.pitch) {
+			memcpy(rect.pBits, level.data.data(), level.data.size());
+		}
+		else {
+			UINT sizeRow = std::min<UINT>(rect.Pitch, level.pitch);
+			for (UINT iRow = 0; iRow < countRow; ++iRow) {
+				memcpy((byte*)rect.pBits + iRow * rect.Pitch, level.data.data() + iRow * level.pitch, sizeRow);
+			}
+		}
+
+		dst->pTexture_->UnlockRect(iLevel);
+	}
+
+	dst->infoImage_ = image->infoImage_;
+	dst->CalculateResourceSize();
 }
 bool TextureManager::_CreateFromFile(shared_ptr<TextureData>& dst, const std::wstring& path, bool genMipmap, bool flgNonPowerOfTwo) {
 	DirectGraphics* graphics = DirectGraphics::GetBase();
@@ -465,10 +766,10 @@ bool TextureManager::_CreateFromFile(shared_ptr<TextureData>& dst, const std::ws
 	std::wstring pathReduce = PathProperty::ReduceModuleDirectory(path);
 	try {
 		data.reset(new TextureData());
-		__CreateFromFile(data, path, genMipmap, flgNonPowerOfTwo);
+		std::wstring timing = __CreateFromFile(data, path, genMipmap, flgNonPowerOfTwo);
 
-		Logger::WriteTop(StringUtility::Format(L"TextureManager: Texture loaded. [%s]",
-			pathReduce.c_str()));
+		Logger::WriteTop(StringUtility::Format(L"TextureManager: Texture loaded. [%s] (%s)",
+			pathReduce.c_str(), timing.c_str()));
 	}
 	catch (wexception& e) {
 		std::wstring str = StringUtility::Format(L"TextureManager: Failed to load texture \"%s\"\r\n    %s", 
@@ -677,6 +978,9 @@ shared_ptr<Texture> TextureManager::CreateFromFileInLoadThread(const std::wstrin
 					}
 				}
 
+				//Decoding starts right away on the decoder's threads, the load thread only uploads the result
+				data->futureImage_ = decoder_.DecodeAsync(path, genMipmap, flgNonPowerOfTwo);
+
 				res->data_ = data;
 				mapTextureData_[path] = data;
 				{
@@ -708,11 +1012,12 @@ void TextureManager::CallFromLoadThread(shared_ptr<FileManager::LoadThreadEvent>
 
 		std::wstring pathReduce = PathProperty::ReduceModuleDirectory(path);
 		try {
-			__CreateFromFile(data, path, data->useMipMap_, data->useNonPowerOfTwo_);
+			std::wstring timing = __CreateFromFile(data, path, data->useMipMap_, data->useNonPowerOfTwo_);
 
 			data->bReady_ = true;
 
-			Logger::WriteTop(StringUtility::Format(L"TextureManager(LT): Texture loaded. [%s]", pathReduce.c_str()));
+			Logger::WriteTop(StringUtility::Format(L"TextureManager(LT): Texture loaded. [%s] (%s)",
+				pathReduce.c_str(), timing.c_str()));
 		}
 		catch (wexception& e) {
 			std::wstring str = StringUtility::Format(L"TextureManager(LT): Failed to load texture \"%s\"\r\n    %s",
@@ -738,6 +1043,20 @@ shared_ptr<Texture> TextureManager::GetTexture(const std::wstring& name) {
 		return itr->second;
 	return nullptr;
 }
+std::vector<shared_ptr<TextureData>> TextureManager::GetFileTextureDataList() {
+	std::vector<shared_ptr<TextureData>> res;
+	{
+		Lock lock(lock_);
+
+		for (auto itr = mapTextureData_.begin(); itr != mapTextureData_.end(); ++itr) {
+			shared_ptr<TextureData>& data = itr->second;
+			if (data == nullptr || !data->bReady_) continue;
+			if (data->type_ != TextureData::Type::TYPE_TEXTURE || data->pTexture_ == nullptr) continue;
+			res.push_back(data);
+		}
+	}
+	return res;
+}
 
 void TextureManager::Add(const std::wstring& name, shared_ptr<Texture> texture) {
 	{
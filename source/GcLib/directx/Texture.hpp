@@ -11,6 +11,77 @@ namespace directx {
 	class TextureManager;
 	class TextureInfoPanel;
 
+	//****************************************************************************
+	//TextureImage
+	//	Decoded pixels of an image file, in the format and size its texture will be created with
+	//****************************************************************************
+	class TextureImage {
+	public:
+		struct Level {
+			UINT width;
+			UINT height;
+			UINT pitch;
+			std::vector<byte> data;
+		};
+	public:
+		D3DXIMAGE_INFO infoImage_;
+		D3DFORMAT format_;
+		std::vector<Level> listLevel_;
+
+		bool bFromCache_ = false;
+		double timeDecode_ = 0;		//In milliseconds, including the file read
+
+		static UINT GetRowCount(D3DFORMAT format, UINT height);
+	};
+
+	//****************************************************************************
+	//TextureDecoder
+	//	Decodes image files into mip chains on worker threads, without touching the device's state.
+	//	Decoded images can be kept in a disk cache keyed by the hash of the file's contents.
+	//****************************************************************************
+	class TextureDecoder {
+	public:
+		using ImageFuture = std::shared_future<shared_ptr<TextureImage>>;
+		enum : uint32_t {
+			CACHE_VERSION = 1,
+		};
+	protected:
+		class WorkerThread : public gstd::Thread {
+			TextureDecoder* decoder_;
+		public:
+			WorkerThread(TextureDecoder* decoder) { decoder_ = decoder; }
+		protected:
+			virtual void _Run();
+		};
+	protected:
+		gstd::CriticalSection lock_;
+		gstd::ThreadSignal signalTask_;
+		std::list<std::packaged_task<shared_ptr<TextureImage>()>> listTask_;
+		std::vector<unique_ptr<WorkerThread>> listWorker_;
+		std::atomic_bool bStop_;
+
+		std::atomic_bool bCache_;
+		std::wstring dirCache_;
+
+		static uint64_t _GetSourceHash(const std::string& source, bool genMipmap, bool flgNonPowerOfTwo);
+		shared_ptr<TextureImage> _ReadCache(const std::wstring& pathCache);
+		void _WriteCache(const std::wstring& pathCache, TextureImage* image);
+		shared_ptr<TextureImage> _Decode(const std::string& source, bool genMipmap, bool flgNonPowerOfTwo);
+	public:
+		TextureDecoder();
+		virtual ~TextureDecoder();
+
+		void Start(size_t countThread);
+		void Stop();
+
+		void SetCacheEnable(bool bEnable) { bCache_ = bEnable; }
+		bool IsCacheEnable() { return bCache_; }
+
+		//Throws gstd::wexception on failure
+		shared_ptr<TextureImage> Decode(const std::wstring& path, bool genMipmap, bool flgNonPowerOfTwo);
+		ImageFuture DecodeAsync(const std::wstring& path, bool genMipmap, bool flgNonPowerOfTwo);
+	};
+
 	//****************************************************************************
 	//Texture
 	//****************************************************************************
@@ -35,6 +106,9 @@ namespace directx {
 		bool useMipMap_;
 		bool useNonPowerOfTwo_;
 
+		//Pending decode of a texture requested in the load thread
+		TextureDecoder::ImageFuture futureImage_;
+
 		IDirect3DTexture9* pTexture_;
 		IDirect3DSurface9* lpRenderSurface_;
 		IDirect3DSurface9* lpRenderZ_;
@@ -106,10 +180,14 @@ namespace directx {
 		std::list<std::pair<std::map<std::wstring, shared_ptr<TextureData>>::iterator, IDirect3DSurface9*>> listRefreshSurface_;
 		shared_ptr<TextureInfoPanel> panelInfo_;
 
+		TextureDecoder decoder_;
+
 		void _ReleaseTextureData(const std::wstring& name);
 		void _ReleaseTextureData(std::map<std::wstring, shared_ptr<TextureData>>::iterator itr);
 
-		void __CreateFromFile(shared_ptr<TextureData>& dst, const std::wstring& path, bool genMipmap, bool flgNonPowerOfTwo);
+		//Returns the decode and upload times for the log
+		std::wstring __CreateFromFile(shared_ptr<TextureData>& dst, const std::wstring& path, bool genMipmap, bool flgNonPowerOfTwo);
+		void _CreateFromImage(shared_ptr<TextureData>& dst, TextureImage* image);
 		bool _CreateFromFile(shared_ptr<TextureData>& dst, const std::wstring& path, bool genMipmap, bool flgNonPowerOfTwo);
 		bool _CreateRenderTarget(shared_ptr<TextureData>& dst, const std::wstring& name, 
 			size_t width = 0U, size_t height = 0U, bool bManaged = true);
@@ -139,6 +217,8 @@ namespace directx {
 
 		shared_ptr<TextureData> GetTextureData(const std::wstring& name);
 		shared_ptr<Texture> GetTexture(const std::wstring& name);
+		//Every fully loaded texture that was created from a file
+		std::vector<shared_ptr<TextureData>> GetFileTextureDataList();
 		
 		shared_ptr<Texture> CreateFromFile(const std::wstring& path, bool genMipmap, bool flgNonPowerOfTwo);
 		shared_ptr<Texture> CreateRenderTarget(const std::wstring& name, size_t width = 0U, size_t height = 0U);
@@ -147,6 +227,7 @@ namespace directx {
 		virtual void CallFromLoadThread(shared_ptr<gstd::FileManager::LoadThreadEvent> event);
 
 		void SetInfoPanel(shared_ptr<TextureInfoPanel> panel) { panelInfo_ = panel; }
+		TextureDecoder* GetDecoder() { return &decoder_; }
 	};
 
 	//****************************************************************************
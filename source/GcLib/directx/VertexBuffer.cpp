@@ -241,11 +241,21 @@ namespace directx {
 		}
 		AssertBuffer(indexBuffer_->Create(usage, pool), L"IB");
 
+		for (size_t iRing = 0; iRing < 2; ++iRing) {
+			FixedVertexBuffer* pVB = vertexBuffers_[iRing].get();
+			ringVertex_[iRing].SetBuffer(pVB->GetBuffer(), pVB->GetSizeInBytes());
+		}
+		ringIndex_.SetBuffer(indexBuffer_->GetBuffer(), indexBuffer_->GetSizeInBytes());
+
 		AssertBuffer(vertexBufferGrowable_->Create(usage, pool), L"VB_Growable");
 		AssertBuffer(indexBufferGrowable_->Create(usage, pool), L"IB_Growable");
 		AssertBuffer(vertexBuffer_HWInstancing_->Create(usage, pool), L"VB_InstanceHW");
 	}
 	void VertexBufferManager::Release() {
+		for (auto& iRing : ringVertex_)
+			iRing.SetBuffer(nullptr, 0);
+		ringIndex_.SetBuffer(nullptr, 0);
+
 		for (auto& iVB : vertexBuffers_)
 			iVB->Release();
 		indexBuffer_->Release();
@@ -255,6 +265,29 @@ namespace directx {
 		vertexBuffer_HWInstancing_->Release();
 	}
 
+	void VertexBufferManager::EndFrame() {
+		for (auto& iRing : ringVertex_)
+			iRing.EndFrame();
+		ringIndex_.EndFrame();
+	}
+	TransientVertexRing::Stats VertexBufferManager::GetRingLastFrameStats() {
+		TransientVertexRing::Stats res;
+		auto _Add = [&](size_t countLock, size_t countDiscard, size_t countByte) {
+			res.countLock += countLock;
+			res.countDiscard += countDiscard;
+			res.countByte += countByte;
+		};
+		for (auto& iRing : ringVertex_) {
+			const auto& stats = iRing.GetLastFrameStats();
+			_Add(stats.countLock, stats.countDiscard, stats.countByte);
+		}
+		{
+			const auto& stats = ringIndex_.GetLastFrameStats();
+			_Add(stats.countLock, stats.countDiscard, stats.countByte);
+		}
+		return res;
+	}
+
 	BufferBase<IDirect3DVertexBuffer9>* VertexBufferManager::CreateExtraVertexBuffer() {
 		DirectGraphics* graphics = DirectGraphics::GetBase();
 		IDirect3DDevice9* device = graphics->GetDevice();
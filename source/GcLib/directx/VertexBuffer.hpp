@@ -133,6 +133,109 @@ namespace directx {
 		D3DFORMAT format_;
 	};
 
+	//*******************************************************************
+	//TransientBufferRing
+	//*******************************************************************
+	//Hands out short-lived slices of one dynamic buffer for per-draw data.
+	//Slices are appended with D3DLOCK_NOOVERWRITE, the buffer is only discarded when an allocation wraps around,
+	//	so the driver no longer has to rename the buffer for every object drawn.
+	//TBuffer is IDirect3DVertexBuffer9 or IDirect3DIndexBuffer9, which share the Lock/Unlock signatures.
+	template<class TBuffer>
+	class TransientBufferRing {
+	public:
+		struct Slice {
+			UINT offset = 0;	//In bytes
+			UINT start = 0;		//In elements, usable as the start vertex/index of a draw call
+			UINT count = 0;
+		};
+		struct Stats {
+			size_t countLock = 0;
+			size_t countDiscard = 0;
+			size_t countByte = 0;
+		};
+	private:
+		TBuffer* buffer_;
+		size_t capacity_;
+		size_t cursor_;
+		bool bDiscardNext_;
+
+		Stats statsFrame_;
+		Stats statsLastFrame_;
+	public:
+		TransientBufferRing() {
+			buffer_ = nullptr;
+			capacity_ = 0;
+			Reset();
+		}
+
+		void SetBuffer(TBuffer* buffer, size_t capacityInBytes) {
+			buffer_ = buffer;
+			capacity_ = buffer ? capacityInBytes : 0;
+			Reset();
+		}
+		TBuffer* GetBuffer() { return buffer_; }
+		size_t GetCapacity() { return capacity_; }
+		size_t GetCursor() { return cursor_; }
+
+		//The next allocation starts over from the beginning of a discarded buffer
+		void Reset() {
+			cursor_ = 0;
+			bDiscardNext_ = true;
+		}
+
+		//Copies count elements into a new slice, elements that do not fit into the whole buffer are dropped.
+		//The slice is aligned to the stride, so it can be drawn with the stream source offset left at 0.
+		HRESULT Write(const void* data, size_t count, size_t stride, Slice* pSlice) {
+			*pSlice = Slice();
+			if (buffer_ == nullptr) return E_POINTER;
+			if (data == nullptr || stride == 0) return S_OK;
+
+			count = std::min(count, capacity_ / stride);
+			size_t size = count * stride;
+			if (size == 0) return S_OK;
+
+			size_t offset = (cursor_ + stride - 1) / stride * stride;
+			DWORD flag = D3DLOCK_NOOVERWRITE;
+			if (bDiscardNext_ || offset + size > capacity_) {
+				offset = 0;
+				flag = D3DLOCK_DISCARD;
+			}
+
+			void* pDst = nullptr;
+			HRESULT hr = buffer_->Lock(offset, size, &pDst, flag);
+			if (FAILED(hr)) return hr;
+			memcpy(pDst, data, size);
+			buffer_->Unlock();
+
+			++statsFrame_.countLock;
+			if (flag == D3DLOCK_DISCARD)
+				++statsFrame_.countDiscard;
+			statsFrame_.countByte += size;
+
+			cursor_ = offset + size;
+			bDiscardNext_ = false;
+
+			pSlice->offset = offset;
+			pSlice->start = offset / stride;
+			pSlice->count = count;
+			return hr;
+		}
+		template<typename T>
+		HRESULT Write(const T& vecSrc, size_t countMax, size_t stride, Slice* pSlice) {
+			return Write((const void*)vecSrc.data(), std::min(countMax, vecSrc.size()), stride, pSlice);
+		}
+
+		//Moves the current frame's counters to the last frame's
+		void EndFrame() {
+			statsLastFrame_ = statsFrame_;
+			statsFrame_ = Stats();
+		}
+		const Stats& GetFrameStats() { return statsFrame_; }
+		const Stats& GetLastFrameStats() { return statsLastFrame_; }
+	};
+	using TransientVertexRing = TransientBufferRing<IDirect3DVertexBuffer9>;
+	using TransientIndexRing = TransientBufferRing<IDirect3DIndexBuffer9>;
+
 	class DirectGraphics;
 	class VertexBufferManager : public DirectGraphicsListener {
 		static VertexBufferManager* thisBase_;
@@ -153,6 +256,14 @@ namespace directx {
 		virtual bool Initialize(DirectGraphics* graphics);
 		virtual void Release();
 
+		//The TLX, LX and index buffers back the transient rings, lock them only through the rings
+		TransientVertexRing* GetVertexRingTLX() { return &ringVertex_[0]; }
+		TransientVertexRing* GetVertexRingLX() { return &ringVertex_[1]; }
+		TransientIndexRing* GetIndexRing() { return &ringIndex_; }
+
+		void EndFrame();
+		TransientVertexRing::Stats GetRingLastFrameStats();
+
 		FixedVertexBuffer* GetVertexBufferTLX() { return vertexBuffers_[0].get(); }
 		FixedVertexBuffer* GetVertexBufferLX() { return vertexBuffers_[1].get(); }
 		FixedVertexBuffer* GetVertexBufferNX() { return vertexBuffers_[2].get(); }
@@ -179,6 +290,9 @@ namespace directx {
 		std::vector<unique_ptr<FixedVertexBuffer>> vertexBuffers_;
 		unique_ptr<FixedIndexBuffer> indexBuffer_;
 
+		TransientVertexRing ringVertex_[2];
+		TransientIndexRing ringIndex_;
+
 		unique_ptr<GrowableVertexBuffer> vertexBufferGrowable_;
 		unique_ptr<GrowableIndexBuffer> indexBufferGrowable_;
 
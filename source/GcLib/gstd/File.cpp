@@ -205,6 +205,42 @@ bool File::IsDirectory(const std::wstring& path) {
 	return res;
 }
 
+int64_t File::GetLastWriteTime(const std::wstring& path) {
+	//Files inside archives have no timestamp, they can't change while the program is running anyway
+	std::error_code err;
+	auto time = stdfs::last_write_time(path, err);
+	return err ? 0 : (int64_t)time.time_since_epoch().count();
+}
+bool File::WriteAtomic(const std::wstring& path, const std::function<bool(File&)>& funcWrite) {
+	//The temporary file is named per thread, several threads may be writing the same target
+	std::wstring pathTemp = StringUtility::Format(L"%s.%u.tmp", path.c_str(), ::GetCurrentThreadId());
+
+	std::error_code err;
+	{
+		CreateFileDirectory(pathTemp);
+
+		File file(pathTemp);
+		if (!file.Open(File::WRITEONLY)) return false;
+
+		bool bWrite = funcWrite(file);
+		file.GetFileHandle().flush();
+		bWrite = bWrite && file.GetFileHandle().good();
+		file.Close();
+
+		if (!bWrite) {
+			stdfs::remove(pathTemp, err);
+			return false;
+		}
+	}
+
+	stdfs::rename(pathTemp, path, err);
+	if (err) {
+		stdfs::remove(pathTemp, err);
+		return false;
+	}
+	return true;
+}
+
 bool File::IsEqualsPath(const std::wstring& path1, const std::wstring& path2) {
 #ifdef __L_STD_FILESYSTEM
 	bool res = (path_t(path1) == path_t(path2));
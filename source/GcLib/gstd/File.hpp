@@ -127,6 +127,12 @@ namespace gstd {
 		static bool CreateFileDirectory(const std::wstring& path);
 		static bool IsExists(const std::wstring& path);
 		static bool IsDirectory(const std::wstring& path);
+		//Returns 0 for files that have no timestamp, such as files inside archives
+		static int64_t GetLastWriteTime(const std::wstring& path);
+
+		//Writes to a temporary file that then replaces the target, so the target is never left half-written.
+		//	Returns false and leaves the target untouched if funcWrite returns false or any write fails.
+		static bool WriteAtomic(const std::wstring& path, const std::function<bool(File&)>& funcWrite);
 
 		static bool IsEqualsPath(const std::wstring& path1, const std::wstring& path2);
 		static std::vector<std::wstring> GetFilePathList(const std::wstring& dir, bool bSearchArchive = false);
@@ -6,6 +6,125 @@
 using namespace gstd;
 using namespace stdch;
 
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+//*******************************************************************
+//FramePacerClock
+//*******************************************************************
+FramePacerClock::FramePacerClock() {
+	bTimePeriod_ = false;
+
+	//High resolution timers are only available from Windows 10 1803
+	hTimer_ = ::CreateWaitableTimerExW(nullptr, nullptr,
+		CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	bHighResolution_ = hTimer_ != nullptr;
+	if (hTimer_ == nullptr) {
+		hTimer_ = ::CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+
+		//Regular timers follow the system timer period
+		bTimePeriod_ = ::timeBeginPeriod(1) == TIMERR_NOERROR;
+	}
+}
+FramePacerClock::~FramePacerClock() {
+	if (hTimer_)
+		::CloseHandle(hTimer_);
+	if (bTimePeriod_)
+		::timeEndPeriod(1);
+}
+bool FramePacerClock::Sleep(nanoseconds time) {
+	if (time <= 0ns) return true;
+
+	if (hTimer_ == nullptr) {
+		::Sleep((DWORD)duration_cast<milliseconds>(time).count());
+		return true;
+	}
+
+	//Negative due time is relative, in 100ns units
+	LARGE_INTEGER due;
+	due.QuadPart = -(LONGLONG)(time.count() / 100);
+	if (due.QuadPart == 0) return true;
+	if (!::SetWaitableTimer(hTimer_, &due, 0, nullptr, nullptr, FALSE)) {
+		::Sleep((DWORD)duration_cast<milliseconds>(time).count());
+		return true;
+	}
+
+	DWORD res = ::MsgWaitForMultipleObjectsEx(1, &hTimer_, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+	if (res == WAIT_OBJECT_0 + 1) {
+		::CancelWaitableTimer(hTimer_);
+		return false;
+	}
+	return true;
+}
+
+//*******************************************************************
+//FramePacer
+//*******************************************************************
+const nanoseconds FramePacer::JITTER_BUCKET_BOUND[JITTER_BUCKET_COUNT - 1] = {
+	100us, 250us, 500us, 1ms, 2ms, 4ms
+};
+FramePacer::FramePacer() {
+	bEnable_ = true;
+
+	marginSpin_ = 1ms;
+
+	bFramePrevious_ = false;
+}
+bool FramePacer::WaitUntil(steady_clock::time_point deadline) {
+	if (!bEnable_) return true;
+
+	auto timeCurrent = clock_.Now();
+	if (deadline - timeCurrent > marginSpin_) {
+		auto timeWake = deadline - marginSpin_;
+		bool bSlept = clock_.Sleep(timeWake - timeCurrent);
+
+		auto timeAfter = clock_.Now();
+		stats_.timeSleep += timeAfter - timeCurrent;
+		timeCurrent = timeAfter;
+
+		if (!bSlept) return false;
+
+		//Widen the margin right away when the clock oversleeps, narrow it slowly otherwise
+		nanoseconds overshoot = std::max(timeCurrent - timeWake, nanoseconds::zero());
+		if (overshoot > marginSpin_)
+			marginSpin_ = overshoot;
+		else
+			marginSpin_ -= (marginSpin_ - overshoot) / 16;
+		marginSpin_ = std::clamp(marginSpin_, MIN_SPIN_MARGIN, MAX_SPIN_MARGIN);
+	}
+
+	auto timeSpinStart = timeCurrent;
+	while (timeCurrent < deadline) {
+		clock_.Spin();
+		timeCurrent = clock_.Now();
+	}
+	stats_.timeSpin += timeCurrent - timeSpinStart;
+
+	return true;
+}
+void FramePacer::RecordFrame(steady_clock::time_point time, nanoseconds target) {
+	if (bFramePrevious_) {
+		nanoseconds interval = time - timeFramePrevious_;
+		nanoseconds jitter = interval > target ? interval - target : target - interval;
+
+		size_t bucket = 0;
+		while (bucket < JITTER_BUCKET_COUNT - 1 && jitter >= JITTER_BUCKET_BOUND[bucket])
+			++bucket;
+
+		++stats_.countFrame;
+		++stats_.histogram[bucket];
+		stats_.jitterTotal += jitter;
+		stats_.jitterMax = std::max(stats_.jitterMax, jitter);
+	}
+	bFramePrevious_ = true;
+	timeFramePrevious_ = time;
+}
+void FramePacer::FlushStats() {
+	statsLast_ = stats_;
+	stats_ = JitterStats();
+}
+
 //*******************************************************************
 //FpsController
 //*******************************************************************
@@ -51,7 +170,7 @@ StaticFpsController::StaticFpsController() {
 
 	rateSkip_ = 0;
 
-	timePrevious_ = SystemUtility::GetCpuTime();
+	timePrevious_ = pacer_.Now();
 	timeAccum_ = 0ns;
 
 	timePreviousFpsUpdate_ = time_point<steady_clock, nanoseconds>{ 0ns };
@@ -62,6 +181,7 @@ void StaticFpsController::SetCriticalFrame() {
 	bCriticalFrame_ = true;
 	timeAccum_ = 0ns;
 	countSkip_ = 0;
+	pacer_.ResetFrame();
 }
 std::array<bool, 2> StaticFpsController::Advance() {
 	std::array<bool, 2> res{ false, false };
@@ -69,12 +189,24 @@ std::array<bool, 2> StaticFpsController::Advance() {
 	DWORD fpsTarget = std::min<DWORD>(bFastMode_ ? fastModeFpsRate_ : std::min(fps_, GetControlObjectFps()), 1000);
 	const auto targetNs = duration<double, std::nano>(std::nano::den / (double)fpsTarget);
 
-	auto timeCurrent = SystemUtility::GetCpuTime();
+	auto timeCurrent = pacer_.Now();
+	{
+		//Wait out the rest of the frame instead of returning to be polled again
+		nanoseconds timeRemain = ceil<nanoseconds>(targetNs) - (timeAccum_ + (timeCurrent - timePrevious_));
+		if (timeRemain > 0ns) {
+			if (!pacer_.WaitUntil(timeCurrent + timeRemain))
+				return res;
+			timeCurrent = pacer_.Now();
+		}
+	}
+
 	auto timeDelta = timeCurrent - timePrevious_;
 	timePrevious_ = timeCurrent;
 
 	timeAccum_ += timeDelta;
 	if (timeAccum_ >= targetNs) {
+		pacer_.RecordFrame(timeCurrent, duration_cast<nanoseconds>(targetNs));
+
 		if (bCriticalFrame_ || (rateSkip_ <= 1 || countSkip_ % rateSkip_ == 0)) {
 			listFps_.push_back(timeAccum_.count());
 			res[0] = true;
@@ -101,6 +233,7 @@ std::array<bool, 2> StaticFpsController::Advance() {
 			listFps_.clear();
 		}
 		else fpsCurrent_ = 0;
+		pacer_.FlushStats();
 
 		timePreviousFpsUpdate_ = timePrevious_;
 	}
@@ -120,7 +253,7 @@ VariableFpsController::VariableFpsController() {
 
 	countSkip_ = 0;
 
-	timePrevious_ = SystemUtility::GetCpuTime();
+	timePrevious_ = pacer_.Now();
 	timePreviousUpdate_ = timePrevious_;
 	timePreviousRender_ = timePrevious_;
 
@@ -136,6 +269,7 @@ void VariableFpsController::SetCriticalFrame() {
 	countSkip_ = 0;
 	timeAccumUpdate_ = 0ns;
 	timeAccumRender_ = 0ns;
+	pacer_.ResetFrame();
 }
 std::array<bool, 2> VariableFpsController::Advance() {
 	std::array<bool, 2> res{ false, false };
@@ -143,7 +277,17 @@ std::array<bool, 2> VariableFpsController::Advance() {
 	DWORD fpsTarget = std::min<DWORD>(bFastMode_ ? fastModeFpsRate_ : std::min(fps_, GetControlObjectFps()), 1000);
 	const auto targetNs = duration<double, std::nano>(std::nano::den / (double)fpsTarget);
 
-	auto timeCurrent = SystemUtility::GetCpuTime();
+	auto timeCurrent = pacer_.Now();
+	if (bFrameRendered_ && !bCriticalFrame_) {
+		//Nothing left to render until the next update, wait for it
+		nanoseconds timeRemain = ceil<nanoseconds>(targetNs) - (timeAccumUpdate_ + (timeCurrent - timePrevious_));
+		if (timeRemain > 0ns) {
+			if (!pacer_.WaitUntil(timeCurrent + timeRemain))
+				return res;
+			timeCurrent = pacer_.Now();
+		}
+	}
+
 	auto timeDelta = timeCurrent - timePrevious_;
 	timePrevious_ = timeCurrent;
 
@@ -151,6 +295,7 @@ std::array<bool, 2> VariableFpsController::Advance() {
 	timeAccumRender_ += timeDelta;
 
 	if (timeAccumUpdate_ >= targetNs) {
+		pacer_.RecordFrame(timeCurrent, duration_cast<nanoseconds>(targetNs));
 		listFpsUpdate_.push_back(timeAccumUpdate_.count());
 		res[1] = true;
 
@@ -204,6 +349,7 @@ std::array<bool, 2> VariableFpsController::Advance() {
 
 		listFpsUpdate_.clear();
 		listFpsRender_.clear();
+		pacer_.FlushStats();
 		timePreviousFpsUpdate_ = timePrevious_;
 	}
 
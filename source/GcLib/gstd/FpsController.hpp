@@ -6,6 +6,94 @@
 
 namespace gstd {
 	class FpsControlObject;
+	//*******************************************************************
+	//FramePacerClock
+	//*******************************************************************
+	//Time source and waitable timer used by FramePacer
+	class FramePacerClock {
+	protected:
+		HANDLE hTimer_;
+		bool bHighResolution_;
+		bool bTimePeriod_;
+	public:
+		FramePacerClock();
+		~FramePacerClock();
+
+		FramePacerClock(const FramePacerClock&) = delete;
+		FramePacerClock& operator=(const FramePacerClock&) = delete;
+
+		stdch::steady_clock::time_point Now() { return stdch::steady_clock::now(); }
+		//Blocks for about the given duration, may oversleep.
+		//	Returns false if woken early because the thread has pending window messages.
+		bool Sleep(stdch::nanoseconds time);
+		//Called on every iteration of the final busy-wait
+		void Spin() { ::YieldProcessor(); }
+
+		bool IsHighResolution() { return bHighResolution_; }
+	};
+
+	//*******************************************************************
+	//FramePacer
+	//*******************************************************************
+	//Waits for a frame deadline by sleeping for most of the remaining time and spinning only for the rest.
+	//	The spin margin follows how much the clock has been oversleeping.
+	class FramePacer {
+	public:
+		enum : size_t {
+			JITTER_BUCKET_COUNT = 7,
+		};
+		//Upper bounds of the jitter histogram buckets, the last bucket has no bound
+		static const stdch::nanoseconds JITTER_BUCKET_BOUND[JITTER_BUCKET_COUNT - 1];
+
+		static constexpr stdch::nanoseconds MIN_SPIN_MARGIN = stdch::microseconds(100);
+		static constexpr stdch::nanoseconds MAX_SPIN_MARGIN = stdch::milliseconds(2);
+
+		struct JitterStats {
+			size_t countFrame = 0;
+			//Frame counts by |frame interval - target interval|
+			std::array<size_t, JITTER_BUCKET_COUNT> histogram{};
+			stdch::nanoseconds jitterTotal = stdch::nanoseconds::zero();
+			stdch::nanoseconds jitterMax = stdch::nanoseconds::zero();
+			stdch::nanoseconds timeSleep = stdch::nanoseconds::zero();
+			stdch::nanoseconds timeSpin = stdch::nanoseconds::zero();
+		};
+	protected:
+		FramePacerClock clock_;
+		bool bEnable_;
+
+		stdch::nanoseconds marginSpin_;
+
+		bool bFramePrevious_;
+		stdch::steady_clock::time_point timeFramePrevious_;
+
+		JitterStats stats_;
+		JitterStats statsLast_;
+	public:
+		FramePacer();
+
+		FramePacerClock* GetClock() { return &clock_; }
+		stdch::steady_clock::time_point Now() { return clock_.Now(); }
+
+		//When disabled, WaitUntil returns immediately and the caller is left to poll
+		void SetEnable(bool b) { bEnable_ = b; }
+		bool IsEnable() { return bEnable_; }
+
+		stdch::nanoseconds GetSpinMargin() { return marginSpin_; }
+
+		//Returns false if the wait was cut short by pending window messages
+		bool WaitUntil(stdch::steady_clock::time_point deadline);
+
+		//Records the interval since the previous frame against the target interval
+		void RecordFrame(stdch::steady_clock::time_point time, stdch::nanoseconds target);
+		//Makes the next recorded frame start a new interval (after loading, etc.)
+		void ResetFrame() { bFramePrevious_ = false; }
+
+		//Moves the current stats to the last stats
+		void FlushStats();
+		const JitterStats& GetStats() { return stats_; }
+		const JitterStats& GetLastStats() { return statsLast_; }
+	};
+
 	//*******************************************************************
 	//FpsController
 	//*******************************************************************
@@ -19,6 +107,8 @@ namespace gstd {
 		size_t fastModeFpsRate_;
 
 		std::list<ref_count_weak_ptr<FpsControlObject>> listFpsControlObject_;
+
+		FramePacer pacer_;
 	public:
 		FpsController();
 		virtual ~FpsController();
@@ -47,6 +137,8 @@ namespace gstd {
 		}
 		void RemoveFpsControlObject(ref_count_weak_ptr<FpsControlObject> obj);
 		DWORD GetControlObjectFps();
+
+		FramePacer* GetFramePacer() { return &pacer_; }
 	};
 
 	//*******************************************************************
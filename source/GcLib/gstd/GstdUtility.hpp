@@ -506,6 +506,24 @@ namespace gstd {
 		static void Reverse(LPVOID buf, DWORD size);
 	};
 
+	//================================================================
+	//Hash
+	class Hash {
+	public:
+		static constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+		static constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+		//64-bit FNV-1a, pass a previous result as the seed to hash several blocks as one
+		static uint64_t Fnv1a(const void* data, size_t size, uint64_t hash = FNV_OFFSET) {
+			const byte* pData = (const byte*)data;
+			for (size_t i = 0; i < size; ++i) {
+				hash ^= pData[i];
+				hash *= FNV_PRIME;
+			}
+			return hash;
+		}
+	};
+
 	//================================================================
 	//PathProperty
 	class PathProperty {
@@ -61,10 +61,27 @@ void Logger::FlushFileLogger() {
 //FileLogger
 //*******************************************************************
 FileLogger::FileLogger() {
+	bEnable_ = false;
+
 	sizeMax_ = 10 * 1024 * 1024;//10MB
+	sizeFile_ = 0;
+
+	posWrite_ = 0;
+	posRead_ = 0;
+	posCommitted_ = 0;
+	countDropped_ = 0;
+	policyOverflow_ = OverflowPolicy::Block;
+
+	bWriterStop_ = false;
 }
 FileLogger::~FileLogger() {
-	file_->Close();
+	if (threadWriter_) {
+		bWriterStop_ = true;
+		signalWriter_.SetSignal();
+		threadWriter_->Join();
+	}
+	if (file_)
+		file_->Close();
 }
 bool FileLogger::Initialize(bool bEnable) {
 	return this->Initialize(L"", bEnable);
@@ -81,44 +98,174 @@ bool FileLogger::Initialize(std::wstring path, bool bEnable) {
 bool FileLogger::SetPath(const std::wstring& path) {
 	if (!bEnable_) return false;
 
-	path_ = path;
-	File::CreateFileDirectory(path_);
+	{
+		Lock lock(lock_);
+
+		path_ = path;
+		File::CreateFileDirectory(path_);
 
-	_CreateFile();
+		_CreateFile();
+	}
+
+	if (threadWriter_ == nullptr) {
+		ring_.reset(new Slot[RING_CAPACITY]);
+		for (size_t i = 0; i < RING_CAPACITY; ++i)
+			ring_[i].sequence.store(i, std::memory_order_relaxed);
+
+		threadWriter_.reset(new WriterThread(this));
+		threadWriter_->Start();
+	}
 
 	return true;
 }
 void FileLogger::_CreateFile() {
 	file_ = shared_ptr<File>(new File(path_));
+	sizeFile_ = 0;
 	if (file_->Open(File::WRITEONLY)) {
 		//BOM for UTF-16 LE
 		file_->WriteCharacter((unsigned char)0xFF);
 		file_->WriteCharacter((unsigned char)0xFE);
+		sizeFile_ = 2;
 	}
 }
+void FileLogger::_RotateFile() {
+	//Keep one previous log as <path>.old
+	file_->Close();
+	std::wstring pathOld = path_ + L".old";
+	::MoveFileExW(path_.c_str(), pathOld.c_str(), MOVEFILE_REPLACE_EXISTING);
+	_CreateFile();
+}
 void FileLogger::FlushFile() {
-	if (!bEnable_) return;
+	if (!bEnable_ || threadWriter_ == nullptr) return;
+
+	//Wait for the writer to commit everything written so far
+	uint64_t pos = posWrite_.load(std::memory_order_acquire);
+	while (posCommitted_.load(std::memory_order_acquire) < pos && !threadWriter_->IsStop()) {
+		signalWriter_.SetSignal();
+		::Sleep(1);
+	}
+
+	Lock lock(lock_);
 	if (file_->IsOpen()) {
 		std::fstream& hFile = file_->GetFileHandle();
 		hFile.flush();
 	}
 }
 void FileLogger::_Write(SYSTEMTIME& time, const std::wstring& str) {
-	if (!bEnable_) return;
+	if (!bEnable_ || ring_ == nullptr) return;
+
+	size_t length = std::min<size_t>(str.size(), RING_CAPACITY / 2 * SLOT_CHARS);
+	size_t countSlot = std::max<size_t>((length + SLOT_CHARS - 1) / SLOT_CHARS, 1);
+
+	//Claim countSlot consecutive slots. The writer frees slots in order,
+	//	so the last one being free for this lap means all of them are.
+	uint64_t pos = posWrite_.load(std::memory_order_relaxed);
+	while (true) {
+		uint64_t posLast = pos + countSlot - 1;
+		uint64_t sequence = ring_[posLast & (RING_CAPACITY - 1)].sequence.load(std::memory_order_acquire);
+		if (sequence == posLast) {
+			if (posWrite_.compare_exchange_weak(pos, pos + countSlot, std::memory_order_relaxed))
+				break;
+		}
+		else if (sequence < posLast) {
+			//Ring is full
+			if (policyOverflow_ == OverflowPolicy::Drop) {
+				countDropped_.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			signalWriter_.SetSignal();
+			::Sleep(0);
+			pos = posWrite_.load(std::memory_order_relaxed);
+		}
+		else {
+			pos = posWrite_.load(std::memory_order_relaxed);
+		}
+	}
 
-	if (file_->IsOpen()) {
+	for (size_t iSlot = 0; iSlot < countSlot; ++iSlot) {
+		Slot& slot = ring_[(pos + iSlot) & (RING_CAPACITY - 1)];
+		size_t offset = iSlot * SLOT_CHARS;
+		size_t count = std::min<size_t>(length - offset, SLOT_CHARS);
+		if (iSlot == 0) {
+			slot.countSlot = countSlot;
+			slot.time[0] = time.wHour;
+			slot.time[1] = time.wMinute;
+			slot.time[2] = time.wSecond;
+			slot.time[3] = time.wMilliseconds;
+		}
+		slot.length = count;
+		memcpy(slot.text, str.data() + offset, count * sizeof(wchar_t));
+		slot.sequence.store(pos + iSlot + 1, std::memory_order_release);
+	}
+
+	//The writer polls on its own, only wake it early when the ring is filling up
+	if (pos + countSlot - posRead_.load(std::memory_order_relaxed) > RING_CAPACITY / 2)
+		signalWriter_.SetSignal();
+}
+void FileLogger::_Drain() {
+	bufferWrite_.clear();
+
+	uint64_t pos = posRead_.load(std::memory_order_relaxed);
+	while (true) {
+		Slot& first = ring_[pos & (RING_CAPACITY - 1)];
+		if (first.sequence.load(std::memory_order_acquire) != pos + 1) break;
+
+		size_t countSlot = first.countSlot;
+		bool bComplete = true;
+		for (size_t iSlot = 1; iSlot < countSlot && bComplete; ++iSlot) {
+			Slot& slot = ring_[(pos + iSlot) & (RING_CAPACITY - 1)];
+			bComplete = slot.sequence.load(std::memory_order_acquire) == pos + iSlot + 1;
+		}
+		if (!bComplete) break;
+
+		wchar_t strTime[32];
+		int lengthTime = swprintf_s(strTime, L"%.2d:%.2d:%.2d.%.3d ",
+			first.time[0], first.time[1], first.time[2], first.time[3]);
+		bufferWrite_.insert(bufferWrite_.end(), strTime, strTime + lengthTime);
+
+		for (size_t iSlot = 0; iSlot < countSlot; ++iSlot) {
+			Slot& slot = ring_[(pos + iSlot) & (RING_CAPACITY - 1)];
+			bufferWrite_.insert(bufferWrite_.end(), slot.text, slot.text + slot.length);
+			slot.sequence.store(pos + iSlot + RING_CAPACITY, std::memory_order_release);
+		}
+		bufferWrite_.push_back(L'\n');
+
+		pos += countSlot;
+		posRead_.store(pos, std::memory_order_release);
+	}
+
+	size_t countDropped = countDropped_.exchange(0);
+	if (countDropped > 0) {
+		std::wstring str = StringUtility::Format(L"[FileLogger] %u message(s) dropped\n", (uint32_t)countDropped);
+		bufferWrite_.insert(bufferWrite_.end(), str.begin(), str.end());
+	}
+
+	if (bufferWrite_.size() > 0) {
 		Lock lock(lock_);
 
-		std::wstring strTime = StringUtility::Format(
-			//L"%.4d/%.2d/%.2d "
-			L"%.2d:%.2d:%.2d.%.3d ", 
-			//time.wYear, time.wMonth, time.wDay, 
-			time.wHour, time.wMinute, time.wSecond, time.wMilliseconds);
-		
-		file_->Write(strTime.data(), StringUtility::GetByteSize(strTime));
-		file_->Write((wchar_t*)str.data(), StringUtility::GetByteSize(str));
-		file_->Write(L"\n", sizeof(wchar_t));
+		size_t sizeBlock = bufferWrite_.size() * sizeof(wchar_t);
+		if (sizeMax_ > 0 && sizeFile_ + sizeBlock > sizeMax_)
+			_RotateFile();
+		if (file_->IsOpen()) {
+			file_->Write(bufferWrite_.data(), sizeBlock);
+			sizeFile_ += sizeBlock;
+		}
+	}
+
+	posCommitted_.store(pos, std::memory_order_release);
+}
+
+//FileLogger::WriterThread
+FileLogger::WriterThread::WriterThread(FileLogger* logger) {
+	_SetOuter(logger);
+}
+void FileLogger::WriterThread::_Run() {
+	FileLogger* logger = _GetOuter();
+	while (!logger->bWriterStop_) {
+		logger->signalWriter_.Wait(10);
+		logger->_Drain();
 	}
+	logger->_Drain();
 }
 
 //*******************************************************************
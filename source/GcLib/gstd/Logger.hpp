@@ -35,13 +35,38 @@ namespace gstd {
 		static void WriteTop(const std::wstring& str) { if (top_) top_->Write(str); }
 
 		void FlushFileLogger();
+		//Waits until everything written so far is in the log file
+		static void FlushTop() { if (top_) top_->FlushFileLogger(); }
 	};
 
 #if defined(DNH_PROJ_EXECUTOR)
 	//*******************************************************************
 	//FileLogger
 	//*******************************************************************
+	//Callers only copy the message into a lock-free ring, a writer thread formats and writes it in blocks.
 	class FileLogger : public Logger {
+	public:
+		enum class OverflowPolicy {
+			Drop,		//Discard the message, the writer logs how many were dropped
+			Block,		//Wait for the writer to free up space, the default
+		};
+
+		class WriterThread;
+		friend WriterThread;
+	protected:
+		enum : size_t {
+			RING_CAPACITY = 4096,	//In slots, must be a power of 2
+			SLOT_CHARS = 120,
+		};
+
+		//A message takes as many consecutive slots as it needs
+		struct Slot {
+			std::atomic<uint64_t> sequence;
+			uint16_t countSlot;		//First slot of a message only
+			uint16_t length;
+			WORD time[4];			//h, m, s, ms
+			wchar_t text[SLOT_CHARS];
+		};
 	protected:
 		bool bEnable_;
 
@@ -49,9 +74,24 @@ namespace gstd {
 		std::wstring path_;
 
 		size_t sizeMax_;
+		size_t sizeFile_;
+
+		unique_ptr<Slot[]> ring_;
+		alignas(64) std::atomic<uint64_t> posWrite_;
+		alignas(64) std::atomic<uint64_t> posRead_;
+		std::atomic<uint64_t> posCommitted_;		//Messages before this are in the file
+		std::atomic<size_t> countDropped_;
+		OverflowPolicy policyOverflow_;
+
+		unique_ptr<WriterThread> threadWriter_;
+		ThreadSignal signalWriter_;
+		std::atomic_bool bWriterStop_;
+		std::vector<wchar_t> bufferWrite_;
 
 		virtual void _Write(SYSTEMTIME& systemTime, const std::wstring& str);
 		void _CreateFile();
+		void _RotateFile();
+		void _Drain();
 	public:
 		FileLogger();
 		~FileLogger();
@@ -63,6 +103,14 @@ namespace gstd {
 		
 		bool SetPath(const std::wstring& path);
 		void SetMaxFileSize(int size) { sizeMax_ = size; }
+		void SetOverflowPolicy(OverflowPolicy policy) { policyOverflow_ = policy; }
+	};
+	class FileLogger::WriterThread : public gstd::Thread, public gstd::InnerClass<FileLogger> {
+		friend FileLogger;
+	protected:
+		WriterThread(FileLogger* logger);
+
+		void _Run();
 	};
 
 	//*******************************************************************
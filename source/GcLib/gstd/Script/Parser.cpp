@@ -12,6 +12,7 @@ script_block::script_block(uint32_t the_level, block_kind the_kind) {
 	level = the_level;
 	arguments = 0;
 	func = nullptr;
+	atom_arg = -1;
 	kind = the_kind;
 }
 
@@ -314,6 +315,7 @@ void parser::register_function(const function& func) {
 	block->arguments = func.argc;
 	block->name = func.name;
 	block->func = func.func;
+	block->atom_arg = func.atom_arg;
 	symbol s = symbol(0, nullptr, false, block);
 	frame.begin()->singular_insert(func.name, s, func.argc);
 }
@@ -860,7 +862,7 @@ void parser::parse_clause(script_block* block, parser_state_t* state) {
 
 continue_as_variadic:
 		if (!s->bVariable) {
-			parse_arguments(block, state, &s->argData);
+			parse_arguments(block, state, &s->argData, s->sub->atom_arg);
 			parser_assert(state, s->sub->kind == block_kind::bk_function,
 				"Tasks and subs cannot return values.\r\n");
 			state->AddCode(block, code(command_kind::pc_call_and_push_result, (uint32_t)s->sub, argc));
@@ -1290,13 +1292,26 @@ void parser::parse_expression(script_block* block, parser_state_t* state) {
 //Format for variadic arguments:
 // argc = -(n + 1)
 // where n = fixed(required) arguments
-int parser::parse_arguments(script_block* block, parser_state_t* state, const std::vector<arg_data>* argsData) {
+int parser::parse_arguments(script_block* block, parser_state_t* state, const std::vector<arg_data>* argsData,
+	int atomArg)
+{
 	int argc = 0;
 	if (state->next() == token_kind::tk_open_par) {
 		state->advance();
 
 		while (state->next() != token_kind::tk_close_par) {
+			size_t countCode = block->codes.size();
 			parse_expression(block, state);
+			//A string literal key, intern it now instead of on every call
+			if (argc == atomArg && block->codes.size() == countCode + 1) {
+				code* ptrBack = &block->codes.back();
+				if (ptrBack->GetOp() == command_kind::pc_push_value
+					&& ptrBack->data.get_type() == script_type_manager::get_string_type())
+				{
+					uint32_t atom = script_atom_table::intern(ptrBack->data.as_string());
+					ptrBack->data = value(script_type_manager::get_atom_type(), (int64_t)atom);
+				}
+			}
 			if (argsData && argsData->size() > 0) {
 				const arg_data* arg = &argsData->at(argc);
 				if (arg->type != nullptr)
@@ -1435,7 +1450,7 @@ void parser::parse_single_statement(script_block* block, parser_state_t* state,
 					name.c_str(), argc));
 			}
 
-			parse_arguments(block, state, &s->argData);
+			parse_arguments(block, state, &s->argData, s->sub->atom_arg);
 			state->AddCode(block, code(command_kind::pc_call, (uint32_t)s->sub, argc));
 
 			break;
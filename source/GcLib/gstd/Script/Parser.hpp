@@ -116,6 +116,7 @@ namespace gstd {
 		uint32_t arguments;
 		std::string name;
 		dnh_func_callback_t func;
+		int atom_arg;
 		std::vector<code> codes;
 		block_kind kind;
 
@@ -299,7 +300,8 @@ namespace gstd {
 		void parse_ternary(script_block* block, parser_state_t* state);
 		void parse_expression(script_block* block, parser_state_t* state);
 
-		int parse_arguments(script_block* block, parser_state_t* state, const std::vector<arg_data>* argsData);
+		int parse_arguments(script_block* block, parser_state_t* state, const std::vector<arg_data>* argsData,
+			int atomArg = -1);
 		void parse_single_statement(script_block* block, parser_state_t* state, 
 			bool check_terminator, token_kind statement_terminator);
 		void parse_statements(script_block* block, parser_state_t* state,
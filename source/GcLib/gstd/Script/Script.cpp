@@ -37,11 +37,25 @@ script_type_manager::script_type_manager() {
 }
 
 type_data* script_type_manager::get_type(type_data* type) {
-	auto itr = types.find(*type);
-	if (itr == types.end()) {
-		//No type found, insert and return the new type
-		itr = types.insert(*type).first;
+	if (countConcurrent == 0) {
+		auto itr = types.find(*type);
+		if (itr == types.end()) {
+			//No type found, insert and return the new type
+			itr = types.insert(*type).first;
+		}
+		return deref_itr(itr);
+	}
+
+	{
+		std::shared_lock<std::shared_mutex> lock(lockTypes);
+		auto itr = types.find(*type);
+		if (itr != types.end())
+			return deref_itr(itr);
 	}
+
+	//No type found, insert and return the new type
+	std::unique_lock<std::shared_mutex> lock(lockTypes);
+	auto itr = types.insert(*type).first;
 	return deref_itr(itr);
 }
 type_data* script_type_manager::get_type(type_data::type_kind kind) {
@@ -53,6 +67,36 @@ type_data* script_type_manager::get_array_type(type_data* element) {
 	return get_type(&target);
 }
 
+//****************************************************************************
+//script_atom_table
+//****************************************************************************
+uint32_t script_atom_table::intern(const std::wstring& str) {
+	uint32_t atom = find(str);
+	if (atom != INVALID_ATOM)
+		return atom;
+
+	table_data& data = get_data();
+	std::unique_lock<std::shared_mutex> lock(data.lock);
+
+	auto itr = data.mapAtom.insert(std::make_pair(str, (uint32_t)data.mapAtom.size())).first;
+	if (itr->second == data.listString.size())
+		data.listString.push_back(&itr->first);
+	return itr->second;
+}
+uint32_t script_atom_table::find(const std::wstring& str) {
+	table_data& data = get_data();
+	std::shared_lock<std::shared_mutex> lock(data.lock);
+
+	auto itr = data.mapAtom.find(str);
+	return itr != data.mapAtom.end() ? itr->second : INVALID_ATOM;
+}
+std::wstring script_atom_table::get_string(uint32_t atom) {
+	table_data& data = get_data();
+	std::shared_lock<std::shared_mutex> lock(data.lock);
+
+	return atom < data.listString.size() ? *data.listString[atom] : std::wstring();
+}
+
 //****************************************************************************
 //script_engine
 //****************************************************************************
@@ -107,6 +151,11 @@ script_machine::environment::environment(script_machine* machine) {
 	has_result = false;
 	waitCount = 0;
 
+	thread = nullptr;
+	order = 0;
+	order_prev = nullptr;
+	order_next = nullptr;
+
 	_ref = 0;
 }
 script_machine::environment::~environment() {
@@ -123,6 +172,11 @@ void script_machine::environment::init(environment* parent, script_block* b) {
 	has_result = false;
 	waitCount = 0;
 
+	thread = nullptr;
+	order = 0;
+	order_prev = nullptr;
+	order_next = nullptr;
+
 	if (parent)
 		parent->add_ref();
 	_ref = 1;
@@ -177,6 +231,55 @@ void script_machine::dispose_environment(environment* env) {
 	_list_free_environments.push_back(env);
 }
 
+void script_machine::link_thread_order(environment* prev, environment* env) {
+	environment* next = prev->order_next;
+	env->order_prev = prev;
+	env->order_next = next;
+	if (next) next->order_prev = env;
+	prev->order_next = env;
+	++thread_order_count;
+
+	uint64_t lo = prev->order;
+	uint64_t hi = next ? next->order : UINT64_MAX;
+	if (hi - lo < 2)
+		relabel_thread_order();
+	else
+		env->order = lo + (hi - lo) / 2;
+}
+void script_machine::unlink_thread_order(environment* env) {
+	if (env->order_prev) env->order_prev->order_next = env->order_next;
+	if (env->order_next) env->order_next->order_prev = env->order_prev;
+	env->order_prev = nullptr;
+	env->order_next = nullptr;
+	--thread_order_count;
+}
+void script_machine::relabel_thread_order() {
+	//Spread the labels evenly again
+	uint64_t step = UINT64_MAX / (thread_order_count + 1);
+	uint64_t order = 0;
+	for (environment* env = thread_order_head; env != nullptr; env = env->order_next) {
+		env->order = order;
+		order += step;
+	}
+}
+void script_machine::wake_threads() {
+	list_woken_threads.clear();
+	sleeping_threads.advance(list_woken_threads);
+	if (list_woken_threads.size() == 0) return;
+
+	//Merge the woken threads back into their original places
+	std::sort(list_woken_threads.begin(), list_woken_threads.end(),
+		[](environment* a, environment* b) { return a->thread->order < b->thread->order; });
+
+	auto itr = threads.begin();
+	for (environment* env : list_woken_threads) {
+		uint64_t order = env->thread->order;
+		while (itr != threads.end() && (*itr)->thread->order < order)
+			++itr;
+		threads.insert(itr, env);
+	}
+}
+
 bool script_machine::has_event(const std::string& event_name, std::map<std::string, script_block*>::iterator& res) {
 	res = engine->events.find(event_name);
 	return res != engine->events.end();
@@ -204,6 +307,11 @@ void script_machine::reset() {
 	list_parent_environment.clear();
 	threads.clear();
 	current_thread_index = std::list<environment*>::iterator();
+
+	sleeping_threads.clear();
+	list_woken_threads.clear();
+	thread_order_head = nullptr;
+	thread_order_count = 0;
 }
 void script_machine::run() {
 	if (bTerminate) return;
@@ -213,8 +321,12 @@ void script_machine::run() {
 
 		environment* mainEnv = get_new_environment();
 		mainEnv->init(nullptr, engine->main_block);
+		mainEnv->thread = mainEnv;
 		threads.push_back(mainEnv);
 
+		thread_order_head = mainEnv;
+		thread_order_count = 1;
+
 		current_thread_index = threads.begin();
 
 		finished = false;
@@ -255,6 +367,7 @@ void script_machine::interrupt(script_block* sub) {
 
 	environment* new_env = get_new_environment();
 	new_env->init(env_first, sub);
+	new_env->thread = env_first->thread;
 	*current_thread_index = new_env;
 
 	finished = false;
@@ -271,6 +384,8 @@ void script_machine::interrupt(script_block* sub) {
 script_machine::environment* script_machine::add_thread(script_block* sub) {
 	environment* e = get_new_environment();
 	e->init(*current_thread_index, sub);
+	e->thread = e;
+	link_thread_order((*current_thread_index)->thread, e);
 
 	threads.insert(++current_thread_index, e);
 	--current_thread_index;
@@ -280,6 +395,7 @@ script_machine::environment* script_machine::add_thread(script_block* sub) {
 script_machine::environment* script_machine::add_child_block(script_block* sub) {
 	environment* e = get_new_environment();
 	e->init(*current_thread_index, sub);
+	e->thread = (*current_thread_index)->thread;
 
 	*current_thread_index = e;
 
@@ -317,6 +433,7 @@ void script_machine::run_code() {
 				}
 				else {
 					if (current->sub->kind == block_kind::bk_microthread) {
+						unlink_thread_order(current);
 						current_thread_index = threads.erase(current_thread_index);
 						yield();
 					}
@@ -351,6 +468,16 @@ void script_machine::run_code() {
 					current->waitCount = (int)t->as_int() - 1;
 					stack.pop_back();
 					if (current->waitCount < 0) break;
+
+					//Park the thread until it is due instead of visiting it on every tick.
+					//The first thread stays in place, interrupt() relies on it.
+					if (current->waitCount > 0 && current_thread_index != threads.begin()) {
+						sleeping_threads.insert(sleeping_threads.get_tick() + current->waitCount + 1, current);
+						current->waitCount = 0;
+						current_thread_index = threads.erase(current_thread_index);
+						yield();
+						break;
+					}
 				}
 				//Fallthrough
 				case command_kind::pc_yield:
@@ -24,14 +24,24 @@ namespace gstd {
 		static type_data* get_int_array_type() { return base_->int_array_type; }
 		static type_data* get_float_array_type() { return base_->float_array_type; }
 
+		//An int type distinct from int_type, marks arguments that were interned by the parser
+		static type_data* get_atom_type() { return &base_->atom_type; }
+
 		type_data* get_type(type_data* type);
 		type_data* get_type(type_data::type_kind kind);
 		type_data* get_array_type(type_data* element);
 
+		//Brackets a section where scripts are compiled on several threads at once
+		void begin_concurrent() { ++countConcurrent; }
+		void end_concurrent() { --countConcurrent; }
+
 		static script_type_manager* get_instance() { return base_; }
 	private:
 		script_type_manager(const script_type_manager& src);
 
+		//Only taken inside begin_concurrent/end_concurrent, new types are then inserted under an exclusive lock
+		std::shared_mutex lockTypes;
+		std::atomic<size_t> countConcurrent = 0;
 		std::set<type_data> types;
 
 		//Common types for quick access without std::set traversal
@@ -47,11 +57,40 @@ namespace gstd {
 		type_data* int_array_type;
 		type_data* float_array_type;
 
+		type_data atom_type = type_data(type_data::tk_int);
+
 		inline static type_data* deref_itr(std::set<type_data>::iterator& itr) {
 			return const_cast<type_data*>(&*itr);
 		}
 	};
 
+	//Interns string literals into integer atoms, shared by all scripts.
+	//Atoms are never released, only the parser interns so the table is bounded by the scripts' source.
+	//Strings built at runtime are only looked up.
+	class script_atom_table {
+	public:
+		enum : uint32_t {
+			INVALID_ATOM = UINT32_MAX,
+		};
+	private:
+		struct table_data {
+			std::shared_mutex lock;
+			std::unordered_map<std::wstring, uint32_t> mapAtom;
+			std::vector<const std::wstring*> listString;
+		};
+		static table_data& get_data() {
+			static table_data data;
+			return data;
+		}
+	public:
+		static uint32_t intern(const std::wstring& str);
+		//Returns INVALID_ATOM if the string was never interned
+		static uint32_t find(const std::wstring& str);
+		static std::wstring get_string(uint32_t atom);
+
+		static bool is_atom(const value& val) { return val.get_type() == script_type_manager::get_atom_type(); }
+	};
+
 	class script_engine {
 	public:
 		script_engine(const std::wstring& source, std::vector<function>* list_func, std::vector<constant>* list_const);
@@ -80,6 +119,86 @@ namespace gstd {
 		std::map<std::string, script_block*> events;
 	};
 
+	//Hierarchical timer wheel keyed by tick.
+	//Level 0 holds entries due within the next 256 ticks, level 1 the next 64 windows of 256 ticks,
+	//	anything further waits in overflow and is redistributed every 16384 ticks.
+	template<class T>
+	class script_timer_wheel {
+	public:
+		enum : uint64_t {
+			LEVEL0_BITS = 8,
+			LEVEL1_BITS = 6,
+			LEVEL0_SIZE = 1 << LEVEL0_BITS,
+			LEVEL1_SIZE = 1 << LEVEL1_BITS,
+		};
+	private:
+		struct entry {
+			uint64_t tick;
+			T* data;
+		};
+
+		std::vector<entry> level0[LEVEL0_SIZE];
+		std::vector<entry> level1[LEVEL1_SIZE];
+		std::vector<entry> overflow;
+		std::vector<entry> scratch;
+
+		uint64_t now;
+		size_t count;
+
+		void _place(const entry& e) {
+			if (e.tick - now < LEVEL0_SIZE)
+				level0[e.tick & (LEVEL0_SIZE - 1)].push_back(e);
+			else if ((e.tick >> LEVEL0_BITS) - (now >> LEVEL0_BITS) < LEVEL1_SIZE)
+				level1[(e.tick >> LEVEL0_BITS) & (LEVEL1_SIZE - 1)].push_back(e);
+			else
+				overflow.push_back(e);
+		}
+		void _cascade(std::vector<entry>& slot) {
+			scratch.swap(slot);
+			for (const entry& e : scratch)
+				_place(e);
+			scratch.clear();
+		}
+	public:
+		script_timer_wheel() {
+			now = 0;
+			count = 0;
+		}
+
+		void clear() {
+			for (auto& slot : level0) slot.clear();
+			for (auto& slot : level1) slot.clear();
+			overflow.clear();
+			now = 0;
+			count = 0;
+		}
+
+		uint64_t get_tick() const { return now; }
+		size_t size() const { return count; }
+
+		//tick must be later than the current tick
+		void insert(uint64_t tick, T* data) {
+			_place(entry{ tick, data });
+			++count;
+		}
+
+		//Moves to the next tick and appends the entries that became due to res
+		void advance(std::vector<T*>& res) {
+			++now;
+			if ((now & (LEVEL0_SIZE - 1)) == 0) {
+				if (((now >> LEVEL0_BITS) & (LEVEL1_SIZE - 1)) == 0)
+					_cascade(overflow);
+				_cascade(level1[(now >> LEVEL0_BITS) & (LEVEL1_SIZE - 1)]);
+			}
+
+			std::vector<entry>& slot = level0[now & (LEVEL0_SIZE - 1)];
+			for (const entry& e : slot)
+				res.push_back(e.data);
+			count -= slot.size();
+			slot.clear();
+		}
+	};
+
 	class script_machine {
 	public:
 		class environment {
@@ -94,6 +213,13 @@ namespace gstd {
 			bool has_result;
 			int waitCount;
 
+			//Base environment of the microthread this environment runs in
+			environment* thread;
+			//Position in the machine's thread order, only kept by base environments
+			uint64_t order;
+			environment* order_prev;
+			environment* order_next;
+
 			int _ref;
 		public:
 			environment(script_machine* machine);
@@ -123,13 +249,27 @@ namespace gstd {
 
 		std::list<environment*> list_parent_environment;
 
+		//Runnable threads, threads parked by wait() are held in sleeping_threads until they are due
 		std::list<environment*> threads;
 		std::list<environment*>::iterator current_thread_index;
+
+		//One tick passes each time the scheduler wraps around threads
+		script_timer_wheel<environment> sleeping_threads;
+		std::vector<environment*> list_woken_threads;
+
+		//Base environments of all threads (runnable or sleeping) in list order, used to put woken threads back in place
+		environment* thread_order_head;
+		size_t thread_order_count;
 	private:
 		void alloc_env_chunk(size_t chunk);
 
 		environment* get_new_environment();
 		void dispose_environment(environment* env);
+
+		void link_thread_order(environment* prev, environment* env);
+		void unlink_thread_order(environment* env);
+		void relabel_thread_order();
+		void wake_threads();
 	public:
 		script_machine(script_engine* the_engine);
 		virtual ~script_machine();
@@ -178,11 +318,13 @@ namespace gstd {
 		int get_current_line();
 		int get_current_thread_addr() { return (int)current_thread_index._Ptr; }
 
-		size_t get_thread_count() { return threads.size(); }
+		size_t get_thread_count() { return threads.size() + sleeping_threads.size(); }
 	private:
 		void yield() {
-			if (current_thread_index == threads.begin())
+			if (current_thread_index == threads.begin()) {
+				wake_threads();
 				current_thread_index = std::prev(threads.end());
+			}
 			else
 				--current_thread_index;
 		}
@@ -20,11 +20,14 @@ namespace gstd {
 		dnh_func_callback_t func;
 		int argc;
 		const char* signature;
+		int atom_arg;		//Index of the argument whose string literals are interned at compile time, -1 if none
 
 		function(const char* name_, dnh_func_callback_t func_) : function(name_, func_, 0, "") {};
 		function(const char* name_, dnh_func_callback_t func_, int argc_) : function(name_, func_, argc_, "") {};
-		function(const char* name_, dnh_func_callback_t func_, int argc_, const char* signature_) : name(name_),
-			func(func_), argc(argc_), signature(signature_) {};
+		function(const char* name_, dnh_func_callback_t func_, int argc_, const char* signature_) : 
+			function(name_, func_, argc_, signature_, -1) {};
+		function(const char* name_, dnh_func_callback_t func_, int argc_, const char* signature_, int atom_arg_) : name(name_),
+			func(func_), argc(argc_), signature(signature_), atom_arg(atom_arg_) {};
 	};
 	struct constant {
 		const char* name;
@@ -25,22 +25,27 @@ void ScriptEngineData::SetSource(std::vector<char>& source) {
 ScriptEngineCache::ScriptEngineCache() {
 }
 void ScriptEngineCache::Clear() {
+	Lock lock(lock_);
 	cache_.clear();
 }
 void ScriptEngineCache::AddCache(const std::wstring& name, shared_ptr<ScriptEngineData> data) {
+	Lock lock(lock_);
 	cache_[name] = data;
 }
 void ScriptEngineCache::RemoveCache(const std::wstring& name) {
+	Lock lock(lock_);
 	auto itrFind = cache_.find(name);
 	if (cache_.find(name) != cache_.end())
 		cache_.erase(itrFind);
 }
 shared_ptr<ScriptEngineData> ScriptEngineCache::GetCache(const std::wstring& name) {
+	Lock lock(lock_);
 	auto itrFind = cache_.find(name);
 	if (cache_.find(name) == cache_.end()) return nullptr;
 	return itrFind->second;
 }
 bool ScriptEngineCache::IsExists(const std::wstring& name) {
+	Lock lock(lock_);
 	return cache_.find(name) != cache_.end();
 }
 
@@ -421,20 +426,23 @@ void ScriptClientBase::SetSource(std::vector<char>& source) {
 	ScriptFileLineMap* mapLine = engine_->GetScriptFileLineMap();
 	mapLine->AddEntry(engine_->GetPath(), 1, StringUtility::CountCharacter(source, '\n') + 1);
 }
-void ScriptClientBase::Compile() {
-	if (engine_->GetEngine() == nullptr) {
-		std::vector<char> source = _ParseScriptSource(engine_->GetSource());
-		engine_->SetSource(source);
+void ScriptClientBase::_CompileEngine() {
+	if (engine_->GetEngine() != nullptr) return;
 
-		bool bCreateSuccess = _CreateEngine();
-		if (!bCreateSuccess) {
-			bError_ = true;
-			_RaiseErrorFromEngine();
-		}
-		if (cache_ != nullptr && engine_->GetPath().size() > 0) {
-			cache_->AddCache(engine_->GetPath(), engine_);
-		}
+	std::vector<char> source = _ParseScriptSource(engine_->GetSource());
+	engine_->SetSource(source);
+
+	bool bCreateSuccess = _CreateEngine();
+	if (!bCreateSuccess) {
+		bError_ = true;
+		_RaiseErrorFromEngine();
+	}
+	if (cache_ != nullptr && engine_->GetPath().size() > 0) {
+		cache_->AddCache(engine_->GetPath(), engine_);
 	}
+}
+void ScriptClientBase::Compile() {
+	_CompileEngine();
 
 	machine_.reset(new script_machine(engine_->GetEngine().get()));
 	if (machine_->get_error()) {
@@ -1814,9 +1822,88 @@ value ScriptClientBase::Func_IsValidCommonDataValuePointer(script_machine* machi
 	return script->CreateBooleanValue(ScriptCommonData::Script_DecomposePtr((uint64_t&)val, nullptr));
 }
 
+//****************************************************************************
+//ScriptCompileService
+//****************************************************************************
+void ScriptCompileService::_CompileJob(Job* job) {
+	auto timeStart = std::chrono::steady_clock::now();
+	try {
+		ScriptClientBase* client = job->client.get();
+		client->SetSourceFromFile(job->path);
+		client->_CompileEngine();
+		job->bSuccess = true;
+	}
+	catch (const wexception& e) {
+		job->error = e.GetErrorMessage();
+	}
+	catch (...) {
+		job->error = L"(Unknown error.)";
+	}
+	std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - timeStart;
+	job->timeCompile = time.count();
+}
+double ScriptCompileService::Compile(std::vector<Job>& listJob, size_t countThread) {
+	auto timeStart = std::chrono::steady_clock::now();
+
+	if (countThread == 0)
+		countThread = std::max(std::thread::hardware_concurrency(), 1U);
+	countThread = std::min(countThread, listJob.size());
+
+	//Workers take the next job in line until none are left
+	std::atomic<size_t> indexNext = 0;
+	auto funcWorker = [&]() {
+		while (true) {
+			size_t index = indexNext++;
+			if (index >= listJob.size()) break;
+			_CompileJob(&listJob[index]);
+		}
+	};
+
+	if (countThread > 1) {
+		script_type_manager* typeManager = script_type_manager::get_instance();
+		typeManager->begin_concurrent();
+
+		std::vector<std::future<void>> listWorker;
+		try {
+			for (size_t i = 1; i < countThread; ++i)
+				listWorker.push_back(std::async(std::launch::async, funcWorker));
+			funcWorker();
+		}
+		catch (...) {
+			for (auto& worker : listWorker)
+				worker.wait();
+			typeManager->end_concurrent();
+			throw;
+		}
+
+		//get() rethrows anything that escaped a worker, but only once every worker has been joined
+		std::exception_ptr pException = nullptr;
+		for (auto& worker : listWorker) {
+			try {
+				worker.get();
+			}
+			catch (...) {
+				if (pException == nullptr)
+					pException = std::current_exception();
+			}
+		}
+		typeManager->end_concurrent();
+
+		if (pException)
+			std::rethrow_exception(pException);
+	}
+	else funcWorker();
+
+	std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - timeStart;
+	return time.count();
+}
+
 //****************************************************************************
 //ScriptLoader
 //****************************************************************************
+CriticalSection ScriptLoader::lockIncludeCache_;
+std::unordered_map<std::wstring, std::pair<int64_t, shared_ptr<ScriptLoader::IncludeFileData>>> ScriptLoader::mapIncludeCache_;
+
 ScriptLoader::ScriptLoader(ScriptClientBase* script, const std::wstring& path, std::vector<char>& source, ScriptFileLineMap* mapLine) {
 	script_ = script;
 
@@ -1827,11 +1914,14 @@ ScriptLoader::ScriptLoader(ScriptClientBase* script, const std::wstring& path, s
 	encoding_ = scanner_->GetEncoding();
 	charSize_ = Encoding::GetCharSize(encoding_);
 
+	lineOffset_ = 0;
+
 	mapLine_ = mapLine;
 }
 
 void ScriptLoader::_RaiseError(int line, const std::wstring& err) {
-	script_->engine_->SetSource(src_);
+	//While includes are being expanded, line numbers refer to the combined source
+	script_->engine_->SetSource(srcResult_.size() > 0 ? srcResult_ : src_);
 	script_->_RaiseError(line, err);
 }
 void ScriptLoader::_DumpRes() {
@@ -1909,7 +1999,7 @@ void ScriptLoader::_ResetScanner(size_t iniReadPos) {
 }
 void ScriptLoader::_AssertNewline() {
 	if (scanner_->HasNext() && scanner_->Next().GetType() != Token::Type::TK_NEWLINE) {
-		int line = scanner_->GetCurrentLine();
+		int line = scanner_->GetCurrentLine() + lineOffset_;
 		_RaiseError(line, L"A newline is required.\r\n");
 	}
 }
@@ -1967,168 +2057,244 @@ static inline void _CheckEnd(const unique_ptr<Scanner>& scanner) {
 		throw wexception("Unexpected EOF while parsing script.");
 }
 void ScriptLoader::_ParseInclude() {
+	std::vector<IncludeDirective> listDirective;
+	_ScanIncludeDirective(listDirective, 0);
+	if (listDirective.empty()) return;
+
+	//Build the combined source in one pass instead of splicing every include into src_ and rescanning
+	srcResult_.clear();
+	srcResult_.reserve(src_.size());
+	_ExpandInclude(src_, listDirective, 1, 0);
+
+	src_.swap(srcResult_);
+	std::vector<char>().swap(srcResult_);
+}
+void ScriptLoader::_ScanIncludeDirective(std::vector<IncludeDirective>& res, size_t offset) {
 	while (true) {
-		bool bReread = false;
 		Token* tok = &scanner_->GetToken();
 		if (tok->GetType() == Token::Type::TK_SHARP) {
 			size_t posBeforeDirective = scanner_->GetCurrentPointer() - charSize_;
 
 			_CheckEnd(scanner_);
 			tok = &scanner_->Next();
-			if (tok->GetType() == Token::Type::TK_ID) {
-				int directiveLine = scanner_->GetCurrentLine();
-				std::wstring directiveType = tok->GetElement();
+			if (tok->GetType() == Token::Type::TK_ID && tok->GetElement() == L"include") {
+				IncludeDirective directive;
+				directive.line = scanner_->GetCurrentLine();
+
+				_CheckEnd(scanner_);
+				tok = &scanner_->Next();
+				directive.path = tok->GetString();
+				directive.posBefore = posBeforeDirective - offset;
+				directive.posAfter = scanner_->GetCurrentPointer() - offset;
+				res.push_back(directive);
+
+				if (!scanner_->HasNext()) break;
+				_AssertNewline();
+				_CheckEnd(scanner_);
+
+				//The current token is now the first one of the next line
+				if (scanner_->Next().GetType() == Token::Type::TK_EOF) break;
+				continue;
+			}
+		}
+		if (!_SkipToNextValidLine()) break;
+	}
+}
+std::wstring ScriptLoader::_ResolveIncludePath(std::wstring path, int directiveLine) {
+	//Transform a "../" or a "..\" at the start into a "./"
+	if (path._Starts_with(L"../") || path._Starts_with(L"..\\"))
+		path = L"./" + path;
 
-				if (directiveType == L"include") {
-					_CheckEnd(scanner_);
-					tok = &scanner_->Next();
-					std::wstring wPath = tok->GetString();
+	//Expand the relative "./" into the full path
+	if (path.find(L".\\") != std::wstring::npos || path.find(L"./") != std::wstring::npos) {
+		const std::wstring& linePath = mapLine_->GetPath(directiveLine);
+		std::wstring tDir = PathProperty::GetFileDirectory(linePath);
+		path = tDir.substr(PathProperty::GetModuleDirectory().size()) + path.substr(2);
+	}
+	path = PathProperty::GetModuleDirectory() + path;
+	return PathProperty::GetUnique(path);
+}
+int ScriptLoader::_ExpandInclude(const std::vector<char>& source, const std::vector<IncludeDirective>& listDirective,
+	int lineBase, int countNewline)
+{
+	//Lines added to this file by the includes expanded so far
+	int lineShift = 0;
 
-					size_t posAfterInclude = scanner_->GetCurrentPointer();
-					if (scanner_->HasNext()) {
-						_AssertNewline();
+	size_t pos = 0;
+	for (const IncludeDirective& directive : listDirective) {
+		srcResult_.insert(srcResult_.end(), source.begin() + pos, source.begin() + directive.posBefore);
+		pos = directive.posAfter;
 
-						_CheckEnd(scanner_);
-						scanner_->Next();
-					}
+		int directiveLine = lineBase + directive.line - 1 + lineShift;
+		std::wstring wPath = _ResolveIncludePath(directive.path, directiveLine);
 
-					//Transform a "../" or a "..\" at the start into a "./"
-					if (wPath._Starts_with(L"../") || wPath._Starts_with(L"..\\"))
-						wPath = L"./" + wPath;
+		//Already included files are dropped along with their directive
+		if (!setIncludedPath_.insert(wPath).second) continue;
 
-					//Expand the relative "./" into the full path
-					if (wPath.find(L".\\") != std::wstring::npos || wPath.find(L"./") != std::wstring::npos) {
-						const std::wstring& linePath = mapLine_->GetPath(directiveLine);
-						std::wstring tDir = PathProperty::GetFileDirectory(linePath);
-						//std::string tDir = PathProperty::GetFileDirectory(pathSource);
-						wPath = tDir.substr(PathProperty::GetModuleDirectory().size()) + wPath.substr(2);
-					}
-					wPath = PathProperty::GetModuleDirectory() + wPath;
-					wPath = PathProperty::GetUnique(wPath);
+		shared_ptr<IncludeFileData> data = _LoadIncludeFile(wPath, directiveLine);
+		mapLine_->AddEntry(wPath, directiveLine, data->countLine);
 
-					if (setIncludedPath_.find(wPath) != setIncludedPath_.end()) {
-						//Logger::WriteTop(StringUtility::Format(
-						//	L"Scanner: File already included, skipping. (%s)", wPath.c_str()));
-						src_.erase(src_.begin() + posBeforeDirective, src_.begin() + posAfterInclude);
-						_ResetScanner(posBeforeDirective);
-					}
-					else {
-						setIncludedPath_.insert(wPath);
-
-						std::vector<char> bufIncluding;
-						{
-							shared_ptr<FileReader> reader = FileManager::GetBase()->GetFileReader(wPath);
-							if (reader == nullptr || !reader->Open()) {
-								std::wstring error = StringUtility::Format(
-									L"Include file is not found. [%s]\r\n", wPath.c_str());
-								_RaiseError(directiveLine, error);
-							}
+		lineShift += _ExpandInclude(data->source, data->listDirective, directiveLine, data->countNewline);
+	}
+	srcResult_.insert(srcResult_.end(), source.begin() + pos, source.end());
 
-							//Detect target encoding
-							size_t targetBomSize = 0;
-							Encoding::Type includeEncoding = Encoding::UTF8;
-							if (reader->GetFileSize() >= 2) {
-								byte data[3];
-								reader->Read(data, 3);
+	return countNewline + lineShift;
+}
+int ScriptLoader::_CountNewline(const char* data, size_t size) {
+	int res = 0;
+	if (charSize_ == 2) {
+		char lo = encoding_ == Encoding::UTF16BE ? 1 : 0;
+		for (size_t i = 0; i + 1 < size; i += 2) {
+			if (data[i + lo] == '\n' && data[i + (lo ^ 1)] == '\0')
+				++res;
+		}
+	}
+	else {
+		res = (int)std::count(data, data + size, '\n');
+	}
+	return res;
+}
+shared_ptr<ScriptLoader::IncludeFileData> ScriptLoader::_LoadIncludeFile(const std::wstring& wPath, int directiveLine) {
+	//The processed file depends on the target encoding and the macros visible to #ifdef
+	std::wstring key = StringUtility::Format(L"%d|", (int)encoding_) + wPath;
+	for (auto itrMacro = script_->definedMacro_.begin(); itrMacro != script_->definedMacro_.end(); ++itrMacro)
+		key += L"|" + itrMacro->first + L"=" + itrMacro->second;
 
-								includeEncoding = Encoding::Detect((char*)data, reader->GetFileSize());
-								targetBomSize = Encoding::GetBomSize(includeEncoding);
+	int64_t timeWrite = File::GetLastWriteTime(wPath);
 
-								reader->SetFilePointerBegin();
-							}
+	{
+		Lock lock(lockIncludeCache_);
+		auto itrFind = mapIncludeCache_.find(key);
+		if (itrFind != mapIncludeCache_.end() && itrFind->second.first == timeWrite)
+			return itrFind->second.second;
+	}
 
-							if (reader->GetFileSize() >= targetBomSize) {
-								reader->Seek(targetBomSize);
-								bufIncluding.resize(reader->GetFileSize() - targetBomSize); //- BOM size
-								reader->Read(&bufIncluding[0], bufIncluding.size());
-							}
+	std::vector<char> bufIncluding;
+	{
+		shared_ptr<FileReader> reader = FileManager::GetBase()->GetFileReader(wPath);
+		if (reader == nullptr || !reader->Open()) {
+			std::wstring error = StringUtility::Format(
+				L"Include file is not found. [%s]\r\n", wPath.c_str());
+			_RaiseError(directiveLine, error);
+		}
 
-							if (bufIncluding.size() > 0U) {
-								if (includeEncoding == Encoding::UTF16LE || includeEncoding == Encoding::UTF16BE) {
-									//Including UTF-16
-
-									//Convert the including file to UTF-8
-									if (encoding_ == Encoding::UTF8 || encoding_ == Encoding::UTF8BOM) {
-										if (includeEncoding == Encoding::UTF16BE) {
-											for (auto wItr = bufIncluding.begin(); wItr != bufIncluding.end(); wItr += 2) {
-												std::swap(*wItr, *(wItr + 1));
-											}
-										}
-
-										std::vector<char> mbres;
-										size_t countMbRes = StringUtility::ConvertWideToMulti(
-											(wchar_t*)bufIncluding.data(), bufIncluding.size() / 2U, mbres, CP_UTF8);
-										if (countMbRes == 0) {
-											std::wstring error = StringUtility::Format(L"Error reading include file. "
-												"(%s -> UTF-8) [%s]\r\n",
-												Encoding::WStringRepresentation(includeEncoding), wPath.c_str());
-											_RaiseError(scanner_->GetCurrentLine(), error);
-										}
-
-										includeEncoding = encoding_;
-										bufIncluding = mbres;
-									}
-								}
-								else {
-									//Including UTF-8
-
-									//Convert the include file to UTF-16 if it's in UTF-8
-									if (encoding_ == Encoding::UTF16LE || encoding_ == Encoding::UTF16BE) {
-										size_t includeSize = bufIncluding.size();
-
-										std::vector<char> wplacement;
-										size_t countWRes = StringUtility::ConvertMultiToWide(bufIncluding.data(),
-											includeSize, wplacement, CP_UTF8);
-										if (countWRes == 0) {
-											std::wstring error = StringUtility::Format(L"Error reading include file. "
-												"(UTF-8 -> %s) [%s]\r\n",
-												Encoding::WStringRepresentation(encoding_), wPath.c_str());
-											_RaiseError(scanner_->GetCurrentLine(), error);
-										}
-
-										bufIncluding = wplacement;
-
-										//Swap bytes for UTF-16 BE
-										if (encoding_ == Encoding::UTF16BE) {
-											for (auto wItr = bufIncluding.begin(); wItr != bufIncluding.end(); wItr += 2) {
-												std::swap(*wItr, *(wItr + 1));
-											}
-										}
-									}
-								}
-							}
-						}
+		//Detect target encoding
+		size_t targetBomSize = 0;
+		Encoding::Type includeEncoding = Encoding::UTF8;
+		if (reader->GetFileSize() >= 2) {
+			byte data[3];
+			reader->Read(data, 3);
 
-						{
-							ScriptLoader includeLoader(script_, pathSource_, bufIncluding, mapLine_);
-							includeLoader._ParseIfElse();
+			includeEncoding = Encoding::Detect((char*)data, reader->GetFileSize());
+			targetBomSize = Encoding::GetBomSize(includeEncoding);
 
-							std::vector<char>& bufIncludingNew = includeLoader.GetResult();
+			reader->SetFilePointerBegin();
+		}
 
-							mapLine_->AddEntry(wPath, directiveLine,
-								StringUtility::CountCharacter(bufIncludingNew, '\n') + 1);
-							{
-								src_.erase(src_.begin() + posBeforeDirective, src_.begin() + posAfterInclude);
-								src_.insert(src_.begin() + posBeforeDirective, bufIncludingNew.begin(), bufIncludingNew.end());
+		if (reader->GetFileSize() >= targetBomSize) {
+			reader->Seek(targetBomSize);
+			bufIncluding.resize(reader->GetFileSize() - targetBomSize); //- BOM size
+			reader->Read(&bufIncluding[0], bufIncluding.size());
+		}
 
-								_ResetScanner(posBeforeDirective);
-							}
+		if (bufIncluding.size() > 0U) {
+			if (includeEncoding == Encoding::UTF16LE || includeEncoding == Encoding::UTF16BE) {
+				//Including UTF-16
+
+				//Convert the including file to UTF-8
+				if (encoding_ == Encoding::UTF8 || encoding_ == Encoding::UTF8BOM) {
+					if (includeEncoding == Encoding::UTF16BE) {
+						for (auto wItr = bufIncluding.begin(); wItr != bufIncluding.end(); wItr += 2) {
+							std::swap(*wItr, *(wItr + 1));
 						}
 					}
 
-					_DumpRes();
-					bReread = true;
+					std::vector<char> mbres;
+					size_t countMbRes = StringUtility::ConvertWideToMulti(
+						(wchar_t*)bufIncluding.data(), bufIncluding.size() / 2U, mbres, CP_UTF8);
+					if (countMbRes == 0) {
+						std::wstring error = StringUtility::Format(L"Error reading include file. "
+							"(%s -> UTF-8) [%s]\r\n",
+							Encoding::WStringRepresentation(includeEncoding), wPath.c_str());
+						_RaiseError(directiveLine, error);
+					}
+
+					includeEncoding = encoding_;
+					bufIncluding = mbres;
+				}
+			}
+			else {
+				//Including UTF-8
+
+				//Convert the include file to UTF-16 if it's in UTF-8
+				if (encoding_ == Encoding::UTF16LE || encoding_ == Encoding::UTF16BE) {
+					size_t includeSize = bufIncluding.size();
+
+					std::vector<char> wplacement;
+					size_t countWRes = StringUtility::ConvertMultiToWide(bufIncluding.data(),
+						includeSize, wplacement, CP_UTF8);
+					if (countWRes == 0) {
+						std::wstring error = StringUtility::Format(L"Error reading include file. "
+							"(UTF-8 -> %s) [%s]\r\n",
+							Encoding::WStringRepresentation(encoding_), wPath.c_str());
+						_RaiseError(directiveLine, error);
+					}
+
+					bufIncluding = wplacement;
+
+					//Swap bytes for UTF-16 BE
+					if (encoding_ == Encoding::UTF16BE) {
+						for (auto wItr = bufIncluding.begin(); wItr != bufIncluding.end(); wItr += 2) {
+							std::swap(*wItr, *(wItr + 1));
+						}
+					}
 				}
 			}
 		}
-		if (bReread) {
-			if (!scanner_->HasNext()) break;
-			tok = &scanner_->Next();
-			if (tok->GetType() == Token::Type::TK_EOF) break;
-			continue;
+	}
+
+	shared_ptr<IncludeFileData> data(new IncludeFileData());
+	{
+		ScriptLoader includeLoader(script_, pathSource_, bufIncluding, mapLine_);
+		includeLoader._ParseIfElse();
+
+		data->source.swap(includeLoader.GetResult());
+		data->countLine = StringUtility::CountCharacter(data->source, '\n') + 1;
+		data->countNewline = _CountNewline(data->source.data(), data->source.size());
+	}
+
+	//Find the file's own directives once, with the BOM of the including script so the scanner reads it in the same encoding
+	{
+		size_t sizeBom = Encoding::GetBomSize(encoding_);
+
+		std::vector<char> bufScan(sizeBom);
+		if (sizeBom > 0)
+			memcpy(bufScan.data(), Encoding::GetBom(encoding_), sizeBom);
+		bufScan.insert(bufScan.end(), data->source.begin(), data->source.end());
+
+		unique_ptr<Scanner> scannerParent = std::move(scanner_);
+		int lineOffsetParent = lineOffset_;
+		try {
+			scanner_.reset(new Scanner(bufScan));
+			lineOffset_ = directiveLine - 1;
+
+			scanner_->Next();
+			_ScanIncludeDirective(data->listDirective, sizeBom);
 		}
-		if (!_SkipToNextValidLine()) break;
+		catch (...) {
+			scanner_ = std::move(scannerParent);
+			lineOffset_ = lineOffsetParent;
+			throw;
+		}
+		scanner_ = std::move(scannerParent);
+		lineOffset_ = lineOffsetParent;
+	}
+
+	{
+		Lock lock(lockIncludeCache_);
+		mapIncludeCache_[key] = std::make_pair(timeWrite, data);
 	}
+	return data;
 }
 void ScriptLoader::_ParseIfElse() {
 	struct _DirectivePos {
@@ -2487,6 +2653,7 @@ ScriptCommonData::ScriptCommonData() {
 ScriptCommonData::~ScriptCommonData() {}
 void ScriptCommonData::Clear() {
 	mapValue_.clear();
+	mapRecordCache_.clear();
 }
 std::pair<bool, std::map<std::string, gstd::value>::iterator> ScriptCommonData::IsExists(const std::string& name) {
 	auto itr = mapValue_.find(name);
@@ -2517,9 +2684,11 @@ void ScriptCommonData::SetValue(std::map<std::string, gstd::value>::iterator itr
 }
 void ScriptCommonData::DeleteValue(const std::string& name) {
 	mapValue_.erase(name);
+	mapRecordCache_.erase(name);
 }
 void ScriptCommonData::Copy(shared_ptr<ScriptCommonData>& dataSrc) {
 	mapValue_.clear();
+	mapRecordCache_.clear();
 	for (auto itrKey = dataSrc->MapBegin(); itrKey != dataSrc->MapEnd(); ++itrKey) {
 		mapValue_.insert(std::make_pair(itrKey->first, itrKey->second));
 	}
@@ -2537,15 +2706,13 @@ void ScriptCommonData::ReadRecord(gstd::RecordBuffer& record) {
 		buffer.Seek(0);
 		buffer.Read(&storedSize, sizeof(uint32_t));
 
-		if (storedSize > 0U) {
-			gstd::ByteBuffer bufferRes;
-			bufferRes.SetSize(storedSize);
-			buffer.Read(bufferRes.GetPointer(), bufferRes.GetSize());
-			storedVal = _ReadRecord(bufferRes);
-		}
+		//Decoded in place, the value directly follows its size
+		if (storedSize > 0U)
+			storedVal = _ReadRecord(buffer);
 
 		mapValue_[key] = storedVal;
 	}
+	mapRecordCache_.clear();
 }
 gstd::value ScriptCommonData::_ReadRecord(gstd::ByteBuffer& buffer) {
 	script_type_manager* scriptTypeManager = script_type_manager::get_instance();
@@ -2577,6 +2744,9 @@ gstd::value ScriptCommonData::_ReadRecord(gstd::ByteBuffer& buffer) {
 	case type_data::type_kind::tk_array:
 	{
 		uint32_t arrayLength = buffer.ReadValue<uint32_t>();
+		//Every element takes at least a byte, anything longer than the rest of the buffer is broken data
+		if (arrayLength > buffer.GetSize() - buffer.GetOffset())
+			return value();
 		if (arrayLength > 0U) {
 			std::vector<value> v;
 			v.resize(arrayLength);
@@ -2596,19 +2766,141 @@ gstd::value ScriptCommonData::_ReadRecord(gstd::ByteBuffer& buffer) {
 void ScriptCommonData::WriteRecord(gstd::RecordBuffer& record) {
 	for (auto itrValue = mapValue_.begin(); itrValue != mapValue_.end(); ++itrValue) {
 		const std::string& key = itrValue->first;
-		const gstd::value& comVal = itrValue->second;
-		
-		gstd::ByteBuffer buffer;
-		buffer.WriteValue<uint32_t>(0U);
+		gstd::ByteBuffer& buffer = _GetRecordData(key, itrValue->second);
+		record.SetRecord(key, buffer.GetPointer(), buffer.GetSize());
+	}
+}
+bool ScriptCommonData::_IsSameValue(const gstd::value& v1, const gstd::value& v2) {
+	if (v1.get_type() != v2.get_type()) return false;
+	if (!v1.has_data()) return true;
 
-		if (comVal.has_data()) {
-			_WriteRecord(buffer, comVal);
-			buffer.Seek(0U);
-			buffer.WriteValue<uint32_t>(buffer.GetSize() - sizeof(uint32_t));
+	switch (v1.get_type()->get_kind()) {
+	case type_data::type_kind::tk_int:
+		return v1.as_int() == v2.as_int();
+	case type_data::type_kind::tk_float:
+	{
+		//Bitwise, so that NaN compares equal to itself
+		double f1 = v1.as_float();
+		double f2 = v2.as_float();
+		return memcmp(&f1, &f2, sizeof(double)) == 0;
+	}
+	case type_data::type_kind::tk_char:
+		return v1.as_char() == v2.as_char();
+	case type_data::type_kind::tk_boolean:
+		return v1.as_boolean() == v2.as_boolean();
+	case type_data::type_kind::tk_array:
+	{
+		//Arrays can grow in place (~=), so compare contents rather than the shared pointer
+		size_t length = v1.length_as_array();
+		if (length != v2.length_as_array()) return false;
+		for (size_t i = 0; i < length; ++i) {
+			if (!_IsSameValue(v1.index_as_array(i), v2.index_as_array(i)))
+				return false;
 		}
+		return true;
+	}
+	}
+	return false;
+}
+gstd::ByteBuffer& ScriptCommonData::_GetRecordData(const std::string& key, const gstd::value& comValue) {
+	RecordCache& cache = mapRecordCache_[key];
+	if (cache.bValid && _IsSameValue(cache.valueSaved, comValue))
+		return cache.data;
 
-		record.SetRecord(key, buffer.GetPointer(), buffer.GetSize());
+	//Re-encode only values that changed since they were last saved, the buffer's reserve is reused
+	gstd::ByteBuffer& buffer = cache.data;
+	buffer.SetSize(0);
+	buffer.Seek(0);
+	buffer.WriteValue<uint32_t>(0U);
+
+	if (comValue.has_data()) {
+		_WriteRecord(buffer, comValue);
+		buffer.Seek(0U);
+		buffer.WriteValue<uint32_t>(buffer.GetSize() - sizeof(uint32_t));
+	}
+
+	//Keep a private copy, the script may still modify the original array in place
+	cache.valueSaved = comValue;
+	cache.valueSaved.make_unique();
+	cache.bValid = true;
+	return buffer;
+}
+bool ScriptCommonData::ReadFromFile(const std::wstring& path, uint64_t version) {
+	gstd::ByteBuffer buffer;
+	{
+		File file(path);
+		if (!file.Open()) return false;
+
+		size_t size = file.GetSize();
+		if (size < HEADER_SAVED_DATA_SIZE + sizeof(uint64_t) + sizeof(uint32_t))
+			return false;
+
+		buffer.SetSize(size);
+		if (file.Read(buffer.GetPointer(), size) != size)
+			return false;
+	}
+
+	if (memcmp(buffer.GetPointer(), HEADER_SAVED_DATA, HEADER_SAVED_DATA_SIZE) != 0)
+		return false;
+	buffer.Seek(HEADER_SAVED_DATA_SIZE);
+	if (!VersionUtility::IsDataBackwardsCompatible(version, buffer.ReadValue<uint64_t>()))
+		return false;
+
+	auto _Readable = [&](size_t size) {
+		return size <= buffer.GetSize() - buffer.GetOffset();
+	};
+
+	std::map<std::string, gstd::value> mapValue;
+	std::unordered_map<std::string, RecordCache> mapRecordCache;
+
+	uint32_t countEntry = buffer.ReadValue<uint32_t>();
+	for (uint32_t iEntry = 0; iEntry < countEntry; ++iEntry) {
+		if (!_Readable(sizeof(uint32_t))) return false;
+		uint32_t sizeKey = buffer.ReadValue<uint32_t>();
+		if (!_Readable(sizeKey + sizeof(uint32_t))) return false;
+
+		std::string key(buffer.GetPointer(buffer.GetOffset()), sizeKey);
+		buffer.Seek(buffer.GetOffset() + sizeKey);
+
+		uint32_t sizeEntry = buffer.ReadValue<uint32_t>();
+		if (sizeEntry < sizeof(uint32_t) || !_Readable(sizeEntry)) return false;
+
+		//Values are decoded straight from the file's buffer
+		size_t posEntry = buffer.GetOffset();
+		gstd::value storedVal;
+		if (buffer.ReadValue<uint32_t>() > 0U)
+			storedVal = _ReadRecord(buffer);
+		buffer.Seek(posEntry + sizeEntry);
+
+		//The loaded bytes are what a save would produce for this value, keep them for the next save
+		RecordCache& cache = mapRecordCache[key];
+		cache.data.Write(buffer.GetPointer(posEntry), sizeEntry);
+		cache.valueSaved = storedVal;
+		cache.bValid = true;
+
+		mapValue[key] = storedVal;
 	}
+
+	mapValue_.swap(mapValue);
+	mapRecordCache_.swap(mapRecordCache);
+	return true;
+}
+bool ScriptCommonData::WriteToFile(const std::wstring& path, uint64_t version) {
+	//A failed save leaves the previous file intact
+	return File::WriteAtomic(path, [&](File& file) {
+		file.Write((LPVOID)HEADER_SAVED_DATA, HEADER_SAVED_DATA_SIZE);
+		file.WriteValue<uint64_t>(version);
+		file.WriteValue<uint32_t>(mapValue_.size());
+		for (auto& [key, comValue] : mapValue_) {
+			gstd::ByteBuffer& data = _GetRecordData(key, comValue);
+
+			file.WriteValue<uint32_t>(key.size());
+			file.Write((LPVOID)key.data(), key.size());
+			file.WriteValue<uint32_t>(data.GetSize());
+			file.Write(data.GetPointer(), data.GetSize());
+		}
+		return true;
+	});
 }
 void ScriptCommonData::_WriteRecord(gstd::ByteBuffer& buffer, const gstd::value& comValue) {
 	type_data::type_kind kind = comValue.get_type()->get_kind();
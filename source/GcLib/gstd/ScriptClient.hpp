@@ -72,6 +72,7 @@ namespace gstd {
 	//*******************************************************************
 	class ScriptEngineCache {
 	protected:
+		gstd::CriticalSection lock_;
 		std::map<std::wstring, shared_ptr<ScriptEngineData>> cache_;
 	public:
 		ScriptEngineCache();
@@ -91,8 +92,10 @@ namespace gstd {
 	//ScriptClientBase
 	//*******************************************************************
 	class ScriptLoader;
+	class ScriptCompileService;
 	class ScriptClientBase {
 		friend class ScriptLoader;
+		friend class ScriptCompileService;
 		static unique_ptr<script_type_manager> pTypeManager_;
 	public:
 		enum {
@@ -134,6 +137,7 @@ namespace gstd {
 
 		virtual std::vector<char> _ParseScriptSource(std::vector<char>& source);
 		virtual bool _CreateEngine();
+		void _CompileEngine();
 
 		std::wstring _ExtendPath(std::wstring path);
 	public:
@@ -427,11 +431,52 @@ namespace gstd {
 	}
 #pragma endregion ScriptClientBase_impl
 
+	//*******************************************************************
+	//ScriptCompileService
+	//	Parses and compiles a batch of scripts on worker threads into their clients' engine caches.
+	//	Each job brings its own client, whose builtin functions and constants are only read while compiling.
+	//*******************************************************************
+	class ScriptCompileService {
+	public:
+		struct Job {
+			std::wstring path;
+			shared_ptr<ScriptClientBase> client;
+
+			bool bSuccess = false;
+			std::wstring error;
+			double timeCompile = 0;		//Milliseconds
+		};
+	protected:
+		static void _CompileJob(Job* job);
+	public:
+		//Returns the wall time spent in milliseconds. countThread == 0 uses one thread per core.
+		static double Compile(std::vector<Job>& listJob, size_t countThread = 0);
+	};
+
 	//*******************************************************************
 	//ScriptLoader
 	//*******************************************************************
 	class ScriptLoader {
+	public:
+		//Positions are relative to the start of the file's text
+		struct IncludeDirective {
+			size_t posBefore;
+			size_t posAfter;
+			int line;
+			std::wstring path;
+		};
+		//An include file converted to the including script's encoding with its #ifdef blocks resolved,
+		//	shared by every script that includes it
+		struct IncludeFileData {
+			std::vector<char> source;
+			std::vector<IncludeDirective> listDirective;
+			int countLine;
+			int countNewline;
+		};
 	protected:
+		static CriticalSection lockIncludeCache_;
+		static std::unordered_map<std::wstring, std::pair<int64_t, shared_ptr<IncludeFileData>>> mapIncludeCache_;
+
 		ScriptClientBase* script_;
 
 		std::wstring pathSource_;
@@ -440,9 +485,11 @@ namespace gstd {
 		size_t charSize_;
 
 		unique_ptr<Scanner> scanner_;
+		int lineOffset_;
 
 		ScriptFileLineMap* mapLine_;
 		std::set<std::wstring> setIncludedPath_;
+		std::vector<char> srcResult_;
 	protected:
 		void _RaiseError(int line, const std::wstring& err);
 		void _DumpRes();
@@ -454,6 +501,13 @@ namespace gstd {
 		void _ParseInclude();
 		void _ParseIfElse();
 
+		void _ScanIncludeDirective(std::vector<IncludeDirective>& res, size_t offset);
+		std::wstring _ResolveIncludePath(std::wstring path, int directiveLine);
+		shared_ptr<IncludeFileData> _LoadIncludeFile(const std::wstring& path, int directiveLine);
+		int _ExpandInclude(const std::vector<char>& source, const std::vector<IncludeDirective>& listDirective,
+			int lineBase, int countNewline);
+		int _CountNewline(const char* data, size_t size);
+
 		void _ConvertToEncoding(Encoding::Type targetEncoding);
 	public:
 		ScriptLoader(ScriptClientBase* script, const std::wstring& path, 
@@ -478,12 +532,23 @@ namespace gstd {
 			ScriptCommonData* pArea = nullptr;
 			gstd::value* pData = nullptr;
 		};
+	protected:
+		//Entry buffer of a value as it was last saved or loaded, reused by the next save while the value is unchanged
+		struct RecordCache {
+			bool bValid = false;
+			gstd::value valueSaved;
+			gstd::ByteBuffer data;
+		};
 	protected:
 		volatile size_t verifHash_;
 		std::map<std::string, gstd::value> mapValue_;
+		std::unordered_map<std::string, RecordCache> mapRecordCache_;
 
 		gstd::value _ReadRecord(gstd::ByteBuffer& buffer);
 		void _WriteRecord(gstd::ByteBuffer& buffer, const gstd::value& comValue);
+
+		static bool _IsSameValue(const gstd::value& v1, const gstd::value& v2);
+		gstd::ByteBuffer& _GetRecordData(const std::string& key, const gstd::value& comValue);
 	public:
 		ScriptCommonData();
 		virtual ~ScriptCommonData();
@@ -506,6 +571,10 @@ namespace gstd {
 		void ReadRecord(gstd::RecordBuffer& record);
 		void WriteRecord(gstd::RecordBuffer& record);
 
+		//Same file format as a RecordBuffer saved with HEADER_SAVED_DATA, without building one in between
+		bool ReadFromFile(const std::wstring& path, uint64_t version);
+		bool WriteToFile(const std::wstring& path, uint64_t version);
+
 		bool CheckHash() { return verifHash_ == DATA_HASH; }
 		static bool Script_DecomposePtr(uint64_t val, _Script_PointerData* dst);
 	};
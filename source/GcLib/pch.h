@@ -123,8 +123,11 @@
 
 #include <memory>
 #include <algorithm>
+#include <functional>
 #include <iterator>
+#include <atomic>
 #include <future>
+#include <shared_mutex>
 
 #include <fstream>
 #include <sstream>
@@ -150,6 +150,20 @@ ref_count_ptr<ScriptInformation> ScriptInformation::CreateScriptInformation(cons
 
 	return res;
 }
+bool ScriptInformation::IsArchiveFile(File& file) {
+	if (file.GetSize() < ArchiveFileHeader::MAGIC_LENGTH) return false;
+
+	char header[ArchiveFileHeader::MAGIC_LENGTH];
+	file.SetFilePointerBegin();
+	file.Read(&header, ArchiveFileHeader::MAGIC_LENGTH);
+	{
+		byte keyBase;
+		byte keyStep;
+		ArchiveEncryption::GetKeyHashHeader(ArchiveEncryption::ARCHIVE_ENCRYPTION_KEY, keyBase, keyStep);
+		ArchiveEncryption::ShiftBlock((byte*)header, ArchiveFileHeader::MAGIC_LENGTH, keyBase, keyStep);
+	}
+	return memcmp(header, ArchiveEncryption::HEADER_ARCHIVEFILE, ArchiveFileHeader::MAGIC_LENGTH) == 0;
+}
 bool ScriptInformation::IsExcludeExtention(const std::wstring& ext) {
 	static std::set<std::wstring> setExt = {
 		L".dat",
@@ -220,17 +234,8 @@ std::vector<ref_count_ptr<ScriptInformation>> ScriptInformation::CreateScriptInf
 	if (!file.Open()) return res;
 	if (file.GetSize() < ArchiveFileHeader::MAGIC_LENGTH) return res;
 
-	char header[ArchiveFileHeader::MAGIC_LENGTH];
-	file.Read(&header, ArchiveFileHeader::MAGIC_LENGTH);
-	{
-		byte keyBase;
-		byte keyStep;
-		ArchiveEncryption::GetKeyHashHeader(ArchiveEncryption::ARCHIVE_ENCRYPTION_KEY, keyBase, keyStep);
-		ArchiveEncryption::ShiftBlock((byte*)header, ArchiveFileHeader::MAGIC_LENGTH, keyBase, keyStep);
-	}
-
 	//Found a .dat, open it to read script files within
-	if (memcmp(header, ArchiveEncryption::HEADER_ARCHIVEFILE, ArchiveFileHeader::MAGIC_LENGTH) == 0) {
+	if (IsArchiveFile(file)) {
 		file.Close();
 
 		ArchiveFile archive(path, 0);
@@ -303,6 +308,176 @@ std::vector<ref_count_ptr<ScriptInformation>> ScriptInformation::FindPlayerScrip
 
 	return res;
 }
+
+//*******************************************************************
+//ScriptInformationIndex
+//*******************************************************************
+ScriptInformationIndex::ScriptInformationIndex(const std::wstring& path) {
+	path_ = path;
+	bDirty_ = false;
+	if (!_Load()) mapEntry_.clear();
+}
+ScriptInformationIndex* ScriptInformationIndex::GetBase() {
+	static ScriptInformationIndex index(PathProperty::GetModuleDirectory() + L"cache/script_index.dat");
+	return &index;
+}
+ScriptInformationIndex::FileStamp ScriptInformationIndex::GetFileStamp(const stdfs::directory_entry& entry) {
+	//Both are cached in the directory entry by the directory scan, no extra file system calls
+	FileStamp res;
+	std::error_code err;
+	res.size = entry.file_size(err);
+	auto time = entry.last_write_time(err);
+	if (!err) res.timeWrite = time.time_since_epoch().count();
+	return res;
+}
+bool ScriptInformationIndex::_Load() {
+	File file(path_);
+	if (!file.Open()) return false;
+
+	ByteBuffer buffer;
+	buffer.SetSize(file.GetSize());
+	if (buffer.GetSize() == 0 || file.Read(buffer.GetPointer(), buffer.GetSize()) != buffer.GetSize()) return false;
+	file.Close();
+
+	try {
+		auto _Read = [&](LPVOID dst, size_t size) {
+			if (buffer.Read(dst, size) != size) throw false;
+		};
+		auto _ReadValue = [&](auto& dst) { _Read(&dst, sizeof(dst)); };
+		auto _ReadString = [&](std::wstring& dst) {
+			uint32_t length = 0;
+			_ReadValue(length);
+			if (length > (buffer.GetSize() - buffer.GetOffset()) / sizeof(wchar_t)) throw false;
+			dst.resize(length);
+			if (length > 0) _Read(&dst[0], length * sizeof(wchar_t));
+		};
+
+		uint32_t version = 0;
+		_ReadValue(version);
+		if (version != INDEX_VERSION) return false;
+
+		uint32_t countEntry = 0;
+		_ReadValue(countEntry);
+		for (uint32_t iEntry = 0; iEntry < countEntry; ++iEntry) {
+			std::wstring path;
+			Entry entry;
+			uint32_t countInfo = 0;
+			_ReadString(path);
+			_ReadValue(entry.stamp.size);
+			_ReadValue(entry.stamp.timeWrite);
+			_ReadValue(countInfo);
+
+			for (uint32_t iInfo = 0; iInfo < countInfo; ++iInfo) {
+				ref_count_ptr<ScriptInformation> info = new ScriptInformation();
+				int32_t type = 0;
+				uint32_t countPlayer = 0;
+				_ReadValue(type);
+				_ReadString(info->pathArchive_);
+				_ReadString(info->pathScript_);
+				_ReadString(info->id_);
+				_ReadString(info->title_);
+				_ReadString(info->text_);
+				_ReadString(info->pathImage_);
+				_ReadString(info->pathSystem_);
+				_ReadString(info->pathBackground_);
+				_ReadValue(countPlayer);
+				for (uint32_t iPlayer = 0; iPlayer < countPlayer; ++iPlayer) {
+					std::wstring pathPlayer;
+					_ReadString(pathPlayer);
+					info->listPlayer_.push_back(pathPlayer);
+				}
+				_ReadString(info->replayName_);
+				info->type_ = type;
+
+				entry.listInfo.push_back(info);
+			}
+
+			mapEntry_[path] = entry;
+		}
+	}
+	catch (bool) {
+		Logger::WriteTop(L"ScriptInformationIndex: Index file is broken, rebuilding.");
+		return false;
+	}
+	return true;
+}
+bool ScriptInformationIndex::Find(const std::wstring& path, const FileStamp& stamp, 
+	std::vector<ref_count_ptr<ScriptInformation>>& res) 
+{
+	Lock lock(lock_);
+	auto itrFind = mapEntry_.find(path);
+	if (itrFind == mapEntry_.end() || !(itrFind->second.stamp == stamp)) return false;
+	res = itrFind->second.listInfo;
+	return true;
+}
+void ScriptInformationIndex::Update(const std::wstring& path, const FileStamp& stamp, 
+	const std::vector<ref_count_ptr<ScriptInformation>>& listInfo) 
+{
+	Lock lock(lock_);
+	Entry& entry = mapEntry_[path];
+	entry.stamp = stamp;
+	entry.listInfo = listInfo;
+	bDirty_ = true;
+}
+void ScriptInformationIndex::RemoveMissing(const std::wstring& dir, bool bRecursive, const std::set<std::wstring>& setPathFound) {
+	Lock lock(lock_);
+	for (auto itr = mapEntry_.begin(); itr != mapEntry_.end();) {
+		const std::wstring& path = itr->first;
+
+		bool bInside = path.size() > dir.size() && path.compare(0, dir.size(), dir) == 0;
+		if (bInside && !bRecursive)
+			bInside = path.find(L'/', dir.size()) == std::wstring::npos;
+
+		if (bInside && setPathFound.find(path) == setPathFound.end()) {
+			itr = mapEntry_.erase(itr);
+			bDirty_ = true;
+		}
+		else ++itr;
+	}
+}
+bool ScriptInformationIndex::Save() {
+	Lock lock(lock_);
+	if (!bDirty_) return true;
+
+	//A broken index is only detected when it's loaded
+	bool bWrite = File::WriteAtomic(path_, [&](File& file) {
+		auto _WriteString = [&](const std::wstring& str) {
+			file.WriteValue<uint32_t>(str.size());
+			if (str.size() > 0)
+				file.Write((LPVOID)str.data(), str.size() * sizeof(wchar_t));
+		};
+
+		file.WriteValue<uint32_t>(INDEX_VERSION);
+		file.WriteValue<uint32_t>(mapEntry_.size());
+		for (auto& [path, entry] : mapEntry_) {
+			_WriteString(path);
+			file.WriteValue<uint64_t>(entry.stamp.size);
+			file.WriteValue<int64_t>(entry.stamp.timeWrite);
+			file.WriteValue<uint32_t>(entry.listInfo.size());
+
+			for (auto& info : entry.listInfo) {
+				file.WriteValue<int32_t>(info->type_);
+				_WriteString(info->pathArchive_);
+				_WriteString(info->pathScript_);
+				_WriteString(info->id_);
+				_WriteString(info->title_);
+				_WriteString(info->text_);
+				_WriteString(info->pathImage_);
+				_WriteString(info->pathSystem_);
+				_WriteString(info->pathBackground_);
+				file.WriteValue<uint32_t>(info->listPlayer_.size());
+				for (auto& pathPlayer : info->listPlayer_)
+					_WriteString(pathPlayer);
+				_WriteString(info->replayName_);
+			}
+		}
+		return true;
+	});
+	if (!bWrite) return false;
+
+	bDirty_ = false;
+	return true;
+}
 #endif
 
 //*******************************************************************
@@ -359,6 +534,11 @@ LRESULT ErrorDialog::_WindowProcedure(HWND hWnd, UINT uMsg, WPARAM wParam, LPARA
 	return _CallPreviousWindowProcedure(hWnd, uMsg, wParam, lParam);
 }
 bool ErrorDialog::ShowModal(std::wstring msg) {
+#if defined(DNH_PROJ_EXECUTOR)
+	//The program may not survive past the error, get the log lines leading up to it on disk
+	Logger::FlushTop();
+#endif
+
 	HINSTANCE hInst = ::GetModuleHandle(NULL);
 	std::wstring wName = L"ErrorWindow";
 
@@ -53,6 +53,8 @@ public:
 		bool bNeedHeader = true);
 	static std::vector<ref_count_ptr<ScriptInformation>> FindPlayerScriptInformationList(const std::wstring& dir);
 	static bool IsExcludeExtention(const std::wstring& ext);
+	//Checks the archive header from the start of the file, archives aren't bound to any extension
+	static bool IsArchiveFile(File& file);
 
 private:
 	static std::wstring _GetString(Scanner& scanner);
@@ -80,6 +82,49 @@ struct ScriptInformation::PlayerListSort {
 		return res == CSTR_LESS_THAN;
 	}
 };
+
+//*******************************************************************
+//ScriptInformationIndex
+//*******************************************************************
+//Persistent record of the script headers found in each file (or archive) under the script directories.
+//An entry is reused for as long as the file's size and write time stay the same.
+class ScriptInformationIndex {
+public:
+	enum : uint32_t {
+		INDEX_VERSION = 1,
+	};
+
+	struct FileStamp {
+		uint64_t size = 0;
+		int64_t timeWrite = 0;
+
+		bool operator==(const FileStamp& other) const { return size == other.size && timeWrite == other.timeWrite; }
+	};
+protected:
+	struct Entry {
+		FileStamp stamp;
+		std::vector<ref_count_ptr<ScriptInformation>> listInfo;
+	};
+protected:
+	gstd::CriticalSection lock_;
+	std::wstring path_;
+	std::unordered_map<std::wstring, Entry> mapEntry_;
+	bool bDirty_;
+
+	bool _Load();
+public:
+	ScriptInformationIndex(const std::wstring& path);
+
+	static ScriptInformationIndex* GetBase();
+	static FileStamp GetFileStamp(const stdfs::directory_entry& entry);
+
+	bool Find(const std::wstring& path, const FileStamp& stamp, std::vector<ref_count_ptr<ScriptInformation>>& res);
+	void Update(const std::wstring& path, const FileStamp& stamp, const std::vector<ref_count_ptr<ScriptInformation>>& listInfo);
+	//Forgets files inside dir that weren't in the last scan
+	void RemoveMissing(const std::wstring& dir, bool bRecursive, const std::set<std::wstring>& setPathFound);
+
+	bool Save();
+};
 #endif
 
 //*******************************************************************
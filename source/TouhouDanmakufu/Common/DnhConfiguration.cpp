@@ -12,6 +12,7 @@ const size_t DnhConfiguration::MinScreenWidth = 150;
 const size_t DnhConfiguration::MinScreenHeight = 150;
 const size_t DnhConfiguration::MaxScreenWidth = 3840;
 const size_t DnhConfiguration::MaxScreenHeight = 2160;
+const size_t DnhConfiguration::MaxResidencyBudget = 2048;	//In megabytes, the budget in bytes must fit a 32-bit size_t
 DnhConfiguration::DnhConfiguration() {
 	modeScreen_ = ScreenMode::SCREENMODE_WINDOW;
 	modeColor_ = ColorMode::COLOR_MODE_32BIT;
@@ -59,6 +60,11 @@ DnhConfiguration::DnhConfiguration() {
 	windowSizeList_ = { { 640, 480 }, { 800, 600 }, { 960, 720 }, { 1280, 960 } };
 
 	bEnableUnfocusedProcessing_ = false;
+	bEnableTextureCache_ = false;
+	bEnableMeshCache_ = false;
+	bEnableDataCache_ = false;
+	bEnableBatch2D_ = true;
+	residencyBudget_ = 256;
 
 	LoadConfigFile();
 	_LoadDefinitionFile();
@@ -93,6 +99,23 @@ bool DnhConfiguration::_LoadDefinitionFile() {
 		std::wstring str = prop.GetString(L"unfocused.processing", L"false");
 		bEnableUnfocusedProcessing_ = str == L"true" ? true : StringUtility::ToInteger(str);
 	}
+	{
+		std::wstring str = prop.GetString(L"texture.cache", L"false");
+		bEnableTextureCache_ = str == L"true" ? true : StringUtility::ToInteger(str);
+	}
+	{
+		std::wstring str = prop.GetString(L"mesh.cache", L"false");
+		bEnableMeshCache_ = str == L"true" ? true : StringUtility::ToInteger(str);
+	}
+	{
+		std::wstring str = prop.GetString(L"data.cache", L"false");
+		bEnableDataCache_ = str == L"true" ? true : StringUtility::ToInteger(str);
+	}
+	{
+		std::wstring str = prop.GetString(L"render.batch2d", L"true");
+		bEnableBatch2D_ = str == L"true" ? true : StringUtility::ToInteger(str);
+	}
+	residencyBudget_ = std::clamp<int>(prop.GetInteger(L"residency.budget", 256), 0, MaxResidencyBudget);
 
 	{
 		auto _AddWindowSize = [&](std::vector<POINT>& listSize, LONG width, LONG height) {
@@ -22,6 +22,7 @@ public:
 	static const size_t MinScreenHeight;
 	static const size_t MaxScreenWidth;
 	static const size_t MaxScreenHeight;
+	static const size_t MaxResidencyBudget;
 public:
 	ScreenMode modeScreen_;
 	ColorMode modeColor_;
@@ -30,6 +31,11 @@ public:
 	LONG screenWidth_;
 	LONG screenHeight_;
 	bool bEnableUnfocusedProcessing_;
+	bool bEnableTextureCache_;
+	bool bEnableMeshCache_;
+	bool bEnableDataCache_;		//Shot and item data
+	bool bEnableBatch2D_;
+	size_t residencyBudget_;		//In megabytes
 
 	uint32_t fpsStandard_;
 	int fpsType_;
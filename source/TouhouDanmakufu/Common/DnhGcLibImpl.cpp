@@ -228,6 +228,10 @@ std::wstring ETextureManager::GetReservedRenderTargetName(int index) {
 //*******************************************************************
 //EDirectInput
 //*******************************************************************
+EDirectInput::~EDirectInput() {
+	//The sampler calls back into this object, it has to stop before any part of it is destroyed
+	StopSampling();
+}
 bool EDirectInput::Initialize(HWND hWnd) {
 	padIndex_ = 0;
 
@@ -235,6 +239,10 @@ bool EDirectInput::Initialize(HWND hWnd) {
 
 	ResetVirtualKeyMap();
 
+#if defined(DNH_PROJ_EXECUTOR)
+	StartSampling();
+#endif
+
 	return true;
 }
 void EDirectInput::ResetVirtualKeyMap() {
@@ -82,6 +82,8 @@ public:
 	void AddFpsControlObject(ref_count_weak_ptr<FpsControlObject> obj) { controller_->AddFpsControlObject(obj); }
 	void RemoveFpsControlObject(ref_count_weak_ptr<FpsControlObject> obj) { controller_->RemoveFpsControlObject(obj); }
 
+	FramePacer* GetFramePacer() { return controller_->GetFramePacer(); }
+
 	int16_t GetFastModeKey() { return fastModeKey_; }
 	void SetFastModeKey(int16_t key) { fastModeKey_ = key; }
 };
@@ -189,6 +191,8 @@ public:
 
 	int padIndex_;
 public:
+	~EDirectInput();
+
 	virtual bool Initialize(HWND hWnd);
 
 	void ResetVirtualKeyMap();
@@ -44,6 +44,7 @@ void StgMoveObject::Copy(StgMoveObject* src) {
 
 	relativePosX_ = src->relativePosX_;
 	relativePosY_ = src->relativePosY_;
+	_OnPositionChanged();
 
 	r2aMatX_ = src->r2aMatX_;
 	r2aMatY_ = src->r2aMatY_;
@@ -194,6 +195,7 @@ void StgMoveObject::SetRelativePositionXY(double posX, double posY) {
 		posX_ = posX;
 		posY_ = posY;
 	}
+	_OnPositionChanged();
 }
 void StgMoveObject::SetPositionXY(double posX, double posY) {
 	posX_ = posX;
@@ -208,6 +210,7 @@ void StgMoveObject::SetPositionXY(double posX, double posY) {
 		relativePosX_ = posX;
 		relativePosY_ = posY;
 	}
+	_OnPositionChanged();
 }
 
 //****************************************************************************
@@ -17,6 +17,54 @@ class StgStageInformation;
 class StgSystemInformation;
 class StgMovePattern;
 
+//*******************************************************************
+//StgDataDefinitionCache
+//*******************************************************************
+//Process-wide cache of parsed data definition files (shot data, item data), kept across stages and retries.
+//An entry is only returned while the file's write time (File::GetLastWriteTime) matches the one it was parsed from.
+//Entries must not be modified once added, they are shared by every list that loads the file.
+//Optionally, the lists also keep a binary form of each parsed file under cache/<name>/, keyed by a hash of the source text.
+template<class TEntry>
+class StgDataDefinitionCache {
+	gstd::CriticalSection lock_;
+	std::unordered_map<std::wstring, std::pair<int64_t, shared_ptr<TEntry>>> mapEntry_;
+
+	std::wstring nameDisk_;
+	bool bDisk_;
+public:
+	StgDataDefinitionCache(const std::wstring& nameDisk) : nameDisk_(nameDisk), bDisk_(false) {}
+
+	void SetDiskCacheEnable(bool bEnable) { bDisk_ = bEnable; }
+	bool IsDiskCacheEnable() { return bDisk_; }
+	std::wstring GetDiskCachePath(uint64_t hash) {
+		return gstd::PathProperty::GetModuleDirectory() + gstd::StringUtility::Format(L"cache/%s/%016llx.dat", nameDisk_.c_str(), hash);
+	}
+
+	shared_ptr<TEntry> Get(const std::wstring& path, int64_t timeWrite) {
+		gstd::Lock lock(lock_);
+		auto itrFind = mapEntry_.find(path);
+		if (itrFind != mapEntry_.end() && itrFind->second.first == timeWrite)
+			return itrFind->second.second;
+		return nullptr;
+	}
+	void Add(const std::wstring& path, int64_t timeWrite, shared_ptr<TEntry> entry) {
+		gstd::Lock lock(lock_);
+		mapEntry_[path] = std::make_pair(timeWrite, entry);
+	}
+	void Remove(const std::wstring& path) {
+		gstd::Lock lock(lock_);
+		mapEntry_.erase(path);
+	}
+	void Clear() {
+		gstd::Lock lock(lock_);
+		mapEntry_.clear();
+	}
+	size_t GetCount() {
+		gstd::Lock lock(lock_);
+		return mapEntry_.size();
+	}
+};
+
 //*******************************************************************
 //StgMoveObject
 //*******************************************************************
@@ -50,6 +98,7 @@ protected:
 	std::map<uint32_t, std::list<ref_unsync_ptr<StgMovePattern>>> mapPattern_;
 
 	virtual void _Move();
+	virtual void _OnPositionChanged() {}
 	void _AttachReservedPattern(ref_unsync_ptr<StgMovePattern> pattern);
 public:
 	StgMoveObject(StgStageController* stageController);
@@ -212,10 +212,7 @@ gstd::value StgControlScript::Func_SaveCommonDataAreaA1(gstd::script_machine* ma
 
 		File::CreateFileDirectory(dirSave);
 
-		RecordBuffer record;
-		commonData->WriteRecord(record);
-		res = record.WriteToFile(pathSave, GAME_VERSION_NUM, 
-			ScriptCommonData::HEADER_SAVED_DATA, ScriptCommonData::HEADER_SAVED_DATA_SIZE);
+		res = commonData->WriteToFile(pathSave, GAME_VERSION_NUM);
 	}
 
 	return script->CreateBooleanValue(res);
@@ -233,14 +230,10 @@ gstd::value StgControlScript::Func_LoadCommonDataAreaA1(gstd::script_machine* ma
 	const std::wstring& pathMain = infoSystem->GetMainScriptInformation()->pathScript_;
 	std::wstring pathSave = EPathProperty::GetCommonDataPath(pathMain, area);
 
-	RecordBuffer record;
-	res = record.ReadFromFile(pathSave, GAME_VERSION_NUM, 
-		ScriptCommonData::HEADER_SAVED_DATA, ScriptCommonData::HEADER_SAVED_DATA_SIZE);
-	if (res) {
-		shared_ptr<ScriptCommonData> commonData(new ScriptCommonData());
-		commonData->ReadRecord(record);
+	shared_ptr<ScriptCommonData> commonData(new ScriptCommonData());
+	res = commonData->ReadFromFile(pathSave, GAME_VERSION_NUM);
+	if (res)
 		commonDataManager->SetData(sArea, commonData);
-	}
 
 	return script->CreateBooleanValue(res);
 }
@@ -261,10 +254,7 @@ gstd::value StgControlScript::Func_SaveCommonDataAreaA2(gstd::script_machine* ma
 
 		File::CreateFileDirectory(dirSave);
 
-		RecordBuffer record;
-		commonData->WriteRecord(record);
-		res = record.WriteToFile(pathSave, GAME_VERSION_NUM, 
-			ScriptCommonData::HEADER_SAVED_DATA, ScriptCommonData::HEADER_SAVED_DATA_SIZE);
+		res = commonData->WriteToFile(pathSave, GAME_VERSION_NUM);
 	}
 
 	return script->CreateBooleanValue(res);
@@ -279,14 +269,10 @@ gstd::value StgControlScript::Func_LoadCommonDataAreaA2(gstd::script_machine* ma
 	bool res = false;
 
 	std::wstring pathSave = argv[1].as_string();
-	RecordBuffer record;
-	res = record.ReadFromFile(pathSave, GAME_VERSION_NUM, 
-		ScriptCommonData::HEADER_SAVED_DATA, ScriptCommonData::HEADER_SAVED_DATA_SIZE);
-	if (res) {
-		shared_ptr<ScriptCommonData> commonData(new ScriptCommonData());
-		commonData->ReadRecord(record);
+	shared_ptr<ScriptCommonData> commonData(new ScriptCommonData());
+	res = commonData->ReadFromFile(pathSave, GAME_VERSION_NUM);
+	if (res)
 		commonDataManager->SetData(area, commonData);
-	}
 
 	return script->CreateBooleanValue(res);
 }
@@ -26,14 +26,19 @@ StgEnemyManager::~StgEnemyManager() {
 	FileManager::GetBase()->RemoveLoadThreadListener(this);
 }
 void StgEnemyManager::Work() {
-	for (auto itr = listEnemy_.begin(); itr != listEnemy_.end();) {
+	//In-order compaction, registration order is kept
+	auto itrDst = listEnemy_.begin();
+	for (auto itr = listEnemy_.begin(); itr != listEnemy_.end(); ++itr) {
 		ref_unsync_ptr<StgEnemyObject>& obj = (*itr);
 		if (obj->IsDeleted()) {
 			obj->ClearEnemyObject();
-			itr = listEnemy_.erase(itr);
+			continue;
 		}
-		else ++itr;
+		if (itrDst != itr)
+			*itrDst = std::move(obj);
+		++itrDst;
 	}
+	listEnemy_.erase(itrDst, listEnemy_.end());
 }
 void StgEnemyManager::RegistIntersectionTarget() {
 	for (ref_unsync_ptr<StgEnemyObject>& obj : listEnemy_) {
@@ -19,7 +19,7 @@ private:
 
 	StgStageController* stageController_;
 
-	std::list<ref_unsync_ptr<StgEnemyObject>> listEnemy_;
+	std::vector<ref_unsync_ptr<StgEnemyObject>> listEnemy_;
 
 	ref_unsync_ptr<StgEnemyBossSceneObject> objBossScene_;
 protected:
@@ -44,7 +44,7 @@ public:
 
 	void SetBossSceneObject(ref_unsync_ptr<StgEnemyBossSceneObject> obj);
 	ref_unsync_ptr<StgEnemyBossSceneObject> GetBossSceneObject();
-	std::list<ref_unsync_ptr<StgEnemyObject>>& GetEnemyList() { return listEnemy_; }
+	std::vector<ref_unsync_ptr<StgEnemyObject>>& GetEnemyList() { return listEnemy_; }
 
 	void LoadBossSceneScriptsInThread(std::vector<shared_ptr<StgEnemyBossSceneData>>* listStepData);
 	virtual void CallFromLoadThread(shared_ptr<FileManager::LoadThreadEvent> event);
@@ -125,20 +125,27 @@ void StgIntersectionManager::Work() {
 
 	size_t totalCheck = 0;
 	size_t totalTarget = 0;
+	stdch::steady_clock::duration timeTest = stdch::steady_clock::duration::zero();	//Narrow phase only
 	for (auto itr = listSpace_.begin(); itr != listSpace_.end(); itr++) {
 		StgIntersectionSpace* space = *itr;
 
 		size_t currentCheck = 0;
 		auto listCheck = space->CreateIntersectionCheckList(this, currentCheck);
 
-		for (size_t iCheck = 0; iCheck < currentCheck; iCheck++) {
-			auto& cTargetPair = listCheck->at(iCheck);
+		bool listHit[CHECK_CHUNK];
+		for (size_t iChunk = 0; iChunk < currentCheck; iChunk += CHECK_CHUNK) {
+			size_t countChunk = std::min<size_t>(CHECK_CHUNK, currentCheck - iChunk);
+			auto timeStart = stdch::steady_clock::now();
+			_TestIntersectionChunk(listCheck->data() + iChunk, countChunk, listHit);
+			timeTest += stdch::steady_clock::now() - timeStart;
 
-			StgIntersectionTarget* targetA = cTargetPair.first;
-			StgIntersectionTarget* targetB = cTargetPair.second;
-			if (targetA == nullptr || targetB == nullptr) continue;
+			for (size_t iCheck = 0; iCheck < countChunk; iCheck++) {
+				if (!listHit[iCheck]) continue;
+
+				auto& cTargetPair = listCheck->at(iChunk + iCheck);
+				StgIntersectionTarget* targetA = cTargetPair.first;
+				StgIntersectionTarget* targetB = cTargetPair.second;
 
-			if (IsIntersected(targetA, targetB)) {
 				ref_unsync_weak_ptr<StgIntersectionObject>& ptrA = targetA->GetObject();
 				ref_unsync_weak_ptr<StgIntersectionObject>& ptrB = targetB->GetObject();
 				{
@@ -173,7 +180,8 @@ void StgIntersectionManager::Work() {
 			StringUtility::Format(L"Used=%4d, Cached=%4d, Total=%4d, Check=%4d", countUsed, countCache, countUsed + countCache, totalCheck));
 		*/
 		logger->SetInfo(9, L"Intersection count",
-			StringUtility::Format(L"Total=%4d, Check=%4d", totalTarget, totalCheck));
+			StringUtility::Format(L"Total=%4d, Check=%4d, Test=%.3fms", totalTarget, totalCheck,
+				stdch::duration<double, std::milli>(timeTest).count()));
 	}
 }
 void StgIntersectionManager::RenderVisualizer() {
@@ -287,6 +295,88 @@ void StgIntersectionManager::AddEnemyTargetToPlayer(ref_unsync_ptr<StgIntersecti
 	}
 }
 
+void StgIntersectionManager::_TestIntersectionChunk(const std::pair<StgIntersectionTarget*, StgIntersectionTarget*>* listPair,
+	size_t count, bool* res)
+{
+	//Circle-circle and circle-line pairs are gathered and tested together, line-line pairs are tested right away.
+	//The shape tag is set by the target's constructor, so the downcasts below don't need to be checked.
+	float listCircle1[3][CHECK_CHUNK];
+	float listCircle2[3][CHECK_CHUNK];
+	size_t listIndexCircle[CHECK_CHUNK];
+	size_t countCircle = 0;
+
+	float listCircle3[3][CHECK_CHUNK];
+	float listLine[5][CHECK_CHUNK];
+	size_t listIndexLine[CHECK_CHUNK];
+	size_t countLine = 0;
+
+	auto _AddCircle = [](float(&dest)[3][CHECK_CHUNK], size_t index, const DxCircle& circle) {
+		dest[0][index] = circle.GetX();
+		dest[1][index] = circle.GetY();
+		dest[2][index] = circle.GetR();
+	};
+
+	for (size_t i = 0; i < count; ++i) {
+		res[i] = false;
+
+		StgIntersectionTarget* p1 = listPair[i].first;
+		StgIntersectionTarget* p2 = listPair[i].second;
+		if (p1 == nullptr || p2 == nullptr) continue;
+
+		StgIntersectionTarget::Shape shape1 = p1->GetShape();
+		StgIntersectionTarget::Shape shape2 = p2->GetShape();
+		if (shape1 == StgIntersectionTarget::SHAPE_CIRCLE && shape2 == StgIntersectionTarget::SHAPE_CIRCLE) {
+			_AddCircle(listCircle1, countCircle, static_cast<StgIntersectionTarget_Circle*>(p1)->circle_);
+			_AddCircle(listCircle2, countCircle, static_cast<StgIntersectionTarget_Circle*>(p2)->circle_);
+			listIndexCircle[countCircle++] = i;
+		}
+		else if (shape1 == StgIntersectionTarget::SHAPE_LINE && shape2 == StgIntersectionTarget::SHAPE_LINE) {
+			res[i] = DxIntersect::LineW_LineW(&static_cast<StgIntersectionTarget_Line*>(p1)->line_,
+				&static_cast<StgIntersectionTarget_Line*>(p2)->line_);
+		}
+		else {
+			if (shape1 == StgIntersectionTarget::SHAPE_LINE)
+				std::swap(p1, p2);
+
+			const DxWidthLine& line = static_cast<StgIntersectionTarget_Line*>(p2)->line_;
+			_AddCircle(listCircle3, countLine, static_cast<StgIntersectionTarget_Circle*>(p1)->circle_);
+			listLine[0][countLine] = line.GetX1();
+			listLine[1][countLine] = line.GetY1();
+			listLine[2][countLine] = line.GetX2();
+			listLine[3][countLine] = line.GetY2();
+			listLine[4][countLine] = line.GetWidth();
+			listIndexLine[countLine++] = i;
+		}
+	}
+
+	bool listRes[CHECK_CHUNK];
+	if (countCircle > 0) {
+		DxIntersect::Circle_Circle_Batch(countCircle,
+			DxIntersect::CircleArray{ listCircle1[0], listCircle1[1], listCircle1[2], 1 },
+			DxIntersect::CircleArray{ listCircle2[0], listCircle2[1], listCircle2[2], 1 }, listRes);
+		for (size_t i = 0; i < countCircle; ++i)
+			res[listIndexCircle[i]] = listRes[i];
+	}
+	if (countLine > 0) {
+		DxIntersect::Circle_LineW_Batch(countLine,
+			DxIntersect::CircleArray{ listCircle3[0], listCircle3[1], listCircle3[2], 1 },
+			DxIntersect::WidthLineArray{ listLine[0], listLine[1], listLine[2], listLine[3], listLine[4], 1 }, listRes);
+		for (size_t i = 0; i < countLine; ++i)
+			res[listIndexLine[i]] = listRes[i];
+	}
+
+#ifdef _DEBUG
+	//Debug builds check every batched result against the one-pair routines
+	for (size_t i = 0; i < count; ++i) {
+		bool bExpect = IsIntersected(listPair[i].first, listPair[i].second);
+		if (res[i] != bExpect) {
+			Logger::WriteTop(StringUtility::Format(L"StgIntersectionManager: Batched test mismatch "
+				"(shapes %d/%d, batched=%d, expected=%d)",
+				(int)listPair[i].first->GetShape(), (int)listPair[i].second->GetShape(), (int)res[i], (int)bExpect));
+		}
+	}
+#endif
+}
 bool StgIntersectionManager::IsIntersected(StgIntersectionTarget* p1, StgIntersectionTarget* p2) {
 	if (p1 != nullptr && p2 != nullptr) {
 		StgIntersectionTarget::Shape shape1 = p1->GetShape();
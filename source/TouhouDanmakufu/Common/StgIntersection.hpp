@@ -107,6 +107,10 @@ private:
 		SPACE_PLAYERSHOT_ENEMY,
 		SPACE_PLAYERSHOT_ENEMYSHOT,
 	};
+	enum : size_t {
+		//Check pairs are narrow-phase tested in chunks of this size using stack buffers
+		CHECK_CHUNK = 128,
+	};
 	
 	std::vector<StgIntersectionSpace*> listSpace_;
 	std::vector<StgIntersectionTargetPoint> listEnemyTargetPoint_;
@@ -123,6 +127,9 @@ private:
 	shared_ptr<Shader> shaderVisualizerLine_;
 
 	CriticalSection lock_;
+private:
+	static void _TestIntersectionChunk(const std::pair<StgIntersectionTarget*, StgIntersectionTarget*>* listPair,
+		size_t count, bool* res);
 public:
 	StgIntersectionManager();
 	virtual ~StgIntersectionManager();
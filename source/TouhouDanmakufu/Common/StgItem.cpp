@@ -44,6 +44,7 @@ StgItemManager::StgItemManager(StgStageController* stageController) {
 	{
 		RenderShaderLibrary* shaderManager_ = ShaderManager::GetBase()->GetRenderLib();
 		effectItem_ = shaderManager_->GetRender2DShader();
+		bindingItem_ = shaderManager_->GetRender2DBinding();
 	}
 	{
 		size_t renderPriMax = stageController_->GetMainObjectManager()->GetRenderBucketCapacity();
@@ -66,14 +67,11 @@ void StgItemManager::Work() {
 	int pr = objPlayer->GetItemIntersectionRadius() * objPlayer->GetItemIntersectionRadius();
 	int pAutoItemCollectY = objPlayer->GetAutoItemCollectY();
 
-	for (auto itr = listObj_.begin(); itr != listObj_.end();) {
-		ref_unsync_ptr<StgItemObject>& obj = *itr;
+	//Item events may run scripts that add items, so iterate by index and hold a reference to each item
+	for (size_t iObj = 0; iObj < listObj_.size(); ++iObj) {
+		ref_unsync_ptr<StgItemObject> obj = listObj_[iObj];
 
-		if (obj->IsDeleted()) {
-			//obj->Clear();
-			itr = listObj_.erase(itr);
-		}
-		else {
+		if (!obj->IsDeleted()) {
 			float ix = obj->GetPositionX();
 			float iy = obj->GetPositionY();
 
@@ -145,10 +143,14 @@ lab_move_to_player:
 			}
 
 lab_next_item:
-			++itr;
+			;
 		}
 	}
 
+	//In-order compaction, deleted items (including those deleted above) are dropped
+	listObj_.erase(std::remove_if(listObj_.begin(), listObj_.end(),
+		[](const ref_unsync_ptr<StgItemObject>& obj) { return obj->IsDeleted(); }), listObj_.end());
+
 	listCircleToPlayer_.clear();
 
 	bAllItemToPlayer_ = false;
@@ -182,7 +184,7 @@ void StgItemManager::Render(int targetPriority) {
 	graphics->SetTextureFilter(filterMin_, filterMag_, D3DTEXF_NONE);
 
 	DWORD bEnableFog = FALSE;
-	device->GetRenderState(D3DRS_FOGENABLE, &bEnableFog);
+	bEnableFog = graphics->IsFogEnable();
 	if (bEnableFog)
 		graphics->SetFogEnable(false);
 
@@ -207,13 +209,11 @@ void StgItemManager::Render(int targetPriority) {
 		listSpriteItem_->ClearVertexCount();
 	}
 
-	device->SetFVF(VERTEX_TLX::fvf);
-	device->SetVertexDeclaration(shaderManager->GetVertexDeclarationTLX());
+	graphics->SetFVF(VERTEX_TLX::fvf);
+	graphics->SetVertexDeclaration(shaderManager->GetVertexDeclarationTLX());
 	pLastTexture_ = nullptr;
 
-	if (D3DXHANDLE handle = effectItem_->GetParameterBySemantic(nullptr, "VIEWPROJECTION")) {
-		effectItem_->SetMatrix(handle, &matProj_);
-	}
+	bindingItem_->SetMatrix(ShaderSemantic::ViewProjection, matProj_);
 
 	for (size_t iBlend = 0; iBlend < blendTypeRenderOrder.size(); ++iBlend) {
 		BlendMode blend = blendTypeRenderOrder[iBlend];
@@ -229,8 +229,8 @@ void StgItemManager::Render(int targetPriority) {
 
 	device->SetVertexShader(nullptr);
 	device->SetPixelShader(nullptr);
-	device->SetVertexDeclaration(nullptr);
-	device->SetIndices(nullptr);
+	graphics->SetVertexDeclaration(nullptr);
+	graphics->SetIndices(nullptr);
 
 	if (bEnableFog)
 		graphics->SetFogEnable(true);
@@ -309,74 +309,76 @@ std::vector<int> StgItemManager::GetItemIdInCircle(int cx, int cy, int radius, i
 //*******************************************************************
 //StgItemDataList
 //*******************************************************************
+StgItemDataList::CompiledCache StgItemDataList::cacheCompiled_(L"itemdata");
 StgItemDataList::StgItemDataList() {
 }
 StgItemDataList::~StgItemDataList() {
 }
+std::vector<VERTEX_TLX> StgItemDataList::_BuildVertices(const std::vector<StgItemData*>& listData, float texW, float texH) {
+	std::vector<VERTEX_TLX> res;
+
+	for (StgItemData* data : listData) {
+		for (StgItemDataFrame& iFrame : data->listFrame_) {
+			LONG* ptrSrc = reinterpret_cast<LONG*>(&iFrame.rcSrc_);
+			float* ptrDst = reinterpret_cast<float*>(&iFrame.rcDst_);
+
+			for (size_t iVert = 0; iVert < 4; ++iVert) {
+				VERTEX_TLX vert;
+
+				//((iVert & 1) << 1)
+				//   0 -> 0
+				//   1 -> 2
+				//   2 -> 0
+				//   3 -> 2
+				//(iVert | 1)
+				//   0 -> 1
+				//   1 -> 1
+				//   2 -> 3
+				//   3 -> 3
+
+				StgShotObject::_SetVertexUV(&vert,
+					ptrSrc[(iVert & 1) << 1] / texW, ptrSrc[iVert | 1] / texH);
+				StgShotObject::_SetVertexPosition(&vert, ptrDst[(iVert & 1) << 1], ptrDst[iVert | 1], 0);
+				StgShotObject::_SetVertexColorARGB(&vert, 0xffffffff);
+
+				res.push_back(vert);
+			}
+		}
+	}
+
+	return res;
+}
 void StgItemDataList::_LoadVertexBuffers(std::map<std::wstring, VBContainerList>::iterator placement,
-	shared_ptr<Texture> texture, std::vector<StgItemData*>& listAddData)
+	shared_ptr<Texture> texture, std::vector<StgItemData*>& listAddData, const std::vector<VERTEX_TLX>& listVertex)
 {
-	DirectGraphics* graphics = DirectGraphics::GetBase();
-	IDirect3DDevice9* device = graphics->GetDevice();
-
-	float texW = texture->GetWidth();
-	float texH = texture->GetHeight();
+	size_t countFrame = listVertex.size() / 4U;
 
-	size_t countFrame = 0;
-	for (StgItemData* iData : listAddData)
-		countFrame += iData->GetFrameCount();
+	auto itrData = listAddData.begin();
+	size_t iAnim = 0;
 
-	size_t iBuffer = 0;
-	while (countFrame > 0) {
-		size_t thisCountFrame = std::min<size_t>(countFrame, StgShotVertexBufferContainer::MAX_DATA);
+	size_t iFrame = 0;
+	while (iFrame < countFrame) {
+		size_t thisCountFrame = std::min<size_t>(countFrame - iFrame, StgShotVertexBufferContainer::MAX_DATA);
 
 		placement->second.push_back(unique_ptr<StgShotVertexBufferContainer>(
 			new StgShotVertexBufferContainer()));
 		StgShotVertexBufferContainer* pVertexBufferContainer = placement->second.back().get();
 		pVertexBufferContainer->SetTexture(texture);
 
-		std::vector<VERTEX_TLX> bufferVertex(4 * thisCountFrame);
-		size_t iVertex = 0;
-
-		VERTEX_TLX verts[4];
-		for (size_t iData = 0; iData < listAddData.size(); ++iData) {
-			StgItemData* data = listAddData[iData];
-			for (size_t iAnim = 0; iAnim < data->GetFrameCount(); ++iAnim) {
-				StgItemDataFrame* pFrame = &data->listFrame_[iAnim];
-				pFrame->listItemData_ = this;
-
-				LONG* ptrSrc = reinterpret_cast<LONG*>(&pFrame->rcSrc_);
-				float* ptrDst = reinterpret_cast<float*>(&pFrame->rcDst_);
-
-				for (size_t iVert = 0; iVert < 4; ++iVert) {
-					VERTEX_TLX* pv = &verts[iVert];
-
-					//((iVert & 1) << 1)
-					//   0 -> 0
-					//   1 -> 2
-					//   2 -> 0
-					//   3 -> 2
-					//(iVert | 1)
-					//   0 -> 1
-					//   1 -> 1
-					//   2 -> 3
-					//   3 -> 3
-
-					StgShotObject::_SetVertexUV(pv,
-						ptrSrc[(iVert & 1) << 1] / texW, ptrSrc[iVert | 1] / texH);
-					StgShotObject::_SetVertexPosition(pv, ptrDst[(iVert & 1) << 1], ptrDst[iVert | 1], 0);
-					StgShotObject::_SetVertexColorARGB(pv, 0xffffffff);
-				}
-
-				pFrame->pVertexBuffer_ = pVertexBufferContainer;
-				pFrame->vertexOffset_ = iVertex;
-
-				for (size_t j = 0; j < 4; ++j)
-					bufferVertex[iVertex + j] = verts[j];
-				iVertex += 4;
+		for (size_t i = 0; i < thisCountFrame; ++i) {
+			while (iAnim >= (*itrData)->GetFrameCount()) {
+				++itrData;
+				iAnim = 0;
 			}
+
+			StgItemDataFrame* pFrame = &(*itrData)->listFrame_[iAnim++];
+			pFrame->listItemData_ = this;
+			pFrame->pVertexBuffer_ = pVertexBufferContainer;
+			pFrame->vertexOffset_ = i * 4;
 		}
 
+		std::vector<VERTEX_TLX> bufferVertex(listVertex.begin() + iFrame * 4,
+			listVertex.begin() + (iFrame + thisCountFrame) * 4);
 		HRESULT hr = pVertexBufferContainer->LoadData(bufferVertex, thisCountFrame);
 		if (FAILED(hr)) {
 			std::wstring err = StringUtility::Format(L"AddItemDataList::Failed to load shot data buffer: "
@@ -385,28 +387,14 @@ void StgItemDataList::_LoadVertexBuffers(std::map<std::wstring, VBContainerList>
 			throw gstd::wexception(err);
 		}
 
-		++iBuffer;
-		countFrame -= thisCountFrame;
+		iFrame += thisCountFrame;
 	}
 }
-bool StgItemDataList::AddItemDataList(const std::wstring& path, bool bReload) {
-	auto itrVB = mapVertexBuffer_.find(path);
-	if (!bReload && itrVB != mapVertexBuffer_.end()) return true;
+shared_ptr<StgItemDataList::CompiledFile> StgItemDataList::_CompileFile(const std::string& source) {
+	shared_ptr<CompiledFile> res = std::make_shared<CompiledFile>();
 
-	std::wstring pathReduce = PathProperty::ReduceModuleDirectory(path);
-
-	shared_ptr<FileReader> reader = FileManager::GetBase()->GetFileReader(path);
-	if (reader == nullptr || !reader->Open()) 
-		throw gstd::wexception(L"AddItemDataList: " + ErrorUtility::GetFileNotFoundErrorMessage(pathReduce, true));
-
-	std::string source = reader->ReadAllString();
-
-	bool res = false;
 	Scanner scanner(source);
 	try {
-		std::map<int, unique_ptr<StgItemData>> mapData;
-		std::wstring pathImage = L"";
-
 		while (scanner.HasNext()) {
 			Token& tok = scanner.Next();
 			if (tok.GetType() == Token::Type::TK_EOF)
@@ -414,18 +402,188 @@ bool StgItemDataList::AddItemDataList(const std::wstring& path, bool bReload) {
 			else if (tok.GetType() == Token::Type::TK_ID) {
 				std::wstring element = tok.GetElement();
 				if (element == L"ItemData") {
-					_ScanItem(mapData, scanner);
+					_ScanItem(res->mapData, scanner);
 				}
 				else if (element == L"item_image") {
 					scanner.CheckType(scanner.Next(), Token::Type::TK_EQUAL);
-					pathImage = scanner.Next().GetString();
+					res->pathImage = scanner.Next().GetString();
 				}
 
 				if (scanner.HasNext())
 					tok = scanner.Next();
 			}
 		}
+	}
+	catch (gstd::wexception& e) {
+		throw gstd::wexception(StringUtility::Format(L"[Line=%d] (%s)", scanner.GetCurrentLine(), e.what()));
+	}
+	catch (...) {
+		throw gstd::wexception(StringUtility::Format(L"[Line=%d] (Unknown error.)", scanner.GetCurrentLine()));
+	}
+
+	return res;
+}
+StgItemData* StgItemDataList::_CopyData(const StgItemData* src) {
+	StgItemData* res = new StgItemData(this);
+	res->typeItem_ = src->typeItem_;
+	res->typeRender_ = src->typeRender_;
+	res->alpha_ = src->alpha_;
+	res->listFrame_ = src->listFrame_;
+	res->totalFrame_ = src->totalFrame_;
+	for (auto& iFrame : res->listFrame_) {
+		iFrame.listItemData_ = this;
+		iFrame.pVertexBuffer_ = nullptr;
+	}
+	if (src->dataOut_)
+		res->dataOut_.reset(_CopyData(src->dataOut_.get()));
+	return res;
+}
+//Binary cache layout:
+//	uint32 version
+//	uint32 image path length, wchar_t[] image path
+//	uint32 data count, { int32 id, data }[]
+//		data: int32 item type, int32 render, int32 alpha, uint32 total frame,
+//			uint32 frame count, { DxRect<LONG> source, DxRect<float> dest, uint32 frame }[],
+//			bool has out data, [data]
+shared_ptr<StgItemDataList::CompiledFile> StgItemDataList::_ReadDiskCache(const std::wstring& pathCache) {
+	File file(pathCache);
+	if (!file.Open()) return nullptr;
+
+	auto _Read = [&](void* dst, size_t size) -> bool {
+		return file.Read(dst, size) == size;
+	};
+	std::function<bool(StgItemData*)> _ReadData = [&](StgItemData* data) -> bool {
+		int32_t values[3];
+		uint32_t totalFrame = 0;
+		if (!_Read(values, sizeof(values))) return false;
+		if (!_Read(&totalFrame, sizeof(uint32_t))) return false;
+		data->typeItem_ = values[0];
+		data->typeRender_ = (BlendMode)values[1];
+		data->alpha_ = values[2];
+		data->totalFrame_ = totalFrame;
+
+		uint32_t countFrame = 0;
+		if (!_Read(&countFrame, sizeof(uint32_t)) || countFrame > file.GetSize()) return false;
+		data->listFrame_.resize(countFrame);
+		for (StgItemDataFrame& frame : data->listFrame_) {
+			uint32_t frameTime = 0;
+			if (!_Read(&frame.rcSrc_, sizeof(DxRect<LONG>))) return false;
+			if (!_Read(&frame.rcDst_, sizeof(DxRect<float>))) return false;
+			if (!_Read(&frameTime, sizeof(uint32_t))) return false;
+			frame.listItemData_ = this;
+			frame.frame_ = frameTime;
+		}
 
+		bool bOut = false;
+		if (!_Read(&bOut, sizeof(bool))) return false;
+		if (bOut) {
+			data->dataOut_.reset(new StgItemData(this));
+			if (!_ReadData(data->dataOut_.get())) return false;
+		}
+		return true;
+	};
+
+	shared_ptr<CompiledFile> res = std::make_shared<CompiledFile>();
+	bool bValid = [&]() -> bool {
+		uint32_t version = 0;
+		if (!_Read(&version, sizeof(uint32_t)) || version != DISK_CACHE_VERSION) return false;
+
+		uint32_t lengthPath = 0;
+		if (!_Read(&lengthPath, sizeof(uint32_t)) || lengthPath > file.GetSize()) return false;
+		res->pathImage.resize(lengthPath);
+		if (!_Read(res->pathImage.data(), lengthPath * sizeof(wchar_t))) return false;
+
+		uint32_t countData = 0;
+		if (!_Read(&countData, sizeof(uint32_t))) return false;
+		for (uint32_t iData = 0; iData < countData; ++iData) {
+			int32_t id = 0;
+			if (!_Read(&id, sizeof(int32_t)) || id < 0) return false;
+
+			StgItemData* data = new StgItemData(this);
+			res->mapData[id].reset(data);
+			if (!_ReadData(data)) return false;
+		}
+		return file.GetFilePointer() == file.GetSize();
+	}();
+
+	return bValid ? res : nullptr;
+}
+void StgItemDataList::_WriteDiskCache(const std::wstring& pathCache, const CompiledFile* compiled) {
+	//The same file may be loaded on several threads
+	File::WriteAtomic(pathCache, [&](File& file) {
+		std::function<void(const StgItemData*)> _WriteData = [&](const StgItemData* data) {
+			file.WriteValue<int32_t>(data->typeItem_);
+			file.WriteValue<int32_t>(data->typeRender_);
+			file.WriteValue<int32_t>(data->alpha_);
+			file.WriteValue<uint32_t>(data->totalFrame_);
+
+			file.WriteValue<uint32_t>(data->listFrame_.size());
+			for (const StgItemDataFrame& frame : data->listFrame_) {
+				file.WriteValue(frame.rcSrc_);
+				file.WriteValue(frame.rcDst_);
+				file.WriteValue<uint32_t>(frame.frame_);
+			}
+
+			file.WriteValue<bool>(data->dataOut_ != nullptr);
+			if (data->dataOut_)
+				_WriteData(data->dataOut_.get());
+		};
+
+		file.WriteValue<uint32_t>(DISK_CACHE_VERSION);
+
+		file.WriteValue<uint32_t>(compiled->pathImage.size());
+		if (compiled->pathImage.size() > 0)
+			file.Write((LPVOID)compiled->pathImage.data(), compiled->pathImage.size() * sizeof(wchar_t));
+
+		file.WriteValue<uint32_t>(compiled->mapData.size());
+		for (auto& [id, data] : compiled->mapData) {
+			file.WriteValue<int32_t>(id);
+			_WriteData(data.get());
+		}
+		return true;
+	});
+}
+bool StgItemDataList::AddItemDataList(const std::wstring& path, bool bReload) {
+	auto itrVB = mapVertexBuffer_.find(path);
+	if (!bReload && itrVB != mapVertexBuffer_.end()) return true;
+
+	std::wstring pathReduce = PathProperty::ReduceModuleDirectory(path);
+
+	int64_t timeWrite = File::GetLastWriteTime(path);
+	if (bReload)
+		cacheCompiled_.Remove(path);
+
+	shared_ptr<CompiledFile> compiled = cacheCompiled_.Get(path, timeWrite);
+	bool bCached = compiled != nullptr;
+
+	std::string source;
+	if (!bCached) {
+		shared_ptr<FileReader> reader = FileManager::GetBase()->GetFileReader(path);
+		if (reader == nullptr || !reader->Open()) 
+			throw gstd::wexception(L"AddItemDataList: " + ErrorUtility::GetFileNotFoundErrorMessage(pathReduce, true));
+
+		source = reader->ReadAllString();
+	}
+
+	bool res = false;
+	bool bDiskCached = false;
+	try {
+		if (!bCached) {
+			std::wstring pathDisk;
+			if (cacheCompiled_.IsDiskCacheEnable() && !bReload) {
+				pathDisk = cacheCompiled_.GetDiskCachePath(Hash::Fnv1a(source.data(), source.size()));
+
+				compiled = _ReadDiskCache(pathDisk);
+				bDiskCached = compiled != nullptr;
+			}
+			if (!bDiskCached) {
+				compiled = _CompileFile(source);
+				if (pathDisk.size() > 0)
+					_WriteDiskCache(pathDisk, compiled.get());
+			}
+		}
+
+		std::wstring pathImage = compiled->pathImage;
 		if (pathImage.size() == 0) throw gstd::wexception("Item texture must be set.");
 		std::wstring dir = PathProperty::GetFileDirectory(path);
 		pathImage = StringUtility::Replace(pathImage, L"./", dir);
@@ -446,56 +604,56 @@ bool StgItemDataList::AddItemDataList(const std::wstring& path, bool bReload) {
 		}
 
 		std::vector<StgItemData*> listAddData;
+		for (auto itr = compiled->mapData.begin(); itr != compiled->mapData.end(); ++itr) {
+			int id = itr->first;
+			StgItemData* data = _CopyData(itr->second.get());
+
+			listAddData.push_back(data);
+			if (listData_.size() <= id)
+				listData_.resize(id + 1);
+			listData_[id].reset(data);
+
+			//Item data has an out frame
+			if (StgItemData* dataOut = data->dataOut_.get())
+				listAddData.push_back(dataOut);
+		}
 
-		size_t countFrame = 0;
-		{
-			size_t i = 0;
-			for (auto itr = mapData.begin(); itr != mapData.end(); ++itr, ++i) {
-				int id = itr->first;
-				unique_ptr<StgItemData>& data = itr->second;
-				if (data == nullptr) continue;
-
-				for (auto& iFrame : data->listFrame_)
-					iFrame.listItemData_ = this;
-				countFrame += data->GetFrameCount();
-
-				listAddData.push_back(data.get());
-				if (listData_.size() <= id)
-					listData_.resize(id + 1);
-				listData_[id] = std::move(data);		//Moves unique_ptr object, do not use mapData after this point
-
-				if (unique_ptr<StgItemData>& dataOut = listData_[id]->dataOut_) {
-					//Item data has an out frame
-					
-					dataOut->listFrame_[0].listItemData_ = this;
-					++countFrame;
-
-					listAddData.push_back(dataOut.get());
-				}
-			}
+		float texW = texture->GetWidth();
+		float texH = texture->GetHeight();
+
+		//The vertices only depend on the frame rects and the texture size
+		const std::vector<VERTEX_TLX>* pListVertex = &compiled->listVertex;
+		std::vector<VERTEX_TLX> listVertexRebuild;
+		if (!bCached) {
+			compiled->textureWidth = texW;
+			compiled->textureHeight = texH;
+			compiled->listVertex = _BuildVertices(listAddData, texW, texH);
+			cacheCompiled_.Add(path, timeWrite, compiled);
+		}
+		else if (compiled->textureWidth != texW || compiled->textureHeight != texH) {
+			listVertexRebuild = _BuildVertices(listAddData, texW, texH);
+			pListVertex = &listVertexRebuild;
 		}
 
-		if (itrVB != mapVertexBuffer_.end()) {
+		if (itrVB != mapVertexBuffer_.end())
 			itrVB->second.clear();
-			_LoadVertexBuffers(itrVB, texture, listAddData);
-		}
-		else {
+		else
 			itrVB = mapVertexBuffer_.insert({ path, VBContainerList() }).first;
-			_LoadVertexBuffers(itrVB, texture, listAddData);
-		}
+		_LoadVertexBuffers(itrVB, texture, listAddData, *pListVertex);
 
-		Logger::WriteTop(StringUtility::Format(L"Loaded item data: %s", pathReduce.c_str()));
+		Logger::WriteTop(StringUtility::Format(L"Loaded item data%s: %s", 
+			bCached ? L" (cached)" : (bDiskCached ? L" (disk cache)" : L""), pathReduce.c_str()));
 		res = true;
 	}
 	catch (gstd::wexception& e) {
-		std::wstring log = StringUtility::Format(L"Failed to load item data: %s\r\n\t[Line=%d] (%s)",
-			pathReduce.c_str(), scanner.GetCurrentLine(), e.what());
+		std::wstring log = StringUtility::Format(L"Failed to load item data: %s\r\n\t%s",
+			pathReduce.c_str(), e.what());
 		Logger::WriteTop(log);
 		res = false;
 	}
 	catch (...) {
-		std::wstring log = StringUtility::Format(L"Failed to load item data: %s\r\n\t[Line=%d] (Unknown error.)",
-			pathReduce.c_str(), scanner.GetCurrentLine());
+		std::wstring log = StringUtility::Format(L"Failed to load item data: %s\r\n\t(Unknown error.)",
+			pathReduce.c_str());
 		Logger::WriteTop(log);
 		res = false;
 	}
@@ -1210,40 +1368,38 @@ void StgItemObject_User::Render(BlendMode targetBlend) {
 
 				IDirect3DTexture9* pTexture = pVB->GetD3DTexture();
 				if (pTexture != itemManager->pLastTexture_) {
-					device->SetTexture(0, pTexture);
+					graphics->SetTexture(0, pTexture);
 					itemManager->pLastTexture_ = pTexture;
 				}
-				device->SetStreamSource(0, pVB->GetD3DBuffer(), vertexOffset * sizeof(VERTEX_TLX), sizeof(VERTEX_TLX));
+				graphics->SetStreamSource(0, pVB->GetD3DBuffer(), vertexOffset * sizeof(VERTEX_TLX), sizeof(VERTEX_TLX));
 
 				{
 					ID3DXEffect* effect = itemManager->GetEffect();
+					ShaderSemanticBinding* binding = itemManager->GetBinding();
 					if (shader_) {
 						effect = shader_->GetEffect();
+						binding = shader_->GetBinding();
 						if (shader_->LoadTechnique()) {
 							shader_->LoadParameter();
 						}
 					}
 
 					if (effect) {
-						D3DXHANDLE handle = nullptr;
-						if (handle = effect->GetParameterBySemantic(nullptr, "WORLD")) {
+						if (binding->IsBound(ShaderSemantic::World)) {
 							D3DXMATRIX matTransform(
 								rScale.x * rAngle.x, rScale.x * rAngle.y, 0, 0,
 								rScale.y * -rAngle.y, rScale.y * rAngle.x, 0, 0,
 								0, 0, 1, 0,
 								rPos.x, rPos.y, 0, 1
 							);
-							effect->SetMatrix(handle, &matTransform);
-						}
-						if (shader_) {
-							if (handle = effect->GetParameterBySemantic(nullptr, "VIEWPROJECTION")) {
-								effect->SetMatrix(handle, itemManager->GetProjectionMatrix());
-							}
+							binding->SetMatrix(ShaderSemantic::World, matTransform);
 						}
-						if (handle = effect->GetParameterBySemantic(nullptr, "ICOLOR")) {
+						if (shader_)
+							binding->SetMatrix(ShaderSemantic::ViewProjection, *itemManager->GetProjectionMatrix());
+						if (binding->IsBound(ShaderSemantic::IColor)) {
 							//To normalized RGBA vector
 							D3DXVECTOR4 vColor = ColorAccess::ToVec4Normalized(rColor, ColorAccess::PERMUTE_RGBA);
-							effect->SetVector(handle, &vColor);
+							binding->SetVector(ShaderSemantic::IColor, vColor);
 						}
 
 						UINT countPass = 1;
@@ -1254,6 +1410,7 @@ void StgItemObject_User::Render(BlendMode targetBlend) {
 							effect->EndPass();
 						}
 						effect->End();
+						graphics->NotifyEffectStateChange();
 					}
 				}
 			}
@@ -37,7 +37,7 @@ protected:
 
 	unique_ptr<StgItemDataList> listItemData_;
 
-	std::list<ref_unsync_ptr<StgItemObject>> listObj_;
+	std::vector<ref_unsync_ptr<StgItemObject>> listObj_;
 	std::vector<RenderQueue> listRenderQueue_;		//one for each render pri
 
 	std::list<DxCircle> listCircleToPlayer_;
@@ -52,6 +52,7 @@ protected:
 	bool bDefaultBonusItemEnable_;
 
 	ID3DXEffect* effectItem_;
+	ShaderSemanticBinding* bindingItem_;
 	D3DXMATRIX matProj_;
 public:
 	IDirect3DTexture9* pLastTexture_;
@@ -69,6 +70,7 @@ public:
 	size_t GetItemCount() { return listObj_.size(); }
 
 	ID3DXEffect* GetEffect() { return effectItem_; }
+	ShaderSemanticBinding* GetBinding() { return bindingItem_; }
 	D3DXMATRIX* GetProjectionMatrix() { return &matProj_; }
 
 	SpriteList2D* GetItemRenderer() { return listSpriteItem_.get(); }
@@ -105,22 +107,48 @@ class StgItemDataList {
 public:
 	//Repurpose StgShotVertexBufferContainer for this, since it'd have been the same code anyway
 	using VBContainerList = std::list<unique_ptr<StgShotVertexBufferContainer>>;
+
+	enum {
+		DISK_CACHE_VERSION = 1,
+	};
+
+	//Parsed contents of an item data file
+	struct CompiledFile {
+		std::wstring pathImage;
+		std::map<int, unique_ptr<StgItemData>> mapData;		//Prototypes, copied into each list
+
+		float textureWidth;
+		float textureHeight;
+		std::vector<VERTEX_TLX> listVertex;		//4 per frame, in the order of the list passed to _LoadVertexBuffers
+	};
+	using CompiledCache = StgDataDefinitionCache<CompiledFile>;
 private:
+	static CompiledCache cacheCompiled_;
+
 	std::map<std::wstring, VBContainerList> mapVertexBuffer_;	//<shot data file, vb list>
 	std::vector<unique_ptr<StgItemData>> listData_;
 
+	shared_ptr<CompiledFile> _CompileFile(const std::string& source);
+	shared_ptr<CompiledFile> _ReadDiskCache(const std::wstring& pathCache);
+	static void _WriteDiskCache(const std::wstring& pathCache, const CompiledFile* compiled);
 	void _ScanItem(std::map<int, unique_ptr<StgItemData>>& mapData, Scanner& scanner);
 	static void _ScanAnimation(StgItemData* itemData, Scanner& scanner);
 
+	StgItemData* _CopyData(const StgItemData* src);
+
+	static std::vector<VERTEX_TLX> _BuildVertices(const std::vector<StgItemData*>& listData, float texW, float texH);
 	void _LoadVertexBuffers(std::map<std::wstring, VBContainerList>::iterator placement,
-		shared_ptr<Texture> texture, std::vector<StgItemData*>& listAddData);
+		shared_ptr<Texture> texture, std::vector<StgItemData*>& listAddData, const std::vector<VERTEX_TLX>& listVertex);
 public:
 	StgItemDataList();
 	virtual ~StgItemDataList();
 
 	StgItemData* GetData(int id) { return (id >= 0 && id < listData_.size()) ? listData_[id].get() : nullptr; }
 
+	//Reuses the parsed file from the process-wide cache unless the file has changed, bReload always reparses
 	bool AddItemDataList(const std::wstring& path, bool bReload);
+
+	static CompiledCache* GetCompiledCache() { return &cacheCompiled_; }
 };
 
 //*******************************************************************
@@ -335,6 +335,7 @@ gstd::value StgPackageScript::Func_PauseStageScene(gstd::script_machine* machine
 			stageScriptManager->RequestEventAll(StgStageScript::EV_PAUSE_LEAVE);
 
 		infoStage->SetPause(bPause);
+		DirectSoundManager::GetBase()->SetSoundEffectPause(bPause);
 	}
 	return value();
 }
@@ -17,12 +17,17 @@ StgShotManager::StgShotManager(StgStageController* stageController) {
 
 	rcDeleteClip_ = DxRect<LONG>(-64, -64, 64, 64);
 
+	spatialIndex_.bValid = false;
+	spatialIndex_.stamp = 0;
+	spatialIndex_.countIndexed = 0;
+
 	filterMin_ = D3DTEXF_LINEAR;
 	filterMag_ = D3DTEXF_LINEAR;
 
 	{
 		RenderShaderLibrary* shaderManager_ = ShaderManager::GetBase()->GetRenderLib();
 		effectShot_ = shaderManager_->GetRender2DShader();
+		bindingShot_ = shaderManager_->GetRender2DBinding();
 	}
 	{
 		size_t renderPriMax = stageController_->GetMainObjectManager()->GetRenderBucketCapacity();
@@ -47,17 +52,25 @@ StgShotManager::~StgShotManager() {
 	}
 }
 void StgShotManager::Work() {
-	for (auto itr = listObj_.begin(); itr != listObj_.end(); ) {
+	//Compaction moves shots to other slots
+	InvalidateSpatialIndex();
+
+	//In-order compaction, draw order within a render priority follows listObj_
+	auto itrDst = listObj_.begin();
+	for (auto itr = listObj_.begin(); itr != listObj_.end(); ++itr) {
 		ref_unsync_ptr<StgShotObject>& obj = *itr;
 		if (obj->IsDeleted()) {
 			obj->ClearShotObject();
-			itr = listObj_.erase(itr);
+			continue;
 		}
 		else if (!obj->IsActive()) {
-			itr = listObj_.erase(itr);
+			continue;
 		}
-		else ++itr;
+		if (itrDst != itr)
+			*itrDst = std::move(obj);
+		++itrDst;
 	}
+	listObj_.erase(itrDst, listObj_.end());
 }
 
 std::array<BlendMode, StgShotManager::BLEND_COUNT> StgShotManager::blendTypeRenderOrder = {
@@ -88,7 +101,7 @@ void StgShotManager::Render(int targetPriority) {
 	graphics->SetTextureFilter(filterMin_, filterMag_, D3DTEXF_NONE);
 
 	DWORD bEnableFog = FALSE;
-	device->GetRenderState(D3DRS_FOGENABLE, &bEnableFog);
+	bEnableFog = graphics->IsFogEnable();
 	if (bEnableFog)
 		graphics->SetFogEnable(false);
 
@@ -97,13 +110,11 @@ void StgShotManager::Render(int targetPriority) {
 
 	D3DXMatrixMultiply(&matProj_, &camera2D->GetMatrix(), &graphics->GetViewPortMatrix());
 
-	device->SetFVF(VERTEX_TLX::fvf);
-	device->SetVertexDeclaration(shaderManager->GetVertexDeclarationTLX());
+	graphics->SetFVF(VERTEX_TLX::fvf);
+	graphics->SetVertexDeclaration(shaderManager->GetVertexDeclarationTLX());
 	pLastTexture_ = nullptr;
 
-	if (D3DXHANDLE handle = effectShot_->GetParameterBySemantic(nullptr, "VIEWPROJECTION")) {
-		effectShot_->SetMatrix(handle, &matProj_);
-	}
+	bindingShot_->SetMatrix(ShaderSemantic::ViewProjection, matProj_);
 
 	auto _RenderQueue = [&](const RenderQueue& renderQueue) {
 		if (renderQueue.count == 0) return;
@@ -127,8 +138,8 @@ void StgShotManager::Render(int targetPriority) {
 
 	device->SetVertexShader(nullptr);
 	device->SetPixelShader(nullptr);
-	device->SetVertexDeclaration(nullptr);
-	device->SetIndices(nullptr);
+	graphics->SetVertexDeclaration(nullptr);
+	graphics->SetIndices(nullptr);
 
 	if (bEnableFog)
 		graphics->SetFogEnable(true);
@@ -158,56 +169,183 @@ void StgShotManager::RegistIntersectionTarget() {
 			obj->RegistIntersectionTarget();
 		}
 	}
+	_BuildSpatialIndex();
+}
+
+int StgShotManager::SpatialIndex::GetCell(double x, double y) const {
+	double cx = (x - left) / CELL_SIZE;
+	double cy = (y - top) / CELL_SIZE;
+	//Also rejects NaN
+	if (!(cx >= 0 && cx < countX && cy >= 0 && cy < countY)) return -1;
+	return (int)cy * countX + (int)cx;
+}
+void StgShotManager::_BuildSpatialIndex() {
+	SpatialIndex& index = spatialIndex_;
+
+	if (++index.stamp == 0) index.stamp = 1;
+	index.bValid = true;
+
+	DxRect<LONG>* const rcStgFrame = stageController_->GetStageInformation()->GetStgFrameRect();
+	LONG right = rcStgFrame->GetWidth() + rcDeleteClip_.right;
+	LONG bottom = rcStgFrame->GetHeight() + rcDeleteClip_.bottom;
+
+	index.left = rcDeleteClip_.left;
+	index.top = rcDeleteClip_.top;
+	index.countX = std::max<LONG>((right - index.left) / SpatialIndex::CELL_SIZE + 1, 1);
+	index.countY = std::max<LONG>((bottom - index.top) / SpatialIndex::CELL_SIZE + 1, 1);
+	index.countIndexed = listObj_.size();
+
+	size_t countCell = index.countX * index.countY;
+	index.listCellStart.assign(countCell + 1, 0);
+	index.listShotCell.resize(listObj_.size());
+	index.listOutside.clear();
+	index.listMoved.clear();
+
+	//Counting sort by cell
+	for (size_t i = 0; i < listObj_.size(); ++i) {
+		StgShotObject* obj = listObj_[i].get();
+		obj->spatialStamp_ = index.stamp;
+		obj->spatialIndex_ = i;
+
+		int cell = index.GetCell(obj->GetPositionX(), obj->GetPositionY());
+		index.listShotCell[i] = cell;
+		if (cell >= 0)
+			++index.listCellStart[cell + 1];
+		else
+			index.listOutside.push_back(i);
+	}
+	for (size_t iCell = 0; iCell < countCell; ++iCell)
+		index.listCellStart[iCell + 1] += index.listCellStart[iCell];
+
+	index.listCellShot.resize(index.listCellStart[countCell]);
+	for (size_t i = 0; i < listObj_.size(); ++i) {
+		int cell = index.listShotCell[i];
+		if (cell < 0) continue;
+		//listCellStart[cell] is used as the write cursor, then restored below
+		index.listCellShot[index.listCellStart[cell]++] = i;
+	}
+	for (size_t iCell = countCell; iCell > 0; --iCell)
+		index.listCellStart[iCell] = index.listCellStart[iCell - 1];
+	index.listCellStart[0] = 0;
+}
+bool StgShotManager::_QuerySpatialIndex(std::vector<uint32_t>& res, int cx, int cy, int r) {
+	const SpatialIndex& index = spatialIndex_;
+	if (!index.bValid) return false;
+
+	auto _AddIfIndexed = [&](uint32_t i) {
+		if (listObj_[i]->spatialStamp_ == index.stamp)
+			res.push_back(i);
+	};
+
+	//Positions are truncated to int by the exact test, widen the range by a pixel to stay conservative
+	double left = (double)cx - r - 1 - index.left;
+	double right = (double)cx + r + 1 - index.left;
+	double top = (double)cy - r - 1 - index.top;
+	double bottom = (double)cy + r + 1 - index.top;
+	LONG x0 = std::max<LONG>((LONG)floor(left / SpatialIndex::CELL_SIZE), 0);
+	LONG x1 = std::min<LONG>((LONG)floor(right / SpatialIndex::CELL_SIZE), (LONG)index.countX - 1);
+	LONG y0 = std::max<LONG>((LONG)floor(top / SpatialIndex::CELL_SIZE), 0);
+	LONG y1 = std::min<LONG>((LONG)floor(bottom / SpatialIndex::CELL_SIZE), (LONG)index.countY - 1);
+
+	for (LONG iy = y0; iy <= y1; ++iy) {
+		for (LONG ix = x0; ix <= x1; ++ix) {
+			size_t cell = iy * index.countX + ix;
+			for (uint32_t iEntry = index.listCellStart[cell]; iEntry < index.listCellStart[cell + 1]; ++iEntry)
+				_AddIfIndexed(index.listCellShot[iEntry]);
+		}
+	}
+	for (uint32_t i : index.listOutside)
+		_AddIfIndexed(i);
+	res.insert(res.end(), index.listMoved.begin(), index.listMoved.end());
+	for (size_t i = index.countIndexed; i < listObj_.size(); ++i)
+		res.push_back(i);
+
+	//Keep listObj_ order, same as a full scan
+	std::sort(res.begin(), res.end());
+	return true;
+}
+void StgShotManager::InvalidateSpatialIndex() {
+	spatialIndex_.bValid = false;
+	if (++spatialIndex_.stamp == 0) spatialIndex_.stamp = 1;
+}
+void StgShotManager::NotifyShotMoved(StgShotObject* obj) {
+	if (obj->spatialStamp_ == spatialIndex_.stamp)
+		spatialIndex_.listMoved.push_back(obj->spatialIndex_);
+	obj->spatialStamp_ = 0;
 }
 void StgShotManager::AddShot(ref_unsync_ptr<StgShotObject> obj) {
 	obj->SetOwnObjectReference();
 	listObj_.push_back(obj);
 }
+void StgShotManager::AddShotBlock(std::vector<ref_unsync_ptr<StgShotObject>>& listShot) {
+	for (auto& obj : listShot)
+		obj->SetOwnObjectReference();
+	listObj_.insert(listObj_.end(), listShot.begin(), listShot.end());
+}
 
-void StgShotManager::DeleteInCircle(int typeDelete, int typeTo, int typeOwner, int cx, int cy, int* radius) {
-	int r = radius ? *radius : 0;
-	int rr = r * r;
+bool StgShotManager::_IsShotInCircle(StgShotObject* obj, int typeOwner, int cx, int cy, int* radius) {
+	if (obj->IsDeleted()) return false;
+	if ((typeOwner != StgShotObject::OWNER_NULL) && (obj->GetOwnerType() != typeOwner)) return false;
+	if (radius == nullptr) return true;
 
+	int r = *radius;
 	DxRect<int> rcBox(cx - r, cy - r, cx + r, cy + r);
 
-	for (ref_unsync_ptr<StgShotObject>& obj : listObj_) {
-		if (obj->IsDeleted()) continue;
-		if ((typeOwner != StgShotObject::OWNER_NULL) && (obj->GetOwnerType() != typeOwner)) continue;
-		if (typeDelete == DEL_TYPE_SHOT && obj->IsSpellResist()) continue;
-
-		int sx = obj->GetPositionX();
-		int sy = obj->GetPositionY();
+	int sx = obj->GetPositionX();
+	int sy = obj->GetPositionY();
+	return rcBox.IsPointIntersected(sx, sy) && Math::HypotSq<int64_t>(cx - sx, cy - sy) <= r * r;
+}
+void StgShotManager::DeleteInCircle(int typeDelete, int typeTo, int typeOwner, int cx, int cy, int* radius) {
+	auto _Delete = [&](size_t i) {
+		//Delete events may run scripts that fire shots, so hold a reference
+		ref_unsync_ptr<StgShotObject> obj = listObj_[i];
+		if (typeDelete == DEL_TYPE_SHOT && obj->IsSpellResist()) return;
+		if (!_IsShotInCircle(obj.get(), typeOwner, cx, cy, radius)) return;
+
+		if (typeTo == TO_TYPE_IMMEDIATE)
+			obj->DeleteImmediate();
+		else if (typeTo == TO_TYPE_FADE)
+			obj->SetFadeDelete();
+		else if (typeTo == TO_TYPE_ITEM)
+			obj->ConvertToItem();
+	};
 
-		if (radius == nullptr || (rcBox.IsPointIntersected(sx, sy) && Math::HypotSq<int64_t>(cx - sx, cy - sy) <= rr)) {
-			if (typeTo == TO_TYPE_IMMEDIATE)
-				obj->DeleteImmediate();
-			else if (typeTo == TO_TYPE_FADE)
-				obj->SetFadeDelete();
-			else if (typeTo == TO_TYPE_ITEM)
-				obj->ConvertToItem();
-		}
+	std::vector<uint32_t> listCandidate;
+	if (radius == nullptr || !_QuerySpatialIndex(listCandidate, cx, cy, *radius)) {
+		for (size_t i = 0; i < listObj_.size(); ++i)
+			_Delete(i);
+		return;
 	}
-}
 
-std::vector<int> StgShotManager::GetShotIdInCircle(int typeOwner, int cx, int cy, int* radius) {
-	int r = radius ? *radius : 0;
-	int rr = r * r;
+	size_t countMoved = spatialIndex_.listMoved.size();
+	size_t countShot = listObj_.size();
+	for (uint32_t i : listCandidate)
+		_Delete(i);
 
-	DxRect<int> rcBox(cx - r, cy - r, cx + r, cy + r);
+	//Shots moved or fired by the events raised above
+	for (size_t i = countMoved; i < spatialIndex_.listMoved.size(); ++i)
+		_Delete(spatialIndex_.listMoved[i]);
+	for (size_t i = countShot; i < listObj_.size(); ++i)
+		_Delete(i);
+}
 
+std::vector<int> StgShotManager::GetShotIdInCircle(int typeOwner, int cx, int cy, int* radius) {
 	std::vector<int> res;
-	for (ref_unsync_ptr<StgShotObject>& obj : listObj_) {
-		if (obj->IsDeleted()) continue;
-		if ((typeOwner != StgShotObject::OWNER_NULL) && (obj->GetOwnerType() != typeOwner)) continue;
-
-		int sx = obj->GetPositionX();
-		int sy = obj->GetPositionY();
 
-		if (radius == nullptr || (rcBox.IsPointIntersected(sx, sy) && Math::HypotSq<int64_t>(cx - sx, cy - sy) <= rr)) {
-			res.push_back(obj->GetObjectID());
+	std::vector<uint32_t> listCandidate;
+	if (radius == nullptr || !_QuerySpatialIndex(listCandidate, cx, cy, *radius)) {
+		for (ref_unsync_ptr<StgShotObject>& obj : listObj_) {
+			if (_IsShotInCircle(obj.get(), typeOwner, cx, cy, radius))
+				res.push_back(obj->GetObjectID());
 		}
+		return res;
 	}
 
+	for (uint32_t i : listCandidate) {
+		StgShotObject* obj = listObj_[i].get();
+		if (_IsShotInCircle(obj, typeOwner, cx, cy, radius))
+			res.push_back(obj->GetObjectID());
+	}
 	return res;
 }
 size_t StgShotManager::GetShotCount(int typeOwner) {
@@ -259,76 +397,78 @@ bool StgShotManager::LoadEnemyShotData(const std::wstring& path, bool bReload) {
 //****************************************************************************
 //StgShotDataList
 //****************************************************************************
+StgShotDataList::CompiledCache StgShotDataList::cacheCompiled_(L"shotdata");
 StgShotDataList::StgShotDataList() {
 	defaultDelayData_ = -1;
 	defaultDelayColor_ = 0xffffffff;	//Solid white
 }
 StgShotDataList::~StgShotDataList() {
 }
+std::vector<VERTEX_TLX> StgShotDataList::_BuildVertices(const std::vector<StgShotData*>& listData, float texW, float texH) {
+	std::vector<VERTEX_TLX> res;
+
+	for (StgShotData* data : listData) {
+		for (StgShotDataFrame& iFrame : data->listFrame_) {
+			LONG* ptrSrc = reinterpret_cast<LONG*>(&iFrame.rcSrc_);
+			float* ptrDst = reinterpret_cast<float*>(&iFrame.rcDst_);
+
+			for (size_t iVert = 0; iVert < 4; ++iVert) {
+				VERTEX_TLX vert;
+
+				//((iVert & 1) << 1)
+				//   0 -> 0
+				//   1 -> 2
+				//   2 -> 0
+				//   3 -> 2
+				//(iVert | 1)
+				//   0 -> 1
+				//   1 -> 1
+				//   2 -> 3
+				//   3 -> 3
+
+				StgShotObject::_SetVertexUV(&vert,
+					ptrSrc[(iVert & 1) << 1] / texW, ptrSrc[iVert | 1] / texH);
+				StgShotObject::_SetVertexPosition(&vert, ptrDst[(iVert & 1) << 1], ptrDst[iVert | 1], 0);
+				StgShotObject::_SetVertexColorARGB(&vert, 0xffffffff);
+
+				res.push_back(vert);
+			}
+		}
+	}
+
+	return res;
+}
 void StgShotDataList::_LoadVertexBuffers(std::map<std::wstring, VBContainerList>::iterator placement, 
-	shared_ptr<Texture> texture, std::vector<StgShotData*>& listAddData)
+	shared_ptr<Texture> texture, std::vector<StgShotData*>& listAddData, const std::vector<VERTEX_TLX>& listVertex)
 {
-	DirectGraphics* graphics = DirectGraphics::GetBase();
-	IDirect3DDevice9* device = graphics->GetDevice();
+	size_t countFrame = listVertex.size() / 4U;
 
-	float texW = texture->GetWidth();
-	float texH = texture->GetHeight();
+	auto itrData = listAddData.begin();
+	size_t iAnim = 0;
 
-	size_t countFrame = 0;
-	for (StgShotData* iData : listAddData)
-		countFrame += iData->GetFrameCount();
-
-	size_t iBuffer = 0;
-	while (countFrame > 0) {
-		size_t thisCountFrame = std::min<size_t>(countFrame, StgShotVertexBufferContainer::MAX_DATA);
+	size_t iFrame = 0;
+	while (iFrame < countFrame) {
+		size_t thisCountFrame = std::min<size_t>(countFrame - iFrame, StgShotVertexBufferContainer::MAX_DATA);
 
 		placement->second.push_back(unique_ptr<StgShotVertexBufferContainer>(
 			new StgShotVertexBufferContainer()));
 		StgShotVertexBufferContainer* pVertexBufferContainer = placement->second.back().get();
 		pVertexBufferContainer->SetTexture(texture);
 
-		std::vector<VERTEX_TLX> bufferVertex(4 * thisCountFrame);
-		size_t iVertex = 0;
-
-		VERTEX_TLX verts[4];
-		for (size_t iData = 0; iData < listAddData.size(); ++iData) {
-			StgShotData* data = listAddData[iData];
-			for (size_t iAnim = 0; iAnim < data->GetFrameCount(); ++iAnim) {
-				StgShotDataFrame* pFrame = &data->listFrame_[iAnim];
-				pFrame->listShotData_ = this;
-
-				LONG* ptrSrc = reinterpret_cast<LONG*>(&pFrame->rcSrc_);
-				float* ptrDst = reinterpret_cast<float*>(&pFrame->rcDst_);
-
-				for (size_t iVert = 0; iVert < 4; ++iVert) {
-					VERTEX_TLX* pv = &verts[iVert];
-
-					//((iVert & 1) << 1)
-					//   0 -> 0
-					//   1 -> 2
-					//   2 -> 0
-					//   3 -> 2
-					//(iVert | 1)
-					//   0 -> 1
-					//   1 -> 1
-					//   2 -> 3
-					//   3 -> 3
-
-					StgShotObject::_SetVertexUV(pv,
-						ptrSrc[(iVert & 1) << 1] / texW, ptrSrc[iVert | 1] / texH);
-					StgShotObject::_SetVertexPosition(pv, ptrDst[(iVert & 1) << 1], ptrDst[iVert | 1], 0);
-					StgShotObject::_SetVertexColorARGB(pv, 0xffffffff);
-				}
-
-				pFrame->pVertexBuffer_ = pVertexBufferContainer;
-				pFrame->vertexOffset_ = iVertex;
-
-				for (size_t j = 0; j < 4; ++j)
-					bufferVertex[iVertex + j] = verts[j];
-				iVertex += 4;
+		for (size_t i = 0; i < thisCountFrame; ++i) {
+			while (iAnim >= (*itrData)->GetFrameCount()) {
+				++itrData;
+				iAnim = 0;
 			}
+
+			StgShotDataFrame* pFrame = &(*itrData)->listFrame_[iAnim++];
+			pFrame->listShotData_ = this;
+			pFrame->pVertexBuffer_ = pVertexBufferContainer;
+			pFrame->vertexOffset_ = i * 4;
 		}
 
+		std::vector<VERTEX_TLX> bufferVertex(listVertex.begin() + iFrame * 4,
+			listVertex.begin() + (iFrame + thisCountFrame) * 4);
 		HRESULT hr = pVertexBufferContainer->LoadData(bufferVertex, thisCountFrame);
 		if (FAILED(hr)) {
 			std::wstring err = StringUtility::Format(L"AddShotDataList::Failed to load shot data buffer: "
@@ -337,28 +477,16 @@ void StgShotDataList::_LoadVertexBuffers(std::map<std::wstring, VBContainerList>
 			throw gstd::wexception(err);
 		}
 
-		++iBuffer;
-		countFrame -= thisCountFrame;
+		iFrame += thisCountFrame;
 	}
 }
-bool StgShotDataList::AddShotDataList(const std::wstring& path, bool bReload) {
-	auto itrVB = mapVertexBuffer_.find(path);
-	if (!bReload && itrVB != mapVertexBuffer_.end()) return true;
-
-	std::wstring pathReduce = PathProperty::ReduceModuleDirectory(path);
+shared_ptr<StgShotDataList::CompiledFile> StgShotDataList::_CompileFile(const std::string& source) {
+	shared_ptr<CompiledFile> res = std::make_shared<CompiledFile>();
+	res->defaultDelayDataIn = defaultDelayData_;
+	res->defaultDelayColorIn = defaultDelayColor_;
 
-	shared_ptr<FileReader> reader = FileManager::GetBase()->GetFileReader(path);
-	if (reader == nullptr || !reader->Open())
-		throw gstd::wexception(L"AddShotDataList: " + ErrorUtility::GetFileNotFoundErrorMessage(pathReduce, true));
-
-	std::string source = reader->ReadAllString();
-
-	bool res = false;
 	Scanner scanner(source);
 	try {
-		std::map<int, unique_ptr<StgShotData>> mapData;
-		std::wstring pathImage;
-
 		while (scanner.HasNext()) {
 			Token& tok = scanner.Next();
 			if (tok.GetType() == Token::Type::TK_EOF)
@@ -366,11 +494,11 @@ bool StgShotDataList::AddShotDataList(const std::wstring& path, bool bReload) {
 			else if (tok.GetType() == Token::Type::TK_ID) {
 				std::wstring element = tok.GetElement();
 				if (element == L"ShotData") {
-					_ScanShot(mapData, scanner);
+					_ScanShot(res->mapData, scanner);
 				}
 				else if (element == L"shot_image") {
 					scanner.CheckType(scanner.Next(), Token::Type::TK_EQUAL);
-					pathImage = scanner.Next().GetString();
+					res->pathImage = scanner.Next().GetString();
 				}
 				else if (element == L"delay_id") {
 					scanner.CheckType(scanner.Next(), Token::Type::TK_EQUAL);
@@ -392,7 +520,191 @@ bool StgShotDataList::AddShotDataList(const std::wstring& path, bool bReload) {
 					tok = scanner.Next();
 			}
 		}
+	}
+	catch (gstd::wexception& e) {
+		throw gstd::wexception(StringUtility::Format(L"[Line=%d] (%s)", scanner.GetCurrentLine(), e.what()));
+	}
+	catch (...) {
+		throw gstd::wexception(StringUtility::Format(L"[Line=%d] (Unknown error.)", scanner.GetCurrentLine()));
+	}
+
+	res->defaultDelayDataOut = defaultDelayData_;
+	res->defaultDelayColorOut = defaultDelayColor_;
+	return res;
+}
+//Binary cache layout:
+//	uint32 version, int32 delay_id after the file, uint32 delay_color after the file
+//	uint32 image path length, wchar_t[] image path
+//	uint32 data count
+//		int32 id, int32 render, int32 delay render, int32 alpha, int32 delay id, uint32 delay color, uint32 total frame
+//		uint32 frame count, { DxRect<LONG> source, DxRect<float> dest, uint32 frame }[]
+//		uint32 collision count, { float x, float y, float r }[]
+//		double angular velocity min, double angular velocity max, bool fixed angle
+shared_ptr<StgShotDataList::CompiledFile> StgShotDataList::_ReadDiskCache(const std::wstring& pathCache) {
+	File file(pathCache);
+	if (!file.Open()) return nullptr;
+
+	auto _Read = [&](void* dst, size_t size) -> bool {
+		return file.Read(dst, size) == size;
+	};
+
+	shared_ptr<CompiledFile> res = std::make_shared<CompiledFile>();
+	res->defaultDelayDataIn = defaultDelayData_;
+	res->defaultDelayColorIn = defaultDelayColor_;
+
+	bool bValid = [&]() -> bool {
+		uint32_t version = 0;
+		if (!_Read(&version, sizeof(uint32_t)) || version != DISK_CACHE_VERSION) return false;
+		if (!_Read(&res->defaultDelayDataOut, sizeof(int32_t))) return false;
+		if (!_Read(&res->defaultDelayColorOut, sizeof(D3DCOLOR))) return false;
+
+		uint32_t lengthPath = 0;
+		if (!_Read(&lengthPath, sizeof(uint32_t)) || lengthPath > file.GetSize()) return false;
+		res->pathImage.resize(lengthPath);
+		if (!_Read(res->pathImage.data(), lengthPath * sizeof(wchar_t))) return false;
+
+		uint32_t countData = 0;
+		if (!_Read(&countData, sizeof(uint32_t))) return false;
+		for (uint32_t iData = 0; iData < countData; ++iData) {
+			int32_t id = 0;
+			int32_t values[5];
+			uint32_t totalFrame = 0;
+			if (!_Read(&id, sizeof(int32_t)) || id < 0) return false;
+			if (!_Read(values, sizeof(values))) return false;
+			if (!_Read(&totalFrame, sizeof(uint32_t))) return false;
+
+			StgShotData* data = new StgShotData(this);
+			res->mapData[id].reset(data);
+			data->typeRender_ = (BlendMode)values[0];
+			data->typeDelayRender_ = (BlendMode)values[1];
+			data->alpha_ = values[2];
+			data->idDefaultDelay_ = values[3];
+			data->colorDelay_ = (D3DCOLOR)values[4];
+			data->totalFrame_ = totalFrame;
+
+			uint32_t countFrame = 0;
+			if (!_Read(&countFrame, sizeof(uint32_t)) || countFrame > file.GetSize()) return false;
+			data->listFrame_.resize(countFrame);
+			for (StgShotDataFrame& frame : data->listFrame_) {
+				uint32_t frameTime = 0;
+				if (!_Read(&frame.rcSrc_, sizeof(DxRect<LONG>))) return false;
+				if (!_Read(&frame.rcDst_, sizeof(DxRect<float>))) return false;
+				if (!_Read(&frameTime, sizeof(uint32_t))) return false;
+				frame.listShotData_ = this;
+				frame.frame_ = frameTime;
+			}
+
+			uint32_t countCol = 0;
+			if (!_Read(&countCol, sizeof(uint32_t)) || countCol > file.GetSize()) return false;
+			for (uint32_t iCol = 0; iCol < countCol; ++iCol) {
+				float circle[3];
+				if (!_Read(circle, sizeof(circle))) return false;
+				data->listCol_.push_back(DxCircle(circle[0], circle[1], circle[2]));
+			}
+
+			if (!_Read(&data->angularVelocityMin_, sizeof(double))) return false;
+			if (!_Read(&data->angularVelocityMax_, sizeof(double))) return false;
+			if (!_Read(&data->bFixedAngle_, sizeof(bool))) return false;
+		}
+		return file.GetFilePointer() == file.GetSize();
+	}();
+
+	return bValid ? res : nullptr;
+}
+void StgShotDataList::_WriteDiskCache(const std::wstring& pathCache, const CompiledFile* compiled) {
+	//The same file may be loaded on several threads
+	File::WriteAtomic(pathCache, [&](File& file) {
+		file.WriteValue<uint32_t>(DISK_CACHE_VERSION);
+		file.WriteValue<int32_t>(compiled->defaultDelayDataOut);
+		file.WriteValue<uint32_t>(compiled->defaultDelayColorOut);
+
+		file.WriteValue<uint32_t>(compiled->pathImage.size());
+		if (compiled->pathImage.size() > 0)
+			file.Write((LPVOID)compiled->pathImage.data(), compiled->pathImage.size() * sizeof(wchar_t));
+
+		file.WriteValue<uint32_t>(compiled->mapData.size());
+		for (auto& [id, data] : compiled->mapData) {
+			file.WriteValue<int32_t>(id);
+			file.WriteValue<int32_t>(data->typeRender_);
+			file.WriteValue<int32_t>(data->typeDelayRender_);
+			file.WriteValue<int32_t>(data->alpha_);
+			file.WriteValue<int32_t>(data->idDefaultDelay_);
+			file.WriteValue<uint32_t>(data->colorDelay_);
+			file.WriteValue<uint32_t>(data->totalFrame_);
+
+			file.WriteValue<uint32_t>(data->listFrame_.size());
+			for (const StgShotDataFrame& frame : data->listFrame_) {
+				file.WriteValue(frame.rcSrc_);
+				file.WriteValue(frame.rcDst_);
+				file.WriteValue<uint32_t>(frame.frame_);
+			}
+
+			file.WriteValue<uint32_t>(data->listCol_.size());
+			for (const DxCircle& circle : data->listCol_) {
+				file.WriteValue<float>(circle.GetX());
+				file.WriteValue<float>(circle.GetY());
+				file.WriteValue<float>(circle.GetR());
+			}
+
+			file.WriteValue<double>(data->angularVelocityMin_);
+			file.WriteValue<double>(data->angularVelocityMax_);
+			file.WriteValue<bool>(data->bFixedAngle_);
+		}
+		return true;
+	});
+}
+bool StgShotDataList::AddShotDataList(const std::wstring& path, bool bReload) {
+	auto itrVB = mapVertexBuffer_.find(path);
+	if (!bReload && itrVB != mapVertexBuffer_.end()) return true;
+
+	std::wstring pathReduce = PathProperty::ReduceModuleDirectory(path);
+
+	int64_t timeWrite = File::GetLastWriteTime(path);
+	if (bReload)
+		cacheCompiled_.Remove(path);
+
+	shared_ptr<CompiledFile> compiled = cacheCompiled_.Get(path, timeWrite);
+	if (compiled && (compiled->defaultDelayDataIn != defaultDelayData_ 
+		|| compiled->defaultDelayColorIn != defaultDelayColor_))
+		compiled = nullptr;
+	bool bCached = compiled != nullptr;
+
+	std::string source;
+	if (!bCached) {
+		shared_ptr<FileReader> reader = FileManager::GetBase()->GetFileReader(path);
+		if (reader == nullptr || !reader->Open())
+			throw gstd::wexception(L"AddShotDataList: " + ErrorUtility::GetFileNotFoundErrorMessage(pathReduce, true));
+
+		source = reader->ReadAllString();
+	}
+
+	bool res = false;
+	bool bDiskCached = false;
+	try {
+		if (!bCached) {
+			std::wstring pathDisk;
+			if (cacheCompiled_.IsDiskCacheEnable() && !bReload) {
+				//The delay defaults carried in from earlier files change the result as much as the text does
+				uint64_t hash = Hash::Fnv1a(source.data(), source.size());
+				hash = Hash::Fnv1a(&defaultDelayData_, sizeof(defaultDelayData_), hash);
+				hash = Hash::Fnv1a(&defaultDelayColor_, sizeof(defaultDelayColor_), hash);
+				pathDisk = cacheCompiled_.GetDiskCachePath(hash);
+
+				compiled = _ReadDiskCache(pathDisk);
+				bDiskCached = compiled != nullptr;
+			}
+			if (!bDiskCached) {
+				compiled = _CompileFile(source);
+				if (pathDisk.size() > 0)
+					_WriteDiskCache(pathDisk, compiled.get());
+			}
+		}
+		if (bCached || bDiskCached) {
+			defaultDelayData_ = compiled->defaultDelayDataOut;
+			defaultDelayColor_ = compiled->defaultDelayColorOut;
+		}
 
+		std::wstring pathImage = compiled->pathImage;
 		if (pathImage.size() == 0) throw gstd::wexception("Shot texture must be set.");
 		std::wstring dir = PathProperty::GetFileDirectory(path);
 		pathImage = StringUtility::Replace(pathImage, L"./", dir);
@@ -413,47 +725,57 @@ bool StgShotDataList::AddShotDataList(const std::wstring& path, bool bReload) {
 		}
 
 		std::vector<StgShotData*> listAddData;
-
-		size_t countFrame = 0;
-		{
-			size_t i = 0;
-			for (auto itr = mapData.begin(); itr != mapData.end(); ++itr, ++i) {
-				int id = itr->first;
-				unique_ptr<StgShotData>& data = itr->second;
-				if (data == nullptr) continue;
-
-				for (auto& iFrame : data->listFrame_)
-					iFrame.listShotData_ = this;
-				countFrame += data->GetFrameCount();
-
-				listAddData.push_back(data.get());
-				if (listData_.size() <= id)
-					listData_.resize(id + 1);
-				listData_[id] = std::move(data);		//Moves unique_ptr object, do not use mapData after this point
+		for (auto itr = compiled->mapData.begin(); itr != compiled->mapData.end(); ++itr) {
+			int id = itr->first;
+			StgShotData* data = new StgShotData(*itr->second);
+			data->listShotData_ = this;
+			for (auto& iFrame : data->listFrame_) {
+				iFrame.listShotData_ = this;
+				iFrame.pVertexBuffer_ = nullptr;
 			}
+
+			listAddData.push_back(data);
+			if (listData_.size() <= id)
+				listData_.resize(id + 1);
+			listData_[id].reset(data);
 		}
 
-		if (itrVB != mapVertexBuffer_.end()) {
-			itrVB->second.clear();
-			_LoadVertexBuffers(itrVB, texture, listAddData);
+		float texW = texture->GetWidth();
+		float texH = texture->GetHeight();
+
+		//The vertices only depend on the frame rects and the texture size
+		const std::vector<VERTEX_TLX>* pListVertex = &compiled->listVertex;
+		std::vector<VERTEX_TLX> listVertexRebuild;
+		if (!bCached) {
+			compiled->textureWidth = texW;
+			compiled->textureHeight = texH;
+			compiled->listVertex = _BuildVertices(listAddData, texW, texH);
+			cacheCompiled_.Add(path, timeWrite, compiled);
 		}
-		else {
-			itrVB = mapVertexBuffer_.insert({ path, VBContainerList() }).first;
-			_LoadVertexBuffers(itrVB, texture, listAddData);
+		else if (compiled->textureWidth != texW || compiled->textureHeight != texH) {
+			listVertexRebuild = _BuildVertices(listAddData, texW, texH);
+			pListVertex = &listVertexRebuild;
 		}
 
-		Logger::WriteTop(StringUtility::Format(L"Loaded shot data: %s", pathReduce.c_str()));
+		if (itrVB != mapVertexBuffer_.end())
+			itrVB->second.clear();
+		else
+			itrVB = mapVertexBuffer_.insert({ path, VBContainerList() }).first;
+		_LoadVertexBuffers(itrVB, texture, listAddData, *pListVertex);
+
+		Logger::WriteTop(StringUtility::Format(L"Loaded shot data%s: %s", 
+			bCached ? L" (cached)" : (bDiskCached ? L" (disk cache)" : L""), pathReduce.c_str()));
 		res = true;
 	}
 	catch (gstd::wexception& e) {
-		std::wstring log = StringUtility::Format(L"Failed to load shot data: %s\r\n\t[Line=%d] (%s)",
-			pathReduce.c_str(), scanner.GetCurrentLine(), e.what());
+		std::wstring log = StringUtility::Format(L"Failed to load shot data: %s\r\n\t%s",
+			pathReduce.c_str(), e.what());
 		Logger::WriteTop(log);
 		res = false;
 	}
 	catch (...) {
-		std::string log = StringUtility::Format("Failed to load shot data: %s\r\n\t[Line=%d] (Unknown error.)",
-			pathReduce.c_str(), scanner.GetCurrentLine());
+		std::wstring log = StringUtility::Format(L"Failed to load shot data: %s\r\n\t(Unknown error.)",
+			pathReduce.c_str());
 		Logger::WriteTop(log);
 		res = false;
 	}
@@ -738,6 +1060,8 @@ StgShotObject::StgShotObject(StgStageController* stageController) : StgMoveObjec
 	frameWork_ = 0;
 	posX_ = 0;
 	posY_ = 0;
+	spatialStamp_ = 0;
+	spatialIndex_ = 0;
 	idShotData_ = 0;
 	SetBlendType(MODE_BLEND_NONE);
 
@@ -841,6 +1165,10 @@ void StgShotObject::SetOwnObjectReference() {
 }
 void StgShotObject::Work() {
 }
+void StgShotObject::_OnPositionChanged() {
+	if (spatialStamp_ != 0)
+		stageController_->GetShotManager()->NotifyShotMoved(this);
+}
 void StgShotObject::_Move() {
 	if (delay_.time == 0 || bEnableMotionDelay_)
 		StgMoveObject::_Move();
@@ -1582,34 +1910,30 @@ void StgShotObject::_DefaultShotRender(StgShotData* shotData, StgShotDataFrame*
 
 		IDirect3DTexture9* pTexture = pVB->GetD3DTexture();
 		if (pTexture != shotManager->pLastTexture_) {
-			device->SetTexture(0, pTexture);
+			graphics->SetTexture(0, pTexture);
 			shotManager->pLastTexture_ = pTexture;
 		}
-		device->SetStreamSource(0, pVB->GetD3DBuffer(), vertexOffset * sizeof(VERTEX_TLX), sizeof(VERTEX_TLX));
+		graphics->SetStreamSource(0, pVB->GetD3DBuffer(), vertexOffset * sizeof(VERTEX_TLX), sizeof(VERTEX_TLX));
 
 		{
 			ID3DXEffect* effect = shotManager->GetEffect();
+			ShaderSemanticBinding* binding = shotManager->GetBinding();
 			if (shader_) {
 				effect = shader_->GetEffect();
+				binding = shader_->GetBinding();
 				if (shader_->LoadTechnique()) {
 					shader_->LoadParameter();
 				}
 			}
 
 			if (effect) {
-				D3DXHANDLE handle = nullptr;
-				if (handle = effect->GetParameterBySemantic(nullptr, "WORLD")) {
-					effect->SetMatrix(handle, &matWorld);
-				}
-				if (shader_) {
-					if (handle = effect->GetParameterBySemantic(nullptr, "VIEWPROJECTION")) {
-						effect->SetMatrix(handle, shotManager->GetProjectionMatrix());
-					}
-				}
-				if (handle = effect->GetParameterBySemantic(nullptr, "ICOLOR")) {
+				binding->SetMatrix(ShaderSemantic::World, matWorld);
+				if (shader_)
+					binding->SetMatrix(ShaderSemantic::ViewProjection, *shotManager->GetProjectionMatrix());
+				if (binding->IsBound(ShaderSemantic::IColor)) {
 					//To normalized RGBA vector
 					D3DXVECTOR4 vColor = ColorAccess::ToVec4Normalized(color, ColorAccess::PERMUTE_RGBA);
-					effect->SetVector(handle, &vColor);
+					binding->SetVector(ShaderSemantic::IColor, vColor);
 				}
 
 				UINT countPass = 1;
@@ -1620,6 +1944,7 @@ void StgShotObject::_DefaultShotRender(StgShotData* shotData, StgShotDataFrame*
 					effect->EndPass();
 				}
 				effect->End();
+				graphics->NotifyEffectStateChange();
 			}
 		}
 	}
@@ -2756,7 +3081,7 @@ void StgCurveLaserObject::Render(BlendMode targetBlend) {
 				IDirect3DDevice9* device = graphics->GetDevice();
 
 				VertexBufferManager* vbManager = VertexBufferManager::GetBase();
-				FixedVertexBuffer* vertexBuffer = vbManager->GetVertexBufferTLX();
+				TransientVertexRing* vertexRing = vbManager->GetVertexRingTLX();
 
 				if (graphics->IsAllowRenderTargetChange()) {
 					if (auto pRT = renderTarget_.lock())
@@ -2766,55 +3091,48 @@ void StgCurveLaserObject::Render(BlendMode targetBlend) {
 
 				IDirect3DTexture9* pTexture = texture->GetD3DTexture();
 				if (pTexture != shotManager->pLastTexture_) {
-					device->SetTexture(0, pTexture);
+					graphics->SetTexture(0, pTexture);
 					shotManager->pLastTexture_ = pTexture;
 				}
 
 				size_t countVert = vertexData_.size();
 				size_t countPrim = RenderObjectPrimitive::GetPrimitiveCount(D3DPT_TRIANGLESTRIP, countVert);
 
-				{
-					BufferLockParameter lockParam = BufferLockParameter(D3DLOCK_DISCARD);
-
-					lockParam.SetSource(vertexData_, countVert, sizeof(VERTEX_TLX));
-					vertexBuffer->UpdateBuffer(&lockParam);
-				}
+				TransientVertexRing::Slice sliceVertex;
+				vertexRing->Write(vertexData_, countVert, sizeof(VERTEX_TLX), &sliceVertex);
 
-				device->SetStreamSource(0, vertexBuffer->GetBuffer(), 0, sizeof(VERTEX_TLX));
+				graphics->SetStreamSource(0, vertexRing->GetBuffer(), 0, sizeof(VERTEX_TLX));
 
 				{
 					ID3DXEffect* effect = shotManager->GetEffect();
+					ShaderSemanticBinding* binding = shotManager->GetBinding();
 					if (shader_) {
 						effect = shader_->GetEffect();
+						binding = shader_->GetBinding();
 						if (shader_->LoadTechnique()) {
 							shader_->LoadParameter();
 						}
 					}
 
 					if (effect) {
-						D3DXHANDLE handle = nullptr;
-						if (handle = effect->GetParameterBySemantic(nullptr, "WORLD")) {
-							effect->SetMatrix(handle, &graphics->GetCamera()->GetIdentity());
-						}
-						if (shader_) {
-							if (handle = effect->GetParameterBySemantic(nullptr, "VIEWPROJECTION")) {
-								effect->SetMatrix(handle, shotManager->GetProjectionMatrix());
-							}
-						}
-						if (handle = effect->GetParameterBySemantic(nullptr, "ICOLOR")) {
+						binding->SetMatrix(ShaderSemantic::World, graphics->GetCamera()->GetIdentity());
+						if (shader_)
+							binding->SetMatrix(ShaderSemantic::ViewProjection, *shotManager->GetProjectionMatrix());
+						if (binding->IsBound(ShaderSemantic::IColor)) {
 							//To normalized RGBA vector
 							D3DXVECTOR4 vColor = ColorAccess::ToVec4Normalized(color_, ColorAccess::PERMUTE_RGBA);
-							effect->SetVector(handle, &vColor);
+							binding->SetVector(ShaderSemantic::IColor, vColor);
 						}
 
 						UINT countPass = 1;
 						effect->Begin(&countPass, D3DXFX_DONOTSAVESHADERSTATE);
 						for (UINT iPass = 0; iPass < countPass; ++iPass) {
 							effect->BeginPass(iPass);
-							device->DrawPrimitive(D3DPT_TRIANGLESTRIP, 0, countPrim);
+							device->DrawPrimitive(D3DPT_TRIANGLESTRIP, sliceVertex.start, countPrim);
 							effect->EndPass();
 						}
 						effect->End();
+						graphics->NotifyEffectStateChange();
 					}
 				}
 			}
@@ -2989,8 +3307,14 @@ void StgShotPatternGeneratorObject::FireSet(void* scriptData, StgStageController
 	for (StgShotPatternTransform& iTransform : listTransformation_)
 		transformAsList.push_back(iTransform);
 
+	//Shots are collected here and handed to the shot manager in one go once the pattern is done
+	size_t countFree = shotManager->GetShotCountFree();
+	std::vector<ref_unsync_ptr<StgShotObject>> listShot;
+	listShot.reserve(std::min<size_t>(shotWay_ * shotStack_, countFree));
+	objManager->ReserveObject(listShot.capacity());
+
 	auto __CreateShot = [&](float _x, float _y, double _ss, double _sa) -> bool {
-		if (shotManager->GetShotCountAll() >= StgShotManager::SHOT_MAX) return false;
+		if (listShot.size() >= countFree) return false;
 
 		ref_unsync_ptr<StgShotObject> objShot;
 		switch (typeShot_) {
@@ -3044,7 +3368,7 @@ void StgShotPatternGeneratorObject::FireSet(void* scriptData, StgStageController
 		int idRes = script->AddObject(objShot);
 		if (idRes == DxScript::ID_INVALID) return false;
 
-		shotManager->AddShot(objShot);
+		listShot.push_back(objShot);
 
 		if (idVector) idVector->push_back(idRes);
 		return true;
@@ -3287,4 +3611,6 @@ void StgShotPatternGeneratorObject::FireSet(void* scriptData, StgStageController
 		}
 		}
 	}
+
+	shotManager->AddShotBlock(listShot);
 }
\ No newline at end of file
@@ -49,13 +49,39 @@ protected:
 		size_t count;
 		std::vector<StgShotObject*> listShot;
 	};
+
+	//Uniform grid over the shot delete clip, rebuilt from listObj_ in RegistIntersectionTarget.
+	//Entries are indices into listObj_, which stay valid until the next Work.
+	struct SpatialIndex {
+		enum : LONG {
+			CELL_SIZE = 32,
+		};
+
+		bool bValid;
+		uint32_t stamp;			//Shots whose spatialStamp_ differs are not (or no longer) at their indexed cell
+
+		LONG left;
+		LONG top;
+		size_t countX;
+		size_t countY;
+		size_t countIndexed;	//Shots added after the build are at [countIndexed, listObj_.size())
+
+		std::vector<uint32_t> listCellStart;	//countX * countY + 1 offsets into listCellShot
+		std::vector<uint32_t> listCellShot;
+		std::vector<int> listShotCell;
+		std::vector<uint32_t> listOutside;		//Shots outside the grid
+		std::vector<uint32_t> listMoved;		//Shots moved after the build
+
+		int GetCell(double x, double y) const;
+	};
 protected:
 	StgStageController* stageController_;
 
 	unique_ptr<StgShotDataList> listPlayerShotData_;
 	unique_ptr<StgShotDataList> listEnemyShotData_;
 
-	std::list<ref_unsync_ptr<StgShotObject>> listObj_;
+	std::vector<ref_unsync_ptr<StgShotObject>> listObj_;
+	SpatialIndex spatialIndex_;
 	std::vector<RenderQueue> listRenderQueuePlayer_;		//one for each render pri
 	std::vector<RenderQueue> listRenderQueueEnemy_;			//one for each render pri
 
@@ -67,7 +93,12 @@ protected:
 	D3DTEXTUREFILTERTYPE filterMag_;
 
 	ID3DXEffect* effectShot_;
+	ShaderSemanticBinding* bindingShot_;
 	D3DXMATRIX matProj_;
+
+	void _BuildSpatialIndex();
+	bool _QuerySpatialIndex(std::vector<uint32_t>& res, int cx, int cy, int r);
+	inline bool _IsShotInCircle(StgShotObject* obj, int typeOwner, int cx, int cy, int* radius);
 public:
 	IDirect3DTexture9* pLastTexture_;
 public:
@@ -79,10 +110,15 @@ public:
 	void LoadRenderQueue();
 
 	void RegistIntersectionTarget();
+	void InvalidateSpatialIndex();
+	void NotifyShotMoved(StgShotObject* obj);
 
 	void AddShot(ref_unsync_ptr<StgShotObject> obj);
+	void AddShotBlock(std::vector<ref_unsync_ptr<StgShotObject>>& listShot);
+	size_t GetShotCountFree() { return SHOT_MAX - std::min<size_t>(SHOT_MAX, listObj_.size()); }
 
 	ID3DXEffect* GetEffect() { return effectShot_; }
+	ShaderSemanticBinding* GetBinding() { return bindingShot_; }
 	D3DXMATRIX* GetProjectionMatrix() { return &matProj_; }
 
 	StgShotDataList* GetPlayerShotDataList() { return listPlayerShotData_.get(); }
@@ -114,25 +150,55 @@ public:
 class StgShotDataList {
 public:
 	using VBContainerList = std::list<unique_ptr<StgShotVertexBufferContainer>>;
+
+	enum {
+		DISK_CACHE_VERSION = 1,
+	};
+
+	//Parsed contents of a shot data file
+	struct CompiledFile {
+		//The defaults are carried over from the files loaded before, so they are part of the result
+		int defaultDelayDataIn;
+		D3DCOLOR defaultDelayColorIn;
+		int defaultDelayDataOut;
+		D3DCOLOR defaultDelayColorOut;
+
+		std::wstring pathImage;
+		std::map<int, unique_ptr<StgShotData>> mapData;		//Prototypes, copied into each list
+
+		float textureWidth;
+		float textureHeight;
+		std::vector<VERTEX_TLX> listVertex;		//4 per frame, in mapData order
+	};
+	using CompiledCache = StgDataDefinitionCache<CompiledFile>;
 protected:
+	static CompiledCache cacheCompiled_;
+
 	std::map<std::wstring, VBContainerList> mapVertexBuffer_;	//<shot data file, vb list>
 	std::vector<unique_ptr<StgShotData>> listData_;
 
 	int defaultDelayData_;
 	D3DCOLOR defaultDelayColor_;
 
+	shared_ptr<CompiledFile> _CompileFile(const std::string& source);
+	shared_ptr<CompiledFile> _ReadDiskCache(const std::wstring& pathCache);
+	static void _WriteDiskCache(const std::wstring& pathCache, const CompiledFile* compiled);
 	void _ScanShot(std::map<int, unique_ptr<StgShotData>>& mapData, Scanner& scanner);
 	static void _ScanAnimation(StgShotData* shotData, Scanner& scanner);
 
+	static std::vector<VERTEX_TLX> _BuildVertices(const std::vector<StgShotData*>& listData, float texW, float texH);
 	void _LoadVertexBuffers(std::map<std::wstring, VBContainerList>::iterator placement, 
-		shared_ptr<Texture> texture, std::vector<StgShotData*>& listAddData);
+		shared_ptr<Texture> texture, std::vector<StgShotData*>& listAddData, const std::vector<VERTEX_TLX>& listVertex);
 public:
 	StgShotDataList();
 	virtual ~StgShotDataList();
 
 	StgShotData* GetData(int id) { return (id >= 0 && id < listData_.size()) ? listData_[id].get() : nullptr; }
 
+	//Reuses the parsed file from the process-wide cache unless the file has changed, bReload always reparses
 	bool AddShotDataList(const std::wstring& path, bool bReload);
+
+	static CompiledCache* GetCompiledCache() { return &cacheCompiled_; }
 };
 
 //*******************************************************************
@@ -349,6 +415,9 @@ public:
 	bool bEnableMotionDelay_;
 	bool bRoundingPosition_;
 	double roundingAngle_;
+
+	uint32_t spatialStamp_;
+	uint32_t spatialIndex_;
 public:
 	StgShotData* _GetShotData() { return _GetShotData(idShotData_); }
 	inline StgShotData* _GetShotData(int id);
@@ -364,6 +433,7 @@ protected:
 	void _CommonWorkTask();
 
 	virtual void _Move();
+	virtual void _OnPositionChanged();
 
 	virtual void _SendDeleteEvent(TypeDelete type) {}
 	void _RequestPlayerDeleteEvent(int hitObjectID);
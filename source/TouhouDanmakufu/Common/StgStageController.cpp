@@ -155,6 +155,39 @@ void StgStageController::Initialize(ref_count_ptr<StgStageStartData> startData)
 	ELogger::WriteTop(StringUtility::Format(L"Main script: [%s]", 
 		PathProperty::ReduceModuleDirectory(infoMain->pathScript_).c_str()));
 
+	//Compile the stage's scripts together before they are loaded one by one
+	{
+		std::vector<std::pair<std::wstring, int>> listCompile;
+
+		std::wstring pathSystemScript = infoMain->pathSystem_;
+		if (pathSystemScript == ScriptInformation::DEFAULT)
+			pathSystemScript = EPathProperty::GetStgDefaultScriptDirectory() + L"Default_System.txt";
+		if (pathSystemScript.size() > 0)
+			listCompile.push_back(std::make_pair(EPathProperty::ExtendRelativeToFull(dirInfo, pathSystemScript), 
+				(int)StgStageScript::TYPE_SYSTEM));
+
+		const std::wstring& pathPlayerScript = infoStage_->GetPlayerScriptInformation()->pathScript_;
+		if (pathPlayerScript.size() > 0)
+			listCompile.push_back(std::make_pair(pathPlayerScript, (int)StgStageScript::TYPE_PLAYER));
+
+		//Single and plural scripts are loaded later by their system stage script, only that one is compiled here
+		if (infoMain->type_ == ScriptInformation::TYPE_SINGLE)
+			listCompile.push_back(std::make_pair(EPathProperty::GetSystemResourceDirectory() + L"script/System_SingleStage.txt",
+				(int)StgStageScript::TYPE_STAGE));
+		else if (infoMain->type_ == ScriptInformation::TYPE_PLURAL)
+			listCompile.push_back(std::make_pair(EPathProperty::GetSystemResourceDirectory() + L"script/System_PluralStage.txt",
+				(int)StgStageScript::TYPE_STAGE));
+		else if (infoMain->pathScript_.size() > 0)
+			listCompile.push_back(std::make_pair(infoMain->pathScript_, (int)StgStageScript::TYPE_STAGE));
+
+		std::wstring pathBack = infoMain->pathBackground_;
+		if (pathBack.size() > 0 && pathBack != ScriptInformation::DEFAULT)
+			listCompile.push_back(std::make_pair(EPathProperty::ExtendRelativeToFull(dirInfo, pathBack), 
+				(int)StgStageScript::TYPE_STAGE));
+
+		scriptManager_->CompileScriptInParallel(listCompile);
+	}
+
 	{
 		std::wstring pathSystemScript = infoMain->pathSystem_;
 		if (pathSystemScript == ScriptInformation::DEFAULT)
@@ -354,6 +387,9 @@ void StgStageController::Work() {
 
 			//Skip all this if the stage has already ended
 			if (infoStage_->IsEnd()) return;
+
+			//Shots are about to move, the grid is rebuilt in RegistIntersectionTarget
+			shotManager_->InvalidateSpatialIndex();
 			objectManagerMain_->WorkObject();
 
 			enemyManager_->Work();
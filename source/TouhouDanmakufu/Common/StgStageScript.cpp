@@ -28,6 +28,12 @@ bool StgStageScriptManager::IsError() {
 }
 
 shared_ptr<ManagedScript> StgStageScriptManager::Create(int type) {
+	shared_ptr<ManagedScript> res = CreateClient(type);
+	if (res)
+		res->SetScriptManager(stageController_->GetScriptManager());
+	return res;
+}
+shared_ptr<ManagedScript> StgStageScriptManager::CreateClient(int type) {
 	shared_ptr<ManagedScript> res = nullptr;
 	switch (type) {
 	case StgStageScript::TYPE_STAGE:
@@ -43,8 +49,6 @@ shared_ptr<ManagedScript> StgStageScriptManager::Create(int type) {
 		res = std::make_shared<StgStagePlayerScript>(stageController_);
 		break;
 	}
-	if (res)
-		res->SetScriptManager(stageController_->GetScriptManager());
 	return res;
 }
 
@@ -313,6 +317,7 @@ static const std::vector<function> stgStageFunction = {
 	{ "DeleteShotAll", StgStageScript::Func_DeleteShotAll, 2 },
 	{ "DeleteShotInCircle", StgStageScript::Func_DeleteShotInCircle, 5 },
 	{ "CreateShotA1", StgStageScript::Func_CreateShotA1, 6 },
+	{ "CreateShotBatchA1", StgStageScript::Func_CreateShotBatchA1, 6 },
 	{ "CreateShotA2", StgStageScript::Func_CreateShotA2, 8 }, //Deprecated, exists for compatibility
 	{ "CreateShotA2", StgStageScript::Func_CreateShotA2, 9 },
 	{ "CreateShotOA1", StgStageScript::Func_CreateShotOA1, 5 },
@@ -1582,6 +1587,72 @@ gstd::value StgStageScript::Func_CreateShotA1(gstd::script_machine* machine, int
 	}
 	return script->CreateIntValue(id);
 }
+//CreateShotBatchA1(x, y, speed, angle, graphic, delay)
+//	Creates many shots in one call. Each of x, y, speed, angle and graphic can either be a single value or an array,
+//	arrays of length 1 are applied to every shot. Returns the IDs of the created shots.
+gstd::value StgStageScript::Func_CreateShotBatchA1(gstd::script_machine* machine, int argc, const gstd::value* argv) {
+	StgStageScript* script = (StgStageScript*)machine->data;
+	StgStageController* stageController = script->stageController_;
+	StgShotManager* shotManager = stageController->GetShotManager();
+
+	auto _IsArray = [](const value& v) {
+		return v.get_type() && v.get_type()->get_kind() == type_data::tk_array;
+	};
+
+	size_t countShot = 1;
+	for (size_t iArg = 0; iArg < 5; ++iArg) {
+		if (!_IsArray(argv[iArg])) continue;
+		size_t size = argv[iArg].length_as_array();
+		if (size == 1U) continue;
+		if (countShot != 1U && size != countShot) {
+			script->RaiseError(L"CreateShotBatchA1: All array arguments must be of the same length, or of length 1.");
+			return value();
+		}
+		countShot = size;
+	}
+	for (size_t iArg = 0; iArg < 5; ++iArg) {
+		if (_IsArray(argv[iArg]) && argv[iArg].length_as_array() == 0U)
+			countShot = 0;
+	}
+
+	auto _Get = [&](size_t iArg, size_t index) -> const value& {
+		const value& v = argv[iArg];
+		if (!_IsArray(v)) return v;
+		return v.length_as_array() == 1U ? v[0] : v[index];
+	};
+
+	int delay = argv[5].as_int();
+	int typeOwner = script->GetScriptType() == TYPE_PLAYER ?
+		StgShotObject::OWNER_PLAYER : StgShotObject::OWNER_ENEMY;
+
+	countShot = std::min(countShot, shotManager->GetShotCountFree());
+	script->GetObjectManager()->ReserveObject(countShot);
+
+	std::vector<ref_unsync_ptr<StgShotObject>> listShot;
+	std::vector<int> listId;
+	listShot.reserve(countShot);
+	listId.reserve(countShot);
+
+	for (size_t iShot = 0; iShot < countShot; ++iShot) {
+		ref_unsync_ptr<StgNormalShotObject> obj = new StgNormalShotObject(stageController);
+		int id = script->AddObject(obj);
+		if (id == ID_INVALID) break;
+
+		obj->SetX(_Get(0, iShot).as_float());
+		obj->SetY(_Get(1, iShot).as_float());
+		obj->SetSpeed(_Get(2, iShot).as_float());
+		obj->SetDirectionAngle(Math::DegreeToRadian(_Get(3, iShot).as_float()));
+		obj->SetShotDataID(_Get(4, iShot).as_int());
+		obj->SetDelay(delay);
+		obj->SetOwnerType(typeOwner);
+
+		listShot.push_back(obj);
+		listId.push_back(id);
+	}
+	shotManager->AddShotBlock(listShot);
+
+	return script->CreateIntArrayValue(listId);
+}
 gstd::value StgStageScript::Func_CreateShotA2(gstd::script_machine* machine, int argc, const gstd::value* argv) {
 	StgStageScript* script = (StgStageScript*)machine->data;
 	StgStageController* stageController = script->stageController_;
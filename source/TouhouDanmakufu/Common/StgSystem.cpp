@@ -8,6 +8,173 @@
 
 #include "../DnhExecutor/GcLibImpl.hpp"
 
+//****************************************************************************
+//StgResourceResidency
+//****************************************************************************
+StgResourceResidency::StgResourceResidency() {
+	generation_ = 0;
+	budget_ = 256U * 1024U * 1024U;
+	sizeTotal_ = 0;
+}
+StgResourceResidency::~StgResourceResidency() {
+	Clear();
+}
+bool StgResourceResidency::_IsEntryValid(const Entry& entry) {
+	for (auto& iFile : entry.listFile) {
+		if (File::GetLastWriteTime(iFile.first) != iFile.second)
+			return false;
+	}
+	return true;
+}
+void StgResourceResidency::_Evict() {
+	if (sizeTotal_ <= budget_) return;
+
+	using EntryRef = std::pair<std::map<std::wstring, Entry>*, std::map<std::wstring, Entry>::iterator>;
+	std::vector<EntryRef> listEntry;
+	for (auto itr = mapScript_.begin(); itr != mapScript_.end(); ++itr)
+		listEntry.push_back(EntryRef(&mapScript_, itr));
+	for (auto itr = mapTexture_.begin(); itr != mapTexture_.end(); ++itr)
+		listEntry.push_back(EntryRef(&mapTexture_, itr));
+
+	//Least recently used first, the larger one first within a generation
+	std::sort(listEntry.begin(), listEntry.end(), [](const EntryRef& a, const EntryRef& b) {
+		const Entry& ea = a.second->second;
+		const Entry& eb = b.second->second;
+		if (ea.generation != eb.generation)
+			return ea.generation < eb.generation;
+		return ea.size > eb.size;
+	});
+
+	for (auto& iEntry : listEntry) {
+		if (sizeTotal_ <= budget_) break;
+		sizeTotal_ -= iEntry.second->second.size;
+		iEntry.first->erase(iEntry.second);
+		++stats_.countEvicted;
+	}
+}
+
+void StgResourceResidency::BeginRun(ScriptEngineCache* cache) {
+	Lock lock(lock_);
+
+	++generation_;
+	stats_.generation = generation_;
+	stats_.countScript = 0;
+	stats_.countInvalidated = 0;
+	stats_.countEvicted = 0;
+
+	for (auto* pMap : { &mapScript_, &mapTexture_ }) {
+		for (auto itr = pMap->begin(); itr != pMap->end();) {
+			if (!_IsEntryValid(itr->second)) {
+				sizeTotal_ -= itr->second.size;
+				itr = pMap->erase(itr);
+				++stats_.countInvalidated;
+			}
+			else ++itr;
+		}
+	}
+
+	if (cache) {
+		for (auto itr = mapScript_.begin(); itr != mapScript_.end(); ++itr) {
+			if (cache->IsExists(itr->first)) continue;
+			cache->AddCache(itr->first, itr->second.script);
+			++stats_.countScript;
+		}
+	}
+
+	stats_.countTexture = mapTexture_.size();
+	stats_.sizeResident = sizeTotal_;
+}
+void StgResourceResidency::EndRun(ScriptEngineCache* cache) {
+	if (budget_ == 0) return;
+
+	Lock lock(lock_);
+
+	auto _Update = [&](Entry& entry, size_t size) {
+		sizeTotal_ = sizeTotal_ - entry.size + size;
+		entry.size = size;
+		entry.generation = generation_;
+	};
+
+	if (cache) {
+		for (auto itr = cache->GetMap().begin(); itr != cache->GetMap().end(); ++itr) {
+			const std::wstring& path = itr->first;
+			const shared_ptr<ScriptEngineData>& data = itr->second;
+			if (data == nullptr || data->GetEngine() == nullptr) continue;
+
+			auto itrFind = mapScript_.find(path);
+			if (itrFind == mapScript_.end())
+				itrFind = mapScript_.insert({ path, Entry{ 0, 0 } }).first;
+			Entry& entry = itrFind->second;
+
+			if (entry.script != data) {
+				entry.script = data;
+
+				//Includes are part of the compiled engine
+				std::set<std::wstring> setPath = { path };
+				for (auto& iLine : data->GetScriptFileLineMap()->GetEntryList())
+					setPath.insert(iLine.path_);
+				entry.listFile.clear();
+				for (auto& iPath : setPath)
+					entry.listFile.push_back({ iPath, File::GetLastWriteTime(iPath) });
+			}
+
+			//The compiled code isn't measured, the source size is used as an estimate of it
+			_Update(entry, data->GetSource().size() * 4U);
+		}
+	}
+
+	if (TextureManager* textureManager = TextureManager::GetBase()) {
+		std::vector<shared_ptr<TextureData>> listData = textureManager->GetFileTextureDataList();
+		for (auto& data : listData) {
+			const std::wstring& path = data->GetName();
+
+			auto itrFind = mapTexture_.find(path);
+			if (itrFind == mapTexture_.end())
+				itrFind = mapTexture_.insert({ path, Entry{ 0, 0 } }).first;
+			Entry& entry = itrFind->second;
+
+			if (entry.texture == nullptr || entry.texture->GetD3DTexture() != data->GetD3DTexture()) {
+				entry.texture = std::make_shared<Texture>();
+				entry.texture->CreateFromData(data);
+				entry.listFile = { { path, File::GetLastWriteTime(path) } };
+			}
+
+			_Update(entry, data->GetResourceSize());
+		}
+	}
+
+	_Evict();
+	stats_.sizeResident = sizeTotal_;
+}
+void StgResourceResidency::ReportRunStart(double time) {
+	Lock lock(lock_);
+
+	bool bWarm = stats_.countScript > 0 || stats_.countTexture > 0;
+	if (bWarm)
+		stats_.timeStartWarm = time;
+	else
+		stats_.timeStartCold = time;
+
+	Logger::WriteTop(StringUtility::Format(
+		L"StgResourceResidency: Run %u started %s in %.2fms "
+		"(scripts reused=%u, textures resident=%u, invalidated=%u, evicted=%u, resident=%.2fMB)",
+		stats_.generation, bWarm ? L"warm" : L"cold", time,
+		(uint32_t)stats_.countScript, (uint32_t)stats_.countTexture,
+		(uint32_t)stats_.countInvalidated, (uint32_t)stats_.countEvicted, stats_.sizeResident / 1048576.0));
+	if (stats_.timeStartCold > 0 && stats_.timeStartWarm > 0) {
+		Logger::WriteTop(StringUtility::Format(L"StgResourceResidency: Start time cold=%.2fms, warm=%.2fms",
+			stats_.timeStartCold, stats_.timeStartWarm));
+	}
+}
+void StgResourceResidency::Clear() {
+	Lock lock(lock_);
+
+	mapScript_.clear();
+	mapTexture_.clear();
+	sizeTotal_ = 0;
+	stats_.sizeResident = 0;
+}
+
 //****************************************************************************
 //StgSystemController
 //****************************************************************************
@@ -18,6 +185,7 @@ StgSystemController::StgSystemController() {
 	bPrevWindowFocused_ = true;
 }
 StgSystemController::~StgSystemController() {
+	_RetainResources();
 	_ResetSystem();
 }
 void StgSystemController::_ResetSystem() {
@@ -46,6 +214,10 @@ void StgSystemController::_ResetSystem() {
 	EFileManager* fileManager = EFileManager::GetInstance();
 	fileManager->ClearArchiveFileCache();
 }
+void StgSystemController::_RetainResources() {
+	if (StgResourceResidency* residency = StgResourceResidency::GetInstance())
+		residency->EndRun(scriptEngineCache_.get());
+}
 void StgSystemController::Initialize(ref_count_ptr<StgSystemInformation> infoSystem) {
 	base_ = this;
 
@@ -56,8 +228,14 @@ void StgSystemController::Initialize(ref_count_ptr<StgSystemInformation> infoSys
 	infoControlScript_ = new StgControlScriptInformation();
 }
 void StgSystemController::Start(ref_count_ptr<ScriptInformation> infoPlayer, ref_count_ptr<ReplayInformation> infoReplay) {
+	auto timeStart = stdch::steady_clock::now();
+
 	_ResetSystem();
 
+	StgResourceResidency* residency = StgResourceResidency::GetInstance();
+	if (residency)
+		residency->BeginRun(scriptEngineCache_.get());
+
 	ref_count_ptr<ScriptInformation> infoMain = infoSystem_->GetMainScriptInformation();
 
 	EFileManager* fileManager = EFileManager::GetInstance();
@@ -87,6 +265,11 @@ void StgSystemController::Start(ref_count_ptr<ScriptInformation> infoPlayer, ref
 		infoStage->SetPlayerScriptInformation(infoPlayer);
 		StartStgScene(infoStage, replayStageData);
 	}
+
+	if (residency) {
+		auto timeEnd = stdch::steady_clock::now();
+		residency->ReportRunStart(stdch::duration<double, std::milli>(timeEnd - timeStart).count());
+	}
 }
 void StgSystemController::Work() {
 	try {
@@ -131,6 +314,7 @@ void StgSystemController::Work() {
 			StartStgScene(newStageStartData);
 		}
 		else {
+			_RetainResources();
 			DoRetry();
 		}
 		return;
@@ -156,6 +340,7 @@ void StgSystemController::Work() {
 		ELogger* logger = ELogger::GetInstance();
 		logger->UpdateCommonDataInfoPanel();
 
+		_RetainResources();
 		DoEnd();
 		return;
 	}
@@ -374,6 +559,8 @@ void StgSystemController::RenderScriptObject(int priMin, int priMax) {
 	bool bRunMinStgFrame = false;
 	bool bRunMaxStgFrame = false;
 
+	RenderQueue2D* renderQueue = DxScriptObjectManager::GetRenderQueue();
+
 	if (bValidStage) {
 		stageController_->GetItemManager()->LoadRenderQueue();
 		stageController_->GetShotManager()->LoadRenderQueue();
@@ -414,7 +601,11 @@ void StgSystemController::RenderScriptObject(int priMin, int priMax) {
 			DxScriptObjectManager::RenderList& renderList = pRenderListStage->at(iPri);
 
 			for (UINT iPass = 0; iPass < cPass; ++iPass) {
-				if (effect) effect->BeginPass(iPass);
+				if (effect) {
+					effect->BeginPass(iPass);
+					//The objects drawn in this pass go through the state cache
+					graphics->NotifyEffectStateChange();
+				}
 
 				if (bValidStage) {
 					stageController_->GetItemManager()->Render(iPri);
@@ -423,11 +614,15 @@ void StgSystemController::RenderScriptObject(int priMin, int priMax) {
 				if (pRenderListStage != nullptr && iPri < pRenderListStage->size()) {
 					for (auto itr = renderList.begin(); itr != renderList.end(); ++itr) {
 						if (DxScriptRenderObject* obj = dynamic_cast<DxScriptRenderObject*>(itr->get())) {
+							if (obj->SubmitBatch(renderQueue)) continue;
+							renderQueue->Flush();
+
 							if (!bClearZBufferFor2DCoordinate)
 								bClearZBufferFor2DCoordinate = CheckMeshAndClearZBuffer(obj);
 							obj->Render();
 						}
 					}
+					renderQueue->Flush();
 					//renderList.clear();
 				}
 
@@ -435,7 +630,10 @@ void StgSystemController::RenderScriptObject(int priMin, int priMax) {
 			}
 			renderList.Clear();
 
-			if (effect) effect->End();
+			if (effect) {
+				effect->End();
+				graphics->NotifyEffectStateChange();
+			}
 
 			//Intersection visualizer
 			{
@@ -460,16 +658,24 @@ void StgSystemController::RenderScriptObject(int priMin, int priMax) {
 			DxScriptObjectManager::RenderList& renderList = pRenderListPackage->at(iPri);
 
 			for (UINT iPass = 0; iPass < cPass; ++iPass) {
-				if (effect) effect->BeginPass(iPass);
+				if (effect) {
+					effect->BeginPass(iPass);
+					//The objects drawn in this pass go through the state cache
+					graphics->NotifyEffectStateChange();
+				}
 
 				if (pRenderListPackage != nullptr && iPri < pRenderListPackage->size()) {
 					for (auto itr = renderList.begin(); itr != renderList.end(); ++itr) {
 						if (DxScriptRenderObject* obj = dynamic_cast<DxScriptRenderObject*>(itr->get())) {
+							if (obj->SubmitBatch(renderQueue)) continue;
+							renderQueue->Flush();
+
 							if (!bClearZBufferFor2DCoordinate)
 								bClearZBufferFor2DCoordinate = CheckMeshAndClearZBuffer(obj);
 							obj->Render();
 						}
 					}
+					renderQueue->Flush();
 					//renderList.clear();
 				}
 
@@ -477,7 +683,10 @@ void StgSystemController::RenderScriptObject(int priMin, int priMax) {
 			}
 			renderList.Clear();
 
-			if (effect) effect->End();
+			if (effect) {
+				effect->End();
+				graphics->NotifyEffectStateChange();
+			}
 		}
 
 		if (iPri == priCamera) {
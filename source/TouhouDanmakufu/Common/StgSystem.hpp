@@ -14,6 +14,65 @@
 #include "StgPackageController.hpp"
 
 class StgSystemInformation;
+//*******************************************************************
+//StgResourceResidency
+//*******************************************************************
+//Keeps the compiled scripts and file textures of finished runs alive after their StgSystemController is gone,
+//	so a retry doesn't recompile every script and reload every texture.
+//Assets are tagged with the generation (run) that last used them and the write times of their files.
+//Changed files are dropped when the next run begins, the oldest generations are evicted first when over the budget.
+class StgResourceResidency : public Singleton<StgResourceResidency> {
+	friend Singleton<StgResourceResidency>;
+public:
+	struct Stats {
+		uint32_t generation = 0;
+		size_t countScript = 0;			//Compiled scripts handed to the run
+		size_t countTexture = 0;		//Textures resident when the run began
+		size_t countInvalidated = 0;
+		size_t countEvicted = 0;
+		size_t sizeResident = 0;
+		double timeStartCold = 0;		//Start time of the last run that began with nothing resident, in milliseconds
+		double timeStartWarm = 0;
+	};
+private:
+	struct Entry {
+		uint32_t generation;
+		size_t size;
+		std::vector<std::pair<std::wstring, int64_t>> listFile;		//Source files and their write times
+
+		shared_ptr<ScriptEngineData> script;
+		shared_ptr<Texture> texture;
+	};
+private:
+	gstd::CriticalSection lock_;
+	std::map<std::wstring, Entry> mapScript_;
+	std::map<std::wstring, Entry> mapTexture_;
+
+	uint32_t generation_;
+	size_t budget_;
+	size_t sizeTotal_;
+	Stats stats_;
+
+	StgResourceResidency();
+
+	static bool _IsEntryValid(const Entry& entry);
+	void _Evict();
+public:
+	~StgResourceResidency();
+
+	void SetBudget(size_t budget) { budget_ = budget; }
+	size_t GetBudget() { return budget_; }
+
+	//Drops the assets whose files changed, and hands the compiled scripts to the new run's cache
+	void BeginRun(ScriptEngineCache* cache);
+	//Takes over the compiled scripts and loaded textures of the finishing run
+	void EndRun(ScriptEngineCache* cache);
+	void ReportRunStart(double time);
+	void Clear();
+
+	const Stats& GetStats() { return stats_; }
+};
+
 //*******************************************************************
 //StgSystemController
 //*******************************************************************
@@ -44,6 +103,7 @@ protected:
 	void _ControlScene();
 
 	void _ResetSystem();
+	void _RetainResources();
 public:
 	StgSystemController();
 	~StgSystemController();
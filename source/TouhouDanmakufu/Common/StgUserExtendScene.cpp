@@ -188,11 +188,13 @@ void StgPauseScene::Start() {
 
 	if (stageController)
 		stageController->GetStageInformation()->SetPause(true);
+	DirectSoundManager::GetBase()->SetSoundEffectPause(true);
 }
 void StgPauseScene::Finish() {
 	shared_ptr<StgStageController> stageController = systemController_->GetStageController();
 	if (stageController)
 		stageController->GetStageInformation()->SetPause(false);
+	DirectSoundManager::GetBase()->SetSoundEffectPause(false);
 
 	if (scriptManager_ == nullptr) return;
 	_CallScriptFinalize();
@@ -52,12 +52,20 @@ bool EApplication::_Initialize() {
 
 	ETextureManager* textureManager = ETextureManager::CreateInstance();
 	textureManager->Initialize();
+	textureManager->GetDecoder()->SetCacheEnable(config->bEnableTextureCache_);
+
+	StgResourceResidency* residency = StgResourceResidency::CreateInstance();
+	residency->SetBudget(config->residencyBudget_ * 1024U * 1024U);
+	StgShotDataList::GetCompiledCache()->SetDiskCacheEnable(config->bEnableDataCache_);
+	StgItemDataList::GetCompiledCache()->SetDiskCacheEnable(config->bEnableDataCache_);
+	DxScriptObjectManager::GetRenderQueue()->SetEnable(config->bEnableBatch2D_);
 
 	EShaderManager* shaderManager = EShaderManager::CreateInstance();
 	shaderManager->Initialize();
 
 	EMeshManager* meshManager = EMeshManager::CreateInstance();
 	meshManager->Initialize();
+	MetasequoiaMeshData::SetCacheEnable(config->bEnableMeshCache_);
 
 	EDxTextRenderer* textRenderer = EDxTextRenderer::CreateInstance();
 	textRenderer->Initialize();
@@ -180,8 +188,61 @@ bool EApplication::_Loop() {
 					logger->SetInfo(1, L"Screen", screenInfo);
 				}
 
-				logger->SetInfo(2, L"Font cache",
-					StringUtility::Format(L"%d", EDxTextRenderer::GetInstance()->GetCacheCount()));
+				{
+					EDxTextRenderer* textRenderer = EDxTextRenderer::GetInstance();
+					auto _HitRate = [](size_t hit, size_t miss) -> double {
+						size_t total = hit + miss;
+						return total > 0 ? hit * 100.0 / total : 0.0;
+					};
+					const auto& statsMetrics = textRenderer->GetGlyphMetricsStats();
+					const auto& statsLayout = textRenderer->GetLayoutCacheStats();
+					logger->SetInfo(2, L"Font cache",
+						StringUtility::Format(L"%d, Metrics hit=%.1f%%, Layout hit=%.1f%%, Layout miss avg=%.3fms",
+							textRenderer->GetCacheCount(),
+							_HitRate(statsMetrics.countHit, statsMetrics.countMiss),
+							_HitRate(statsLayout.countHit, statsLayout.countMiss),
+							statsLayout.countMiss > 0 ? statsLayout.timeLayout / statsLayout.countMiss : 0.0));
+				}
+
+				{
+					const auto& stats = graphics->GetStateCache()->GetLastFrameStats();
+					logger->SetInfo(3, L"Device state calls",
+						StringUtility::Format(L"Issued=%u, Filtered=%u", stats.countIssued, stats.countFiltered));
+				}
+				{
+					const auto& stats = VertexBufferManager::GetBase()->GetRingLastFrameStats();
+					logger->SetInfo(12, L"Transient buffer",
+						StringUtility::Format(L"Lock=%u, Discard=%u, Size=%.1fKB",
+							stats.countLock, stats.countDiscard, stats.countByte / 1024.0));
+				}
+				{
+					const auto& stats = DxScriptObjectManager::GetRenderQueue()->GetLastFrameStats();
+					logger->SetInfo(13, L"2D batching",
+						StringUtility::Format(L"Objects=%u, Draws=%u", stats.countObject, stats.countDraw));
+				}
+				{
+					const auto& stats = ParticleEmitter::GetLastFrameStats();
+					logger->SetInfo(15, L"Particle emitters",
+						StringUtility::Format(L"Emitters=%u, Particles=%u, Time=%.3fms",
+							stats.countEmitter, stats.countParticle, stats.timeUpdate));
+				}
+				if (input->IsSampling()) {
+					const auto& stats = input->GetLastSampleStats();
+					logger->SetInfo(14, L"Input sampling",
+						StringUtility::Format(L"Events=%u, Short=%u, Dropped=%u, Latency=%.2fms",
+							stats.countEvent, stats.countShortPress, stats.countDropped, stats.latencyMax / 1000000.0));
+				}
+				{
+					const auto& stats = fpsController->GetFramePacer()->GetLastStats();
+					const auto& hist = stats.histogram;
+					double jitterAvg = stats.countFrame > 0
+						? stats.jitterTotal.count() / 1e6 / stats.countFrame : 0.0;
+					logger->SetInfo(10, L"Frame jitter",
+						StringUtility::Format(L"Avg=%.3fms, Max=%.3fms, [<0.1 <0.25 <0.5 <1 <2 <4 >=4]=[%u %u %u %u %u %u %u], Sleep=%.1fms, Spin=%.1fms",
+							jitterAvg, stats.jitterMax.count() / 1e6,
+							hist[0], hist[1], hist[2], hist[3], hist[4], hist[5], hist[6],
+							stats.timeSleep.count() / 1e6, stats.timeSpin.count() / 1e6));
+				}
 			}
 
 			if (count % 120 == 0) {
@@ -230,10 +291,10 @@ void EApplication::_RenderDisplay() {
 		graphics->BeginScene(true, true);
 
 		{
-			device->SetFVF(VERTEX_TLX::fvf);
+			graphics->SetFVF(VERTEX_TLX::fvf);
 
 			std::array<VERTEX_TLX, 4> verts;
-			auto _Render = [](IDirect3DDevice9* device, VERTEX_TLX* verts, const D3DXMATRIX* mat) {
+			auto _Render = [graphics](IDirect3DDevice9* device, VERTEX_TLX* verts, const D3DXMATRIX* mat) {
 				constexpr float bias = -0.5f;
 				for (size_t iVert = 0; iVert < 4; ++iVert) {
 					VERTEX_TLX* vertex = (VERTEX_TLX*)verts + iVert;
@@ -246,6 +307,7 @@ void EApplication::_RenderDisplay() {
 					D3DXVec3TransformCoord((D3DXVECTOR3*)vPos, (D3DXVECTOR3*)vPos, mat);
 				}
 				device->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, (void*)verts, sizeof(VERTEX_TLX));
+				graphics->NotifyDrawUP(false);
 			};
 
 			{
@@ -263,8 +325,9 @@ void EApplication::_RenderDisplay() {
 				verts[3] = VERTEX_TLX(D3DXVECTOR4(texW, texH, 0, 1), 0xffffffff,
 					D3DXVECTOR2(1, 1));
 
-				device->SetTexture(0, secondaryBackBuffer_->GetD3DTexture());
+				graphics->SetTexture(0, secondaryBackBuffer_->GetD3DTexture());
 				device->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, (void*)verts.data(), sizeof(VERTEX_TLX));
+				graphics->NotifyDrawUP(false);
 			}
 			{
 				//Render the main scene
@@ -272,7 +335,7 @@ void EApplication::_RenderDisplay() {
 				DisplaySettings* pDispSettings = graphics->GetDisplaySettings();
 
 				VertexBufferManager* vbManager = VertexBufferManager::GetBase();
-				FixedVertexBuffer* vertexBuffer = vbManager->GetVertexBufferTLX();
+				TransientVertexRing* vertexRing = vbManager->GetVertexRingTLX();
 
 				UINT scW = graphics->GetScreenWidth(), scH = graphics->GetScreenHeight();
 				UINT vpW = graphics->GetRenderScreenWidth(), vpH = graphics->GetRenderScreenHeight();
@@ -309,15 +372,13 @@ void EApplication::_RenderDisplay() {
 					}
 				}
 
-				device->SetTexture(0, mainSceneTexture->GetD3DTexture());
+				graphics->SetTexture(0, mainSceneTexture->GetD3DTexture());
 				if (shader) {
-					BufferLockParameter lockParam = BufferLockParameter(D3DLOCK_DISCARD);
-
-					lockParam.SetSource(verts, 4, sizeof(VERTEX_TLX));
-					vertexBuffer->UpdateBuffer(&lockParam);
+					TransientVertexRing::Slice sliceVertex;
+					vertexRing->Write(verts, 4, sizeof(VERTEX_TLX), &sliceVertex);
 
-					device->SetStreamSource(0, vertexBuffer->GetBuffer(), 0, sizeof(VERTEX_TLX));
-					device->SetVertexDeclaration(
+					graphics->SetStreamSource(0, vertexRing->GetBuffer(), 0, sizeof(VERTEX_TLX));
+					graphics->SetVertexDeclaration(
 						ShaderManager::GetBase()->GetRenderLib()->GetVertexDeclarationTLX());
 
 					ID3DXEffect* effect = shader->GetEffect();
@@ -325,23 +386,21 @@ void EApplication::_RenderDisplay() {
 						if (shader->LoadTechnique()) {
 							shader->LoadParameter();
 
-							D3DXHANDLE handle = nullptr;
-							if (handle = effect->GetParameterBySemantic(nullptr, "WORLD"))
-								effect->SetMatrix(handle, &matDisplayTransform);
-							if (handle = effect->GetParameterBySemantic(nullptr, "VIEWPROJECTION"))
-								effect->SetMatrix(handle, &graphics->GetViewPortMatrix());
-							if (handle = effect->GetParameterBySemantic(nullptr, "TEXTURE"))
-								effect->SetTexture(handle, mainSceneTexture->GetD3DTexture());
+							ShaderSemanticBinding* binding = shader->GetBinding();
+							binding->SetMatrix(ShaderSemantic::World, matDisplayTransform);
+							binding->SetMatrix(ShaderSemantic::ViewProjection, graphics->GetViewPortMatrix());
+							binding->SetTexture(ShaderSemantic::Texture, mainSceneTexture->GetD3DTexture());
 						}
 
 						UINT countPass = 1;
 						effect->Begin(&countPass, 0);
 						for (UINT iPass = 0; iPass < countPass; ++iPass) {
 							effect->BeginPass(iPass);
-							device->DrawPrimitive(D3DPT_TRIANGLESTRIP, 0, 2);
+							device->DrawPrimitive(D3DPT_TRIANGLESTRIP, sliceVertex.start, 2);
 							effect->EndPass();
 						}
 						effect->End();
+						graphics->NotifyEffectStateChange();
 					}
 				}
 				else {
@@ -351,11 +410,14 @@ void EApplication::_RenderDisplay() {
 					}
 
 					device->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, (void*)verts.data(), sizeof(VERTEX_TLX));
+					graphics->NotifyDrawUP(false);
 				}
 			}
 		}
 
 		graphics->EndScene(true);
+		DxScriptObjectManager::GetRenderQueue()->EndFrame();
+		ParticleEmitter::EndFrame();
 		{
 			graphics->SetRenderTarget(secondaryBackBuffer_);
 			device->Clear(0, nullptr, D3DCLEAR_TARGET, D3DCOLOR_ARGB(0, 0, 0, 0), 1.0f, 0);
@@ -371,6 +433,7 @@ bool EApplication::_Finalize() {
 	//EDirectGraphics::GetBase()->ResetDisplaySettings();
 
 	SystemController::DeleteInstance();
+	StgResourceResidency::DeleteInstance();
 	ETaskManager::DeleteInstance();
 	EFileManager::GetInstance()->EndLoadThread();
 	EDirectInput::DeleteInstance();
@@ -479,7 +479,10 @@ ScriptSelectFileModel::~ScriptSelectFileModel() {
 void ScriptSelectFileModel::_Run() {
 	timeLastUpdate_ = SystemUtility::GetCpuTime2() - 1000;
 
+	listFile_.clear();
 	_SearchScript(dir_);
+	_CreateMenuItem();
+	listFile_.clear();
 
 	bCreated_ = true;
 }
@@ -488,14 +491,6 @@ void ScriptSelectFileModel::_SearchScript(const std::wstring& dir) {
 		for (auto itr : stdfs::directory_iterator(dir)) {
 			if (GetStatus() != RUN) return;
 
-			uint64_t time = SystemUtility::GetCpuTime2();
-			if ((time - timeLastUpdate_) > 100) {
-				//100ms delay between updates
-				timeLastUpdate_ = time;
-				scene_->AddMenuItem(listItem_);
-				listItem_.clear();
-			}
-
 			if (itr.is_directory()) {
 				std::wstring tDir = PathProperty::ReplaceYenToSlash(itr.path());
 				tDir = PathProperty::AppendSlash(tDir);
@@ -511,23 +506,104 @@ void ScriptSelectFileModel::_SearchScript(const std::wstring& dir) {
 			}
 			else {
 				std::wstring tPath = PathProperty::ReplaceYenToSlash(itr.path());
-				_CreateMenuItem(tPath);
+
+				//Files of excluded extensions can't be scripts, but they may still be archives
+				std::wstring ext = PathProperty::GetFileExtension(tPath);
+				if (ScriptInformation::IsExcludeExtention(ext)) {
+					File file(tPath);
+					if (!file.Open() || !ScriptInformation::IsArchiveFile(file)) continue;
+				}
+
+				listFile_.push_back({ tPath, ScriptInformationIndex::GetFileStamp(itr) });
 			}
 		}
 	}
+}
+void ScriptSelectFileModel::_CreateMenuItem() {
+	enum : size_t {
+		PARSE_BATCH = 64,
+	};
+
+	ScriptInformationIndex* index = ScriptInformationIndex::GetBase();
+
+	bool bComplete = true;
+	std::set<std::wstring> setPathFound;
+	std::vector<ScanFile*> listParse;
+
+	//Files with an up-to-date index entry become items right away
+	for (ScanFile& file : listFile_) {
+		if (GetStatus() != RUN) {
+			bComplete = false;
+			break;
+		}
+		setPathFound.insert(file.path);
 
-	scene_->AddMenuItem(listItem_);
-	listItem_.clear();
+		std::vector<ref_count_ptr<ScriptInformation>> listInfo;
+		if (index->Find(file.path, file.stamp, listInfo))
+			_AddMenuItem(listInfo);
+		else
+			listParse.push_back(&file);
+	}
+	_FlushMenuItem(true);
+
+	//New and changed files are parsed in parallel, in batches so that items keep appearing during long scans
+	size_t countThread = std::max(std::thread::hardware_concurrency(), 1U);
+	for (size_t iBatch = 0; bComplete && iBatch < listParse.size(); iBatch += PARSE_BATCH) {
+		if (GetStatus() != RUN) {
+			bComplete = false;
+			break;
+		}
+
+		size_t countBatch = std::min<size_t>(PARSE_BATCH, listParse.size() - iBatch);
+		std::vector<std::vector<ref_count_ptr<ScriptInformation>>> listResult(countBatch);
+
+		std::atomic<size_t> indexNext = 0;
+		auto funcWorker = [&]() {
+			while (true) {
+				size_t i = indexNext++;
+				if (i >= countBatch) break;
+
+				ScanFile* file = listParse[iBatch + i];
+				listResult[i] = ScriptInformation::CreateScriptInformationList(file->path, true);
+				index->Update(file->path, file->stamp, listResult[i]);
+			}
+		};
+
+		std::vector<std::future<void>> listWorker;
+		for (size_t i = 1; i < std::min(countThread, countBatch); ++i)
+			listWorker.push_back(std::async(std::launch::async, funcWorker));
+		funcWorker();
+		for (auto& worker : listWorker)
+			worker.wait();
+
+		for (auto& listInfo : listResult)
+			_AddMenuItem(listInfo);
+		_FlushMenuItem(false);
+	}
+	_FlushMenuItem(true);
+
+	if (bComplete) {
+		std::wstring dir = PathProperty::AppendSlash(PathProperty::ReplaceYenToSlash(dir_));
+		index->RemoveMissing(dir, type_ != TYPE_DIR, setPathFound);
+	}
+	index->Save();
 }
-void ScriptSelectFileModel::_CreateMenuItem(const std::wstring& path) {
-	std::vector<ref_count_ptr<ScriptInformation>> listInfo = ScriptInformation::CreateScriptInformationList(path, true);
-	for (ref_count_ptr<ScriptInformation> info : listInfo) {
+void ScriptSelectFileModel::_AddMenuItem(const std::vector<ref_count_ptr<ScriptInformation>>& listInfo) {
+	for (const ref_count_ptr<ScriptInformation>& info : listInfo) {
 		if (!_IsValidScriptInformation(info)) continue;
 
 		int typeItem = _ConvertTypeInfoToItem(info->type_);
 		listItem_.push_back(new ScriptSelectSceneMenuItem(typeItem, info->pathScript_, info));
 	}
+}
+void ScriptSelectFileModel::_FlushMenuItem(bool bForce) {
+	uint64_t time = SystemUtility::GetCpuTime2();
+	if (!bForce && (time - timeLastUpdate_) <= 100) return;
 
+	//100ms delay between updates
+	timeLastUpdate_ = time;
+	scene_->AddMenuItem(listItem_);
+	listItem_.clear();
 }
 bool ScriptSelectFileModel::_IsValidScriptInformation(ref_count_ptr<ScriptInformation> info) {
 	int typeScript = info->type_;
@@ -131,10 +131,18 @@ protected:
 	uint64_t timeLastUpdate_;
 
 	std::list<ref_count_ptr<ScriptSelectSceneMenuItem>> listItem_;
+
+	struct ScanFile {
+		std::wstring path;
+		ScriptInformationIndex::FileStamp stamp;
+	};
+	std::vector<ScanFile> listFile_;
 	
 	virtual void _Run();
 	virtual void _SearchScript(const std::wstring& dir);
-	void _CreateMenuItem(const std::wstring& path);
+	void _CreateMenuItem();
+	void _AddMenuItem(const std::vector<ref_count_ptr<ScriptInformation>>& listInfo);
+	void _FlushMenuItem(bool bForce);
 	bool _IsValidScriptInformation(ref_count_ptr<ScriptInformation> info);
 	int _ConvertTypeInfoToItem(int typeInfo);
 public: